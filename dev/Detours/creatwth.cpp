@@ -924,6 +924,10 @@ BOOL WINAPI DetourCopyPayloadToProcess(_In_ HANDLE hProcess,
 
     DETOUR_TRACE(("Copied %d byte payload into target process at %p\n",
                   cbTotal, pbTarget - cbTotal));
+
+    if (GetProcessId(hProcess) == GetCurrentProcessId()) {
+        detour_invalidate_image_snapshot();
+    }
     return TRUE;
 }
 
@@ -1160,6 +1160,8 @@ struct DETOUR_REGION
     ULONG               dwSignature;
     DETOUR_REGION *     pNext;  // Next region in list of regions.
     DETOUR_TRAMPOLINE * pFree;  // List of free trampolines in this region.
+    DETOUR_REGION *     pNextTouched;   // Next region made writable by this transaction.
+    BOOL                fTouched;       // Writable until the transaction ends.
 };
 typedef DETOUR_REGION * PDETOUR_REGION;
 
@@ -1169,16 +1171,89 @@ const ULONG DETOUR_TRAMPOLINES_PER_REGION = (DETOUR_REGION_SIZE
                                              / sizeof(DETOUR_TRAMPOLINE)) - 1;
 static PDETOUR_REGION s_pRegions = NULL;            // List of all regions.
 static PDETOUR_REGION s_pRegion = NULL;             // Default region.
+static PDETOUR_REGION s_pTouchedRegions = NULL;     // Regions writable in this transaction.
 
-static DWORD detour_writable_trampoline_regions()
+//////////////////////////////////////////////////////////// Statistics.
+//
+//  Only the thread that owns the pending transaction updates these, so they
+//  need no interlocking.  Times are kept in performance counter ticks.
+//
+static ULONG64 s_nStatTrampolinesAllocated = 0;
+static ULONG64 s_nStatRegionsAllocated = 0;
+static ULONG64 s_nStatRegionsPlanned = 0;
+static ULONG64 s_nStatRegionProtectionChanges = 0;
+static ULONG64 s_nStatTrampolineAllocTicks = 0;
+static ULONG64 s_nStatCommits = 0;
+static ULONG64 s_nStatCommitTicks = 0;
+static ULONG64 s_nStatLastCommitTicks = 0;
+
+static inline ULONG64 detour_stat_ticks()
 {
-    // Mark all of the regions as writable.
-    for (PDETOUR_REGION pRegion = s_pRegions; pRegion != NULL; pRegion = pRegion->pNext) {
-        DWORD dwOld;
-        if (!VirtualProtect(pRegion, DETOUR_REGION_SIZE, PAGE_EXECUTE_READWRITE, &dwOld)) {
-            return GetLastError();
+    LARGE_INTEGER li;
+    QueryPerformanceCounter(&li);
+    return (ULONG64)li.QuadPart;
+}
+
+static ULONG64 detour_stat_ticks_to_microseconds(ULONG64 nTicks)
+{
+    LARGE_INTEGER liFrequency;
+    if (!QueryPerformanceFrequency(&liFrequency) || liFrequency.QuadPart == 0) {
+        return 0;
+    }
+    ULONG64 nFrequency = (ULONG64)liFrequency.QuadPart;
+    return (nTicks / nFrequency) * 1000000 + ((nTicks % nFrequency) * 1000000) / nFrequency;
+}
+
+BOOL WINAPI DetourGetStatistics(_Out_ PDETOUR_STATISTICS pStatistics)
+{
+    if (pStatistics == NULL) {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return FALSE;
+    }
+
+    pStatistics->nTrampolinesAllocated = s_nStatTrampolinesAllocated;
+    pStatistics->nRegionsAllocated = s_nStatRegionsAllocated;
+    pStatistics->nRegionsPlanned = s_nStatRegionsPlanned;
+    pStatistics->nRegionProtectionChanges = s_nStatRegionProtectionChanges;
+    pStatistics->nTrampolineAllocMicroseconds = detour_stat_ticks_to_microseconds(s_nStatTrampolineAllocTicks);
+    pStatistics->nCommits = s_nStatCommits;
+    pStatistics->nCommitMicroseconds = detour_stat_ticks_to_microseconds(s_nStatCommitTicks);
+    pStatistics->nLastCommitMicroseconds = detour_stat_ticks_to_microseconds(s_nStatLastCommitTicks);
+    return TRUE;
+}
+
+static void detour_track_touched_region(PDETOUR_REGION pRegion)
+{
+    pRegion->fTouched = TRUE;
+    pRegion->pNextTouched = s_pTouchedRegions;
+    s_pTouchedRegions = pRegion;
+}
+
+static void detour_untrack_touched_region(PDETOUR_REGION pRegion)
+{
+    for (PDETOUR_REGION *ppRegion = &s_pTouchedRegions; *ppRegion != NULL;
+         ppRegion = &(*ppRegion)->pNextTouched) {
+        if (*ppRegion == pRegion) {
+            *ppRegion = pRegion->pNextTouched;
+            break;
         }
     }
+}
+
+static DWORD detour_writable_trampoline_region(PDETOUR_REGION pRegion)
+{
+    // A region is made writable the first time a transaction needs to change
+    // it, rather than every region at the start of every transaction.
+    if (pRegion->fTouched) {
+        return NO_ERROR;
+    }
+
+    DWORD dwOld;
+    if (!VirtualProtect(pRegion, DETOUR_REGION_SIZE, PAGE_EXECUTE_READWRITE, &dwOld)) {
+        return GetLastError();
+    }
+    s_nStatRegionProtectionChanges++;
+    detour_track_touched_region(pRegion);
     return NO_ERROR;
 }
 
@@ -1186,12 +1261,20 @@ static void detour_runnable_trampoline_regions()
 {
     HANDLE hProcess = GetCurrentProcess();
 
-    // Mark all of the regions as executable.
-    for (PDETOUR_REGION pRegion = s_pRegions; pRegion != NULL; pRegion = pRegion->pNext) {
+    // Mark the regions this transaction touched as executable.
+    for (PDETOUR_REGION pRegion = s_pTouchedRegions; pRegion != NULL;) {
+        PDETOUR_REGION pNext = pRegion->pNextTouched;
+        pRegion->pNextTouched = NULL;
+        pRegion->fTouched = FALSE;
+
         DWORD dwOld;
         VirtualProtect(pRegion, DETOUR_REGION_SIZE, PAGE_EXECUTE_READ, &dwOld);
         FlushInstructionCache(hProcess, pRegion, DETOUR_REGION_SIZE);
+        s_nStatRegionProtectionChanges++;
+
+        pRegion = pNext;
     }
+    s_pTouchedRegions = NULL;
 }
 
 static PBYTE detour_alloc_round_down_to_region(PBYTE pbTry)
@@ -1374,6 +1457,41 @@ PVOID WINAPI DetourAllocateRegionWithinJumpBounds(_In_ LPCVOID pbTarget,
     return pbNewlyAllocated;
 }
 
+// Allocates a region near pbTarget within [pLo, pHi] and adds it to the list of regions.
+
+static PDETOUR_REGION detour_alloc_trampoline_region(PBYTE pbTarget,
+                                                     PDETOUR_TRAMPOLINE pLo,
+                                                     PDETOUR_TRAMPOLINE pHi)
+{
+    PVOID pbNewlyAllocated =
+        detour_alloc_trampoline_allocate_new(pbTarget, pLo, pHi);
+    if (pbNewlyAllocated == NULL) {
+        return NULL;
+    }
+
+    PDETOUR_REGION pRegion = (DETOUR_REGION*)pbNewlyAllocated;
+    pRegion->dwSignature = DETOUR_REGION_SIGNATURE;
+    pRegion->pFree = NULL;
+    pRegion->pNext = s_pRegions;
+    s_pRegions = pRegion;
+    s_nStatRegionsAllocated++;
+    DETOUR_TRACE(("  Allocated region %p..%p\n\n",
+                  pRegion, ((PBYTE)pRegion) + DETOUR_REGION_SIZE - 1));
+
+    // New regions start out writable, so they only need to be made runnable.
+    detour_track_touched_region(pRegion);
+
+    // Put everything but the first trampoline on the free list.
+    PBYTE pFree = NULL;
+    PDETOUR_TRAMPOLINE pTrampoline = ((PDETOUR_TRAMPOLINE)pRegion) + 1;
+    for (int i = DETOUR_TRAMPOLINES_PER_REGION - 1; i > 1; i--) {
+        pTrampoline[i].pbRemain = pFree;
+        pFree = (PBYTE)&pTrampoline[i];
+    }
+    pRegion->pFree = (PDETOUR_TRAMPOLINE)pFree;
+    return pRegion;
+}
+
 static PDETOUR_TRAMPOLINE detour_alloc_trampoline(PBYTE pbTarget)
 {
     // We have to place trampolines within +/- 2GB of target.
@@ -1384,6 +1502,7 @@ static PDETOUR_TRAMPOLINE detour_alloc_trampoline(PBYTE pbTarget)
     detour_find_jmp_bounds(pbTarget, &pLo, &pHi);
 
     PDETOUR_TRAMPOLINE pTrampoline = NULL;
+    ULONG64 nStartTicks = detour_stat_ticks();
 
     // Insure that there is a default region.
     if (s_pRegion == NULL && s_pRegions != NULL) {
@@ -1400,8 +1519,14 @@ static PDETOUR_TRAMPOLINE detour_alloc_trampoline(PBYTE pbTarget)
         if (pTrampoline < pLo || pTrampoline > pHi) {
             return NULL;
         }
+        if (detour_writable_trampoline_region(s_pRegion) != NO_ERROR) {
+            return NULL;
+        }
         s_pRegion->pFree = (PDETOUR_TRAMPOLINE)pTrampoline->pbRemain;
         memset(pTrampoline, 0xcc, sizeof(*pTrampoline));
+
+        s_nStatTrampolinesAllocated++;
+        s_nStatTrampolineAllocTicks += detour_stat_ticks() - nStartTicks;
         return pTrampoline;
     }
 
@@ -1418,25 +1543,8 @@ static PDETOUR_TRAMPOLINE detour_alloc_trampoline(PBYTE pbTarget)
     // Round pbTarget down to 64KB block.
     pbTarget = pbTarget - (PtrToUlong(pbTarget) & 0xffff);
 
-    PVOID pbNewlyAllocated =
-        detour_alloc_trampoline_allocate_new(pbTarget, pLo, pHi);
-    if (pbNewlyAllocated != NULL) {
-        s_pRegion = (DETOUR_REGION*)pbNewlyAllocated;
-        s_pRegion->dwSignature = DETOUR_REGION_SIGNATURE;
-        s_pRegion->pFree = NULL;
-        s_pRegion->pNext = s_pRegions;
-        s_pRegions = s_pRegion;
-        DETOUR_TRACE(("  Allocated region %p..%p\n\n",
-                      s_pRegion, ((PBYTE)s_pRegion) + DETOUR_REGION_SIZE - 1));
-
-        // Put everything but the first trampoline on the free list.
-        PBYTE pFree = NULL;
-        pTrampoline = ((PDETOUR_TRAMPOLINE)s_pRegion) + 1;
-        for (int i = DETOUR_TRAMPOLINES_PER_REGION - 1; i > 1; i--) {
-            pTrampoline[i].pbRemain = pFree;
-            pFree = (PBYTE)&pTrampoline[i];
-        }
-        s_pRegion->pFree = (PDETOUR_TRAMPOLINE)pFree;
+    s_pRegion = detour_alloc_trampoline_region(pbTarget, pLo, pHi);
+    if (s_pRegion != NULL) {
         goto found_region;
     }
 
@@ -1444,11 +1552,38 @@ static PDETOUR_TRAMPOLINE detour_alloc_trampoline(PBYTE pbTarget)
     return NULL;
 }
 
+// Counts free trampolines within [pLo, pHi], stopping once nWanted are found.
+
+static ULONG detour_count_free_trampolines(PDETOUR_TRAMPOLINE pLo,
+                                           PDETOUR_TRAMPOLINE pHi,
+                                           ULONG nWanted)
+{
+    ULONG nFree = 0;
+    for (PDETOUR_REGION pRegion = s_pRegions; pRegion != NULL && nFree < nWanted;
+         pRegion = pRegion->pNext) {
+
+        if ((PBYTE)pRegion + DETOUR_REGION_SIZE <= (PBYTE)pLo || (PBYTE)pRegion > (PBYTE)pHi) {
+            continue;
+        }
+        for (PDETOUR_TRAMPOLINE pFree = pRegion->pFree; pFree != NULL && nFree < nWanted;
+             pFree = (PDETOUR_TRAMPOLINE)pFree->pbRemain) {
+            if (pFree >= pLo && pFree <= pHi) {
+                nFree++;
+            }
+        }
+    }
+    return nFree;
+}
+
 static void detour_free_trampoline(PDETOUR_TRAMPOLINE pTrampoline)
 {
     PDETOUR_REGION pRegion = (PDETOUR_REGION)
         ((ULONG_PTR)pTrampoline & ~(ULONG_PTR)0xffff);
 
+    // Trampolines being freed were allocated or detached in this transaction,
+    // so the region is normally writable already.
+    detour_writable_trampoline_region(pRegion);
+
     memset(pTrampoline, 0, sizeof(*pTrampoline));
     pTrampoline->pbRemain = (PBYTE)pRegion->pFree;
     pRegion->pFree = pTrampoline;
@@ -1487,6 +1622,9 @@ static void detour_free_unused_trampoline_regions()
         if (detour_is_region_empty(pRegion)) {
             *ppRegionBase = pRegion->pNext;
 
+            if (pRegion->fTouched) {
+                detour_untrack_touched_region(pRegion);
+            }
             VirtualFree(pRegion, 0, MEM_RELEASE);
             s_pRegion = NULL;
         }
@@ -1523,6 +1661,7 @@ static LONG                 s_nPendingError         = NO_ERROR;
 static PVOID *              s_ppPendingError        = NULL;
 static DetourThread *       s_pPendingThreads       = NULL;
 static DetourOperation *    s_pPendingOperations    = NULL;
+static BOOL                 s_fPlannedRegions       = FALSE; // Planning allocated a region.
 
 //////////////////////////////////////////////////////////////////////////////
 //
@@ -1579,9 +1718,10 @@ _Benign_race_end_
     s_pPendingOperations = NULL;
     s_pPendingThreads = NULL;
     s_ppPendingError = NULL;
+    s_fPlannedRegions = FALSE;
 
-    // Make sure the trampoline pages are writable.
-    s_nPendingError = detour_writable_trampoline_regions();
+    // Trampoline regions are made writable as the transaction touches them.
+    s_nPendingError = NO_ERROR;
 
     return s_nPendingError;
 }
@@ -1612,6 +1752,12 @@ LONG WINAPI DetourTransactionAbort()
     }
     s_pPendingOperations = NULL;
 
+    // Free any regions that planning allocated for the aborted attaches.
+    if (s_fPlannedRegions && !s_fRetainRegions) {
+        detour_free_unused_trampoline_regions();
+    }
+    s_fPlannedRegions = FALSE;
+
     // Make sure the trampoline pages are no longer writable.
     detour_runnable_trampoline_regions();
 
@@ -1672,6 +1818,8 @@ LONG WINAPI DetourTransactionCommitEx(_Out_opt_ PVOID **pppFailedPointer)
         return s_nPendingError;
     }
 
+    ULONG64 nCommitStartTicks = detour_stat_ticks();
+
     // Common variables.
     DetourOperation *o;
     DetourThread *t;
@@ -1897,10 +2045,12 @@ typedef ULONG_PTR DETOURS_EIP_TYPE;
     }
     s_pPendingOperations = NULL;
 
-    // Free any trampoline regions that are now unused.
-    if (freed && !s_fRetainRegions) {
+    // Free any trampoline regions that are now unused, including any that
+    // planning allocated but no attach ended up using.
+    if ((freed || s_fPlannedRegions) && !s_fRetainRegions) {
         detour_free_unused_trampoline_regions();
     }
+    s_fPlannedRegions = FALSE;
 
     // Make sure the trampoline pages are no longer writable.
     detour_runnable_trampoline_regions();
@@ -1915,6 +2065,11 @@ typedef ULONG_PTR DETOURS_EIP_TYPE;
         t = n;
     }
     s_pPendingThreads = NULL;
+
+    s_nStatLastCommitTicks = detour_stat_ticks() - nCommitStartTicks;
+    s_nStatCommitTicks += s_nStatLastCommitTicks;
+    s_nStatCommits++;
+
     s_nPendingThreadId = 0;
 
     if (pppFailedPointer != NULL) {
@@ -1924,6 +2079,116 @@ typedef ULONG_PTR DETOURS_EIP_TYPE;
     return s_nPendingError;
 }
 
+LONG WINAPI DetourPlanTrampolines(_In_reads_(cTargets) PVOID *ppTargets,
+                                  _In_ ULONG cTargets)
+{
+    if (s_nPendingThreadId != (LONG)GetCurrentThreadId()) {
+        return ERROR_INVALID_OPERATION;
+    }
+    if (s_nPendingError != NO_ERROR) {
+        return s_nPendingError;
+    }
+    if (cTargets == 0) {
+        return NO_ERROR;
+    }
+    if (ppTargets == NULL) {
+        return ERROR_INVALID_PARAMETER;
+    }
+
+    PBYTE *rpbTargets = new NOTHROW PBYTE [cTargets];
+    if (rpbTargets == NULL) {
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    ULONG64 nStartTicks = detour_stat_ticks();
+
+    // Sort the code addresses, so that targets which can share a region are adjacent.
+    ULONG nTargets = 0;
+    for (ULONG n = 0; n < cTargets; n++) {
+        if (ppTargets[n] == NULL) {
+            continue;
+        }
+        PBYTE pbTarget = (PBYTE)DetourCodeFromPointer(ppTargets[n], NULL);
+        ULONG i = nTargets++;
+        for (; i > 0 && rpbTargets[i - 1] > pbTarget; i--) {
+            rpbTargets[i] = rpbTargets[i - 1];
+        }
+        rpbTargets[i] = pbTarget;
+    }
+
+    for (ULONG nFirst = 0; nFirst < nTargets;) {
+        PDETOUR_TRAMPOLINE pLo;
+        PDETOUR_TRAMPOLINE pHi;
+        detour_find_jmp_bounds(rpbTargets[nFirst], &pLo, &pHi);
+
+        // Grow the cluster for as long as one region in reach of all of its
+        // targets can still hold a trampoline for each of them.
+        ULONG nLast = nFirst + 1;
+        for (; nLast < nTargets && nLast - nFirst < DETOUR_TRAMPOLINES_PER_REGION; nLast++) {
+            PDETOUR_TRAMPOLINE pNextLo;
+            PDETOUR_TRAMPOLINE pNextHi;
+            detour_find_jmp_bounds(rpbTargets[nLast], &pNextLo, &pNextHi);
+
+            PDETOUR_TRAMPOLINE pNewLo = (pNextLo > pLo) ? pNextLo : pLo;
+            PDETOUR_TRAMPOLINE pNewHi = (pNextHi < pHi) ? pNextHi : pHi;
+            if (pNewHi <= pNewLo ||
+                (ULONG_PTR)((PBYTE)pNewHi - (PBYTE)pNewLo) < DETOUR_REGION_SIZE) {
+                break;
+            }
+            pLo = pNewLo;
+            pHi = pNewHi;
+        }
+
+        // Allocate one region for the cluster if the existing ones can't take it.
+        // Failing here isn't fatal; DetourAttach will search again for each target.
+        ULONG nNeeded = nLast - nFirst;
+        if (detour_count_free_trampolines(pLo, pHi, nNeeded) < nNeeded) {
+            PBYTE pbCenter = rpbTargets[nFirst + nNeeded / 2];
+            pbCenter = pbCenter - (PtrToUlong(pbCenter) & 0xffff);
+
+            PDETOUR_REGION pRegion = detour_alloc_trampoline_region(pbCenter, pLo, pHi);
+            if (pRegion != NULL) {
+                s_fPlannedRegions = TRUE;
+                s_nStatRegionsPlanned++;
+            }
+        }
+        nFirst = nLast;
+    }
+
+    delete[] rpbTargets;
+    s_nStatTrampolineAllocTicks += detour_stat_ticks() - nStartTicks;
+    return NO_ERROR;
+}
+
+LONG WINAPI DetourAttachBatch(_Inout_updates_(cDetours) PVOID **pppPointers,
+                              _In_reads_(cDetours) PVOID *ppDetours,
+                              _In_ ULONG cDetours)
+{
+    if (cDetours == 0) {
+        return NO_ERROR;
+    }
+    if (pppPointers == NULL || ppDetours == NULL) {
+        return ERROR_INVALID_PARAMETER;
+    }
+
+    PVOID *ppTargets = new NOTHROW PVOID [cDetours];
+    if (ppTargets == NULL) {
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+    for (ULONG n = 0; n < cDetours; n++) {
+        ppTargets[n] = (pppPointers[n] != NULL) ? *pppPointers[n] : NULL;
+    }
+
+    // Place the trampolines for the whole batch before attaching any of it.
+    LONG error = DetourPlanTrampolines(ppTargets, cDetours);
+    delete[] ppTargets;
+
+    for (ULONG n = 0; n < cDetours && error == NO_ERROR; n++) {
+        error = DetourAttach(pppPointers[n], ppDetours[n]);
+    }
+    return error;
+}
+
 LONG WINAPI DetourUpdateThread(_In_ HANDLE hThread)
 {
     LONG error;
@@ -2455,6 +2720,15 @@ LONG WINAPI DetourDetach(_Inout_ PVOID *ppPointer,
         goto fail;
     }
 
+    // The commit frees this trampoline, which writes to its region.
+    error = detour_writable_trampoline_region((PDETOUR_REGION)
+                                              ((ULONG_PTR)pTrampoline & ~(ULONG_PTR)0xffff));
+    if (error != NO_ERROR) {
+        VirtualProtect(pbTarget, cbTarget, dwOld, &dwOld);
+        DETOUR_BREAK();
+        goto fail;
+    }
+
     o->fIsRemove = TRUE;
     o->ppbPointer = (PBYTE*)ppPointer;
     o->pTrampoline = pTrampoline;
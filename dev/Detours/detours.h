@@ -153,6 +153,7 @@ typedef ULONG ULONG_PTR;
 #undef _In_z_
 #undef _Inout_
 #undef _Inout_opt_
+#undef _Inout_updates_
 #undef _Inout_z_count_
 #undef _Out_
 #undef _Out_opt_
@@ -252,6 +253,10 @@ typedef ULONG ULONG_PTR;
 #define _Inout_opt_
 #endif
 
+#ifndef _Inout_updates_
+#define _Inout_updates_(x)
+#endif
+
 #ifndef _Inout_z_count_
 #define _Inout_z_count_(x)
 #endif
@@ -538,6 +543,20 @@ typedef BOOL (CALLBACK *PF_DETOUR_IMPORT_FUNC_CALLBACK_EX)(_In_opt_ PVOID pConte
 
 typedef VOID * PDETOUR_BINARY;
 typedef VOID * PDETOUR_LOADED_BINARY;
+typedef VOID * PDETOUR_EXPORT_INDEX;
+typedef VOID * PDETOUR_MODULE_SNAPSHOT;
+
+typedef struct _DETOUR_MODULE_INFO
+{
+    HMODULE                 hModule;        // Base address of the image.
+    ULONG                   cbImage;
+    PIMAGE_NT_HEADERS       pNtHeader;
+    PIMAGE_SECTION_HEADER   pSections;
+    ULONG                   nSections;
+    PDETOUR_LOADED_BINARY   pPayloads;      // The .detour section, or NULL.
+} DETOUR_MODULE_INFO, *PDETOUR_MODULE_INFO;
+
+#define DETOUR_MODULE_SNAPSHOT_ALL_IMAGES       0x00000001  // Also walk the address space.
 
 //////////////////////////////////////////////////////////// Transaction APIs.
 //
@@ -560,6 +579,26 @@ LONG WINAPI DetourAttachEx(_Inout_ PVOID *ppPointer,
 LONG WINAPI DetourDetach(_Inout_ PVOID *ppPointer,
                          _In_ PVOID pDetour);
 
+LONG WINAPI DetourPlanTrampolines(_In_reads_(cTargets) PVOID *ppTargets,
+                                  _In_ ULONG cTargets);
+LONG WINAPI DetourAttachBatch(_Inout_updates_(cDetours) PVOID **pppPointers,
+                              _In_reads_(cDetours) PVOID *ppDetours,
+                              _In_ ULONG cDetours);
+
+typedef struct _DETOUR_STATISTICS
+{
+    ULONG64 nTrampolinesAllocated;
+    ULONG64 nRegionsAllocated;
+    ULONG64 nRegionsPlanned;                // Regions allocated by DetourPlanTrampolines.
+    ULONG64 nRegionProtectionChanges;
+    ULONG64 nTrampolineAllocMicroseconds;
+    ULONG64 nCommits;
+    ULONG64 nCommitMicroseconds;
+    ULONG64 nLastCommitMicroseconds;
+} DETOUR_STATISTICS, *PDETOUR_STATISTICS;
+
+BOOL WINAPI DetourGetStatistics(_Out_ PDETOUR_STATISTICS pStatistics);
+
 BOOL WINAPI DetourSetIgnoreTooSmall(_In_ BOOL fIgnore);
 BOOL WINAPI DetourSetRetainRegions(_In_ BOOL fRetain);
 PVOID WINAPI DetourSetSystemRegionLowerBound(_In_ PVOID pSystemRegionLowerBound);
@@ -615,6 +654,31 @@ PVOID WINAPI DetourFindPayloadEx(_In_ REFGUID rguid,
 
 DWORD WINAPI DetourGetSizeOfPayloads(_In_opt_ HMODULE hModule);
 
+PDETOUR_MODULE_SNAPSHOT WINAPI DetourModuleSnapshotCreate(_In_ DWORD dwFlags);
+ULONG WINAPI DetourModuleSnapshotGetCount(_In_ PDETOUR_MODULE_SNAPSHOT pModuleSnapshot);
+BOOL WINAPI DetourModuleSnapshotGetModule(_In_ PDETOUR_MODULE_SNAPSHOT pModuleSnapshot,
+                                          _In_ ULONG nIndex,
+                                          _Out_ PDETOUR_MODULE_INFO pInfo);
+BOOL WINAPI DetourModuleSnapshotFindAddress(_In_ PDETOUR_MODULE_SNAPSHOT pModuleSnapshot,
+                                            _In_ PVOID pvAddr,
+                                            _Out_ PDETOUR_MODULE_INFO pInfo);
+BOOL WINAPI DetourModuleSnapshotClose(_In_ PDETOUR_MODULE_SNAPSHOT pModuleSnapshot);
+
+////////////////////////////////////////////////////// Export Index Functions.
+//
+PDETOUR_EXPORT_INDEX WINAPI DetourExportIndexCreate(_In_reads_bytes_(cbImage) PVOID pvImage,
+                                                    _In_ ULONG cbImage,
+                                                    _In_ BOOL fMapped);
+BOOL WINAPI DetourExportIndexFind(_In_ PDETOUR_EXPORT_INDEX pExportIndex,
+                                  _In_ LPCSTR pszName,
+                                  _Out_opt_ ULONG *pnOrdinal,
+                                  _Out_opt_ ULONG *pnRva);
+BOOL WINAPI DetourExportIndexClose(_In_ PDETOUR_EXPORT_INDEX pExportIndex);
+
+PVOID WINAPI DetourFindExport(_In_opt_ HMODULE hModule,
+                              _In_ LPCSTR pszFunction);
+BOOL WINAPI DetourFlushExportIndexes(_In_opt_ HMODULE hModule);
+
 ///////////////////////////////////////////////// Persistent Binary Functions.
 //
 
@@ -1118,6 +1182,57 @@ BOOL WINAPI DetourVirtualProtectSameExecute(_In_  PVOID pAddress,
 }
 #endif // __cplusplus
 
+//////////////////////////////////////////////////////////////////////////////
+//
+// Export index (expindex.cpp).  These return a Win32 error code rather than
+// setting the last error, and take no locks.
+//
+
+struct DETOUR_EXPORT_SLOT
+{
+    DWORD       nHash;
+    DWORD       nName;          // Index into AddressOfNames plus one; 0 is empty.
+};
+
+struct DETOUR_EXPORT_INDEX
+{
+    PBYTE                   pbImage;
+    ULONG                   cbImage;
+    BOOL                    fMapped;
+    PIMAGE_SECTION_HEADER   pSections;
+    DWORD                   nSections;
+
+    DWORD                   rvaExportDir;
+    DWORD                   cbExportDir;
+    DWORD                   nBase;
+    DWORD                   nFunctions;
+    DWORD                   nNames;
+    PDWORD                  pdwFunctions;
+    PDWORD                  pdwNames;
+    PWORD                   pwOrdinals;
+
+    DWORD                   nSlots;         // Power of two, or 0 if there are no names.
+    DETOUR_EXPORT_SLOT *    pSlots;
+
+    HMODULE                 hModule;        // Set for indexes cached by DetourFindExport.
+    DETOUR_EXPORT_INDEX *   pNext;
+};
+
+DWORD detour_export_index_create(_In_ PBYTE pbImage,
+                                 _In_ ULONG cbImage,
+                                 _In_ BOOL fMapped,
+                                 _Out_ DETOUR_EXPORT_INDEX **ppIndex);
+BOOL detour_export_index_find(_In_ const DETOUR_EXPORT_INDEX *pIndex,
+                              _In_ LPCSTR pszName,
+                              _Out_ PDWORD pnFunction);
+BOOL detour_export_index_code_rva(_In_ const DETOUR_EXPORT_INDEX *pIndex,
+                                  _In_ DWORD nFunction,
+                                  _Out_ PDWORD pRva);
+VOID detour_export_index_free(_In_ DETOUR_EXPORT_INDEX *pIndex);
+
+// Makes DetourFindPayloadEx take a new snapshot of the images in this process.
+VOID detour_invalidate_image_snapshot();
+
 //////////////////////////////////////////////////////////////////////////////
 
 #define MM_ALLOCATION_GRANULARITY 0x10000
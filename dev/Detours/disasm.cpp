@@ -19,6 +19,14 @@
 #undef ASSERT
 #define ASSERT(x)
 
+// The x86/x64 table-driven pre-decoder in CopyInstruction.  The tests under
+// test/Detours also build the disassembler without it, as the reference that
+// the pre-decoder is checked against.
+//
+#ifndef DETOURS_DISASM_FAST_PATH
+#define DETOURS_DISASM_FAST_PATH 1
+#endif
+
 //////////////////////////////////////////////////////////////////////////////
 //
 //  Special macros to handle the case when we are building disassembler for
@@ -266,6 +274,19 @@ class CDetourDis
     PBYTE AdjustTarget(PBYTE pbDst, PBYTE pbSrc, UINT cbOp,
                        UINT cbTargetOffset, UINT cbTargetSize);
 
+  protected:
+    // Pre-decoder for instructions whose length follows from the tables alone.
+    PBYTE CopyFast(PBYTE pbDst, PBYTE pbSrc);
+    static UINT FastLength(BYTE bFast, PBYTE pbSrc);
+    static VOID BuildFastTables();
+
+    // s_rbFast flags.
+    enum {
+        FAST        = 0x80u,
+        FASTMOD     = 0x70u,    // Offset to mod/rm byte, as in nModOffset.
+        FASTSIZE    = 0x0fu,    // Fixed size, as in nFixedSize.
+    };
+
   protected:
     PBYTE Copy0F(REFCOPYENTRY pEntry, PBYTE pbDst, PBYTE pbSrc);
     PBYTE Copy0F00(REFCOPYENTRY pEntry, PBYTE pbDst, PBYTE pbSrc); // x86 only sldt/0 str/1 lldt/2 ltr/3 err/4 verw/5 jmpe/6/dynamic invalid/7
@@ -289,6 +310,9 @@ class CDetourDis
     static const COPYENTRY  s_rceCopyTable[257];
     static const COPYENTRY  s_rceCopyTable0F[257];
     static const BYTE       s_rbModRm[256];
+    static BYTE             s_rbFast[256];
+    static BYTE             s_rbFast0F[256];
+    static LONG volatile    s_fFastTablesBuilt;
     static PBYTE            s_pbModuleBeg;
     static PBYTE            s_pbModuleEnd;
     static BOOL             s_fLimitReferencesToModule;
@@ -354,6 +378,21 @@ PBYTE CDetourDis::CopyInstruction(PBYTE pbDst, PBYTE pbSrc)
         return NULL;
     }
 
+#if DETOURS_DISASM_FAST_PATH
+    // Most instructions in a prologue are plain opcodes, optionally behind a
+    // REX prefix, with nothing to relocate.  Those are measured and copied
+    // straight from the pre-decoder tables.
+    //
+    if (!s_fFastTablesBuilt) {
+        BuildFastTables();
+    }
+
+    PBYTE pbNext = CopyFast(pbDst, pbSrc);
+    if (pbNext != NULL) {
+        return pbNext;
+    }
+#endif
+
     // Figure out how big the instruction is, do the appropriate copy,
     // and figure out what the target of the instruction is if any.
     //
@@ -361,6 +400,108 @@ PBYTE CDetourDis::CopyInstruction(PBYTE pbDst, PBYTE pbSrc)
     return (this->*pEntry->pfCopy)(pEntry, pbDst, pbSrc);
 }
 
+PBYTE CDetourDis::CopyFast(PBYTE pbDst, PBYTE pbSrc)
+{
+    PBYTE pbOp = pbSrc;
+#ifdef DETOURS_X64
+    // A single REX prefix.  REX.W only changes the size of RAX entries,
+    // which never make it into the fast tables.
+    if ((pbOp[0] & 0xf0) == 0x40) {
+        pbOp++;
+    }
+#endif
+
+    BYTE bFast;
+    if (pbOp[0] == 0x0f) {
+        pbOp++;
+        bFast = s_rbFast0F[pbOp[0]];
+    }
+    else {
+        bFast = s_rbFast[pbOp[0]];
+    }
+    if (bFast == 0) {
+        return NULL;
+    }
+
+    UINT const nBytes = FastLength(bFast, pbOp);
+    if (nBytes == 0) {
+        return NULL;
+    }
+
+    UINT const cbTotal = (UINT)(pbOp - pbSrc) + nBytes;
+    CopyMemory(pbDst, pbSrc, cbTotal);
+    return pbSrc + cbTotal;
+}
+
+UINT CDetourDis::FastLength(BYTE bFast, PBYTE pbSrc)
+{
+    // Same sizing as CopyBytes with no prefixes in effect.
+    UINT nBytes = bFast & FASTSIZE;
+    UINT const nModOffset = (bFast & FASTMOD) >> 4;
+
+    if (nModOffset > 0) {
+        BYTE const bModRm = pbSrc[nModOffset];
+        BYTE const bFlags = s_rbModRm[bModRm];
+
+#ifdef DETOURS_X64
+        if (bFlags & RIP) {
+            // RIP relative, so the displacement has to be adjusted.
+            return 0;
+        }
+#endif
+        nBytes += bFlags & NOTSIB;
+
+        if (bFlags & SIB) {
+            BYTE const bSib = pbSrc[nModOffset + 1];
+
+            if ((bSib & 0x07) == 0x05) {
+                if ((bModRm & 0xc0) == 0x00) {
+                    nBytes += 4;
+                }
+                else if ((bModRm & 0xc0) == 0x40) {
+                    nBytes += 1;
+                }
+                else if ((bModRm & 0xc0) == 0x80) {
+                    nBytes += 4;
+                }
+            }
+        }
+    }
+    return nBytes;
+}
+
+VOID CDetourDis::BuildFastTables()
+{
+    // Only plain CopyBytes entries qualify: no flags (so the size doesn't
+    // depend on a prefix and there is no dynamic target) and no relative
+    // target.  Everything else goes through the full decoder.
+    //
+    // Concurrent builders write identical values, so the only ordering
+    // needed is that the tables are complete before they are published.
+    //
+    for (ULONG n = 0; n < 256; n++) {
+        const COPYENTRY *rpEntries[2] = { &s_rceCopyTable[n], &s_rceCopyTable0F[n] };
+        BYTE *rpbFast[2] = { &s_rbFast[n], &s_rbFast0F[n] };
+
+        for (ULONG i = 0; i < 2; i++) {
+            REFCOPYENTRY pEntry = rpEntries[i];
+            BYTE bFast = 0;
+
+            if (pEntry->pfCopy == &CDetourDis::CopyBytes &&
+                pEntry->nFlagBits == 0 &&
+                pEntry->nRelOffset == 0 &&
+                pEntry->nFixedSize > 0 &&
+                pEntry->nModOffset <= (FASTMOD >> 4)) {
+
+                bFast = (BYTE)(FAST | (pEntry->nModOffset << 4) | pEntry->nFixedSize);
+            }
+            *rpbFast[i] = bFast;
+        }
+    }
+
+    InterlockedExchange((LONG *)&s_fFastTablesBuilt, TRUE);
+}
+
 PBYTE CDetourDis::CopyBytes(REFCOPYENTRY pEntry, PBYTE pbDst, PBYTE pbSrc)
 {
     UINT nBytesFixed;
@@ -921,6 +1062,9 @@ pp is like VEX but only instructions with 0 are defined
 PBYTE CDetourDis::s_pbModuleBeg = NULL;
 PBYTE CDetourDis::s_pbModuleEnd = (PBYTE)~(ULONG_PTR)0;
 BOOL CDetourDis::s_fLimitReferencesToModule = FALSE;
+BYTE CDetourDis::s_rbFast[256];
+BYTE CDetourDis::s_rbFast0F[256];
+LONG volatile CDetourDis::s_fFastTablesBuilt = FALSE;
 
 BOOL CDetourDis::SetCodeModule(PBYTE pbBeg, PBYTE pbEnd, BOOL fLimitReferencesToModule)
 {
@@ -0,0 +1,318 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  Export Index Functions (expindex.cpp of detours.lib)
+//
+//  Microsoft Research Detours Package, Version 4.0.1
+//
+//  Copyright (c) Microsoft Corporation and Contributors.  All rights reserved.
+//
+//  Parses and hashes the export directory of one PE image.  Nothing in here
+//  takes a lock or sets the last error, so it builds against image files on
+//  any OS; the public API and the per-module cache are in modules.cpp.
+//
+
+// #define DETOUR_DEBUG 1
+#define DETOURS_INTERNAL
+#include "detours.h"
+
+#if DETOURS_VERSION != 0x4c0c1   // 0xMAJORcMINORcPATCH
+#error detours.h version mismatch
+#endif
+
+static inline DWORD detour_export_hash(_In_ LPCSTR pszName)
+{
+    DWORD nHash = 2166136261u;
+    for (; *pszName != '\0'; pszName++) {
+        nHash = (nHash ^ (BYTE)*pszName) * 16777619u;
+    }
+    return nHash;
+}
+
+// Export names are matched exactly, as GetProcAddress does.
+//
+static inline BOOL detour_export_name_equal(_In_ LPCSTR pszA, _In_ LPCSTR pszB)
+{
+    for (; *pszA == *pszB; pszA++, pszB++) {
+        if (*pszA == '\0') {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Returns a pointer to cb bytes at rva, or NULL if they aren't all inside the image.
+//
+static PBYTE detour_export_rva(_In_ const DETOUR_EXPORT_INDEX *pIndex,
+                               _In_ DWORD rva,
+                               _In_ DWORD cb,
+                               _Out_opt_ PDWORD pcbAvail)
+{
+    if (pcbAvail != NULL) {
+        *pcbAvail = 0;
+    }
+
+    DWORD offset = rva;
+    DWORD cbAvail = 0;
+
+    if (pIndex->fMapped) {
+        if (rva >= pIndex->cbImage) {
+            return NULL;
+        }
+        cbAvail = pIndex->cbImage - rva;
+    }
+    else {
+        // The headers keep their file offsets; everything else is found
+        // through the section that holds it.
+        BOOL fFound = FALSE;
+        for (DWORD n = 0; n < pIndex->nSections; n++) {
+            PIMAGE_SECTION_HEADER pSection = &pIndex->pSections[n];
+            if (rva >= pSection->VirtualAddress &&
+                rva - pSection->VirtualAddress < pSection->SizeOfRawData) {
+                offset = pSection->PointerToRawData + (rva - pSection->VirtualAddress);
+                cbAvail = pSection->SizeOfRawData - (rva - pSection->VirtualAddress);
+                fFound = TRUE;
+                break;
+            }
+        }
+        if (!fFound) {
+            if (pIndex->nSections > 0 && rva >= pIndex->pSections[0].VirtualAddress) {
+                return NULL;
+            }
+            cbAvail = ~0u;
+        }
+        if (offset >= pIndex->cbImage) {
+            return NULL;
+        }
+        if (cbAvail > pIndex->cbImage - offset) {
+            cbAvail = pIndex->cbImage - offset;
+        }
+    }
+
+    if (cb > cbAvail) {
+        return NULL;
+    }
+    if (pcbAvail != NULL) {
+        *pcbAvail = cbAvail;
+    }
+    return pIndex->pbImage + offset;
+}
+
+static LPCSTR detour_export_name(_In_ const DETOUR_EXPORT_INDEX *pIndex, _In_ DWORD nName)
+{
+    DWORD cbAvail;
+    LPCSTR pszName = (LPCSTR)detour_export_rva(pIndex, pIndex->pdwNames[nName], 1, &cbAvail);
+    if (pszName == NULL) {
+        return NULL;
+    }
+
+    // Only hand out names that are terminated inside the image.
+    for (DWORD cch = 0; cch < cbAvail; cch++) {
+        if (pszName[cch] == '\0') {
+            return pszName;
+        }
+    }
+    return NULL;
+}
+
+static DWORD detour_export_index_parse(_Inout_ DETOUR_EXPORT_INDEX *pIndex)
+{
+    if (pIndex->cbImage < sizeof(IMAGE_DOS_HEADER)) {
+        return ERROR_BAD_EXE_FORMAT;
+    }
+
+    PIMAGE_DOS_HEADER pDosHeader = (PIMAGE_DOS_HEADER)pIndex->pbImage;
+    if (pDosHeader->e_magic != IMAGE_DOS_SIGNATURE ||
+        pDosHeader->e_lfanew < (LONG)sizeof(IMAGE_DOS_HEADER) ||
+        (ULONG)pDosHeader->e_lfanew > pIndex->cbImage - FIELD_OFFSET(IMAGE_NT_HEADERS32, OptionalHeader)) {
+        return ERROR_BAD_EXE_FORMAT;
+    }
+
+    // The Signature and FileHeader layout is the same for PE32 and PE32+ images.
+    PIMAGE_NT_HEADERS32 pNtHeader = (PIMAGE_NT_HEADERS32)(pIndex->pbImage + pDosHeader->e_lfanew);
+    if (pNtHeader->Signature != IMAGE_NT_SIGNATURE) {
+        return ERROR_INVALID_EXE_SIGNATURE;
+    }
+
+    ULONG cbOptional = pNtHeader->FileHeader.SizeOfOptionalHeader;
+    ULONG offOptional = (ULONG)pDosHeader->e_lfanew + FIELD_OFFSET(IMAGE_NT_HEADERS32, OptionalHeader);
+    ULONG offSections = offOptional + cbOptional;
+    ULONG nSections = pNtHeader->FileHeader.NumberOfSections;
+    if (cbOptional < sizeof(WORD) ||
+        offSections > pIndex->cbImage ||
+        nSections > (pIndex->cbImage - offSections) / sizeof(IMAGE_SECTION_HEADER)) {
+        return ERROR_EXE_MARKED_INVALID;
+    }
+
+    pIndex->pSections = (PIMAGE_SECTION_HEADER)(pIndex->pbImage + offSections);
+    pIndex->nSections = nSections;
+
+    PIMAGE_DATA_DIRECTORY pDirectories;
+    DWORD nDirectories;
+    PBYTE pbOptional = pIndex->pbImage + offOptional;
+    WORD wMagic = *(PWORD)pbOptional;
+    if (wMagic == IMAGE_NT_OPTIONAL_HDR32_MAGIC && cbOptional >= sizeof(IMAGE_OPTIONAL_HEADER32)) {
+        pDirectories = ((PIMAGE_OPTIONAL_HEADER32)pbOptional)->DataDirectory;
+        nDirectories = ((PIMAGE_OPTIONAL_HEADER32)pbOptional)->NumberOfRvaAndSizes;
+    }
+    else if (wMagic == IMAGE_NT_OPTIONAL_HDR64_MAGIC && cbOptional >= sizeof(IMAGE_OPTIONAL_HEADER64)) {
+        pDirectories = ((PIMAGE_OPTIONAL_HEADER64)pbOptional)->DataDirectory;
+        nDirectories = ((PIMAGE_OPTIONAL_HEADER64)pbOptional)->NumberOfRvaAndSizes;
+    }
+    else {
+        return ERROR_EXE_MARKED_INVALID;
+    }
+
+    if (nDirectories <= IMAGE_DIRECTORY_ENTRY_EXPORT ||
+        pDirectories[IMAGE_DIRECTORY_ENTRY_EXPORT].VirtualAddress == 0) {
+        // No exports is a valid, empty index.
+        return NO_ERROR;
+    }
+
+    pIndex->rvaExportDir = pDirectories[IMAGE_DIRECTORY_ENTRY_EXPORT].VirtualAddress;
+    pIndex->cbExportDir = pDirectories[IMAGE_DIRECTORY_ENTRY_EXPORT].Size;
+
+    PIMAGE_EXPORT_DIRECTORY pExportDir = (PIMAGE_EXPORT_DIRECTORY)
+        detour_export_rva(pIndex, pIndex->rvaExportDir, sizeof(IMAGE_EXPORT_DIRECTORY), NULL);
+    if (pExportDir == NULL ||
+        pExportDir->NumberOfFunctions > pIndex->cbImage / sizeof(DWORD) ||
+        pExportDir->NumberOfNames > pIndex->cbImage / sizeof(DWORD)) {
+        return ERROR_EXE_MARKED_INVALID;
+    }
+
+    pIndex->nBase = pExportDir->Base;
+    pIndex->nFunctions = pExportDir->NumberOfFunctions;
+    pIndex->nNames = pExportDir->NumberOfNames;
+
+    if (pIndex->nFunctions > 0) {
+        pIndex->pdwFunctions = (PDWORD)detour_export_rva(pIndex,
+                                                         pExportDir->AddressOfFunctions,
+                                                         pIndex->nFunctions * sizeof(DWORD),
+                                                         NULL);
+        if (pIndex->pdwFunctions == NULL) {
+            return ERROR_EXE_MARKED_INVALID;
+        }
+    }
+
+    if (pIndex->nNames > 0) {
+        pIndex->pdwNames = (PDWORD)detour_export_rva(pIndex,
+                                                     pExportDir->AddressOfNames,
+                                                     pIndex->nNames * sizeof(DWORD),
+                                                     NULL);
+        pIndex->pwOrdinals = (PWORD)detour_export_rva(pIndex,
+                                                      pExportDir->AddressOfNameOrdinals,
+                                                      pIndex->nNames * sizeof(WORD),
+                                                      NULL);
+        if (pIndex->pdwNames == NULL || pIndex->pwOrdinals == NULL) {
+            return ERROR_EXE_MARKED_INVALID;
+        }
+    }
+    return NO_ERROR;
+}
+
+DWORD detour_export_index_create(_In_ PBYTE pbImage,
+                                 _In_ ULONG cbImage,
+                                 _In_ BOOL fMapped,
+                                 _Out_ DETOUR_EXPORT_INDEX **ppIndex)
+{
+    *ppIndex = NULL;
+
+    DETOUR_EXPORT_INDEX header;
+    ZeroMemory(&header, sizeof(header));
+    header.pbImage = pbImage;
+    header.cbImage = cbImage;
+    header.fMapped = fMapped;
+
+    DWORD dwError = detour_export_index_parse(&header);
+    if (dwError != NO_ERROR) {
+        return dwError;
+    }
+
+    // Keep the table at most half full so probe sequences stay short.
+    if (header.nNames > 0) {
+        header.nSlots = 2;
+        while (header.nSlots < header.nNames * 2) {
+            header.nSlots <<= 1;
+        }
+    }
+
+    // The name count is only bounded by the image size, so on 32-bit a large
+    // enough image would wrap the allocation size.
+    if (header.nSlots > (MAXSIZE_T - sizeof(DETOUR_EXPORT_INDEX)) / sizeof(DETOUR_EXPORT_SLOT)) {
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    DETOUR_EXPORT_INDEX *pIndex = (DETOUR_EXPORT_INDEX *)
+        new NOTHROW BYTE [sizeof(DETOUR_EXPORT_INDEX) + header.nSlots * sizeof(DETOUR_EXPORT_SLOT)];
+    if (pIndex == NULL) {
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    *pIndex = header;
+    pIndex->pSlots = (DETOUR_EXPORT_SLOT *)(pIndex + 1);
+    ZeroMemory(pIndex->pSlots, pIndex->nSlots * sizeof(DETOUR_EXPORT_SLOT));
+
+    // Names are inserted in table order, so the first of any duplicate names is
+    // also the first one a lookup probes.
+    DWORD nMask = pIndex->nSlots - 1;
+    for (DWORD n = 0; n < pIndex->nNames; n++) {
+        LPCSTR pszName = detour_export_name(pIndex, n);
+        if (pszName == NULL || pIndex->pwOrdinals[n] >= pIndex->nFunctions) {
+            continue;
+        }
+
+        DWORD nHash = detour_export_hash(pszName);
+        DWORD nSlot = nHash & nMask;
+        while (pIndex->pSlots[nSlot].nName != 0) {
+            nSlot = (nSlot + 1) & nMask;
+        }
+        pIndex->pSlots[nSlot].nHash = nHash;
+        pIndex->pSlots[nSlot].nName = n + 1;
+    }
+
+    *ppIndex = pIndex;
+    return NO_ERROR;
+}
+
+BOOL detour_export_index_find(_In_ const DETOUR_EXPORT_INDEX *pIndex,
+                              _In_ LPCSTR pszName,
+                              _Out_ PDWORD pnFunction)
+{
+    *pnFunction = 0;
+    if (pIndex->nSlots == 0) {
+        return FALSE;
+    }
+
+    DWORD nHash = detour_export_hash(pszName);
+    DWORD nMask = pIndex->nSlots - 1;
+    for (DWORD nSlot = nHash & nMask; pIndex->pSlots[nSlot].nName != 0; nSlot = (nSlot + 1) & nMask) {
+        const DETOUR_EXPORT_SLOT *pSlot = &pIndex->pSlots[nSlot];
+        if (pSlot->nHash == nHash) {
+            LPCSTR pszExport = detour_export_name(pIndex, pSlot->nName - 1);
+            if (pszExport != NULL && detour_export_name_equal(pszExport, pszName)) {
+                *pnFunction = pIndex->pwOrdinals[pSlot->nName - 1];
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
+BOOL detour_export_index_code_rva(_In_ const DETOUR_EXPORT_INDEX *pIndex,
+                                  _In_ DWORD nFunction,
+                                  _Out_ PDWORD pRva)
+{
+    // Forwarders point back into the export directory; leave those to the loader.
+    // A file image can't be checked against its mapped size, which isn't kept.
+    DWORD rva = pIndex->pdwFunctions[nFunction];
+    *pRva = rva;
+    return !(rva == 0 ||
+             (rva >= pIndex->rvaExportDir && rva - pIndex->rvaExportDir < pIndex->cbExportDir) ||
+             (pIndex->fMapped && rva >= pIndex->cbImage));
+}
+
+VOID detour_export_index_free(_In_ DETOUR_EXPORT_INDEX *pIndex)
+{
+    delete[] (PBYTE)pIndex;
+}
+
+//  End of File
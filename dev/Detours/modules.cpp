@@ -12,6 +12,7 @@
 // #define DETOUR_DEBUG 1
 #define DETOURS_INTERNAL
 #include "detours.h"
+#include <psapi.h>
 
 #if DETOURS_VERSION != 0x4c0c1   // 0xMAJORcMINORcPATCH
 #error detours.h version mismatch
@@ -150,7 +151,17 @@ PVOID WINAPI DetourFindFunction(_In_ LPCSTR pszModule,
         return NULL;
     }
 
-    PBYTE pbCode = (PBYTE)GetProcAddress(hModule, pszFunction);
+#if !defined(DETOURS_IA64)
+    // The cached export index answers most lookups without the loader.
+    PBYTE pbCode = (PBYTE)DetourFindExport(hModule, pszFunction);
+    if (pbCode) {
+        return pbCode;
+    }
+#else
+    PBYTE pbCode = NULL;
+#endif
+
+    pbCode = (PBYTE)GetProcAddress(hModule, pszFunction);
     if (pbCode) {
         return pbCode;
     }
@@ -461,6 +472,8 @@ BOOL WINAPI DetourEnumerateExports(_In_ HMODULE hModule,
         pDosHeader = (PIMAGE_DOS_HEADER)GetModuleHandleW(NULL);
     }
 
+    PDWORD pdwFuncToName = NULL;
+
     __try {
 #pragma warning(suppress:6011) // GetModuleHandleW(NULL) never returns NULL.
         if (pDosHeader->e_magic != IMAGE_DOS_SIGNATURE) {
@@ -496,6 +509,24 @@ BOOL WINAPI DetourEnumerateExports(_In_ HMODULE hModule,
         PDWORD pdwNames = (PDWORD)RvaAdjust(pDosHeader, pExportDir->AddressOfNames);
         PWORD pwOrdinals = (PWORD)RvaAdjust(pDosHeader, pExportDir->AddressOfNameOrdinals);
 
+        // Invert AddressOfNameOrdinals in one pass, so each function finds its name
+        // without rescanning the name table.  Entries hold the name index plus one;
+        // zero means the function is only exported by ordinal.  The first name for
+        // a function wins, as it did with the scan.
+        //
+        if (pExportDir->NumberOfFunctions > 0 && pwOrdinals != NULL) {
+            pdwFuncToName = new NOTHROW DWORD [pExportDir->NumberOfFunctions];
+        }
+        if (pdwFuncToName != NULL) {
+            ZeroMemory(pdwFuncToName, pExportDir->NumberOfFunctions * sizeof(DWORD));
+            for (DWORD n = 0; n < pExportDir->NumberOfNames; n++) {
+                if (pwOrdinals[n] < pExportDir->NumberOfFunctions &&
+                    pdwFuncToName[pwOrdinals[n]] == 0) {
+                    pdwFuncToName[pwOrdinals[n]] = n + 1;
+                }
+            }
+        }
+
         for (DWORD nFunc = 0; nFunc < pExportDir->NumberOfFunctions; nFunc++) {
             PBYTE pbCode = (pdwFunctions != NULL)
                 ? (PBYTE)RvaAdjust(pDosHeader, pdwFunctions[nFunc]) : NULL;
@@ -506,11 +537,20 @@ BOOL WINAPI DetourEnumerateExports(_In_ HMODULE hModule,
                 pbCode = NULL;
             }
 
-            for (DWORD n = 0; n < pExportDir->NumberOfNames; n++) {
-                if (pwOrdinals[n] == nFunc) {
+            if (pdwFuncToName != NULL) {
+                if (pdwFuncToName[nFunc] != 0) {
                     pszName = (pdwNames != NULL)
-                        ? (PCHAR)RvaAdjust(pDosHeader, pdwNames[n]) : NULL;
-                    break;
+                        ? (PCHAR)RvaAdjust(pDosHeader, pdwNames[pdwFuncToName[nFunc] - 1]) : NULL;
+                }
+            }
+            else if (pwOrdinals != NULL) {
+                // Out of memory; fall back to scanning the name table.
+                for (DWORD n = 0; n < pExportDir->NumberOfNames; n++) {
+                    if (pwOrdinals[n] == nFunc) {
+                        pszName = (pdwNames != NULL)
+                            ? (PCHAR)RvaAdjust(pDosHeader, pdwNames[n]) : NULL;
+                        break;
+                    }
                 }
             }
             ULONG nOrdinal = pExportDir->Base + nFunc;
@@ -519,16 +559,227 @@ BOOL WINAPI DetourEnumerateExports(_In_ HMODULE hModule,
                 break;
             }
         }
+
+        delete[] pdwFuncToName;
         SetLastError(NO_ERROR);
         return TRUE;
     }
     __except(GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION ?
              EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH) {
+        delete[] pdwFuncToName;
         SetLastError(ERROR_EXE_MARKED_INVALID);
         return NULL;
     }
 }
 
+//////////////////////////////////////////////////////// Export Index Functions.
+//
+//  An export index hashes the export names of one PE image, so a name can be
+//  looked up without walking the name table.  The index itself is built by
+//  expindex.cpp; this adds the last-error reporting and the module cache.
+//
+static SRWLOCK s_srwExportIndexes = SRWLOCK_INIT;
+static DETOUR_EXPORT_INDEX * s_pExportIndexes = NULL;
+
+PDETOUR_EXPORT_INDEX WINAPI DetourExportIndexCreate(_In_reads_bytes_(cbImage) PVOID pvImage,
+                                                    _In_ ULONG cbImage,
+                                                    _In_ BOOL fMapped)
+{
+    if (pvImage == NULL) {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return NULL;
+    }
+
+    DETOUR_EXPORT_INDEX *pIndex;
+    DWORD dwError = detour_export_index_create((PBYTE)pvImage, cbImage, fMapped, &pIndex);
+    SetLastError(dwError);
+    return pIndex;
+}
+
+BOOL WINAPI DetourExportIndexFind(_In_ PDETOUR_EXPORT_INDEX pExportIndex,
+                                  _In_ LPCSTR pszName,
+                                  _Out_opt_ ULONG *pnOrdinal,
+                                  _Out_opt_ ULONG *pnRva)
+{
+    if (pnOrdinal != NULL) {
+        *pnOrdinal = 0;
+    }
+    if (pnRva != NULL) {
+        *pnRva = 0;
+    }
+    if (pExportIndex == NULL || pszName == NULL) {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return FALSE;
+    }
+    if (IS_INTRESOURCE(pszName)) {
+        // The index only holds names.
+        SetLastError(ERROR_PROC_NOT_FOUND);
+        return FALSE;
+    }
+
+    DETOUR_EXPORT_INDEX *pIndex = (DETOUR_EXPORT_INDEX *)pExportIndex;
+    DWORD nFunction;
+    if (!detour_export_index_find(pIndex, pszName, &nFunction)) {
+        SetLastError(ERROR_PROC_NOT_FOUND);
+        return FALSE;
+    }
+
+    if (pnOrdinal != NULL) {
+        *pnOrdinal = pIndex->nBase + nFunction;
+    }
+    if (pnRva != NULL) {
+        *pnRva = pIndex->pdwFunctions[nFunction];
+    }
+    SetLastError(NO_ERROR);
+    return TRUE;
+}
+
+BOOL WINAPI DetourExportIndexClose(_In_ PDETOUR_EXPORT_INDEX pExportIndex)
+{
+    DETOUR_EXPORT_INDEX *pIndex = (DETOUR_EXPORT_INDEX *)pExportIndex;
+    if (pIndex == NULL || pIndex->hModule != NULL) {
+        // Cached indexes belong to DetourFindExport; see DetourFlushExportIndexes.
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return FALSE;
+    }
+
+    detour_export_index_free(pIndex);
+    return TRUE;
+}
+
+// Builds an index for hModule and adds it to the cache, unless another thread
+// got there first.
+//
+static BOOL detour_cache_export_index(_In_ HMODULE hModule)
+{
+    // Hold a reference on the module for as long as its index is cached,
+    // so the index can't outlive the image it points into.
+    HMODULE hReference;
+    if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+                            (LPCWSTR)hModule, &hReference)) {
+        return FALSE;
+    }
+    if (hReference != hModule) {
+        FreeLibrary(hReference);
+        SetLastError(ERROR_BAD_EXE_FORMAT);
+        return FALSE;
+    }
+
+    ULONG cbModule = DetourGetModuleSize(hModule);
+    DETOUR_EXPORT_INDEX *pNew = NULL;
+    DWORD dwError = (cbModule != 0)
+        ? detour_export_index_create((PBYTE)hModule, cbModule, TRUE, &pNew) : GetLastError();
+    if (pNew == NULL) {
+        FreeLibrary(hReference);
+        SetLastError(dwError);
+        return FALSE;
+    }
+    pNew->hModule = hModule;
+
+    AcquireSRWLockExclusive(&s_srwExportIndexes);
+    BOOL fCached = FALSE;
+    for (DETOUR_EXPORT_INDEX *pEntry = s_pExportIndexes; pEntry != NULL; pEntry = pEntry->pNext) {
+        if (pEntry->hModule == hModule) {
+            fCached = TRUE;
+            break;
+        }
+    }
+    if (!fCached) {
+        pNew->pNext = s_pExportIndexes;
+        s_pExportIndexes = pNew;
+        pNew = NULL;
+    }
+    ReleaseSRWLockExclusive(&s_srwExportIndexes);
+
+    if (pNew != NULL) {
+        // Another thread cached the same module first.
+        detour_export_index_free(pNew);
+        FreeLibrary(hReference);
+    }
+    return TRUE;
+}
+
+PVOID WINAPI DetourFindExport(_In_opt_ HMODULE hModule,
+                              _In_ LPCSTR pszFunction)
+{
+    if (pszFunction == NULL) {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return NULL;
+    }
+    if (IS_INTRESOURCE(pszFunction)) {
+        // Exports by ordinal are left to GetProcAddress.
+        SetLastError(ERROR_PROC_NOT_FOUND);
+        return NULL;
+    }
+    if (hModule == NULL) {
+        hModule = GetModuleHandleW(NULL);
+    }
+
+    for (;;) {
+        BOOL fCached = FALSE;
+        BOOL fFound = FALSE;
+        DWORD rva = 0;
+
+        // The probe and the RVA read stay under the lock, so a concurrent
+        // DetourFlushExportIndexes can't free the index or unload the module
+        // while we're reading them.
+        AcquireSRWLockShared(&s_srwExportIndexes);
+        for (DETOUR_EXPORT_INDEX *pEntry = s_pExportIndexes; pEntry != NULL; pEntry = pEntry->pNext) {
+            if (pEntry->hModule == hModule) {
+                fCached = TRUE;
+
+                DWORD nFunction;
+                fFound = (detour_export_index_find(pEntry, pszFunction, &nFunction) &&
+                          detour_export_index_code_rva(pEntry, nFunction, &rva));
+                break;
+            }
+        }
+        ReleaseSRWLockShared(&s_srwExportIndexes);
+
+        if (fCached) {
+            if (!fFound) {
+                SetLastError(ERROR_PROC_NOT_FOUND);
+                return NULL;
+            }
+            SetLastError(NO_ERROR);
+            return (PBYTE)hModule + rva;
+        }
+
+        // Not cached yet (or flushed since); cache it and probe again.
+        if (!detour_cache_export_index(hModule)) {
+            return NULL;
+        }
+    }
+}
+
+BOOL WINAPI DetourFlushExportIndexes(_In_opt_ HMODULE hModule)
+{
+    DETOUR_EXPORT_INDEX *pFlushed = NULL;
+
+    AcquireSRWLockExclusive(&s_srwExportIndexes);
+    for (DETOUR_EXPORT_INDEX **ppEntry = &s_pExportIndexes; *ppEntry != NULL;) {
+        DETOUR_EXPORT_INDEX *pEntry = *ppEntry;
+        if (hModule == NULL || pEntry->hModule == hModule) {
+            *ppEntry = pEntry->pNext;
+            pEntry->pNext = pFlushed;
+            pFlushed = pEntry;
+        }
+        else {
+            ppEntry = &pEntry->pNext;
+        }
+    }
+    ReleaseSRWLockExclusive(&s_srwExportIndexes);
+
+    while (pFlushed != NULL) {
+        DETOUR_EXPORT_INDEX *pEntry = pFlushed;
+        pFlushed = pEntry->pNext;
+
+        FreeLibrary(pEntry->hModule);
+        detour_export_index_free(pEntry);
+    }
+    return TRUE;
+}
+
 BOOL WINAPI DetourEnumerateImportsEx(_In_opt_ HMODULE hModule,
                                      _In_opt_ PVOID pContext,
                                      _In_opt_ PF_DETOUR_IMPORT_FILE_CALLBACK pfImportFile,
@@ -820,12 +1071,534 @@ PVOID WINAPI DetourFindPayload(_In_opt_ HMODULE hModule,
     }
 }
 
+///////////////////////////////////////////////////////// Module Snapshots.
+//
+//  A snapshot records every image in the process once, sorted by base address,
+//  so callers can look up modules and payloads without walking the address
+//  space again.  The loader list finds modules cheaply; walking the address
+//  space also finds images mapped without the loader, such as the payloads
+//  that DetourCopyPayloadToProcess writes into a new process.
+//
+struct DETOUR_MODULE_SNAPSHOT
+{
+    ULONG                   nModules;
+    ULONG                   nAlloc;
+    DETOUR_MODULE_INFO *    pModules;
+};
+
+// A process-wide snapshot that DetourFindPayloadEx keeps between calls.  While
+// the loader's DLL notifications are watched, every load and unload bumps
+// s_nImageGeneration, so a snapshot taken at the current generation is known
+// to be complete and a miss in it is final.  Without the watch, a miss only
+// means the snapshot might be old.
+//
+struct DETOUR_CACHED_SNAPSHOT
+{
+    SRWLOCK                     srwLock;
+    DWORD                       dwFlags;
+    DETOUR_MODULE_SNAPSHOT *    pSnapshot;
+    BOOL                        fWatched;       // Taken while loads were watched.
+    LONG                        nGeneration;    // s_nImageGeneration before it was taken.
+};
+
+static DETOUR_CACHED_SNAPSHOT s_ImageSnapshot = { SRWLOCK_INIT, DETOUR_MODULE_SNAPSHOT_ALL_IMAGES, NULL, FALSE, 0 };
+static LONG volatile s_nImageGeneration = 0;
+
+// LdrRegisterDllNotification isn't in the SDK headers; ntdll has exported it
+// since Windows Vista.
+//
+typedef VOID (CALLBACK *PDETOUR_DLL_NOTIFICATION)(_In_ ULONG nReason,
+                                                  _In_ const VOID *pvData,
+                                                  _In_opt_ PVOID pvContext);
+typedef LONG (NTAPI *PF_LDR_REGISTER_DLL_NOTIFICATION)(_In_ ULONG dwFlags,
+                                                       _In_ PDETOUR_DLL_NOTIFICATION pfNotify,
+                                                       _In_opt_ PVOID pvContext,
+                                                       _Out_ PVOID *ppvCookie);
+typedef LONG (NTAPI *PF_LDR_UNREGISTER_DLL_NOTIFICATION)(_In_ PVOID pvCookie);
+
+const LONG DETOUR_IMAGE_WATCH_NONE          = 0;
+const LONG DETOUR_IMAGE_WATCH_STARTING      = 1;
+const LONG DETOUR_IMAGE_WATCH_ACTIVE        = 2;
+const LONG DETOUR_IMAGE_WATCH_UNAVAILABLE   = 3;
+
+static LONG volatile s_nImageWatch = DETOUR_IMAGE_WATCH_NONE;
+static PVOID s_pvImageWatchCookie = NULL;
+static PF_LDR_UNREGISTER_DLL_NOTIFICATION s_pfLdrUnregisterDllNotification = NULL;
+
+// Runs under the loader lock, so it only bumps the generation.
+static VOID CALLBACK detour_image_notification(_In_ ULONG nReason,
+                                               _In_ const VOID *pvData,
+                                               _In_opt_ PVOID pvContext)
+{
+    (void)nReason;
+    (void)pvData;
+    (void)pvContext;
+
+    InterlockedIncrement(&s_nImageGeneration);
+}
+
+// Registers for load and unload notifications the first time it is called.
+// Returns TRUE once they are being delivered.
+//
+static BOOL detour_watch_images()
+{
+    LONG nState = s_nImageWatch;
+    if (nState == DETOUR_IMAGE_WATCH_ACTIVE) {
+        return TRUE;
+    }
+    if (nState != DETOUR_IMAGE_WATCH_NONE ||
+        InterlockedCompareExchange(&s_nImageWatch,
+                                   DETOUR_IMAGE_WATCH_STARTING,
+                                   DETOUR_IMAGE_WATCH_NONE) != DETOUR_IMAGE_WATCH_NONE) {
+        // Another thread is registering, or registration failed.
+        return FALSE;
+    }
+
+    HMODULE hNtdll = GetModuleHandleW(L"ntdll.dll");
+    PF_LDR_REGISTER_DLL_NOTIFICATION pfRegister = NULL;
+    PF_LDR_UNREGISTER_DLL_NOTIFICATION pfUnregister = NULL;
+    if (hNtdll != NULL) {
+        pfRegister = (PF_LDR_REGISTER_DLL_NOTIFICATION)
+            GetProcAddress(hNtdll, "LdrRegisterDllNotification");
+        pfUnregister = (PF_LDR_UNREGISTER_DLL_NOTIFICATION)
+            GetProcAddress(hNtdll, "LdrUnregisterDllNotification");
+    }
+
+    PVOID pvCookie = NULL;
+    if (pfRegister == NULL || pfUnregister == NULL ||
+        pfRegister(0, detour_image_notification, NULL, &pvCookie) < 0) {
+
+        InterlockedExchange(&s_nImageWatch, DETOUR_IMAGE_WATCH_UNAVAILABLE);
+        return FALSE;
+    }
+
+    s_pvImageWatchCookie = pvCookie;
+    s_pfLdrUnregisterDllNotification = pfUnregister;
+    InterlockedExchange(&s_nImageWatch, DETOUR_IMAGE_WATCH_ACTIVE);
+    return TRUE;
+}
+
+// The notification callback lives in this module, so it has to be unregistered
+// before the module unloads.  Cached snapshots stop being trusted.
+//
+static VOID detour_unwatch_images()
+{
+    if (InterlockedCompareExchange(&s_nImageWatch,
+                                   DETOUR_IMAGE_WATCH_UNAVAILABLE,
+                                   DETOUR_IMAGE_WATCH_ACTIVE) == DETOUR_IMAGE_WATCH_ACTIVE) {
+        s_pfLdrUnregisterDllNotification(s_pvImageWatchCookie);
+        s_pvImageWatchCookie = NULL;
+        InterlockedIncrement(&s_nImageGeneration);
+    }
+}
+
+static struct DETOUR_IMAGE_WATCH_CLEANUP
+{
+    ~DETOUR_IMAGE_WATCH_CLEANUP()
+    {
+        detour_unwatch_images();
+    }
+} s_ImageWatchCleanup;
+
+// Payloads written into this process without the loader, as by
+// DetourCopyPayloadToProcess(GetCurrentProcess(), ...), make the cached
+// snapshot old too.
+//
+VOID detour_invalidate_image_snapshot()
+{
+    InterlockedIncrement(&s_nImageGeneration);
+}
+
+static BOOL detour_module_info(_In_ HMODULE hModule, _Out_ DETOUR_MODULE_INFO *pInfo)
+{
+    ZeroMemory(pInfo, sizeof(*pInfo));
+
+    __try {
+        PIMAGE_DOS_HEADER pDosHeader = (PIMAGE_DOS_HEADER)hModule;
+        if (pDosHeader->e_magic != IMAGE_DOS_SIGNATURE ||
+            pDosHeader->e_lfanew < (LONG)sizeof(*pDosHeader)) {
+            return FALSE;
+        }
+
+        PIMAGE_NT_HEADERS pNtHeader = (PIMAGE_NT_HEADERS)((PBYTE)pDosHeader +
+                                                          pDosHeader->e_lfanew);
+        if (pNtHeader->Signature != IMAGE_NT_SIGNATURE ||
+            pNtHeader->FileHeader.SizeOfOptionalHeader == 0) {
+            return FALSE;
+        }
+
+        pInfo->hModule = hModule;
+        pInfo->cbImage = pNtHeader->OptionalHeader.SizeOfImage;
+        pInfo->pNtHeader = pNtHeader;
+        pInfo->pSections = (PIMAGE_SECTION_HEADER)((PBYTE)pNtHeader
+                                                   + sizeof(pNtHeader->Signature)
+                                                   + sizeof(pNtHeader->FileHeader)
+                                                   + pNtHeader->FileHeader.SizeOfOptionalHeader);
+        pInfo->nSections = pNtHeader->FileHeader.NumberOfSections;
+
+        // DetourCopyPayloadToProcess leaves SizeOfImage zero, so size those
+        // images by the end of their last section.
+        if (pInfo->cbImage == 0) {
+            for (ULONG n = 0; n < pInfo->nSections; n++) {
+                ULONG cbEnd = pInfo->pSections[n].VirtualAddress + pInfo->pSections[n].SizeOfRawData;
+                if (cbEnd > pInfo->cbImage) {
+                    pInfo->cbImage = cbEnd;
+                }
+            }
+            if (pInfo->cbImage == 0) {
+                ZeroMemory(pInfo, sizeof(*pInfo));
+                return FALSE;
+            }
+        }
+    }
+#pragma prefast(suppress:28940, "A bad pointer means this probably isn't a PE header.")
+    __except(GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION ?
+             EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH) {
+        ZeroMemory(pInfo, sizeof(*pInfo));
+        return FALSE;
+    }
+
+    pInfo->pPayloads = GetPayloadSectionFromModule(hModule);
+    return TRUE;
+}
+
+static BOOL detour_snapshot_add(_Inout_ DETOUR_MODULE_SNAPSHOT *pSnapshot, _In_ HMODULE hModule)
+{
+    DETOUR_MODULE_INFO info;
+    if (!detour_module_info(hModule, &info)) {
+        // Not an image; skip it.
+        return TRUE;
+    }
+
+    if (pSnapshot->nModules == pSnapshot->nAlloc) {
+        ULONG nAlloc = (pSnapshot->nAlloc > 0) ? pSnapshot->nAlloc * 2 : 64;
+        DETOUR_MODULE_INFO *pModules = new NOTHROW DETOUR_MODULE_INFO [nAlloc];
+        if (pModules == NULL) {
+            return FALSE;
+        }
+        if (pSnapshot->nModules > 0) {
+            CopyMemory(pModules, pSnapshot->pModules, pSnapshot->nModules * sizeof(DETOUR_MODULE_INFO));
+        }
+        delete[] pSnapshot->pModules;
+        pSnapshot->pModules = pModules;
+        pSnapshot->nAlloc = nAlloc;
+    }
+
+    // Keep the records sorted by base address, without duplicates.  Both sources
+    // mostly produce ascending addresses, so this rarely moves anything.
+    ULONG n = pSnapshot->nModules;
+    while (n > 0 && (ULONG_PTR)pSnapshot->pModules[n - 1].hModule > (ULONG_PTR)hModule) {
+        n--;
+    }
+    if (n > 0 && pSnapshot->pModules[n - 1].hModule == hModule) {
+        return TRUE;
+    }
+    MoveMemory(&pSnapshot->pModules[n + 1], &pSnapshot->pModules[n],
+               (pSnapshot->nModules - n) * sizeof(DETOUR_MODULE_INFO));
+    pSnapshot->pModules[n] = info;
+    pSnapshot->nModules++;
+    return TRUE;
+}
+
+static BOOL detour_snapshot_add_loader_modules(_Inout_ DETOUR_MODULE_SNAPSHOT *pSnapshot)
+{
+    HMODULE rhModules[256];
+    HMODULE *phModules = rhModules;
+    DWORD cbModules = sizeof(rhModules);
+    DWORD cbNeeded = 0;
+
+    for (;;) {
+        if (!EnumProcessModules(GetCurrentProcess(), phModules, cbModules, &cbNeeded)) {
+            if (phModules != rhModules) {
+                delete[] phModules;
+            }
+            return FALSE;
+        }
+        if (cbNeeded <= cbModules) {
+            break;
+        }
+
+        // Modules were loaded since the last call; grow with some slack.
+        if (phModules != rhModules) {
+            delete[] phModules;
+        }
+        cbModules = cbNeeded + 16 * sizeof(HMODULE);
+        phModules = new NOTHROW HMODULE [cbModules / sizeof(HMODULE)];
+        if (phModules == NULL) {
+            SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+            return FALSE;
+        }
+    }
+
+    BOOL fGood = TRUE;
+    for (DWORD n = 0; n < cbNeeded / sizeof(HMODULE) && fGood; n++) {
+        fGood = detour_snapshot_add(pSnapshot, phModules[n]);
+    }
+    if (phModules != rhModules) {
+        delete[] phModules;
+    }
+    return fGood;
+}
+
+static BOOL detour_snapshot_add_all_images(_Inout_ DETOUR_MODULE_SNAPSHOT *pSnapshot)
+{
+    MEMORY_BASIC_INFORMATION mbi;
+    ZeroMemory(&mbi, sizeof(mbi));
+
+    // Only allocation bases can hold an image header, and a loaded image can be
+    // skipped as a whole rather than one section region at a time.
+    //
+    for (PBYTE pbNext = NULL;;) {
+        if (VirtualQuery(pbNext, &mbi, sizeof(mbi)) <= 0) {
+            break;
+        }
+
+        PBYTE pbRegionEnd = (PBYTE)mbi.BaseAddress + mbi.RegionSize;
+        if (mbi.State == MEM_COMMIT &&
+            (mbi.Protect & 0xff) != PAGE_NOACCESS &&
+            (mbi.Protect & PAGE_GUARD) == 0 &&
+            mbi.BaseAddress == mbi.AllocationBase) {
+
+            ULONG nModules = pSnapshot->nModules;
+            if (!detour_snapshot_add(pSnapshot, (HMODULE)mbi.BaseAddress)) {
+                return FALSE;
+            }
+            if (mbi.Type == MEM_IMAGE && pSnapshot->nModules > nModules) {
+                PBYTE pbImageEnd = (PBYTE)mbi.BaseAddress + DetourGetModuleSize((HMODULE)mbi.BaseAddress);
+                if (pbImageEnd > pbRegionEnd) {
+                    pbRegionEnd = pbImageEnd;
+                }
+            }
+        }
+
+        if (pbRegionEnd <= pbNext) {
+            break;
+        }
+        pbNext = pbRegionEnd;
+    }
+    return TRUE;
+}
+
+static DETOUR_MODULE_SNAPSHOT * detour_snapshot_create(_In_ DWORD dwFlags)
+{
+    DETOUR_MODULE_SNAPSHOT *pSnapshot = new NOTHROW DETOUR_MODULE_SNAPSHOT;
+    if (pSnapshot == NULL) {
+        SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+        return NULL;
+    }
+    ZeroMemory(pSnapshot, sizeof(*pSnapshot));
+
+    // The address space walk finds every loaded module too.
+    BOOL fGood = (dwFlags & DETOUR_MODULE_SNAPSHOT_ALL_IMAGES)
+        ? detour_snapshot_add_all_images(pSnapshot)
+        : detour_snapshot_add_loader_modules(pSnapshot);
+    if (!fGood) {
+        DWORD dwError = GetLastError();
+        delete[] pSnapshot->pModules;
+        delete pSnapshot;
+        SetLastError(dwError != NO_ERROR ? dwError : ERROR_NOT_ENOUGH_MEMORY);
+        return NULL;
+    }
+
+    SetLastError(NO_ERROR);
+    return pSnapshot;
+}
+
+static VOID detour_snapshot_free(_In_opt_ DETOUR_MODULE_SNAPSHOT *pSnapshot)
+{
+    if (pSnapshot != NULL) {
+        delete[] pSnapshot->pModules;
+        delete pSnapshot;
+    }
+}
+
+static const DETOUR_MODULE_INFO * detour_snapshot_find(_In_ const DETOUR_MODULE_SNAPSHOT *pSnapshot,
+                                                       _In_ PVOID pvAddr)
+{
+    // Find the last module that starts at or below the address.
+    ULONG nLo = 0;
+    ULONG nHi = pSnapshot->nModules;
+    while (nLo < nHi) {
+        ULONG nMid = nLo + (nHi - nLo) / 2;
+        if ((ULONG_PTR)pSnapshot->pModules[nMid].hModule <= (ULONG_PTR)pvAddr) {
+            nLo = nMid + 1;
+        }
+        else {
+            nHi = nMid;
+        }
+    }
+    if (nLo == 0) {
+        return NULL;
+    }
+
+    const DETOUR_MODULE_INFO *pInfo = &pSnapshot->pModules[nLo - 1];
+    if ((ULONG_PTR)pvAddr - (ULONG_PTR)pInfo->hModule >= pInfo->cbImage) {
+        return NULL;
+    }
+    return pInfo;
+}
+
+// Returns the cached snapshot with its shared lock held, taking a new snapshot
+// first if there is none yet, the watched generation has moved on, or fRefresh
+// is set.  *pfCurrent is set if nothing can have loaded since the snapshot was
+// taken.  The caller releases pCache->srwLock.
+//
+static DETOUR_MODULE_SNAPSHOT * detour_acquire_cached_snapshot(_Inout_ DETOUR_CACHED_SNAPSHOT *pCache,
+                                                               _In_ BOOL fRefresh,
+                                                               _Out_ BOOL *pfCurrent)
+{
+    *pfCurrent = FALSE;
+
+    if (!fRefresh) {
+        AcquireSRWLockShared(&pCache->srwLock);
+        if (pCache->pSnapshot != NULL) {
+            if (!pCache->fWatched) {
+                return pCache->pSnapshot;
+            }
+            if (pCache->nGeneration == s_nImageGeneration) {
+                *pfCurrent = TRUE;
+                return pCache->pSnapshot;
+            }
+        }
+        ReleaseSRWLockShared(&pCache->srwLock);
+    }
+
+    // Read the generation before the walk, so anything that loads during it
+    // makes the new snapshot old straight away.
+    BOOL fWatched = detour_watch_images();
+    LONG nGeneration = s_nImageGeneration;
+    DETOUR_MODULE_SNAPSHOT *pNew = detour_snapshot_create(pCache->dwFlags);
+    if (pNew == NULL) {
+        return NULL;
+    }
+
+    AcquireSRWLockExclusive(&pCache->srwLock);
+    DETOUR_MODULE_SNAPSHOT *pOld = pCache->pSnapshot;
+    pCache->pSnapshot = pNew;
+    pCache->fWatched = fWatched;
+    pCache->nGeneration = nGeneration;
+    ReleaseSRWLockExclusive(&pCache->srwLock);
+    detour_snapshot_free(pOld);
+
+    // Another thread may replace the snapshot between the two locks, which
+    // is as good as the one taken here.
+    AcquireSRWLockShared(&pCache->srwLock);
+    if (pCache->pSnapshot == NULL) {
+        ReleaseSRWLockShared(&pCache->srwLock);
+        return NULL;
+    }
+    *pfCurrent = TRUE;
+    return pCache->pSnapshot;
+}
+
+PDETOUR_MODULE_SNAPSHOT WINAPI DetourModuleSnapshotCreate(_In_ DWORD dwFlags)
+{
+    if (dwFlags & ~DETOUR_MODULE_SNAPSHOT_ALL_IMAGES) {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return NULL;
+    }
+    return (PDETOUR_MODULE_SNAPSHOT)detour_snapshot_create(dwFlags);
+}
+
+ULONG WINAPI DetourModuleSnapshotGetCount(_In_ PDETOUR_MODULE_SNAPSHOT pModuleSnapshot)
+{
+    if (pModuleSnapshot == NULL) {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return 0;
+    }
+    return ((DETOUR_MODULE_SNAPSHOT *)pModuleSnapshot)->nModules;
+}
+
+BOOL WINAPI DetourModuleSnapshotGetModule(_In_ PDETOUR_MODULE_SNAPSHOT pModuleSnapshot,
+                                          _In_ ULONG nIndex,
+                                          _Out_ PDETOUR_MODULE_INFO pInfo)
+{
+    DETOUR_MODULE_SNAPSHOT *pSnapshot = (DETOUR_MODULE_SNAPSHOT *)pModuleSnapshot;
+    if (pSnapshot == NULL || pInfo == NULL) {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return FALSE;
+    }
+    if (nIndex >= pSnapshot->nModules) {
+        ZeroMemory(pInfo, sizeof(*pInfo));
+        SetLastError(ERROR_NO_MORE_ITEMS);
+        return FALSE;
+    }
+
+    *pInfo = pSnapshot->pModules[nIndex];
+    SetLastError(NO_ERROR);
+    return TRUE;
+}
+
+BOOL WINAPI DetourModuleSnapshotFindAddress(_In_ PDETOUR_MODULE_SNAPSHOT pModuleSnapshot,
+                                            _In_ PVOID pvAddr,
+                                            _Out_ PDETOUR_MODULE_INFO pInfo)
+{
+    DETOUR_MODULE_SNAPSHOT *pSnapshot = (DETOUR_MODULE_SNAPSHOT *)pModuleSnapshot;
+    if (pSnapshot == NULL || pInfo == NULL) {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return FALSE;
+    }
+
+    const DETOUR_MODULE_INFO *pFound = detour_snapshot_find(pSnapshot, pvAddr);
+    if (pFound == NULL) {
+        ZeroMemory(pInfo, sizeof(*pInfo));
+        SetLastError(ERROR_MOD_NOT_FOUND);
+        return FALSE;
+    }
+
+    *pInfo = *pFound;
+    SetLastError(NO_ERROR);
+    return TRUE;
+}
+
+BOOL WINAPI DetourModuleSnapshotClose(_In_ PDETOUR_MODULE_SNAPSHOT pModuleSnapshot)
+{
+    if (pModuleSnapshot == NULL) {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return FALSE;
+    }
+    detour_snapshot_free((DETOUR_MODULE_SNAPSHOT *)pModuleSnapshot);
+    return TRUE;
+}
+
 _Writable_bytes_(*pcbData)
 _Readable_bytes_(*pcbData)
 _Success_(return != NULL)
 PVOID WINAPI DetourFindPayloadEx(_In_ REFGUID rguid,
                                  _Out_ DWORD * pcbData)
 {
+    // Search the cached snapshot first.  A miss in a snapshot that may be old
+    // could just mean the payload arrived after it was taken, so take a new one.
+    //
+    // Payloads that another process writes into this one after the first
+    // search aren't seen by the load notifications.  DetourCreateProcessWithDll
+    // and friends write theirs before the process starts running.
+    //
+    for (BOOL fRefresh = FALSE;; fRefresh = TRUE) {
+        BOOL fCurrent = FALSE;
+        DETOUR_MODULE_SNAPSHOT *pSnapshot = detour_acquire_cached_snapshot(&s_ImageSnapshot, fRefresh, &fCurrent);
+        if (pSnapshot == NULL) {
+            break;
+        }
+
+        PVOID pvData = NULL;
+        for (ULONG n = 0; n < pSnapshot->nModules && pvData == NULL; n++) {
+            if (pSnapshot->pModules[n].pPayloads != NULL) {
+                pvData = DetourFindPayload(pSnapshot->pModules[n].hModule, rguid, pcbData);
+            }
+        }
+        ReleaseSRWLockShared(&s_ImageSnapshot.srwLock);
+
+        if (pvData != NULL) {
+            return pvData;
+        }
+        if (fCurrent) {
+            SetLastError(ERROR_MOD_NOT_FOUND);
+            return NULL;
+        }
+    }
+
+    // Without a snapshot, fall back to walking the address space.
     for (HMODULE hMod = NULL; (hMod = DetourEnumerateModules(hMod)) != NULL;) {
         PVOID pvData;
 
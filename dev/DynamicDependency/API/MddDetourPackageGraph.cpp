@@ -119,9 +119,14 @@ HRESULT WINAPI MddDetourPackageGraphInitialize() noexcept
         return S_OK;
     }
 
-    // Detour package graph APIs to our implementation
+    // Detour package graph APIs to our implementation, attaching them as one
+    // batch so their trampolines are placed together
+    PVOID* pointers[4]{};
+    PVOID detours[4]{};
+    ULONG count{};
     FAIL_FAST_IF_WIN32_ERROR(DetourUpdateThread(GetCurrentThread()));
-    FAIL_FAST_IF_WIN32_ERROR(DetourAttach(&(PVOID&)TrueGetCurrentPackageInfo, DynamicGetCurrentPackageInfo));
+    pointers[count] = &(PVOID&)TrueGetCurrentPackageInfo;
+    detours[count++] = DynamicGetCurrentPackageInfo;
     //
     // NOTE: GetCurrentPackageInfo2 requires >=19H1
     // NOTE: GetCurrentPackageInfo3 requires >=20H1
@@ -135,7 +140,8 @@ HRESULT WINAPI MddDetourPackageGraphInitialize() noexcept
         auto dllGetCurrentPackageInfo2{ reinterpret_cast<GetCurrentPackageInfo2Function>(GetProcAddress(dllApisetAppmodelRuntime_1_3, "GetCurrentPackageInfo2")) };
         FAIL_FAST_HR_IF_NULL(HRESULT_FROM_WIN32(GetLastError()), dllGetCurrentPackageInfo2);
         TrueGetCurrentPackageInfo2 = dllGetCurrentPackageInfo2;
-        FAIL_FAST_IF_WIN32_ERROR(DetourAttach(&(PVOID&)TrueGetCurrentPackageInfo2, DynamicGetCurrentPackageInfo2));
+        pointers[count] = &(PVOID&)TrueGetCurrentPackageInfo2;
+        detours[count++] = DynamicGetCurrentPackageInfo2;
 
         // Also grab GetPackageInfo2 if available (see MddGetPackageInfo1Or2() for details)
         auto dllGetPackageInfo2{ reinterpret_cast<GetPackageInfo2Function>(GetProcAddress(dllApisetAppmodelRuntime_1_3, "GetPackageInfo2")) };
@@ -150,7 +156,8 @@ HRESULT WINAPI MddDetourPackageGraphInitialize() noexcept
             auto dllGetCurrentPackageInfo3{ reinterpret_cast<GetCurrentPackageInfo3Function>(GetProcAddress(dllApisetAppmodelRuntimeInternal_1_6, "GetCurrentPackageInfo3")) };
             FAIL_FAST_HR_IF_NULL(HRESULT_FROM_WIN32(GetLastError()), dllGetCurrentPackageInfo3);
             TrueGetCurrentPackageInfo3 = dllGetCurrentPackageInfo3;
-            FAIL_FAST_IF_WIN32_ERROR(DetourAttach(&(PVOID&)TrueGetCurrentPackageInfo3, DynamicGetCurrentPackageInfo3));
+            pointers[count] = &(PVOID&)TrueGetCurrentPackageInfo3;
+            detours[count++] = DynamicGetCurrentPackageInfo3;
 
             if (WindowsVersion::IsWindows11_22H2OrGreater())
             {
@@ -160,10 +167,12 @@ HRESULT WINAPI MddDetourPackageGraphInitialize() noexcept
                 auto dllGetPackageGraphRevisionId{ reinterpret_cast<GetPackageGraphRevisionIdFunction>(GetProcAddress(dllApisetAppmodelRuntime_1_6, "GetPackageGraphRevisionId")) };
                 FAIL_FAST_HR_IF_NULL(HRESULT_FROM_WIN32(GetLastError()), dllGetPackageGraphRevisionId);
                 TrueGetPackageGraphRevisionId = dllGetPackageGraphRevisionId;
-                FAIL_FAST_IF_WIN32_ERROR(DetourAttach(&(PVOID&)TrueGetPackageGraphRevisionId, DynamicGetPackageGraphRevisionId));
+                pointers[count] = &(PVOID&)TrueGetPackageGraphRevisionId;
+                detours[count++] = DynamicGetPackageGraphRevisionId;
             }
         }
     }
+    FAIL_FAST_IF_WIN32_ERROR(DetourAttachBatch(pointers, detours, count));
     return S_OK;
 }
 
@@ -3,6 +3,7 @@
 
 #include <Windows.h>
 #include <Pathcch.h>
+#include "wil/resource.h"
 #include "wil/win32_helpers.h"
 #include "wil/filesystem.h"
 #include "mrm/BaseInternal.h"
@@ -10,21 +11,45 @@
 #include "mrm/readers/MrmReaders.h"
 #include "mrm/platform/WindowsCore.h"
 #include "mrm/readers/MrmManagers.h"
+#include "mrm/Checksums.h"
 
 #include "mrm/common/MrmTraceLogging.h"
 
 #include "MRM.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 using namespace Microsoft::Resources;
 
+struct SharedPriFile;
+
 typedef struct _MrmObjects
 {
+    // The profile, view and PRI file are borrowed from sharedPriFile.
+    SharedPriFile* sharedPriFile = nullptr;
     CoreProfile* profile = nullptr;
     UnifiedResourceView* unifiedView = nullptr;
     const PriFile* priFile = nullptr;
     ProviderResolver* resolver = nullptr;
+
+    // Background warm-up, see MrmWarmResourceMap. warmUpRunning guards the other three.
+    PTP_WORK warmUpWork = nullptr;
+    const ResourceMapSubtree* warmUpMap = nullptr;
+    UINT32 warmUpFlags = 0;
+    volatile LONG warmUpRunning = 0;
+
+    // Counters for MrmGetWarmUpStatistics. Durations are in QueryPerformanceCounter ticks; firstLookup holds the
+    // duration of the first lookup shifted left by one, with the low bit set if a warm-up had finished before it.
+    volatile LONG warmUpCount = 0;
+    volatile LONG64 prefetchTicks = 0;
+    volatile LONG64 resolveTicks = 0;
+    volatile LONG resolvedDecisions = 0;
+    volatile LONG64 firstLookup = 0;
 } MrmObjects;
 
 constexpr wchar_t ResourceUriPrefix[] = L"ms-resource://";
@@ -105,6 +130,45 @@ static HRESULT BlobResultReleaseOwnershipBuffer(
     return S_OK;
 }
 
+static HRESULT StringResultGetBorrowedView(
+    _In_ const StringResult& result,
+    _Outptr_result_buffer_(*length) PCWSTR* view,
+    _Out_ UINT32* length)
+{
+    *view = nullptr;
+    *length = 0;
+
+    // Only a reference points into the PRI file and outlives the result. Anything that had to be converted
+    // (UTF-8 data, paths with the package root prepended) lives in a buffer owned by the result.
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED), result.GetType() != DefResultType_Reference);
+
+    PCWSTR localView;
+    RETURN_IF_FAILED(result.GetRef(&localView));
+
+    size_t localLength;
+    RETURN_IF_FAILED(result.GetLength(&localLength));
+    RETURN_IF_FAILED(SizeTToUInt32(localLength, length));
+
+    *view = localView;
+    return S_OK;
+}
+
+static HRESULT BlobResultGetBorrowedView(_In_ const BlobResult& result, _Out_ MrmResourceData* view)
+{
+    view->data = nullptr;
+    view->size = 0;
+
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED), result.GetType() != DefResultType_Reference);
+
+    size_t sizeInBytes;
+    const void* localView = result.GetRef(&sizeInBytes);
+    RETURN_HR_IF_NULL(E_UNEXPECTED, localView);
+    RETURN_IF_FAILED(SizeTToUInt32(sizeInBytes, &view->size));
+
+    view->data = const_cast<void*>(localView);
+    return S_OK;
+}
+
 static HRESULT GetQualifierInfoFromCandidateImpl(
     _In_ MrmObjects* resourceManager,
     _In_ const ResourceCandidateResult* candidate,
@@ -195,6 +259,100 @@ static HRESULT GetQualifierInfoFromCandidate(
     return hr;
 }
 
+static HRESULT EvaluateResourceDecision(
+    _In_ ProviderResolver* resolver,
+    _In_ const DecisionResult& decision,
+    _Out_ int* resultIndex)
+{
+    *resultIndex = -1;
+
+    // A frozen context already knows the answer; anything else falls back to a full evaluation.
+    int localResultIndex;
+    HRESULT hr = resolver->EvaluateFrozenDecision(&decision, &localResultIndex);
+    if (hr != HRESULT_FROM_WIN32(ERROR_NOT_FOUND))
+    {
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        *resultIndex = localResultIndex;
+        return S_OK;
+    }
+
+    QualifierSetResult qualifierSet;
+    RETURN_IF_FAILED(resolver->EvaluateDecision(&decision, &localResultIndex, &qualifierSet));
+
+    bool isMatch, isDefault, isMatchAsDefault;
+    RETURN_IF_FAILED(resolver->EvaluateQualifierSet(&qualifierSet, &isMatch, &isDefault, &isMatchAsDefault, nullptr));
+
+    if (!isMatch && !isDefault)
+    {
+        return HRESULT_FROM_WIN32(ERROR_MRM_NO_MATCH_OR_DEFAULT_CANDIDATE);
+    }
+
+    *resultIndex = localResultIndex;
+    return S_OK;
+}
+
+static HRESULT ResolveResourceCandidate(
+    _In_ ProviderResolver* resolver,
+    _In_ const NamedResourceResult& namedResource,
+    _Out_ ResourceCandidateResult* resourceCandidate)
+{
+    DecisionResult decision;
+    RETURN_IF_FAILED(namedResource.GetDecision(&decision));
+
+    int resultIndex;
+    RETURN_IF_FAILED(EvaluateResourceDecision(resolver, decision, &resultIndex));
+
+    RETURN_IF_FAILED(namedResource.GetCandidate(resultIndex, resourceCandidate));
+    return S_OK;
+}
+
+static ProviderResolver* GetResolver(_In_ MrmObjects* resourceManagerObjects, _In_opt_ void* resourceContext)
+{
+    if (resourceContext == nullptr)
+    {
+        return resourceManagerObjects->resolver;
+    }
+
+    return reinterpret_cast<ProviderResolver*>(resourceContext);
+}
+
+// Times the first lookup made through a resource manager. Every later lookup only pays for one read.
+class FirstLookupTimer
+{
+public:
+    explicit FirstLookupTimer(_In_ MrmObjects* resourceManagerObjects)
+    {
+        if (ReadNoFence64(&resourceManagerObjects->firstLookup) == 0)
+        {
+            m_resourceManagerObjects = resourceManagerObjects;
+            m_wasWarm = (ReadAcquire(&resourceManagerObjects->warmUpCount) > 0);
+            QueryPerformanceCounter(&m_start);
+        }
+    }
+
+    ~FirstLookupTimer()
+    {
+        if (m_resourceManagerObjects != nullptr)
+        {
+            LARGE_INTEGER end;
+            QueryPerformanceCounter(&end);
+
+            // A lookup that took less than a tick still has to read as done.
+            LONG64 ticks = std::max<LONG64>(end.QuadPart - m_start.QuadPart, 1);
+            InterlockedCompareExchange64(&m_resourceManagerObjects->firstLookup, (ticks << 1) | (m_wasWarm ? 1 : 0), 0);
+        }
+    }
+
+private:
+    MrmObjects* m_resourceManagerObjects = nullptr;
+    bool m_wasWarm = false;
+    LARGE_INTEGER m_start{};
+};
+
 static HRESULT LoadResourceCandidate(
     _In_ void* resourceManager,
     _In_opt_ void* resourceContext,
@@ -231,16 +389,9 @@ static HRESULT LoadResourceCandidate(
     size_t nameStringLength;
 
     MrmObjects* resourceManagerObjects = reinterpret_cast<MrmObjects*>(resourceManager);
+    FirstLookupTimer firstLookupTimer(resourceManagerObjects);
 
-    ProviderResolver* resolver;
-    if (resourceContext == nullptr)
-    {
-        resolver = resourceManagerObjects->resolver;
-    }
-    else
-    {
-        resolver = reinterpret_cast<ProviderResolver*>(resourceContext);
-    }
+    ProviderResolver* resolver = GetResolver(resourceManagerObjects, resourceContext);
 
     NamedResourceResult namedResource;
 
@@ -311,22 +462,7 @@ static HRESULT LoadResourceCandidate(
         }
     }
 
-    DecisionResult decision;
-    RETURN_IF_FAILED(namedResource.GetDecision(&decision));
-
-    QualifierSetResult qualifierSet;
-    int resultIndex;
-    RETURN_IF_FAILED(resolver->EvaluateDecision(&decision, &resultIndex, &qualifierSet));
-
-    bool isMatch, isDefault, isMatchAsDefault;
-    RETURN_IF_FAILED(resolver->EvaluateQualifierSet(&qualifierSet, &isMatch, &isDefault, &isMatchAsDefault, nullptr));
-
-    if (!isMatch && !isDefault)
-    {
-        return HRESULT_FROM_WIN32(ERROR_MRM_NO_MATCH_OR_DEFAULT_CANDIDATE);
-    }
-
-    RETURN_IF_FAILED(namedResource.GetCandidate(resultIndex, resourceCandidate));
+    RETURN_IF_FAILED(ResolveResourceCandidate(resolver, namedResource, resourceCandidate));
 
     if ((qualifierCount != nullptr) && (qualifierNames != nullptr) && (qualifierValues != nullptr))
     {
@@ -368,6 +504,166 @@ static HRESULT LoadStringResource(
     return S_OK;
 }
 
+static HRESULT GetMapSubtree(_In_ MrmObjects* resourceManagerObjects, _In_opt_ void* resourceMap, _Out_ const ResourceMapSubtree** mapSubtree)
+{
+    *mapSubtree = nullptr;
+
+    if (resourceMap == nullptr)
+    {
+        // The primary resource map is the default.
+        const IResourceMapBase* primaryMap;
+        RETURN_IF_FAILED(resourceManagerObjects->priFile->GetPrimaryResourceMap(&primaryMap));
+        *mapSubtree = primaryMap->GetRootSubtree();
+    }
+    else
+    {
+        *mapSubtree = reinterpret_cast<ResourceMapSubtree*>(resourceMap);
+    }
+
+    return S_OK;
+}
+
+struct BatchDecisionOutcome
+{
+    HRESULT hr;
+    int resultIndex;
+};
+
+// All resources of a batch come from the same resource map and therefore share its decision info, so the
+// outcome of each decision only needs to be evaluated once per batch.
+typedef std::unordered_map<int, BatchDecisionOutcome> BatchDecisionCache;
+
+static HRESULT LoadStringResourceFromScope(
+    _In_ ProviderResolver* resolver,
+    _In_ const ResourceMapSubtree* scope,
+    _In_ PCWSTR relativeResourceId,
+    _Inout_ BatchDecisionCache& decisionCache,
+    _Outptr_ PWSTR* resourceString)
+{
+    *resourceString = nullptr;
+
+    NamedResourceResult namedResource;
+    RETURN_IF_FAILED_WITH_EXPECTED(scope->GetResource(relativeResourceId, &namedResource), HRESULT_FROM_WIN32(ERROR_MRM_NAMED_RESOURCE_NOT_FOUND));
+
+    DecisionResult decision;
+    RETURN_IF_FAILED(namedResource.GetDecision(&decision));
+
+    int decisionIndex = decision.GetIndex();
+    auto cached = decisionCache.find(decisionIndex);
+    if (cached == decisionCache.end())
+    {
+        BatchDecisionOutcome outcome;
+        outcome.hr = EvaluateResourceDecision(resolver, decision, &outcome.resultIndex);
+        cached = decisionCache.emplace(decisionIndex, outcome).first;
+    }
+    RETURN_IF_FAILED(cached->second.hr);
+
+    ResourceCandidateResult candidate;
+    RETURN_IF_FAILED(namedResource.GetCandidate(cached->second.resultIndex, &candidate));
+
+    StringResult stringResult;
+    if (!candidate.TryGetStringValue(&stringResult))
+    {
+        return HRESULT_FROM_WIN32(ERROR_MRM_RESOURCE_TYPE_MISMATCH);
+    }
+
+    // This ensures the string result holds a copy of the data we can return to the caller, not a pointer to the PRI file.
+    RETURN_IF_FAILED(StringResultReleaseOwnershipBuffer(stringResult, resourceString));
+
+    return S_OK;
+}
+
+static HRESULT LoadStringResources(
+    _In_ void* resourceManager,
+    _In_opt_ void* resourceContext,
+    _In_opt_ void* resourceMap,
+    UINT32 count,
+    _In_reads_(count) PCWSTR* resourceIds,
+    _Out_writes_(count) PWSTR* resourceStrings,
+    _Out_writes_(count) HRESULT* results)
+{
+    for (UINT32 i = 0; i < count; i++)
+    {
+        resourceStrings[i] = nullptr;
+        results[i] = E_UNEXPECTED;
+    }
+
+    MrmObjects* resourceManagerObjects = reinterpret_cast<MrmObjects*>(resourceManager);
+    FirstLookupTimer firstLookupTimer(resourceManagerObjects);
+    ProviderResolver* resolver = GetResolver(resourceManagerObjects, resourceContext);
+
+    const ResourceMapSubtree* mapSubtree;
+    RETURN_IF_FAILED(GetMapSubtree(resourceManagerObjects, resourceMap, &mapSubtree));
+
+    // Visit the IDs in sorted order so that resources in the same scope are adjacent and share one walk of the
+    // path prefix down to that scope.
+    std::vector<UINT32> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [resourceIds](UINT32 left, UINT32 right) {
+        PCWSTR leftId = (resourceIds[left] != nullptr) ? resourceIds[left] : L"";
+        PCWSTR rightId = (resourceIds[right] != nullptr) ? resourceIds[right] : L"";
+        return CompareStringOrdinal(leftId, -1, rightId, -1, TRUE) == CSTR_LESS_THAN;
+    });
+
+    BatchDecisionCache decisionCache;
+    std::unique_ptr<const ResourceMapSubtree> currentScope;
+    std::wstring currentScopeName;
+    HRESULT currentScopeHr = S_OK;
+
+    HRESULT hr = S_OK;
+    for (UINT32 i : order)
+    {
+        PCWSTR resourceId = resourceIds[i];
+        if ((resourceId == nullptr) || (*resourceId == L'\0'))
+        {
+            results[i] = E_INVALIDARG;
+        }
+        else if (IsResourceUri(resourceId))
+        {
+            // URIs can point at any root map, so they are resolved on their own.
+            results[i] = LoadStringResource(resourceManager, resourceContext, nullptr, INDEX_RESOURCE_URI, resourceId, &resourceStrings[i]);
+        }
+        else
+        {
+            PCWSTR separator = wcsrchr(resourceId, L'/');
+            if ((separator == nullptr) || (separator == resourceId))
+            {
+                results[i] = LoadStringResourceFromScope(resolver, mapSubtree, resourceId, decisionCache, &resourceStrings[i]);
+            }
+            else
+            {
+                size_t scopeNameLength = separator - resourceId;
+                if ((scopeNameLength != currentScopeName.length()) ||
+                    (CompareStringOrdinal(resourceId, static_cast<int>(scopeNameLength), currentScopeName.c_str(), static_cast<int>(scopeNameLength), TRUE) != CSTR_EQUAL))
+                {
+                    currentScopeName.assign(resourceId, scopeNameLength);
+
+                    const ResourceMapSubtree* scope = nullptr;
+                    currentScopeHr = mapSubtree->GetSubtree(currentScopeName.c_str(), &scope);
+                    currentScope.reset(scope);
+                }
+
+                if (SUCCEEDED(currentScopeHr))
+                {
+                    results[i] = LoadStringResourceFromScope(resolver, currentScope.get(), separator + 1, decisionCache, &resourceStrings[i]);
+                }
+                else
+                {
+                    // Let the full lookup report the appropriate error.
+                    results[i] = LoadStringResourceFromScope(resolver, mapSubtree, resourceId, decisionCache, &resourceStrings[i]);
+                }
+            }
+        }
+
+        if (FAILED(results[i]))
+        {
+            hr = S_FALSE;
+        }
+    }
+
+    return hr;
+}
+
 static HRESULT LoadEmbeddedResource(
     _In_ void* resourceManager,
     _In_opt_ void* resourceContext,
@@ -478,20 +774,268 @@ static HRESULT LoadStringOrEmbeddedResource(
     return S_OK;
 }
 
-static void DestroyResourceManager(_In_ void* resourceManager)
+static HRESULT LoadStringResourceView(
+    _In_ void* resourceManager,
+    _In_opt_ void* resourceContext,
+    _In_opt_ void* resourceMap,
+    int index,
+    _In_opt_ PCWSTR resourceIdOrUri,
+    _Outptr_result_buffer_(*resourceStringLength) PCWSTR* resourceString,
+    _Out_ UINT32* resourceStringLength)
 {
-    MrmObjects* resourceManagerObjects = reinterpret_cast<MrmObjects*>(resourceManager);
+    *resourceString = nullptr;
+    *resourceStringLength = 0;
+
+    ResourceCandidateResult candidate;
+    RETURN_IF_FAILED_WITH_EXPECTED(LoadResourceCandidate(resourceManager, resourceContext, resourceMap, index, resourceIdOrUri, &candidate, nullptr, nullptr, nullptr, nullptr),
+        HRESULT_FROM_WIN32(ERROR_MRM_NAMED_RESOURCE_NOT_FOUND));
 
-    if (resourceManagerObjects->profile != nullptr)
+    StringResult stringResult;
+    if (!candidate.TryGetStringValue(&stringResult))
     {
-        delete resourceManagerObjects->profile;
-        resourceManagerObjects->profile = nullptr;
+        return HRESULT_FROM_WIN32(ERROR_MRM_RESOURCE_TYPE_MISMATCH);
     }
 
-    if (resourceManagerObjects->unifiedView != nullptr)
+    RETURN_IF_FAILED_WITH_EXPECTED(StringResultGetBorrowedView(stringResult, resourceString, resourceStringLength), HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+
+    return S_OK;
+}
+
+static HRESULT LoadStringOrEmbeddedResourceView(
+    _In_ void* resourceManager,
+    _In_opt_ void* resourceContext,
+    _In_opt_ void* resourceMap,
+    int index,
+    _In_opt_ PCWSTR resourceIdOrUri,
+    _Out_ MrmType* resourceType,
+    _Outptr_result_maybenull_ PCWSTR* resourceString,
+    _Out_ UINT32* resourceStringLength,
+    _Out_ MrmResourceData* data)
+{
+    *resourceType = MrmType_Unknown;
+    *resourceString = nullptr;
+    *resourceStringLength = 0;
+    data->data = nullptr;
+    data->size = 0;
+
+    ResourceCandidateResult candidate;
+    RETURN_IF_FAILED_WITH_EXPECTED(LoadResourceCandidate(resourceManager, resourceContext, resourceMap, index, resourceIdOrUri, &candidate, nullptr, nullptr, nullptr, nullptr),
+        HRESULT_FROM_WIN32(ERROR_MRM_NAMED_RESOURCE_NOT_FOUND));
+
+    MrmEnvironment::ResourceValueType internalResourceType;
+    RETURN_IF_FAILED(candidate.GetResourceValueType(&internalResourceType));
+
+    if (MrmEnvironment::IsBinaryResourceValueType(internalResourceType))
     {
-        delete resourceManagerObjects->unifiedView;
-        resourceManagerObjects->unifiedView = nullptr;
+        BlobResult blobResult;
+        if (!candidate.TryGetBlobValue(&blobResult))
+        {
+            return E_UNEXPECTED;
+        }
+
+        RETURN_IF_FAILED_WITH_EXPECTED(BlobResultGetBorrowedView(blobResult, data), HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+        *resourceType = MrmType_Embedded;
+    }
+    else
+    {
+        StringResult stringResult;
+        if (!candidate.TryGetStringValue(&stringResult))
+        {
+            return E_UNEXPECTED;
+        }
+
+        MrmType localType;
+        if (MrmEnvironment::IsStringResourceValueType(internalResourceType))
+        {
+            localType = MrmType_String;
+        }
+        else if (MrmEnvironment::IsPathResourceValueType(internalResourceType))
+        {
+            localType = MrmType_Path;
+        }
+        else
+        {
+            return E_UNEXPECTED;
+        }
+
+        RETURN_IF_FAILED_WITH_EXPECTED(StringResultGetBorrowedView(stringResult, resourceString, resourceStringLength), HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+        *resourceType = localType;
+    }
+
+    return S_OK;
+}
+
+// A parsed PRI file is shared by every resource manager in the process that opens the same, unchanged file. The file
+// data itself is mapped, so its pages are already shared with other processes. Each resource manager keeps its own
+// default context, so only the read-only parsed state is shared, which a single resource manager already shares
+// between threads.
+struct SharedPriFileKey
+{
+    std::wstring path;
+    UINT64 size = 0;
+    UINT64 lastWriteTime = 0;
+    DefChecksum::Checksum checksum = 0;
+
+    bool operator==(const SharedPriFileKey& other) const
+    {
+        return (size == other.size) && (lastWriteTime == other.lastWriteTime) && (checksum == other.checksum) &&
+               (CompareStringOrdinal(path.c_str(), -1, other.path.c_str(), -1, TRUE) == CSTR_EQUAL);
+    }
+};
+
+struct SharedPriFile
+{
+    SharedPriFileKey key;
+    bool isCached = false;
+    volatile LONG refCount = 1;
+    CoreProfile* profile = nullptr;
+    UnifiedResourceView* unifiedView = nullptr;
+    const PriFile* priFile = nullptr;
+
+    ~SharedPriFile()
+    {
+        delete unifiedView;
+        delete profile;
+    }
+};
+
+static SRWLOCK g_sharedPriFilesLock = SRWLOCK_INIT;
+static std::vector<SharedPriFile*> g_sharedPriFiles;
+
+static HRESULT GetSharedPriFileKey(_In_ PCWSTR priPath, _Out_ SharedPriFileKey* key)
+{
+    DWORD length = GetFullPathNameW(priPath, 0, nullptr, nullptr);
+    RETURN_LAST_ERROR_IF(length == 0);
+
+    key->path.resize(length);
+    length = GetFullPathNameW(priPath, length, &key->path[0], nullptr);
+    RETURN_LAST_ERROR_IF(length == 0);
+    RETURN_HR_IF(E_UNEXPECTED, length >= key->path.size());
+    key->path.resize(length);
+
+    wil::unique_hfile file(CreateFileW(
+        key->path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+    RETURN_LAST_ERROR_IF(!file);
+
+    BY_HANDLE_FILE_INFORMATION fileInfo;
+    RETURN_IF_WIN32_BOOL_FALSE(GetFileInformationByHandle(file.get(), &fileInfo));
+    key->size = (static_cast<UINT64>(fileInfo.nFileSizeHigh) << 32) | fileInfo.nFileSizeLow;
+    key->lastWriteTime =
+        (static_cast<UINT64>(fileInfo.ftLastWriteTime.dwHighDateTime) << 32) | fileInfo.ftLastWriteTime.dwLowDateTime;
+
+    // Checksumming the header and table of contents catches a file that was replaced without changing its size or
+    // timestamp, without reading the whole file.
+    DEFFILE_HEADER header;
+    DWORD bytesRead;
+    RETURN_IF_WIN32_BOOL_FALSE(ReadFile(file.get(), &header, sizeof(header), &bytesRead, nullptr));
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE), bytesRead != sizeof(header));
+    key->checksum = DefChecksum::ComputeChecksum(0, reinterpret_cast<const BYTE*>(&header), sizeof(header));
+
+    if (header.sizeToc > 0)
+    {
+        std::vector<BYTE> toc(header.sizeToc * sizeof(DEFFILE_TOC_ENTRY));
+
+        LARGE_INTEGER tocOffset;
+        tocOffset.QuadPart = header.tocOffset;
+        RETURN_IF_WIN32_BOOL_FALSE(SetFilePointerEx(file.get(), tocOffset, nullptr, FILE_BEGIN));
+        RETURN_IF_WIN32_BOOL_FALSE(ReadFile(file.get(), toc.data(), static_cast<DWORD>(toc.size()), &bytesRead, nullptr));
+        RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE), bytesRead != toc.size());
+
+        key->checksum = DefChecksum::ComputeChecksum(key->checksum, toc.data(), static_cast<UINT32>(toc.size()));
+    }
+
+    return S_OK;
+}
+
+static SharedPriFile* TryAddRefSharedPriFileLocked(_In_ const SharedPriFileKey& key)
+{
+    for (SharedPriFile* sharedPriFile : g_sharedPriFiles)
+    {
+        if (sharedPriFile->key == key)
+        {
+            InterlockedIncrement(&sharedPriFile->refCount);
+            return sharedPriFile;
+        }
+    }
+
+    return nullptr;
+}
+
+static HRESULT LoadSharedPriFile(_In_ PCWSTR priPath, _Outptr_ SharedPriFile** result)
+{
+    *result = nullptr;
+
+    // If we can't build a key, load a private copy and let SetApplicationPriFile report any problem with the file.
+    SharedPriFileKey key;
+    bool isCacheable = SUCCEEDED(GetSharedPriFileKey(priPath, &key));
+    if (isCacheable)
+    {
+        auto lock = wil::AcquireSRWLockShared(&g_sharedPriFilesLock);
+        *result = TryAddRefSharedPriFileLocked(key);
+        if (*result != nullptr)
+        {
+            return S_OK;
+        }
+    }
+
+    std::unique_ptr<SharedPriFile> sharedPriFile(new (std::nothrow) SharedPriFile());
+    RETURN_IF_NULL_ALLOC(sharedPriFile);
+
+    RETURN_IF_FAILED(CoreProfile::ChooseDefaultProfile(&sharedPriFile->profile));
+    RETURN_IF_FAILED(UnifiedResourceView::CreateInstance(sharedPriFile->profile, &sharedPriFile->unifiedView));
+    RETURN_IF_FAILED(sharedPriFile->unifiedView->SetApplicationPriFile(priPath, nullptr, &sharedPriFile->priFile));
+
+    if (isCacheable)
+    {
+        auto lock = wil::AcquireSRWLockExclusive(&g_sharedPriFilesLock);
+
+        // Another resource manager may have loaded the same file while we were parsing it.
+        *result = TryAddRefSharedPriFileLocked(key);
+        if (*result != nullptr)
+        {
+            return S_OK;
+        }
+
+        sharedPriFile->key = std::move(key);
+        sharedPriFile->isCached = true;
+        g_sharedPriFiles.push_back(sharedPriFile.get());
+    }
+
+    *result = sharedPriFile.release();
+    return S_OK;
+}
+
+static void ReleaseSharedPriFile(_In_ SharedPriFile* sharedPriFile)
+{
+    if (sharedPriFile->isCached)
+    {
+        // Lookups take their reference under the shared lock, so this can't race with one.
+        auto lock = wil::AcquireSRWLockExclusive(&g_sharedPriFilesLock);
+        if (InterlockedDecrement(&sharedPriFile->refCount) != 0)
+        {
+            return;
+        }
+
+        g_sharedPriFiles.erase(std::find(g_sharedPriFiles.begin(), g_sharedPriFiles.end(), sharedPriFile));
+    }
+    else if (InterlockedDecrement(&sharedPriFile->refCount) != 0)
+    {
+        return;
+    }
+
+    delete sharedPriFile;
+}
+
+static void DestroyResourceManager(_In_ void* resourceManager)
+{
+    MrmObjects* resourceManagerObjects = reinterpret_cast<MrmObjects*>(resourceManager);
+
+    if (resourceManagerObjects->warmUpWork != nullptr)
+    {
+        // A background warm-up uses the default resolver and the PRI file, so let it finish first.
+        WaitForThreadpoolWorkCallbacks(resourceManagerObjects->warmUpWork, FALSE);
+        CloseThreadpoolWork(resourceManagerObjects->warmUpWork);
+        resourceManagerObjects->warmUpWork = nullptr;
     }
 
     if (resourceManagerObjects->resolver != nullptr)
@@ -500,6 +1044,15 @@ static void DestroyResourceManager(_In_ void* resourceManager)
         resourceManagerObjects->resolver = nullptr;
     }
 
+    if (resourceManagerObjects->sharedPriFile != nullptr)
+    {
+        ReleaseSharedPriFile(resourceManagerObjects->sharedPriFile);
+        resourceManagerObjects->sharedPriFile = nullptr;
+        resourceManagerObjects->profile = nullptr;
+        resourceManagerObjects->unifiedView = nullptr;
+        resourceManagerObjects->priFile = nullptr;
+    }
+
     delete resourceManagerObjects;
 
     return;
@@ -517,9 +1070,6 @@ STDAPI MrmCreateResourceManager(_In_ PCWSTR priFileName, _Out_ MrmManagerHandle*
         new (std::nothrow) MrmObjects(), &DestroyResourceManager);
     RETURN_IF_NULL_ALLOC(resourceManagerObjects);
 
-    RETURN_IF_FAILED(CoreProfile::ChooseDefaultProfile(&resourceManagerObjects->profile));
-    RETURN_IF_FAILED(UnifiedResourceView::CreateInstance(resourceManagerObjects->profile, &resourceManagerObjects->unifiedView));
-
     HRESULT hr = S_OK;
     if (wcschr(priFileName, L'\\') == nullptr)
     {
@@ -528,14 +1078,18 @@ STDAPI MrmCreateResourceManager(_In_ PCWSTR priFileName, _Out_ MrmManagerHandle*
         RETURN_IF_FAILED(MrmGetFilePathFromName(priFileName, &filepath));
 
         std::unique_ptr<wchar_t, decltype(&MrmFreeResource)> priPath(filepath, MrmFreeResource);
-        hr = resourceManagerObjects->unifiedView->SetApplicationPriFile(priPath.get(), nullptr, &resourceManagerObjects->priFile);
+        hr = LoadSharedPriFile(priPath.get(), &resourceManagerObjects->sharedPriFile);
     }
     else
     {
-        hr = resourceManagerObjects->unifiedView->SetApplicationPriFile(priFileName, nullptr, &resourceManagerObjects->priFile);
+        hr = LoadSharedPriFile(priFileName, &resourceManagerObjects->sharedPriFile);
     }
     RETURN_IF_FAILED(hr);
 
+    resourceManagerObjects->profile = resourceManagerObjects->sharedPriFile->profile;
+    resourceManagerObjects->unifiedView = resourceManagerObjects->sharedPriFile->unifiedView;
+    resourceManagerObjects->priFile = resourceManagerObjects->sharedPriFile->priFile;
+
     const IResourceMapBase* primaryMap;
     RETURN_IF_FAILED(resourceManagerObjects->priFile->GetPrimaryResourceMap(&primaryMap));
 
@@ -662,6 +1216,235 @@ STDAPI MrmSetQualifier(_In_ MrmContextHandle resourceContext, _In_ PCWSTR qualif
     return reinterpret_cast<ProviderResolver*>(resourceContext)->SetQualifier(qualifierName, qualifierValue);
 }
 
+// Decisions are handed out to the freeze workers in chunks of this size.
+constexpr LONG c_freezeChunkSize = 64;
+
+struct FreezeWorkContext
+{
+    ProviderResolver* resolver;
+    ResolverBase::FrozenDecisions* frozen;
+    LONG numDecisions;
+    volatile LONG nextDecision;
+    volatile LONG hr;
+};
+
+static void CALLBACK FreezeWorkCallback(_Inout_opt_ PTP_CALLBACK_INSTANCE, _Inout_opt_ void* context, _Inout_opt_ PTP_WORK)
+{
+    FreezeWorkContext* work = reinterpret_cast<FreezeWorkContext*>(context);
+    while (SUCCEEDED(ReadAcquire(&work->hr)))
+    {
+        LONG first = InterlockedExchangeAdd(&work->nextDecision, c_freezeChunkSize);
+        if (first >= work->numDecisions)
+        {
+            break;
+        }
+
+        LONG count = std::min(c_freezeChunkSize, work->numDecisions - first);
+        HRESULT hr = work->resolver->FreezeDecisions(work->frozen, first, count);
+        if (FAILED(hr))
+        {
+            InterlockedCompareExchange(&work->hr, hr, S_OK);
+        }
+    }
+}
+
+STDAPI MrmFreezeResourceContext(_In_ MrmManagerHandle resourceManager, _In_opt_ MrmContextHandle resourceContext)
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, resourceManager);
+
+    ProviderResolver* resolver = GetResolver(reinterpret_cast<MrmObjects*>(resourceManager), resourceContext);
+
+    int numDecisions;
+    ResolverBase::FrozenDecisions* frozen;
+    RETURN_IF_FAILED(resolver->BeginFreeze(&frozen, &numDecisions));
+
+    FreezeWorkContext work{ resolver, frozen, numDecisions, 0, S_OK };
+
+    // The calling thread always takes part, so a single chunk never touches the thread pool.
+    DWORD numChunks = static_cast<DWORD>((numDecisions + c_freezeChunkSize - 1) / c_freezeChunkSize);
+    DWORD numWorkers = std::min(GetActiveProcessorCount(ALL_PROCESSOR_GROUPS), numChunks);
+    PTP_WORK threadpoolWork = nullptr;
+    if (numWorkers > 1)
+    {
+        threadpoolWork = CreateThreadpoolWork(FreezeWorkCallback, &work, nullptr);
+        if (threadpoolWork == nullptr)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            resolver->EndFreeze(frozen, false);
+            RETURN_HR(hr);
+        }
+
+        for (DWORD i = 1; i < numWorkers; i++)
+        {
+            SubmitThreadpoolWork(threadpoolWork);
+        }
+    }
+
+    FreezeWorkCallback(nullptr, &work, nullptr);
+
+    if (threadpoolWork != nullptr)
+    {
+        WaitForThreadpoolWorkCallbacks(threadpoolWork, FALSE);
+        CloseThreadpoolWork(threadpoolWork);
+    }
+
+    HRESULT hr = work.hr;
+    HRESULT endHr = resolver->EndFreeze(frozen, SUCCEEDED(hr));
+    RETURN_IF_FAILED(hr);
+    RETURN_IF_FAILED(endHr);
+    return S_OK;
+}
+
+static HRESULT WarmResourceMap(
+    _In_ MrmObjects* resourceManagerObjects,
+    _In_ ProviderResolver* resolver,
+    _In_ const ResourceMapSubtree* mapSubtree,
+    UINT32 flags)
+{
+    LARGE_INTEGER start;
+    LARGE_INTEGER end;
+
+    if ((flags & MrmWarmFlags_PrefetchFile) != 0)
+    {
+        const BaseFile* baseFile;
+        RETURN_IF_FAILED(resourceManagerObjects->priFile->GetBaseFile(&baseFile));
+
+        QueryPerformanceCounter(&start);
+        RETURN_IF_FAILED(baseFile->Prefetch());
+        QueryPerformanceCounter(&end);
+
+        InterlockedExchangeAdd64(&resourceManagerObjects->prefetchTicks, end.QuadPart - start.QuadPart);
+    }
+
+    if ((flags & MrmWarmFlags_ResolveDecisions) != 0)
+    {
+        QueryPerformanceCounter(&start);
+
+        // Many resources share a decision, and evaluating it once is enough to fill the caches.
+        std::vector<bool> resolved(static_cast<size_t>(resolver->GetDecisions()->GetNumDecisions()));
+        LONG numResolved = 0;
+
+        AutoDeletePtr<DescendentResourceEnumerator> enumerator;
+        RETURN_IF_FAILED(DescendentResourceEnumerator::CreateInstance(mapSubtree, &enumerator));
+
+        NamedResourceResult namedResource;
+        DecisionResult decision;
+        for (;;)
+        {
+            HRESULT hr = enumerator->MoveNext();
+            RETURN_IF_FAILED(hr);
+            if (hr == S_FALSE)
+            {
+                break;
+            }
+
+            RETURN_IF_FAILED(enumerator->GetCurrentResource(&namedResource));
+            RETURN_IF_FAILED(namedResource.GetDecision(&decision));
+
+            int decisionIndex = decision.GetIndex();
+            if ((decisionIndex >= 0) && (static_cast<size_t>(decisionIndex) < resolved.size()))
+            {
+                if (resolved[decisionIndex])
+                {
+                    continue;
+                }
+                resolved[decisionIndex] = true;
+            }
+
+            // A decision without a usable candidate fails again, with the same error, when its resource is
+            // looked up; that isn't the warm-up's to report.
+            int resultIndex;
+            (void)EvaluateResourceDecision(resolver, decision, &resultIndex);
+            numResolved++;
+        }
+
+        QueryPerformanceCounter(&end);
+
+        InterlockedExchangeAdd64(&resourceManagerObjects->resolveTicks, end.QuadPart - start.QuadPart);
+        InterlockedExchangeAdd(&resourceManagerObjects->resolvedDecisions, numResolved);
+    }
+
+    InterlockedIncrement(&resourceManagerObjects->warmUpCount);
+    return S_OK;
+}
+
+static void CALLBACK WarmUpWorkCallback(_Inout_opt_ PTP_CALLBACK_INSTANCE, _Inout_opt_ void* context, _Inout_opt_ PTP_WORK)
+{
+    MrmObjects* resourceManagerObjects = reinterpret_cast<MrmObjects*>(context);
+
+    // Nobody is waiting for the result. A warm-up that fails only leaves the lookups it didn't get to cold.
+    (void)WarmResourceMap(
+        resourceManagerObjects, resourceManagerObjects->resolver, resourceManagerObjects->warmUpMap, resourceManagerObjects->warmUpFlags);
+
+    InterlockedExchange(&resourceManagerObjects->warmUpRunning, 0);
+}
+
+STDAPI MrmWarmResourceMap(
+    _In_ MrmManagerHandle resourceManager,
+    _In_opt_ MrmContextHandle resourceContext,
+    _In_opt_ MrmMapHandle resourceMap,
+    UINT32 flags)
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, resourceManager);
+    RETURN_HR_IF(E_INVALIDARG, (flags & ~(MrmWarmFlags_Default | MrmWarmFlags_Background)) != 0);
+
+    MrmObjects* resourceManagerObjects = reinterpret_cast<MrmObjects*>(resourceManager);
+
+    const ResourceMapSubtree* mapSubtree;
+    RETURN_IF_FAILED(GetMapSubtree(resourceManagerObjects, resourceMap, &mapSubtree));
+
+    if ((flags & MrmWarmFlags_Background) == 0)
+    {
+        return WarmResourceMap(resourceManagerObjects, GetResolver(resourceManagerObjects, resourceContext), mapSubtree, flags);
+    }
+
+    // The default context lives as long as the resource manager, which waits for the warm-up before it goes away.
+    // Nothing would keep any other context alive until the warm-up is done.
+    RETURN_HR_IF(E_INVALIDARG, resourceContext != nullptr);
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_BUSY), InterlockedCompareExchange(&resourceManagerObjects->warmUpRunning, 1, 0) != 0);
+
+    if (resourceManagerObjects->warmUpWork == nullptr)
+    {
+        resourceManagerObjects->warmUpWork = CreateThreadpoolWork(WarmUpWorkCallback, resourceManagerObjects, nullptr);
+        if (resourceManagerObjects->warmUpWork == nullptr)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            InterlockedExchange(&resourceManagerObjects->warmUpRunning, 0);
+            RETURN_HR(hr);
+        }
+    }
+
+    resourceManagerObjects->warmUpMap = mapSubtree;
+    resourceManagerObjects->warmUpFlags = flags;
+    SubmitThreadpoolWork(resourceManagerObjects->warmUpWork);
+
+    return S_OK;
+}
+
+STDAPI MrmGetWarmUpStatistics(_In_ MrmManagerHandle resourceManager, _Out_ MrmWarmUpStatistics* statistics)
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, statistics);
+    *statistics = {};
+    RETURN_HR_IF_NULL(E_INVALIDARG, resourceManager);
+
+    MrmObjects* resourceManagerObjects = reinterpret_cast<MrmObjects*>(resourceManager);
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    auto toMicroseconds = [&frequency](LONG64 ticks) { return static_cast<UINT64>(ticks) * 1000000 / frequency.QuadPart; };
+
+    statistics->warmUpCount = static_cast<UINT32>(ReadAcquire(&resourceManagerObjects->warmUpCount));
+    statistics->prefetchMicroseconds = toMicroseconds(ReadAcquire64(&resourceManagerObjects->prefetchTicks));
+    statistics->resolveMicroseconds = toMicroseconds(ReadAcquire64(&resourceManagerObjects->resolveTicks));
+    statistics->resolvedDecisions = static_cast<UINT32>(ReadAcquire(&resourceManagerObjects->resolvedDecisions));
+
+    LONG64 firstLookup = ReadAcquire64(&resourceManagerObjects->firstLookup);
+    statistics->firstLookupMicroseconds = toMicroseconds(firstLookup >> 1);
+    statistics->firstLookupWasWarm = ((firstLookup & 1) != 0);
+
+    return S_OK;
+}
+
 STDAPI_(void) MrmDestroyResourceContext(_In_opt_ MrmContextHandle resourceContext)
 {
     if (resourceContext != nullptr)
@@ -764,6 +1547,47 @@ STDAPI MrmGetResourceCount(_In_ MrmManagerHandle resourceManager, _In_opt_ MrmMa
     return S_OK;
 }
 
+STDAPI MrmEnumerateResources(
+    _In_ MrmManagerHandle resourceManager,
+    _In_opt_ MrmMapHandle resourceMap,
+    _In_ MrmEnumerateResourcesCallback callback,
+    _In_opt_ void* context)
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, callback);
+
+    MrmObjects* resourceManagerObjects = reinterpret_cast<MrmObjects*>(resourceManager);
+    const ResourceMapSubtree* mapSubtree;
+    RETURN_IF_FAILED(GetMapSubtree(resourceManagerObjects, resourceMap, &mapSubtree));
+
+    AutoDeletePtr<DescendentResourceEnumerator> enumerator;
+    RETURN_IF_FAILED(DescendentResourceEnumerator::CreateInstance(mapSubtree, &enumerator));
+
+    StringResult nameResult;
+    UINT32 index = 0;
+    for (;;)
+    {
+        HRESULT hr = enumerator->MoveNext();
+        RETURN_IF_FAILED(hr);
+        if (hr == S_FALSE)
+        {
+            break;
+        }
+
+        RETURN_IF_FAILED(enumerator->GetCurrentResourceName(&nameResult));
+
+        hr = callback(index, nameResult.GetRef(), context);
+        RETURN_IF_FAILED(hr);
+        if (hr == S_FALSE)
+        {
+            break;
+        }
+
+        index++;
+    }
+
+    return S_OK;
+}
+
 STDAPI MrmLoadStringResource(
     _In_ MrmManagerHandle resourceManager,
     _In_opt_ MrmContextHandle resourceContext,
@@ -937,6 +1761,72 @@ STDAPI MrmLoadStringOrEmbeddedResourceByIndexWithQualifierValues(
     return S_OK;
 }
 
+STDAPI MrmLoadStringResources(
+    _In_ MrmManagerHandle resourceManager,
+    _In_opt_ MrmContextHandle resourceContext,
+    _In_opt_ MrmMapHandle resourceMap,
+    UINT32 count,
+    _In_reads_(count) PCWSTR* resourceIds,
+    _Out_writes_(count) PWSTR* resourceStrings,
+    _Out_writes_(count) HRESULT* results)
+{
+    RETURN_HR_IF(E_INVALIDARG, (count > 0) && ((resourceIds == nullptr) || (resourceStrings == nullptr) || (results == nullptr)));
+
+    return LoadStringResources(resourceManager, resourceContext, resourceMap, count, resourceIds, resourceStrings, results);
+}
+
+STDAPI MrmLoadStringResourceView(
+    _In_ MrmManagerHandle resourceManager,
+    _In_opt_ MrmContextHandle resourceContext,
+    _In_opt_ MrmMapHandle resourceMap,
+    _In_ PCWSTR resourceId,
+    _Outptr_result_buffer_(*resourceStringLength) PCWSTR* resourceString,
+    _Out_ UINT32* resourceStringLength)
+{
+    if (IsResourceUri(resourceId))
+    {
+        RETURN_IF_FAILED_WITH_EXPECTED(LoadStringResourceView(
+            resourceManager, resourceContext, nullptr, INDEX_RESOURCE_URI, resourceId, resourceString, resourceStringLength),
+            HRESULT_FROM_WIN32(ERROR_MRM_NAMED_RESOURCE_NOT_FOUND),
+            HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+    }
+    else
+    {
+        RETURN_IF_FAILED_WITH_EXPECTED(LoadStringResourceView(
+            resourceManager, resourceContext, resourceMap, INDEX_RESOURCE_ID, resourceId, resourceString, resourceStringLength),
+            HRESULT_FROM_WIN32(ERROR_MRM_NAMED_RESOURCE_NOT_FOUND),
+            HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+    }
+    return S_OK;
+}
+
+STDAPI MrmLoadStringOrEmbeddedResourceView(
+    _In_ MrmManagerHandle resourceManager,
+    _In_opt_ MrmContextHandle resourceContext,
+    _In_opt_ MrmMapHandle resourceMap,
+    _In_ PCWSTR resourceId,
+    _Out_ MrmType* resourceType,
+    _Outptr_result_maybenull_ PCWSTR* resourceString,
+    _Out_ UINT32* resourceStringLength,
+    _Out_ MrmResourceData* data)
+{
+    if (IsResourceUri(resourceId))
+    {
+        RETURN_IF_FAILED_WITH_EXPECTED(LoadStringOrEmbeddedResourceView(
+            resourceManager, resourceContext, nullptr, INDEX_RESOURCE_URI, resourceId, resourceType, resourceString, resourceStringLength, data),
+            HRESULT_FROM_WIN32(ERROR_MRM_NAMED_RESOURCE_NOT_FOUND),
+            HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+    }
+    else
+    {
+        RETURN_IF_FAILED_WITH_EXPECTED(LoadStringOrEmbeddedResourceView(
+            resourceManager, resourceContext, resourceMap, INDEX_RESOURCE_ID, resourceId, resourceType, resourceString, resourceStringLength, data),
+            HRESULT_FROM_WIN32(ERROR_MRM_NAMED_RESOURCE_NOT_FOUND),
+            HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+    }
+    return S_OK;
+}
+
 STDAPI_(void*) MrmAllocateBuffer(size_t size) { return Def_Alloc(size); }
 
 STDAPI_(void) MrmFreeResource(_In_opt_ void* resource)
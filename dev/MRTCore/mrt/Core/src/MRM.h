@@ -36,6 +36,50 @@ extern "C"
     STDAPI MrmSetQualifier(_In_ MrmContextHandle resourceContext, _In_ PCWSTR qualifierName, _In_ PCWSTR qualifierValue);
     STDAPI_(void) MrmDestroyResourceContext(_In_opt_ MrmContextHandle resourceContext);
 
+    // Evaluates every resource decision against the current qualifier values of the context (or the default context if
+    // resourceContext is null) and remembers the results, so later loads skip candidate selection. Any change to the
+    // context, including MrmSetQualifier, discards the results; call this again to refreeze.
+    STDAPI MrmFreezeResourceContext(_In_ MrmManagerHandle resourceManager, _In_opt_ MrmContextHandle resourceContext);
+
+    enum MrmWarmFlags
+    {
+        MrmWarmFlags_None = 0x0,
+        // Reads the PRI file in with one sequential pass instead of a page fault at a time.
+        MrmWarmFlags_PrefetchFile = 0x1,
+        // Evaluates the decision of every resource in the resource map, filling the caches of the context.
+        MrmWarmFlags_ResolveDecisions = 0x2,
+        // Returns straight away and warms on a thread pool thread. Only the default context can be warmed this way.
+        MrmWarmFlags_Background = 0x4,
+
+        MrmWarmFlags_Default = MrmWarmFlags_PrefetchFile | MrmWarmFlags_ResolveDecisions
+    };
+
+    // Pays the cost of the first lookups in a resource map (or the primary resource map if resourceMap is null) up front,
+    // typically while the app is still initializing. Lookups give the same results whether or not this has run. With
+    // MrmWarmFlags_Background, returns HRESULT_FROM_WIN32(ERROR_BUSY) if a background warm-up is already running, and
+    // MrmDestroyResourceManager waits for a running warm-up to finish.
+    STDAPI MrmWarmResourceMap(
+        _In_ MrmManagerHandle resourceManager,
+        _In_opt_ MrmContextHandle resourceContext,
+        _In_opt_ MrmMapHandle resourceMap,
+        UINT32 flags);
+
+    struct MrmWarmUpStatistics
+    {
+        // Totals over every warm-up of the resource manager that has finished.
+        UINT32 warmUpCount;
+        UINT64 prefetchMicroseconds;
+        UINT64 resolveMicroseconds;
+        UINT32 resolvedDecisions;
+
+        // How long the first lookup through the resource manager took, and whether a warm-up had finished before it
+        // started; both zero until there has been a lookup.
+        UINT64 firstLookupMicroseconds;
+        BOOL firstLookupWasWarm;
+    };
+
+    STDAPI MrmGetWarmUpStatistics(_In_ MrmManagerHandle resourceManager, _Out_ MrmWarmUpStatistics* statistics);
+
     // Resource maps are owned by the resource manager and so do not need to be destroyed.
     STDAPI MrmGetChildResourceMap(
         _In_ MrmManagerHandle resourceManager,
@@ -45,6 +89,20 @@ extern "C"
 
     STDAPI MrmGetResourceCount(_In_ MrmManagerHandle resourceManager, _In_opt_ MrmMapHandle resourceMap, _Out_ UINT32* count);
 
+    // Called by MrmEnumerateResources for each resource. index is the index that the ...ByIndex functions take for the same
+    // resource, and resourceName is only valid for the duration of the call. Return S_FALSE to stop the enumeration; a
+    // failure also stops it and is returned by MrmEnumerateResources.
+    typedef HRESULT(CALLBACK* MrmEnumerateResourcesCallback)(UINT32 index, _In_ PCWSTR resourceName, _In_opt_ void* context);
+
+    // Calls the callback for every resource in the resource map (or the primary resource map if resourceMap is null), in
+    // index order. Unlike MrmGetResourceCount followed by index-based loads, this walks the map without first building
+    // an index of all of its resources.
+    STDAPI MrmEnumerateResources(
+        _In_ MrmManagerHandle resourceManager,
+        _In_opt_ MrmMapHandle resourceMap,
+        _In_ MrmEnumerateResourcesCallback callback,
+        _In_opt_ void* context);
+
     STDAPI MrmLoadStringResource(
         _In_ MrmManagerHandle resourceManager,
         _In_opt_ MrmContextHandle resourceContext,
@@ -123,6 +181,40 @@ extern "C"
         _Outptr_result_buffer_(*qualifierCount) PWSTR** qualifierNames,
         _Outptr_result_buffer_(*qualifierCount) PWSTR** qualifierValues);
 
+    // Loads many string resources from the same resource map in one call. On return, resourceStrings[i] and results[i]
+    // hold the string (to be freed with MrmFreeResource) and the outcome for resourceIds[i]. Returns S_FALSE if any of
+    // the lookups failed.
+    STDAPI MrmLoadStringResources(
+        _In_ MrmManagerHandle resourceManager,
+        _In_opt_ MrmContextHandle resourceContext,
+        _In_opt_ MrmMapHandle resourceMap,
+        UINT32 count,
+        _In_reads_(count) PCWSTR* resourceIds,
+        _Out_writes_(count) PWSTR* resourceStrings,
+        _Out_writes_(count) HRESULT* results);
+
+    // The view variants return pointers into the loaded PRI file instead of copies. The returned data is read-only,
+    // must not be freed, and stays valid for the lifetime of the resource manager. Values that are not stored in
+    // the PRI file in their final form (for example, file paths that get the package root prepended) cannot be
+    // returned as a view and fail with HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED); use the copying variants for those.
+    STDAPI MrmLoadStringResourceView(
+        _In_ MrmManagerHandle resourceManager,
+        _In_opt_ MrmContextHandle resourceContext,
+        _In_opt_ MrmMapHandle resourceMap,
+        _In_ PCWSTR resourceId,
+        _Outptr_result_buffer_(*resourceStringLength) PCWSTR* resourceString,
+        _Out_ UINT32* resourceStringLength);
+
+    STDAPI MrmLoadStringOrEmbeddedResourceView(
+        _In_ MrmManagerHandle resourceManager,
+        _In_opt_ MrmContextHandle resourceContext,
+        _In_opt_ MrmMapHandle resourceMap,
+        _In_ PCWSTR resourceId,
+        _Out_ MrmType* resourceType,
+        _Outptr_result_maybenull_ PCWSTR* resourceString,
+        _Out_ UINT32* resourceStringLength,
+        _Out_ MrmResourceData* data);
+
     STDAPI_(void*) MrmAllocateBuffer(size_t size);
     STDAPI_(void) MrmFreeResource(_In_opt_ void* resource);
 
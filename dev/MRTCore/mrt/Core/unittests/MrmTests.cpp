@@ -312,6 +312,151 @@ public:
         MrmDestroyResourceManager(resourceManager);
     }
 
+    TEST_METHOD(FreezeResourceContext)
+    {
+        MrmManagerHandle resourceManager;
+        VERIFY_ARE_EQUAL(MrmCreateResourceManager(L".\\resources.pri", &resourceManager), S_OK);
+
+        MrmContextHandle resourceContext;
+        VERIFY_ARE_EQUAL(MrmCreateResourceContext(resourceManager, &resourceContext), S_OK);
+
+        wchar_t* resourceString;
+        VERIFY_ARE_EQUAL(MrmSetQualifier(resourceContext, L"Language", L"en-GB"), S_OK);
+        VERIFY_ARE_EQUAL(MrmFreezeResourceContext(resourceManager, resourceContext), S_OK);
+        VERIFY_ARE_EQUAL(MrmLoadStringResource(resourceManager, resourceContext, nullptr, L"resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE", &resourceString), S_OK);
+
+        VerifyStringEqual(resourceString, L"Equaliser");
+        MrmFreeResource(resourceString);
+
+        // Changing a qualifier thaws the context.
+        VERIFY_ARE_EQUAL(MrmSetQualifier(resourceContext, L"Language", L"en-US"), S_OK);
+        VERIFY_ARE_EQUAL(MrmLoadStringResource(resourceManager, resourceContext, nullptr, L"resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE", &resourceString), S_OK);
+
+        VerifyStringEqual(resourceString, L"Equalizer");
+        MrmFreeResource(resourceString);
+
+        VERIFY_ARE_EQUAL(MrmFreezeResourceContext(resourceManager, resourceContext), S_OK);
+        VERIFY_ARE_EQUAL(MrmLoadStringResource(resourceManager, resourceContext, nullptr, L"resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE", &resourceString), S_OK);
+
+        VerifyStringEqual(resourceString, L"Equalizer");
+        MrmFreeResource(resourceString);
+
+        MrmDestroyResourceContext(resourceContext);
+        MrmDestroyResourceManager(resourceManager);
+    }
+
+    TEST_METHOD(RepeatedLookupsWithUnchangedContext)
+    {
+        MrmManagerHandle resourceManager;
+        VERIFY_ARE_EQUAL(MrmCreateResourceManager(L".\\resources.pri", &resourceManager), S_OK);
+
+        MrmContextHandle resourceContext;
+        VERIFY_ARE_EQUAL(MrmCreateResourceContext(resourceManager, &resourceContext), S_OK);
+
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+
+        // Each lookup re-applies the context first, the way ResourceMap::GetValue does. Re-applying
+        // unchanged values must keep the caches warm; changing them every time shows the cold cost.
+        const unsigned int c_lookups[] = { 100000, 10000 };
+        for (unsigned int pass = 0; pass < ARRAYSIZE(c_lookups); pass++)
+        {
+            bool unchanged = (pass == 0);
+
+            unsigned int mismatches = 0;
+            LARGE_INTEGER start;
+            QueryPerformanceCounter(&start);
+
+            for (unsigned int i = 0; i < c_lookups[pass]; i++)
+            {
+                PCWSTR language = (unchanged || ((i % 2) == 0)) ? L"en-GB" : L"en-AU";
+                wchar_t* resourceString = nullptr;
+                if (FAILED(MrmSetQualifier(resourceContext, L"Language", language)) ||
+                    FAILED(MrmLoadStringResource(resourceManager, resourceContext, nullptr, L"resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE", &resourceString)) ||
+                    (wcscmp(resourceString, L"Equaliser") != 0))
+                {
+                    mismatches++;
+                }
+                MrmFreeResource(resourceString);
+            }
+
+            LARGE_INTEGER end;
+            QueryPerformanceCounter(&end);
+            VERIFY_ARE_EQUAL(mismatches, 0u);
+
+            double microseconds = ((end.QuadPart - start.QuadPart) * 1000000.0) / frequency.QuadPart;
+            Log::Comment(String().Format(
+                L"%s context: %u lookups, %.3f us per lookup",
+                unchanged ? L"Unchanged" : L"Changing",
+                c_lookups[pass],
+                microseconds / c_lookups[pass]));
+        }
+
+        MrmDestroyResourceContext(resourceContext);
+        MrmDestroyResourceManager(resourceManager);
+    }
+
+    TEST_METHOD(WarmResourceMap)
+    {
+        // Both resource managers share the PRI file, so this compares the resolver side of the first lookup; the
+        // page cache is usually warm already from the other tests.
+        for (int warm = 0; warm < 2; warm++)
+        {
+            MrmManagerHandle resourceManager;
+            VERIFY_ARE_EQUAL(MrmCreateResourceManager(L".\\resources.pri", &resourceManager), S_OK);
+
+            MrmWarmUpStatistics statistics;
+            if (warm != 0)
+            {
+                VERIFY_ARE_EQUAL(MrmWarmResourceMap(resourceManager, nullptr, nullptr, MrmWarmFlags_Default), S_OK);
+
+                VERIFY_ARE_EQUAL(MrmGetWarmUpStatistics(resourceManager, &statistics), S_OK);
+                VERIFY_ARE_EQUAL(statistics.warmUpCount, 1u);
+                VERIFY_IS_TRUE(statistics.resolvedDecisions > 0);
+                VERIFY_ARE_EQUAL(statistics.firstLookupMicroseconds, 0ull);
+                Log::Comment(String().Format(
+                    L"Warm-up: prefetch %llu us, %u decisions resolved in %llu us",
+                    statistics.prefetchMicroseconds,
+                    statistics.resolvedDecisions,
+                    statistics.resolveMicroseconds));
+            }
+
+            wchar_t* resourceString;
+            VERIFY_ARE_EQUAL(MrmLoadStringResource(resourceManager, nullptr, nullptr, L"resources/IDS_MANIFEST_MUSIC_APP_NAME", &resourceString), S_OK);
+            VerifyStringEqual(resourceString, L"Groove Music");
+            MrmFreeResource(resourceString);
+
+            VERIFY_ARE_EQUAL(MrmGetWarmUpStatistics(resourceManager, &statistics), S_OK);
+            VERIFY_ARE_EQUAL(statistics.firstLookupWasWarm, static_cast<BOOL>(warm != 0));
+            Log::Comment(String().Format(
+                L"First lookup %s warm-up: %llu us", (warm != 0) ? L"with" : L"without", statistics.firstLookupMicroseconds));
+
+            MrmDestroyResourceManager(resourceManager);
+        }
+
+        MrmManagerHandle resourceManager;
+        VERIFY_ARE_EQUAL(MrmCreateResourceManager(L".\\resources.pri", &resourceManager), S_OK);
+
+        MrmContextHandle resourceContext;
+        VERIFY_ARE_EQUAL(MrmCreateResourceContext(resourceManager, &resourceContext), S_OK);
+
+        // Only the default context can be warmed in the background.
+        VERIFY_ARE_EQUAL(MrmWarmResourceMap(resourceManager, resourceContext, nullptr, MrmWarmFlags_Default | MrmWarmFlags_Background), E_INVALIDARG);
+        VERIFY_ARE_EQUAL(MrmWarmResourceMap(resourceManager, nullptr, nullptr, 0x80), E_INVALIDARG);
+
+        // Warming in the background must not change what lookups return while it runs.
+        VERIFY_ARE_EQUAL(MrmWarmResourceMap(resourceManager, nullptr, nullptr, MrmWarmFlags_Default | MrmWarmFlags_Background), S_OK);
+
+        wchar_t* resourceString;
+        VERIFY_ARE_EQUAL(MrmLoadStringResource(resourceManager, nullptr, nullptr, L"resources/IDS_MANIFEST_MUSIC_APP_NAME", &resourceString), S_OK);
+        VerifyStringEqual(resourceString, L"Groove Music");
+        MrmFreeResource(resourceString);
+
+        // Destroying the resource manager waits for the warm-up to finish.
+        MrmDestroyResourceContext(resourceContext);
+        MrmDestroyResourceManager(resourceManager);
+    }
+
     TEST_METHOD(ReadEmbeddedResourceFromFullUri)
     {
         MrmManagerHandle resourceManager;
@@ -578,6 +723,73 @@ public:
         MrmDestroyResourceManager(resourceManager);
     }
 
+    struct EnumeratedResources
+    {
+        MrmManagerHandle resourceManager;
+        MrmMapHandle resourceMap;
+        UINT32 count;
+        UINT32 stopAfter;
+    };
+
+    static HRESULT CALLBACK VerifyEnumeratedResource(UINT32 index, _In_ PCWSTR resourceName, _In_opt_ void* context)
+    {
+        EnumeratedResources* enumerated = static_cast<EnumeratedResources*>(context);
+        VERIFY_ARE_EQUAL(enumerated->count, index);
+
+        // Resources come back in the same order, and with the same names, as the index-based functions report them.
+        MrmType resourceType;
+        wchar_t* resourceString = nullptr;
+        wchar_t* indexedName = nullptr;
+        MrmResourceData resourceData{};
+        VERIFY_ARE_EQUAL(MrmLoadStringOrEmbeddedResourceByIndex(enumerated->resourceManager, nullptr, enumerated->resourceMap, index, &resourceType, &indexedName, &resourceString, &resourceData), S_OK);
+        VerifyStringEqual(indexedName, resourceName);
+
+        MrmFreeResource(resourceString);
+        MrmFreeResource(resourceData.data);
+        MrmFreeResource(indexedName);
+
+        enumerated->count++;
+        return (enumerated->count == enumerated->stopAfter) ? S_FALSE : S_OK;
+    }
+
+    static HRESULT CALLBACK FailEnumeratedResource(UINT32, _In_ PCWSTR, _In_opt_ void*)
+    {
+        return E_ABORT;
+    }
+
+    TEST_METHOD(EnumerateResourcesWithCallback)
+    {
+        MrmManagerHandle resourceManager;
+        VERIFY_ARE_EQUAL(MrmCreateResourceManager(L".\\resources.pri", &resourceManager), S_OK);
+
+        MrmMapHandle childResourceMap;
+        VERIFY_ARE_EQUAL(MrmGetChildResourceMap(resourceManager, nullptr, L"Microsoft.UI.Xaml", &childResourceMap), S_OK);
+
+        MrmMapHandle childChildResourceMap;
+        VERIFY_ARE_EQUAL(MrmGetChildResourceMap(resourceManager, childResourceMap, L"Resources", &childChildResourceMap), S_OK);
+
+        EnumeratedResources enumerated{ resourceManager, childChildResourceMap, 0, 0 };
+        VERIFY_ARE_EQUAL(MrmEnumerateResources(resourceManager, childChildResourceMap, VerifyEnumeratedResource, &enumerated), S_OK);
+        VERIFY_ARE_EQUAL(enumerated.count, 78u);
+
+        // The primary resource map holds the resources of every child map.
+        UINT32 count;
+        VERIFY_ARE_EQUAL(MrmGetResourceCount(resourceManager, nullptr, &count), S_OK);
+        enumerated = { resourceManager, nullptr, 0, 0 };
+        VERIFY_ARE_EQUAL(MrmEnumerateResources(resourceManager, nullptr, VerifyEnumeratedResource, &enumerated), S_OK);
+        VERIFY_ARE_EQUAL(enumerated.count, count);
+
+        // S_FALSE from the callback ends the enumeration early, and failures are passed back.
+        enumerated = { resourceManager, childChildResourceMap, 0, 3 };
+        VERIFY_ARE_EQUAL(MrmEnumerateResources(resourceManager, childChildResourceMap, VerifyEnumeratedResource, &enumerated), S_OK);
+        VERIFY_ARE_EQUAL(enumerated.count, 3u);
+
+        VERIFY_ARE_EQUAL(MrmEnumerateResources(resourceManager, childChildResourceMap, FailEnumeratedResource, nullptr), E_ABORT);
+        VERIFY_ARE_EQUAL(MrmEnumerateResources(resourceManager, childChildResourceMap, nullptr, nullptr), E_INVALIDARG);
+
+        MrmDestroyResourceManager(resourceManager);
+    }
+
     TEST_METHOD(ReadResourceStringWithQualifierValue)
     {
         MrmManagerHandle resourceManager;
@@ -627,6 +839,100 @@ public:
         MrmDestroyResourceManager(resourceManager);
     }
 
+    TEST_METHOD(ReadResourceStringBatch)
+    {
+        MrmManagerHandle resourceManager;
+        VERIFY_ARE_EQUAL(MrmCreateResourceManager(L".\\resources.pri", &resourceManager), S_OK);
+
+        MrmContextHandle resourceContext;
+        VERIFY_ARE_EQUAL(MrmCreateResourceContext(resourceManager, &resourceContext), S_OK);
+        VERIFY_ARE_EQUAL(MrmSetQualifier(resourceContext, L"Language", L"en-GB"), S_OK);
+
+        PCWSTR resourceIds[] = {
+            L"resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE",
+            L"Microsoft.UI.Xaml/Resources/HelpTextMoreButton",
+            L"resources/IDS_MANIFEST_MUSIC_APP_NAME",
+            L"resources/wrongresource",
+            L"ms-resource:///resources/IDS_MANIFEST_MUSIC_APP_NAME",
+            L"Files/Controls/AlbumBasicInfoControl.xbf",
+        };
+        PWSTR resourceStrings[ARRAYSIZE(resourceIds)];
+        HRESULT results[ARRAYSIZE(resourceIds)];
+
+        VERIFY_ARE_EQUAL(MrmLoadStringResources(resourceManager, resourceContext, nullptr, ARRAYSIZE(resourceIds), resourceIds, resourceStrings, results), S_FALSE);
+
+        VERIFY_ARE_EQUAL(results[0], S_OK);
+        VerifyStringEqual(resourceStrings[0], L"Equaliser");
+        VERIFY_ARE_EQUAL(results[1], S_OK);
+        VerifyStringEqual(resourceStrings[1], L"Invoke to show or hide the text entry fields.");
+        VERIFY_ARE_EQUAL(results[2], S_OK);
+        VerifyStringEqual(resourceStrings[2], L"Groove Music");
+        VERIFY_ARE_EQUAL(results[3], HRESULT_FROM_WIN32(ERROR_MRM_NAMED_RESOURCE_NOT_FOUND));
+        VERIFY_IS_NULL(resourceStrings[3]);
+        VERIFY_ARE_EQUAL(results[4], S_OK);
+        VerifyStringEqual(resourceStrings[4], L"Groove Music");
+        VERIFY_ARE_EQUAL(results[5], HRESULT_FROM_WIN32(ERROR_MRM_RESOURCE_TYPE_MISMATCH));
+        VERIFY_IS_NULL(resourceStrings[5]);
+
+        for (PWSTR resourceString : resourceStrings)
+        {
+            MrmFreeResource(resourceString);
+        }
+
+        // Every result matches the single lookup.
+        PCWSTR validResourceIds[] = { resourceIds[0], resourceIds[1], resourceIds[2] };
+        VERIFY_ARE_EQUAL(MrmLoadStringResources(resourceManager, resourceContext, nullptr, ARRAYSIZE(validResourceIds), validResourceIds, resourceStrings, results), S_OK);
+        for (UINT32 i = 0; i < ARRAYSIZE(validResourceIds); i++)
+        {
+            wchar_t* resourceString;
+            VERIFY_ARE_EQUAL(MrmLoadStringResource(resourceManager, resourceContext, nullptr, validResourceIds[i], &resourceString), S_OK);
+            VerifyStringEqual(resourceString, resourceStrings[i]);
+            MrmFreeResource(resourceString);
+            MrmFreeResource(resourceStrings[i]);
+        }
+
+        MrmDestroyResourceContext(resourceContext);
+        MrmDestroyResourceManager(resourceManager);
+    }
+
+    TEST_METHOD(ReadResourceView)
+    {
+        MrmManagerHandle resourceManager;
+        VERIFY_ARE_EQUAL(MrmCreateResourceManager(L".\\resources.pri", &resourceManager), S_OK);
+
+        PCWSTR resourceView;
+        UINT32 resourceViewLength;
+        VERIFY_ARE_EQUAL(MrmLoadStringResourceView(resourceManager, nullptr, nullptr, L"resources/IDS_MANIFEST_MUSIC_APP_NAME", &resourceView, &resourceViewLength), S_OK);
+        VERIFY_ARE_EQUAL(resourceViewLength, 12u);
+        VERIFY_ARE_EQUAL(0, wcsncmp(resourceView, L"Groove Music", resourceViewLength));
+
+        // The view points into the PRI file, so a second lookup returns the same memory.
+        PCWSTR secondView;
+        VERIFY_ARE_EQUAL(MrmLoadStringResourceView(resourceManager, nullptr, nullptr, L"ms-resource:///resources/IDS_MANIFEST_MUSIC_APP_NAME", &secondView, &resourceViewLength), S_OK);
+        VERIFY_ARE_EQUAL(resourceView, secondView);
+
+        VERIFY_ARE_EQUAL(MrmLoadStringResourceView(resourceManager, nullptr, nullptr, L"resources/wrongresource", &resourceView, &resourceViewLength), HRESULT_FROM_WIN32(ERROR_MRM_NAMED_RESOURCE_NOT_FOUND));
+        VERIFY_ARE_EQUAL(MrmLoadStringResourceView(resourceManager, nullptr, nullptr, L"Files/Controls/AlbumBasicInfoControl.xbf", &resourceView, &resourceViewLength), HRESULT_FROM_WIN32(ERROR_MRM_RESOURCE_TYPE_MISMATCH));
+
+        MrmType resourceType;
+        MrmResourceData resourceData {};
+        VERIFY_ARE_EQUAL(MrmLoadStringOrEmbeddedResourceView(resourceManager, nullptr, nullptr, L"Files/Controls/AlbumBasicInfoControl.xbf", &resourceType, &resourceView, &resourceViewLength, &resourceData), S_OK);
+        VERIFY_IS_TRUE(resourceType == MrmType_Embedded);
+        VERIFY_IS_NULL(resourceView);
+        VERIFY_IS_NOT_NULL(resourceData.data);
+        VERIFY_ARE_EQUAL(resourceData.size, 15002u);
+
+        MrmResourceData copiedData {};
+        VERIFY_ARE_EQUAL(MrmLoadEmbeddedResource(resourceManager, nullptr, nullptr, L"Files/Controls/AlbumBasicInfoControl.xbf", &copiedData), S_OK);
+        VERIFY_ARE_EQUAL(0, memcmp(copiedData.data, resourceData.data, resourceData.size));
+        MrmFreeResource(copiedData.data);
+
+        // File paths get the package root prepended, so they cannot be returned in place.
+        VERIFY_ARE_EQUAL(MrmLoadStringOrEmbeddedResourceView(resourceManager, nullptr, nullptr, L"Files/Assets/AppList.png", &resourceType, &resourceView, &resourceViewLength, &resourceData), HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+
+        MrmDestroyResourceManager(resourceManager);
+    }
+
     TEST_METHOD(InvalidPriName)
     {
         MrmManagerHandle resourceManager;
@@ -677,6 +983,48 @@ public:
         }
     }
 
+    TEST_METHOD(SharedPriFile)
+    {
+        // Both resource managers share the parsed file but keep their own contexts.
+        MrmManagerHandle resourceManager1;
+        VERIFY_ARE_EQUAL(MrmCreateResourceManager(L".\\resources.pri", &resourceManager1), S_OK);
+
+        MrmManagerHandle resourceManager2;
+        VERIFY_ARE_EQUAL(MrmCreateResourceManager(L".\\resources.pri", &resourceManager2), S_OK);
+
+        MrmContextHandle resourceContext1;
+        VERIFY_ARE_EQUAL(MrmCreateResourceContext(resourceManager1, &resourceContext1), S_OK);
+        VERIFY_ARE_EQUAL(MrmSetQualifier(resourceContext1, L"Language", L"en-GB"), S_OK);
+
+        MrmContextHandle resourceContext2;
+        VERIFY_ARE_EQUAL(MrmCreateResourceContext(resourceManager2, &resourceContext2), S_OK);
+        VERIFY_ARE_EQUAL(MrmSetQualifier(resourceContext2, L"Language", L"en-US"), S_OK);
+
+        wchar_t* resourceString;
+        VERIFY_ARE_EQUAL(MrmLoadStringResource(resourceManager1, resourceContext1, nullptr, L"resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE", &resourceString), S_OK);
+        VerifyStringEqual(resourceString, L"Equaliser");
+        MrmFreeResource(resourceString);
+
+        VERIFY_ARE_EQUAL(MrmLoadStringResource(resourceManager2, resourceContext2, nullptr, L"resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE", &resourceString), S_OK);
+        VerifyStringEqual(resourceString, L"Equalizer");
+        MrmFreeResource(resourceString);
+
+        // The second resource manager keeps the shared file alive.
+        MrmDestroyResourceContext(resourceContext1);
+        MrmDestroyResourceManager(resourceManager1);
+
+        VERIFY_ARE_EQUAL(MrmLoadStringResource(resourceManager2, resourceContext2, nullptr, L"resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE", &resourceString), S_OK);
+        VerifyStringEqual(resourceString, L"Equalizer");
+        MrmFreeResource(resourceString);
+
+        VERIFY_ARE_EQUAL(MrmLoadStringResource(resourceManager2, nullptr, nullptr, L"resources/IDS_MANIFEST_MUSIC_APP_NAME", &resourceString), S_OK);
+        VerifyStringEqual(resourceString, L"Groove Music");
+        MrmFreeResource(resourceString);
+
+        MrmDestroyResourceContext(resourceContext2);
+        MrmDestroyResourceManager(resourceManager2);
+    }
+
     TEST_METHOD(GetFilePath)
     {
         wchar_t* path;
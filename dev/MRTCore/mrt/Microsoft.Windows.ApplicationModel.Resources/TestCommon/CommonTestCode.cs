@@ -113,6 +113,19 @@ namespace CommonTestCode
             var fromManager = resourceManager.MainResourceMap.GetValue("resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE").ValueAsString;
             Verify.AreEqual(fromLoader, fromManager);
         }
+
+        public static void GetStringsTest()
+        {
+            var resourceLoader = new ResourceLoader("resources.pri.standalone");
+            var resourceIds = new string[] { "IDS_MANIFEST_MUSIC_APP_NAME", "IDS_DOES_NOT_EXIST", "IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE" };
+            var resources = resourceLoader.GetStrings(resourceIds);
+
+            // A missing ID comes back empty without failing the rest of the batch.
+            Verify.AreEqual(resources.Count, 3);
+            Verify.AreEqual(resources[0], "Groove Music");
+            Verify.AreEqual(resources[1], "");
+            Verify.AreEqual(resources[2], resourceLoader.GetString("IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE"));
+        }
     }
 
     public class ResourceManagerTest
@@ -584,5 +597,65 @@ namespace CommonTestCode
             resourceCandidate = resourceMap.TryGetValue("xyz", resourceContext);
             Verify.IsNull(resourceCandidate);
         }
+
+        public static void DefaultContextTest()
+        {
+            var resourceManager = new ResourceManager("NoSuchFile.pri");
+            var resourceMap = resourceManager.MainResourceMap;
+
+            ResourceContext lastContext = null;
+            resourceManager.ResourceNotFound += (sender, args) =>
+            {
+                lastContext = args.Context;
+                args.SetResolvedCandidate(new ResourceCandidate(ResourceCandidateKind.String, args.Context.QualifierValues[KnownResourceQualifierName.Language]));
+            };
+
+            // Handlers get a context of their own for lookups without one, so changing it can't affect other lookups.
+            resourceMap.GetValue("abc");
+            var handlerContext = lastContext;
+            Verify.IsNotNull(handlerContext);
+            var languages = handlerContext.QualifierValues[KnownResourceQualifierName.Language];
+
+            handlerContext.QualifierValues[KnownResourceQualifierName.Language] = "qps-ploc";
+            var resourceCandidate = resourceMap.GetValue("abc");
+            Verify.IsFalse(Object.ReferenceEquals(handlerContext, lastContext));
+            Verify.AreEqual(resourceCandidate.ValueAsString, languages);
+            resourceCandidate = resourceMap.TryGetValue("abc");
+            Verify.IsFalse(Object.ReferenceEquals(handlerContext, lastContext));
+            Verify.AreEqual(resourceCandidate.ValueAsString, languages);
+
+            // A context the caller passes is handed to the handlers as is.
+            resourceCandidate = resourceMap.GetValue("abc", handlerContext);
+            Verify.IsTrue(Object.ReferenceEquals(handlerContext, lastContext));
+            Verify.AreEqual(resourceCandidate.ValueAsString, "qps-ploc");
+        }
+
+        // Needs package identity to set Windows.Globalization's PrimaryLanguageOverride.
+        public static void DefaultContextLanguageChangeTest()
+        {
+            var originalOverride = Windows.Globalization.ApplicationLanguages.PrimaryLanguageOverride;
+            try
+            {
+                // A manager's default context takes the application languages it starts with.
+                Windows.Globalization.ApplicationLanguages.PrimaryLanguageOverride = "en-GB";
+                var resourceManager = new ResourceManager("resources.pri.standalone");
+                var resourceCandidate = resourceManager.MainResourceMap.GetValue("resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE");
+                Verify.AreEqual(resourceCandidate.ValueAsString, "Equaliser");
+                resourceCandidate = resourceManager.MainResourceMap.GetValue("resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE");
+                Verify.AreEqual(resourceCandidate.ValueAsString, "Equaliser");
+
+                // Setting the override directly on Windows.Globalization isn't watched, so only contexts created
+                // afterwards are guaranteed to see it.
+                Windows.Globalization.ApplicationLanguages.PrimaryLanguageOverride = "en-US";
+                resourceCandidate = resourceManager.MainResourceMap.GetValue("resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE", resourceManager.CreateResourceContext());
+                Verify.AreEqual(resourceCandidate.ValueAsString, "Equalizer");
+                resourceCandidate = new ResourceManager("resources.pri.standalone").MainResourceMap.GetValue("resources/IDS_WHATS_NEW_1710_2_EQUALIZER_TITLE");
+                Verify.AreEqual(resourceCandidate.ValueAsString, "Equalizer");
+            }
+            finally
+            {
+                Windows.Globalization.ApplicationLanguages.PrimaryLanguageOverride = originalOverride;
+            }
+        }
     }
 }
@@ -264,6 +264,18 @@ namespace MrtCoreUnpackagedTests
             CommonTestCode.ResourceLoaderTest.ReturnSameResultAsResourceManager();
         }
 
+        [TestMethod]
+        public void ResourceLoader_GetStringsTest()
+        {
+            if (m_rs5)
+            {
+                // Test doesn't run before 19H1. Make it pass as skipped is treated as failure in Helix.
+                return;
+            }
+
+            CommonTestCode.ResourceLoaderTest.GetStringsTest();
+        }
+
         [TestMethod]
         public void ResourceManager_ValueAsStringTest_StringResource_Succeeds()
         {
@@ -467,5 +479,17 @@ namespace MrtCoreUnpackagedTests
 
             CommonTestCode.ResourceContextTest.NoResourceFileWithContextTest();
         }
+
+        [TestMethod]
+        public void ResourceContext_DefaultContextTest()
+        {
+            if (m_rs5)
+            {
+                // Test doesn't run before 19H1. Make it pass as skipped is treated as failure in Helix.
+                return;
+            }
+
+            CommonTestCode.ResourceContextTest.DefaultContextTest();
+        }
     }
 }
\ No newline at end of file
@@ -10,6 +10,27 @@
 
 #include <AppModel.Identity.h>
 
+namespace
+{
+    std::atomic<uint32_t> g_languagesGeneration{ 0 };
+    std::once_flag g_languagesWatchInitialized;
+    std::atomic<bool> g_languagesWatchFailed{ false };
+    wil::unique_hkey g_internationalKey;
+    wil::unique_event_nothrow g_languagesChanged;
+
+    // The user's language list lives under Control Panel\International. The notification is one-shot, so it's
+    // re-armed each time it fires.
+    bool WatchLanguageSettings()
+    {
+        return RegNotifyChangeKeyValue(
+            g_internationalKey.get(),
+            TRUE,
+            REG_NOTIFY_CHANGE_LAST_SET | REG_NOTIFY_THREAD_AGNOSTIC,
+            g_languagesChanged.get(),
+            TRUE) == ERROR_SUCCESS;
+    }
+}
+
 namespace winrt::Microsoft::Windows::Globalization::implementation
 {
     hstring ApplicationLanguages::m_language;
@@ -52,5 +73,38 @@ namespace winrt::Microsoft::Windows::Globalization::implementation
         {
             winrt::Windows::Globalization::ApplicationLanguages::PrimaryLanguageOverride(language);
         }
+
+        g_languagesGeneration++;
+    }
+
+    uint32_t ApplicationLanguages::LanguagesGeneration()
+    {
+        // Setting Windows.Globalization's PrimaryLanguageOverride directly, rather than through this class, isn't
+        // seen here.
+        std::call_once(g_languagesWatchInitialized, [] {
+            if ((RegOpenKeyExW(HKEY_CURRENT_USER, L"Control Panel\\International", 0, KEY_NOTIFY, g_internationalKey.put()) != ERROR_SUCCESS) ||
+                FAILED(g_languagesChanged.create()) ||
+                !WatchLanguageSettings())
+            {
+                g_languagesWatchFailed = true;
+            }
+        });
+
+        if (g_languagesWatchFailed)
+        {
+            // Without the notification, nothing derived from Languages() can be kept.
+            return ++g_languagesGeneration;
+        }
+
+        // The event resets when the wait succeeds, so only one thread re-arms the notification.
+        if (WaitForSingleObject(g_languagesChanged.get(), 0) == WAIT_OBJECT_0)
+        {
+            if (!WatchLanguageSettings())
+            {
+                g_languagesWatchFailed = true;
+            }
+            g_languagesGeneration++;
+        }
+        return g_languagesGeneration;
     }
 } // namespace winrt::Microsoft::Windows::Globalization::implementation
@@ -15,6 +15,10 @@ namespace winrt::Microsoft::Windows::Globalization::implementation
         static hstring PrimaryLanguageOverride();
         static void PrimaryLanguageOverride(hstring const& language);
 
+        // Changes whenever the user's language settings or PrimaryLanguageOverride may have changed, so
+        // callers can keep values derived from Languages() until it does.
+        static uint32_t LanguagesGeneration();
+
     private:
         static hstring m_language;
         static wil::srwlock m_lock;
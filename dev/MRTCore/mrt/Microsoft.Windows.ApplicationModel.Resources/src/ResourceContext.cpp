@@ -47,7 +47,8 @@ void ResourceContext::InitializeQualifierValueMap()
     std::call_once(m_areQualifierNamesAndValueMapInitialized, [this] {
         InitializeQualifierNames();
 
-        m_qualifierValueMap = single_threaded_map<hstring, hstring>();
+        auto qualifierValueMap = single_threaded_observable_map<hstring, hstring>();
+        m_qualifierValueMap = qualifierValueMap;
 
         if (m_resourceContext != nullptr)
         {
@@ -74,6 +75,14 @@ void ResourceContext::InitializeQualifierValueMap()
         {
             m_qualifierValueMap.Insert(c_languageQualifierName, GetLangugageContext());
         }
+
+        // The map is handed out by QualifierValues() and may outlive us.
+        qualifierValueMap.MapChanged([weakThis = get_weak()](auto&&, auto&&) {
+            if (auto strongThis = weakThis.get())
+            {
+                strongThis->m_qualifierValuesGeneration++;
+            }
+        });
     });
 }
 
@@ -94,6 +103,19 @@ void ResourceContext::Apply()
 
     InitializeQualifierValueMap();
 
+    // Every lookup applies the context, so skip it when nothing changed since the last time.
+    // Re-setting the same values is cheap in MRM, but it still takes the resolver's locks.
+    uint32_t generation = m_qualifierValuesGeneration.load();
+    hstring languageOverride = ApplicationLanguages::PrimaryLanguageOverride();
+    {
+        auto lock = m_applyLock.lock_shared();
+        if ((generation == m_appliedGeneration) && (languageOverride == m_appliedLanguageOverride))
+        {
+            return;
+        }
+    }
+
+    auto lock = m_applyLock.lock_exclusive();
     for (auto const& eachValue : m_qualifierValueMap)
     {
         if (!eachValue.Value().empty())
@@ -101,10 +123,13 @@ void ResourceContext::Apply()
             winrt::check_hresult(MrmSetQualifier(m_resourceContext, eachValue.Key().c_str(), eachValue.Value().c_str()));
         }
     }
-    if (!ApplicationLanguages::PrimaryLanguageOverride().empty())
+    if (!languageOverride.empty())
     {
-        winrt::check_hresult(MrmSetQualifier(m_resourceContext, c_languageQualifierName, ApplicationLanguages::PrimaryLanguageOverride().c_str()));
+        winrt::check_hresult(MrmSetQualifier(m_resourceContext, c_languageQualifierName, languageOverride.c_str()));
     }
+
+    m_appliedGeneration = generation;
+    m_appliedLanguageOverride = languageOverride;
 }
 
 hstring ResourceContext::GetLangugageContext()
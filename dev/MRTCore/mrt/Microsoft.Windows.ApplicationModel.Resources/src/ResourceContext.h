@@ -27,6 +27,12 @@ private:
     MrmContextHandle m_resourceContext = nullptr;
     com_array<hstring> m_qualifierNames;
     winrt::Windows::Foundation::Collections::IMap<hstring, hstring> m_qualifierValueMap = nullptr;
+
+    // Bumped on every change to m_qualifierValueMap, so Apply() can skip pushing values it already pushed.
+    std::atomic<uint32_t> m_qualifierValuesGeneration{ 1 };
+    wil::srwlock m_applyLock;
+    uint32_t m_appliedGeneration = 0;
+    hstring m_appliedLanguageOverride;
 };
 
 } // namespace winrt::Microsoft::Windows::ApplicationModel::Resources::implementation
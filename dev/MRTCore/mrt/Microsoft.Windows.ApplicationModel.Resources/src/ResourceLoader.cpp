@@ -48,8 +48,19 @@ hstring ResourceLoader::GetDefaultResourceFilePath()
 
 hstring ResourceLoader::GetString(hstring const& resourceId)
 {
-    wchar_t* resourceString;
     auto contextHandle = m_defaultContext.as<Resources::implementation::ResourceContext>()->GetContextHandle();
+
+    // Try to copy straight out of the PRI file first. Values that cannot be referenced in place fall back to the copying API.
+    PCWSTR resourceView;
+    UINT32 resourceViewLength;
+    HRESULT hr = MrmLoadStringResourceView(m_resourceManager, contextHandle, m_currentResourceMap, resourceId.c_str(), &resourceView, &resourceViewLength);
+    if (hr != HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED))
+    {
+        winrt::check_hresult(hr);
+        return hstring(resourceView, resourceViewLength);
+    }
+
+    wchar_t* resourceString;
     winrt::check_hresult(MrmLoadStringResource(m_resourceManager, contextHandle, m_currentResourceMap, resourceId.c_str(), &resourceString));
 
     string_resoure_ptr resourceContainer(resourceString);
@@ -66,6 +77,48 @@ hstring ResourceLoader::GetStringForUri(winrt::Windows::Foundation::Uri const& r
     return winrt::to_hstring(resourceContainer.get());
 }
 
+winrt::Windows::Foundation::Collections::IVectorView<hstring> ResourceLoader::GetStrings(
+    winrt::Windows::Foundation::Collections::IVectorView<hstring> const& resourceIds)
+{
+    uint32_t count = resourceIds.Size();
+
+    std::vector<hstring> ids(count);
+    resourceIds.GetMany(0, ids);
+
+    std::vector<PCWSTR> idPointers(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        idPointers[i] = ids[i].c_str();
+    }
+
+    std::vector<PWSTR> resourceStrings(count);
+    std::vector<HRESULT> results(count);
+    auto contextHandle = m_defaultContext.as<Resources::implementation::ResourceContext>()->GetContextHandle();
+    HRESULT hr = MrmLoadStringResources(
+        m_resourceManager, contextHandle, m_currentResourceMap, count, idPointers.data(), resourceStrings.data(), results.data());
+
+    // Take ownership of everything that was returned before reporting any failure.
+    std::vector<string_resoure_ptr> resourceContainers;
+    resourceContainers.reserve(count);
+    for (PWSTR resourceString : resourceStrings)
+    {
+        resourceContainers.emplace_back(resourceString);
+    }
+
+    // Only a failure of the batch as a whole throws. An ID that can't be loaded gets an empty string, so one
+    // missing resource doesn't cost the caller every other result.
+    winrt::check_hresult(hr);
+
+    std::vector<hstring> strings;
+    strings.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        strings.emplace_back(SUCCEEDED(results[i]) ? hstring(resourceContainers[i].get()) : hstring());
+    }
+
+    return winrt::single_threaded_vector<hstring>(std::move(strings)).GetView();
+}
+
 void ResourceLoader::SetDefaultContext()
 {
     MrmContextHandle contextHandle = nullptr;
@@ -20,6 +20,8 @@ struct ResourceLoader : ResourceLoaderT<ResourceLoader>
 
     hstring GetString(hstring const& resourceId);
     hstring GetStringForUri(winrt::Windows::Foundation::Uri const& resourceUri);
+    winrt::Windows::Foundation::Collections::IVectorView<hstring> GetStrings(
+        winrt::Windows::Foundation::Collections::IVectorView<hstring> const& resourceIds);
 
 private:
     ~ResourceLoader();
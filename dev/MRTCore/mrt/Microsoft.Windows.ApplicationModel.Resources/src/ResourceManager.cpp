@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "pch.h"
+#include "ApplicationLanguages.h"
 #include "Helper.h"
 #include "ResourceCandidate.h"
 #include "ResourceContext.h"
@@ -34,7 +35,11 @@ ResourceManager::ResourceManager(hstring const& fileName)
     }
 }
 
-ResourceManager::~ResourceManager() { MrmDestroyResourceManager(m_resourceManagerHandle); }
+ResourceManager::~ResourceManager()
+{
+    m_defaultContext = nullptr;
+    MrmDestroyResourceManager(m_resourceManagerHandle);
+}
 
 Microsoft::Windows::ApplicationModel::Resources::ResourceMap ResourceManager::MainResourceMap()
 {
@@ -52,6 +57,25 @@ Microsoft::Windows::ApplicationModel::Resources::ResourceContext ResourceManager
     return winrt::make<ResourceContext>(contextHandle);
 }
 
+Microsoft::Windows::ApplicationModel::Resources::ResourceContext ResourceManager::GetDefaultResourceContext()
+{
+    // A new context takes its Language value from the application languages, or the display language
+    // without them, so the shared context is only as good as the language settings it was created with.
+    // The other qualifiers come from fixed providers and don't change for the process, and the
+    // Microsoft.Windows.Globalization override is re-checked by Apply().
+    // Read the generation first, so a change while the context is created replaces it on the next call.
+    uint32_t languagesGeneration = winrt::Microsoft::Windows::Globalization::implementation::ApplicationLanguages::LanguagesGeneration();
+
+    slim_lock_guard const guard {m_defaultContextLock};
+    if ((m_defaultContext == nullptr) || (languagesGeneration != m_defaultContextLanguagesGeneration))
+    {
+        m_defaultContext = CreateResourceContext();
+        m_defaultContextLanguagesGeneration = languagesGeneration;
+    }
+
+    return m_defaultContext;
+}
+
 winrt::event_token ResourceManager::ResourceNotFound(winrt::Windows::Foundation::TypedEventHandler<
                                                      Microsoft::Windows::ApplicationModel::Resources::ResourceManager,
                                                      Microsoft::Windows::ApplicationModel::Resources::ResourceNotFoundEventArgs> const& handler)
@@ -70,6 +94,18 @@ Microsoft::Windows::ApplicationModel::Resources::ResourceCandidate ResourceManag
     Microsoft::Windows::ApplicationModel::Resources::ResourceContext context,
     hstring name)
 {
+    if (!m_resourceNotFound)
+    {
+        return nullptr;
+    }
+
+    // Handlers can change the context they're given, so they never get the shared one that other threads
+    // are resolving through.
+    if (context == nullptr)
+    {
+        context = CreateResourceContext();
+    }
+
     Microsoft::Windows::ApplicationModel::Resources::ResourceNotFoundEventArgs args = winrt::make<ResourceNotFoundEventArgs>(context, name);
     m_resourceNotFound(*this, args);
     Microsoft::Windows::ApplicationModel::Resources::ResourceCandidate candidate = args.as<ResourceNotFoundEventArgs>()->GetResolvedCandidate();
@@ -21,15 +21,24 @@ struct ResourceManager : ResourceManagerT<ResourceManager>
 
     void ResourceNotFound(winrt::event_token const& token) noexcept;
 
+    // A null context means the lookup used the shared default context, which handlers don't get to see.
     Microsoft::Windows::ApplicationModel::Resources::ResourceCandidate HandleResourceNotFound(
         Microsoft::Windows::ApplicationModel::Resources::ResourceContext context,
         hstring name);
 
+    // Shared context for lookups that don't pass one. Never handed out, and replaced when the application
+    // languages may have changed.
+    Microsoft::Windows::ApplicationModel::Resources::ResourceContext GetDefaultResourceContext();
+
 private:
     ~ResourceManager();
     MrmManagerHandle m_resourceManagerHandle = nullptr;
     slim_mutex m_lock;
 
+    slim_mutex m_defaultContextLock;
+    Microsoft::Windows::ApplicationModel::Resources::ResourceContext m_defaultContext {nullptr};
+    uint32_t m_defaultContextLanguagesGeneration = 0;
+
     winrt::event<winrt::Windows::Foundation::TypedEventHandler<
         Microsoft::Windows::ApplicationModel::Resources::ResourceManager,
         Microsoft::Windows::ApplicationModel::Resources::ResourceNotFoundEventArgs>>
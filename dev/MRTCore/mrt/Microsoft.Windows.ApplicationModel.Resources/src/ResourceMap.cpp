@@ -56,13 +56,16 @@ Resources::ResourceMap ResourceMap::TryGetSubtree(hstring const& reference)
 
 Resources::ResourceCandidate ResourceMap::GetValueImpl(const Resources::ResourceContext* context, hstring const& resource, bool treatNotFoundAsOk)
 {
-    // Always use a context as we override the languages.
-    Resources::ResourceContext resourceContext = (context != nullptr) ? *context : m_resourceManager.CreateResourceContext();
+    // Always use a context as we override the languages. Context-less lookups share the manager's default context
+    // rather than paying for a new MRM context each time.
+    Resources::ResourceContext resourceContext =
+        (context != nullptr) ? *context : m_resourceManager.as<ResourceManager>()->GetDefaultResourceContext();
 
     if (m_resourceManagerHandle == nullptr)
     {
         // Resource is not managed by MRT. Handle with event handler
-        Resources::ResourceCandidate candidate = m_resourceManager.as<ResourceManager>()->HandleResourceNotFound(resourceContext, resource);
+        Resources::ResourceCandidate candidate =
+            m_resourceManager.as<ResourceManager>()->HandleResourceNotFound((context != nullptr) ? *context : Resources::ResourceContext{ nullptr }, resource);
         if (candidate != nullptr)
         {
             return candidate;
@@ -76,22 +79,71 @@ Resources::ResourceCandidate ResourceMap::GetValueImpl(const Resources::Resource
     }
 
     resourceContext.as<Resources::implementation::ResourceContext>()->Apply();
+    auto contextHandle = resourceContext.as<Resources::implementation::ResourceContext>()->GetContextHandle();
 
     MrmType resourceType;
-    wchar_t* resourceString;
+    PCWSTR resourceView;
+    UINT32 resourceViewLength;
     MrmResourceData resourceData {};
 
-    HRESULT hr = MrmLoadStringOrEmbeddedResource(
+    // The candidate copies the value anyway, so copy it straight out of the PRI file when the value can be referenced in place.
+    HRESULT hr = MrmLoadStringOrEmbeddedResourceView(
         m_resourceManagerHandle,
-        resourceContext.as<Resources::implementation::ResourceContext>()->GetContextHandle(),
+        contextHandle,
         m_resourceMapHandle,
         resource.c_str(),
         &resourceType,
-        &resourceString,
+        &resourceView,
+        &resourceViewLength,
         &resourceData);
+    if (SUCCEEDED(hr))
+    {
+        switch (resourceType)
+        {
+        case MrmType_Embedded:
+        {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(resourceData.data);
+            return winrt::make<ResourceCandidate>(
+                m_resourceManagerHandle,
+                resourceContext,
+                m_resourceMapHandle,
+                static_cast<uint32_t>(-1),
+                resource,
+                winrt::array_view<uint8_t const>(bytes, bytes + resourceData.size));
+        }
+        case MrmType_String:
+        case MrmType_Path:
+        {
+            return winrt::make<ResourceCandidate>(
+                m_resourceManagerHandle,
+                resourceContext,
+                m_resourceMapHandle,
+                static_cast<uint32_t>(-1),
+                resource,
+                (resourceType == MrmType_String) ? ResourceCandidateKind::String : ResourceCandidateKind::FilePath,
+                hstring(resourceView, resourceViewLength));
+        }
+        }
+        // Should never happen.
+        winrt::throw_hresult(E_UNEXPECTED);
+    }
+
+    wchar_t* resourceString;
+    if (hr == HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED))
+    {
+        hr = MrmLoadStringOrEmbeddedResource(
+            m_resourceManagerHandle,
+            contextHandle,
+            m_resourceMapHandle,
+            resource.c_str(),
+            &resourceType,
+            &resourceString,
+            &resourceData);
+    }
     if (IsResourceNotFound(hr))
     {
-        Resources::ResourceCandidate candidate = m_resourceManager.as<ResourceManager>()->HandleResourceNotFound(resourceContext, resource);
+        Resources::ResourceCandidate candidate =
+            m_resourceManager.as<ResourceManager>()->HandleResourceNotFound((context != nullptr) ? *context : Resources::ResourceContext{ nullptr }, resource);
         if (candidate != nullptr)
         {
             return candidate;
@@ -172,7 +224,7 @@ IKeyValuePair<hstring, Resources::ResourceCandidate> ResourceMap::GetValueByInde
 {
     // Always use a context as we override the languages.
     Microsoft::Windows::ApplicationModel::Resources::ResourceContext resourceContext =
-        (context != nullptr) ? *context : m_resourceManager.CreateResourceContext();
+        (context != nullptr) ? *context : m_resourceManager.as<ResourceManager>()->GetDefaultResourceContext();
 
     resourceContext.as<Resources::implementation::ResourceContext>()->Apply();
 
@@ -48,6 +48,12 @@ namespace ManagedTest
         {
             CommonTestCode.ResourceLoaderTest.ReturnSameResultAsResourceManager();
         }
+
+        [TestMethod]
+        public void GetStringsTest()
+        {
+            CommonTestCode.ResourceLoaderTest.GetStringsTest();
+        }
     }
 
     [TestClass]
@@ -164,5 +170,17 @@ namespace ManagedTest
         {
             CommonTestCode.ResourceContextTest.NoResourceFileWithContextTest();
         }
+
+        [TestMethod]
+        public void DefaultContextTest()
+        {
+            CommonTestCode.ResourceContextTest.DefaultContextTest();
+        }
+
+        [TestMethod]
+        public void DefaultContextLanguageChangeTest()
+        {
+            CommonTestCode.ResourceContextTest.DefaultContextLanguageChangeTest();
+        }
     }
 }
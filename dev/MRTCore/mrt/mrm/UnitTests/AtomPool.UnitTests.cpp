@@ -162,6 +162,19 @@ class FileAtomPoolUnitTests : public WEX::TestClass<FileAtomPoolUnitTests>, publ
     BEGIN_TEST_METHOD(BigPoolBuilderReaderTests)
         TEST_METHOD_PROPERTY(L"DataSource", L"Table:AtomPool.UnitTests.xml#BigAtomPoolTests")
     END_TEST_METHOD()
+
+    TEST_METHOD(StrongHashTests);
+
+    BEGIN_TEST_METHOD(LegacyHashLayoutTests)
+        TEST_METHOD_PROPERTY(L"DataSource", L"Table:AtomPool.UnitTests.xml#SimpleAtomPoolTests")
+    END_TEST_METHOD()
+
+    BEGIN_TEST_METHOD(HashMethodBenchmark)
+        TEST_METHOD_PROPERTY(L"DataSource", L"Table:AtomPool.UnitTests.xml#AtomPoolHashBenchmark")
+    END_TEST_METHOD()
+
+    static int CountHashCollisions(__in_ecount(numHashes) Atom::Hash* pHashes, int numHashes);
+    static double TimeLookups(__in const FileAtomPool* pPool, int numAtoms, int numPasses);
 };
 
 void FileAtomPoolUnitTests::New_ParamChecks(void)
@@ -519,6 +532,211 @@ void FileAtomPoolUnitTests::BigPoolBuilderReaderTests(void)
     delete pBuilder;
 }
 
+void FileAtomPoolUnitTests::StrongHashTests(void)
+{
+    // case-folding must not depend on whether a block takes the ASCII fast path
+    VERIFY_ARE_EQUAL(
+        Atom::HashString(L"Files/Images/Logo.PNG", Atom::HashMethodStrongCaseInsensitive),
+        Atom::HashString(L"files/images/logo.png", Atom::HashMethodStrongCaseInsensitive));
+    VERIFY_ARE_EQUAL(
+        Atom::HashString(L"\u00E9COLE/Stra\u00DFe", Atom::HashMethodStrongCaseInsensitive),
+        Atom::HashString(L"\u00E9cole/stra\u00DFE", Atom::HashMethodStrongCaseInsensitive));
+    VERIFY_ARE_NOT_EQUAL(
+        Atom::HashString(L"Files/Images/Logo.PNG", Atom::HashMethodStrong),
+        Atom::HashString(L"files/images/logo.png", Atom::HashMethodStrong));
+
+    // '@' and '[' bracket 'A'..'Z' and must not be folded
+    VERIFY_ARE_NOT_EQUAL(Atom::HashString(L"@@@@", Atom::HashMethodStrongCaseInsensitive), Atom::HashString(L"````", Atom::HashMethodStrongCaseInsensitive));
+    VERIFY_ARE_NOT_EQUAL(Atom::HashString(L"[[[[", Atom::HashMethodStrongCaseInsensitive), Atom::HashString(L"{{{{", Atom::HashMethodStrongCaseInsensitive));
+
+    // length is mixed in, so trailing characters in a partial block count
+    VERIFY_ARE_NOT_EQUAL(Atom::HashString(L"abcd", Atom::HashMethodStrong), Atom::HashString(L"abcd\x0001", Atom::HashMethodStrong));
+
+    // the legacy method is unchanged
+    VERIFY_ARE_EQUAL(Atom::HashString(L"A", Atom::HashMethodDefault), static_cast<Atom::Hash>((0x3482 << 1) ^ L'A'));
+}
+
+void FileAtomPoolUnitTests::LegacyHashLayoutTests(void)
+{
+    FileAtomPoolBuilder* pBuilder;
+    FileAtomPool* pReader = NULL;
+    Atom atom;
+
+    int poolIndex = 0;
+    bool bIsCaseInsensitive;
+    TestDataArray<String> specs;
+
+    if (!GetTestSetup(bIsCaseInsensitive, poolIndex, specs))
+    {
+        Log::Error(L"Couldn't initialize test");
+        return;
+    }
+
+    VERIFY_SUCCEEDED(FileAtomPoolBuilder::CreateInstance(L"Test", bIsCaseInsensitive, &pBuilder));
+    pBuilder->SetPoolIndex(poolIndex);
+
+    String key;
+    int index = 0;
+    for (size_t i = 0; i < specs.GetSize(); i++)
+    {
+        VERIFY_IS_TRUE(ParseAtomSpec(specs[i], key, index));
+        VERIFY_SUCCEEDED(pBuilder->GetOrAddAtom(key, &atom));
+    }
+
+    BuildHelper pool;
+    VERIFY_SUCCEEDED(pool.Build(pBuilder));
+
+    VERIFY_SUCCEEDED(FileAtomPool::CreateInstance(pool.GetBuffer(), pool.GetBufferSize(), &pReader));
+    VERIFY_IS_TRUE(pReader->GetHasOpenHashTable());
+    CheckAtomPoolGetMethods(pReader);
+    CheckUnexpectedStrings(pReader);
+    delete pReader;
+    pReader = NULL;
+
+    // The hashes array still uses the legacy method, so a pool without the open-addressed
+    // table (i.e. one written before it existed) must be found through it.
+    DEFFILE_ATOMPOOL_HEADER* pHdr = reinterpret_cast<DEFFILE_ATOMPOOL_HEADER*>(pool.GetBuffer());
+    VERIFY_IS_TRUE((pHdr->flags & DEFFILE_ATOMPOOL_HASH_OPEN_ADDRESSED) != 0);
+    pHdr->flags &= ~DEFFILE_ATOMPOOL_HASH_OPEN_ADDRESSED;
+
+    const DEFFILE_ATOMPOOL_HASHINDEX* pHashes = reinterpret_cast<const DEFFILE_ATOMPOOL_HASHINDEX*>(pHdr + 1);
+    Atom::HashMethod legacyMethod = (bIsCaseInsensitive ? Atom::HashMethodCaseInsensitive : Atom::HashMethodDefault);
+    StringResult str;
+    for (int i = 0; i < pHdr->nAtoms; i++)
+    {
+        VERIFY_IS_TRUE(pBuilder->TryGetString(pHashes[i].index, &str));
+        VERIFY_ARE_EQUAL(Atom::HashString(str.GetRef(), legacyMethod), pHashes[i].hash);
+    }
+
+    VERIFY_SUCCEEDED(FileAtomPool::CreateInstance(pool.GetBuffer(), pool.GetBufferSize(), &pReader));
+    VERIFY_IS_FALSE(pReader->GetHasOpenHashTable());
+    CheckAtomPoolGetMethods(pReader);
+    CheckUnexpectedStrings(pReader);
+
+    delete pReader;
+    delete pBuilder;
+}
+
+int FileAtomPoolUnitTests::CountHashCollisions(__in_ecount(numHashes) Atom::Hash* pHashes, int numHashes)
+{
+    qsort(pHashes, numHashes, sizeof(Atom::Hash), [](const void* a, const void* b) {
+        Atom::Hash h1 = *static_cast<const Atom::Hash*>(a);
+        Atom::Hash h2 = *static_cast<const Atom::Hash*>(b);
+        return (h1 < h2) ? -1 : ((h1 > h2) ? 1 : 0);
+    });
+
+    int collisions = 0;
+    for (int i = 1; i < numHashes; i++)
+    {
+        if (pHashes[i] == pHashes[i - 1])
+        {
+            collisions++;
+        }
+    }
+    return collisions;
+}
+
+double FileAtomPoolUnitTests::TimeLookups(__in const FileAtomPool* pPool, int numAtoms, int numPasses)
+{
+    LARGE_INTEGER frequency, start, end;
+    WCHAR buf[100];
+    Atom atom;
+    int misses = 0;
+
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+    for (int pass = 0; pass < numPasses; pass++)
+    {
+        for (int i = 0; i < numAtoms; i++)
+        {
+            (void)StringCchPrintf(buf, _countof(buf), L"Atom%d", i);
+            if (!pPool->TryGetAtom(buf, &atom) || (atom.GetIndex() != i))
+            {
+                misses++;
+            }
+        }
+    }
+    QueryPerformanceCounter(&end);
+
+    VERIFY_ARE_EQUAL(0, misses);
+    return ((end.QuadPart - start.QuadPart) * 1000.0) / frequency.QuadPart;
+}
+
+void FileAtomPoolUnitTests::HashMethodBenchmark(void)
+{
+    FileAtomPoolBuilder* pBuilder = NULL;
+    FileAtomPool* pOpenReader = NULL;
+    FileAtomPool* pLegacyReader = NULL;
+    bool bIsCaseInsensitive;
+    int numAtoms;
+    int numPasses;
+    WCHAR buf[100];
+    Atom atom;
+
+    if (FAILED(TestData::TryGetValue(L"IsCaseInsensitive", bIsCaseInsensitive)) || FAILED(TestData::TryGetValue(L"NumAtoms", numAtoms)) ||
+        FAILED(TestData::TryGetValue(L"LookupPasses", numPasses)))
+    {
+        Log::Error(L"Couldn't load test data");
+        return;
+    }
+
+    VERIFY_SUCCEEDED(FileAtomPoolBuilder::CreateInstance(L"Benchmark", bIsCaseInsensitive, &pBuilder));
+    pBuilder->SetPoolIndex(1);
+
+    Atom::Hash* pLegacyHashes = _DefArray_AllocZeroed(Atom::Hash, numAtoms);
+    Atom::Hash* pStrongHashes = _DefArray_AllocZeroed(Atom::Hash, numAtoms);
+    VERIFY_IS_NOT_NULL(pLegacyHashes);
+    VERIFY_IS_NOT_NULL(pStrongHashes);
+
+    Atom::HashMethod legacyMethod = (bIsCaseInsensitive ? Atom::HashMethodCaseInsensitive : Atom::HashMethodDefault);
+    Atom::HashMethod strongMethod = (bIsCaseInsensitive ? Atom::HashMethodStrongCaseInsensitive : Atom::HashMethodStrong);
+    for (int i = 0; i < numAtoms; i++)
+    {
+        VERIFY_SUCCEEDED(StringCchPrintf(buf, _countof(buf), L"Atom%d", i));
+        VERIFY_SUCCEEDED(pBuilder->GetOrAddAtom(buf, &atom));
+        pLegacyHashes[i] = Atom::HashString(buf, legacyMethod);
+        pStrongHashes[i] = Atom::HashString(buf, strongMethod);
+    }
+
+    int legacyCollisions = CountHashCollisions(pLegacyHashes, numAtoms);
+    int strongCollisions = CountHashCollisions(pStrongHashes, numAtoms);
+    Def_Free(pLegacyHashes);
+    Def_Free(pStrongHashes);
+
+    BuildHelper openPool;
+    VERIFY_SUCCEEDED(openPool.Build(pBuilder));
+    VERIFY_SUCCEEDED(FileAtomPool::CreateInstance(openPool.GetBuffer(), openPool.GetBufferSize(), &pOpenReader));
+    VERIFY_IS_TRUE(pOpenReader->GetHasOpenHashTable());
+
+    // Same data without the table is what existing files look like.
+    BuildHelper legacyPool;
+    VERIFY_SUCCEEDED(legacyPool.Build(pBuilder));
+    reinterpret_cast<DEFFILE_ATOMPOOL_HEADER*>(legacyPool.GetBuffer())->flags &= ~DEFFILE_ATOMPOOL_HASH_OPEN_ADDRESSED;
+    VERIFY_SUCCEEDED(FileAtomPool::CreateInstance(legacyPool.GetBuffer(), legacyPool.GetBufferSize(), &pLegacyReader));
+    VERIFY_IS_FALSE(pLegacyReader->GetHasOpenHashTable());
+
+    double openMs = TimeLookups(pOpenReader, numAtoms, numPasses);
+    double legacyMs = TimeLookups(pLegacyReader, numAtoms, numPasses);
+
+    String logmsg;
+    logmsg.Format(L"%d atoms: legacy hash %d collisions, strong hash %d collisions", numAtoms, legacyCollisions, strongCollisions);
+    Log::Comment(logmsg);
+    logmsg.Format(L"%d lookups: legacy %.3f ms, open-addressed %.3f ms", numAtoms * numPasses, legacyMs, openMs);
+    Log::Comment(logmsg);
+    const DEFFILE_ATOMPOOL_HEADER* pHdr = reinterpret_cast<const DEFFILE_ATOMPOOL_HEADER*>(openPool.GetBuffer());
+    logmsg.Format(
+        L"Pool size: legacy %u bytes, open-addressed %u bytes",
+        FileAtomPool::GetSizeInBytes(pHdr->nAtoms, pHdr->cchPool),
+        FileAtomPool::GetSizeInBytes(pHdr));
+    Log::Comment(logmsg);
+
+    VERIFY_IS_TRUE(strongCollisions <= legacyCollisions);
+
+    delete pOpenReader;
+    delete pLegacyReader;
+    delete pBuilder;
+}
+
 /*!
      * StaticAtomPool Unit Tests
      */
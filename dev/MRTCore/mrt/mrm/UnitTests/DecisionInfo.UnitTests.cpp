@@ -40,6 +40,10 @@ public:
         TEST_METHOD_PROPERTY(L"DataSource", L"Table:DecisionInfo.UnitTests.xml#SimpleBuilderTests")
     END_TEST_METHOD();
 
+    BEGIN_TEST_METHOD(FlatViewTests)
+        TEST_METHOD_PROPERTY(L"DataSource", L"Table:DecisionInfo.UnitTests.xml#SimpleBuilderTests")
+    END_TEST_METHOD();
+
     BEGIN_TEST_METHOD(DecisionInfoMergeTests)
         TEST_METHOD_PROPERTY(L"DataSource", L"Table:DecisionInfo.UnitTests.xml#MergeTests")
     END_TEST_METHOD();
@@ -166,6 +170,90 @@ void DecisionInfoUnitTests::SimpleBuilderReaderTests()
     validate.ValidateDecisions(pReader, pEnvironment);
 }
 
+void DecisionInfoUnitTests::FlatViewTests()
+{
+    TestHPri pri;
+    TestDecisionInfo decisionInfo;
+
+    AutoDeletePtr<CoreProfile> pProfile;
+    VERIFY_SUCCEEDED(CoreProfile::ChooseDefaultProfile(&pProfile));
+    VERIFY_SUCCEEDED(pri.Init(pProfile));
+
+    if (FAILED(decisionInfo.InitDataFromTestVars(L"")))
+    {
+        Log::Error(L"[ Couldn't load test data ]");
+        return;
+    }
+
+    const UnifiedEnvironment* pEnvironment = pri.GetPriSectionBuilder()->GetEnvironment();
+    AutoDeletePtr<DecisionInfoSectionBuilder> pBuilder;
+    VERIFY_SUCCEEDED(DecisionInfoSectionBuilder::CreateInstance(pri.GetFileBuilder(), pEnvironment, &pBuilder));
+    VERIFY_SUCCEEDED(decisionInfo.ApplyTestData(pBuilder));
+
+    BuildHelper build;
+    VERIFY_SUCCEEDED(build.Build(pBuilder));
+
+    AutoDeletePtr<DecisionInfoFileSection> pReader;
+    VERIFY_SUCCEEDED(DecisionInfoFileSection::CreateInstance(build.GetBuffer(), build.GetWrittenSize(), nullptr, &pReader));
+
+    // Builders don't keep a flat view, only file sections do.
+    VERIFY_IS_NULL(pBuilder->GetFlatView());
+
+    const DecisionInfoFlatView* pFlat = pReader->GetFlatView();
+    VERIFY_IS_NOT_NULL(pFlat);
+    VERIFY_ARE_EQUAL(pReader->GetNumQualifiers(), pFlat->numQualifiers);
+    VERIFY_ARE_EQUAL(pReader->GetNumQualifierSets(), pFlat->numQualifierSets);
+    VERIFY_ARE_EQUAL(pReader->GetNumDecisions(), pFlat->numDecisions);
+
+    // Every entry in the flat view has to agree with the wrappers.
+    for (int i = 0; i < pFlat->numQualifiers; i++)
+    {
+        QualifierResult qualifier;
+        Atom attribute;
+        VERIFY_SUCCEEDED(pReader->GetQualifier(i, &qualifier));
+        VERIFY_SUCCEEDED(qualifier.GetOperand1Qualifier(&attribute));
+
+        VERIFY_ARE_EQUAL(attribute.GetSmallAtom().uVal, pFlat->pQualifiers[i].attribute.uVal);
+        VERIFY_ARE_EQUAL(qualifier.GetPriority(), static_cast<int>(pFlat->pQualifiers[i].priority));
+        VERIFY_ARE_EQUAL(qualifier.GetFallbackScoreAsScaledInt(), static_cast<int>(pFlat->pQualifiers[i].fallbackScore));
+    }
+
+    for (int i = 0; i < pFlat->numQualifierSets; i++)
+    {
+        QualifierSetResult qualifierSet;
+        VERIFY_SUCCEEDED(pReader->GetQualifierSet(i, &qualifierSet));
+        VERIFY_ARE_EQUAL(qualifierSet.GetNumQualifiers(), pFlat->GetNumQualifiersInSet(i));
+
+        const UINT16* pIndexes = pFlat->GetQualifierIndexesInSet(i);
+        for (int j = 0; j < qualifierSet.GetNumQualifiers(); j++)
+        {
+            int indexInPool;
+            VERIFY_SUCCEEDED(qualifierSet.GetQualifierIndexInPool(j, &indexInPool));
+            VERIFY_ARE_EQUAL(indexInPool, static_cast<int>(pIndexes[j]));
+        }
+    }
+
+    for (int i = 0; i < pFlat->numDecisions; i++)
+    {
+        DecisionResult decision;
+        VERIFY_SUCCEEDED(pReader->GetDecision(i, &decision));
+        VERIFY_ARE_EQUAL(decision.GetNumQualifierSets(), pFlat->GetNumSetsInDecision(i));
+
+        const UINT16* pIndexes = pFlat->GetSetIndexesInDecision(i);
+        for (int j = 0; j < decision.GetNumQualifierSets(); j++)
+        {
+            int indexInPool;
+            VERIFY_SUCCEEDED(decision.GetQualifierSetIndexInPool(j, &indexInPool));
+            VERIFY_ARE_EQUAL(indexInPool, static_cast<int>(pIndexes[j]));
+        }
+    }
+
+    // A unified view over the file passes the flat view through.
+    AutoDeletePtr<UnifiedDecisionInfo> pUnified;
+    VERIFY_SUCCEEDED(UnifiedDecisionInfo::CreateInstance(pEnvironment, pReader, &pUnified));
+    VERIFY_ARE_EQUAL(pFlat, pUnified->GetFlatView());
+}
+
 void DecisionInfoUnitTests::DecisionInfoMergeTests()
 {
     String tmp;
@@ -39,6 +39,8 @@ public:
         TEST_METHOD_PROPERTY(L"DataSource", L"Table:DefChecksum.UnitTests.xml#FileChecksumTests")
     END_TEST_METHOD()
     TEST_METHOD(FileChecksumFailsForMissingFile);
+    TEST_METHOD(Crc32ImplementationsAgree);
+    TEST_METHOD(Crc32Benchmark);
 };
 
 void DefChecksumUnitTests::IntegerChecksumTests(void)
@@ -356,4 +358,121 @@ void DefChecksumUnitTests::FileChecksumFailsForMissingFile(void)
     VERIFY_FAILED(DefChecksum::ComputeFileChecksum(0, L"missingfile.htm", &checksum));
 }
 
+void DefChecksumUnitTests::Crc32ImplementationsAgree(void)
+{
+    static const UINT32 cbMax = 70000;
+    BYTE* pBuf = _DefArray_AllocZeroed(BYTE, cbMax + 16);
+    VERIFY_IS_NOT_NULL(pBuf);
+
+    // deterministic pseudo-random data so failures reproduce
+    UINT32 seed = 0x5eed1234;
+    auto next = [&seed]() {
+        seed = (seed * 1664525) + 1013904223;
+        return seed;
+    };
+    for (UINT32 i = 0; i < cbMax + 16; i++)
+    {
+        pBuf[i] = static_cast<BYTE>(next() >> 24);
+    }
+
+    // well-known check value for "123456789"
+    const BYTE check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    VERIFY_ARE_EQUAL(0xcbf43926u, _DefComputeCrc32(0, check, sizeof(check)));
+    VERIFY_ARE_EQUAL(0xcbf43926u, _DefComputeCrc32Sliced(0, check, sizeof(check)));
+    VERIFY_ARE_EQUAL(0xcbf43926u, _DefComputeCrc32Bytewise(0, check, sizeof(check)));
+
+    Log::Comment(_DefCrc32HardwareIsAvailable() ? L"Hardware CRC32 available" : L"Hardware CRC32 not available");
+
+    int mismatches = 0;
+    for (int i = 0; i < 4000; i++)
+    {
+        // mostly short buffers around the kernel thresholds, some long ones
+        UINT32 cb = ((i % 8) == 0) ? (next() % cbMax) : (next() % 300);
+        UINT32 offset = next() % 16;
+        UINT32 partial = ((i % 2) == 0) ? 0 : next();
+
+        UINT32 expected = _DefComputeCrc32Bytewise(partial, pBuf + offset, cb);
+        UINT32 sliced = _DefComputeCrc32Sliced(partial, pBuf + offset, cb);
+        UINT32 dispatched = _DefComputeCrc32(partial, pBuf + offset, cb);
+
+        // splitting the buffer must not change the result either
+        UINT32 split = (cb > 0) ? (next() % cb) : 0;
+        UINT32 chained = _DefComputeCrc32(_DefComputeCrc32(partial, pBuf + offset, split), pBuf + offset + split, cb - split);
+
+        if ((sliced != expected) || (dispatched != expected) || (chained != expected))
+        {
+            // only log failures to reduce noise
+            if (mismatches++ < 10)
+            {
+                String logmsg;
+                logmsg.Format(
+                    L"CRC mismatch: cb=%u offset=%u split=%u expected=%08x sliced=%08x dispatched=%08x chained=%08x",
+                    cb,
+                    offset,
+                    split,
+                    expected,
+                    sliced,
+                    dispatched,
+                    chained);
+                Log::Error(logmsg);
+            }
+        }
+    }
+    VERIFY_ARE_EQUAL(0, mismatches);
+
+    Def_Free(pBuf);
+}
+
+void DefChecksumUnitTests::Crc32Benchmark(void)
+{
+    static const UINT32 cbBuf = 4 * 1024 * 1024;
+    static const int numPasses = 8;
+    BYTE* pBuf = _DefArray_AllocZeroed(BYTE, cbBuf);
+    VERIFY_IS_NOT_NULL(pBuf);
+    for (UINT32 i = 0; i < cbBuf; i++)
+    {
+        pBuf[i] = static_cast<BYTE>(i * 31);
+    }
+
+    typedef UINT32 (*Crc32Func)(UINT32, const BYTE*, UINT32);
+    const struct
+    {
+        PCWSTR name;
+        Crc32Func func;
+    } impls[] = {
+        {L"bytewise", _DefComputeCrc32Bytewise},
+        {L"slicing-by-8", _DefComputeCrc32Sliced},
+        {L"dispatched", _DefComputeCrc32},
+    };
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+
+    UINT32 results[ARRAYSIZE(impls)];
+    for (size_t i = 0; i < ARRAYSIZE(impls); i++)
+    {
+        LARGE_INTEGER start, end;
+        UINT32 crc = 0;
+
+        QueryPerformanceCounter(&start);
+        for (int pass = 0; pass < numPasses; pass++)
+        {
+            crc = impls[i].func(crc, pBuf, cbBuf);
+        }
+        QueryPerformanceCounter(&end);
+        results[i] = crc;
+
+        double ms = ((end.QuadPart - start.QuadPart) * 1000.0) / frequency.QuadPart;
+        double mbPerSec = (ms > 0) ? ((static_cast<double>(cbBuf) * numPasses) / (1024.0 * 1024.0)) / (ms / 1000.0) : 0;
+        String logmsg;
+        logmsg.Format(L"%s: %.3f ms for %d x %u bytes (%.0f MB/s)", impls[i].name, ms, numPasses, cbBuf, mbPerSec);
+        Log::Comment(logmsg);
+    }
+
+    VERIFY_ARE_EQUAL(results[0], results[1]);
+    VERIFY_ARE_EQUAL(results[0], results[2]);
+
+    Def_Free(pBuf);
+}
+
 }; // namespace UnitTests
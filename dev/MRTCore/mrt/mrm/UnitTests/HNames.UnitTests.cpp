@@ -37,6 +37,8 @@ class HierarchicalNamesUnitTests : public WEX::TestClass<HierarchicalNamesUnitTe
     BEGIN_TEST_METHOD(LargeBuilderReaderTests)
         TEST_METHOD_PROPERTY(L"DataSource", L"Table:HNames.UnitTests.xml#LargeBuilderReaderTests")
     END_TEST_METHOD()
+
+    TEST_METHOD(PathHashIndexTests);
 };
 
 void CheckNames(_In_ const IHierarchicalNames* pNames)
@@ -795,4 +797,115 @@ void HierarchicalNamesUnitTests::LargeBuilderReaderTests(void)
     }
 }
 
+static void BuildPathHashIndexTestNames(
+    _In_ UINT32 flags,
+    _In_reads_(numItems) const PCWSTR* items,
+    _In_ int numItems,
+    _Inout_ BuildHelper* pNames,
+    _Outptr_ HierarchicalNames** ppReader)
+{
+    AutoDeletePtr<HierarchicalNamesBuilder> pBuilder;
+    HRESULT hr = HierarchicalNamesBuilder::CreateInstance(flags, &pBuilder);
+    VERIFY_HRESULT_EXPR((pBuilder != NULL), hr);
+
+    for (int i = 0; i < numItems; i++)
+    {
+        ItemInfo* pItem;
+        VERIFY_SUCCEEDED(pBuilder->GetOrAddItem(items[i], &pItem));
+    }
+
+    VERIFY_HRESULT(pNames->Build(pBuilder));
+    hr = HierarchicalNames::CreateInstance(
+        ((flags & HierarchicalNamesBuilder::BuildAsciiOrUtf16) ? gHierarchicalNamesExSectionType : gHierarchicalNamesSectionType),
+        pNames->GetBuffer(),
+        pNames->GetBufferSize(),
+        ppReader);
+    VERIFY_HRESULT_EXPR((*ppReader != NULL), hr);
+}
+
+void HierarchicalNamesUnitTests::PathHashIndexTests(void)
+{
+    const PCWSTR items[] = {
+        L"Files/images/logo.png",
+        L"Files/images/Logo.scale-200.png",
+        L"Files/strings.json",
+        L"resources/Greeting",
+        L"resources/Errors/NotFound",
+        L"resources/Errors/Timeout",
+        L"resources/\x00C9t\x00E9/Caf\x00E9",
+    };
+
+    const PCWSTR lookups[] = {
+        L"Files",
+        L"files/IMAGES",
+        L"Files/images/logo.png",
+        L"FILES/IMAGES/LOGO.PNG",
+        L"/Files/images/logo.png",
+        L"Files\\images\\logo.png",
+        L"Files/images/logo.scale-200.png",
+        L"resources/errors/notfound",
+        L"resources/Errors/Timeout",
+        L"resources/Errors/",
+        L"resources//Errors",
+        L"resources/Errors/Missing",
+        L"resources/Greeting/More",
+        L"resources/\x00C9t\x00E9/Caf\x00E9",
+        L"resources/\x00E9T\x00C9/CAF\x00C9",
+        L"Files/images/logo",
+        L"Logo.png",
+        L"/",
+    };
+
+    const UINT32 configs[] = {
+        HierarchicalNamesBuilder::BuildUtf16Only,
+        HierarchicalNamesBuilder::BuildAsciiOrUtf16,
+        HierarchicalNamesBuilder::BuildAsciiOrUtf16 | HierarchicalNamesBuilder::BuildLargeHNamesNode,
+    };
+
+    String tmp;
+    for (int iConfig = 0; iConfig < ARRAYSIZE(configs); iConfig++)
+    {
+        Log::Comment(tmp.Format(L"[ Build flags: 0x%x ]", configs[iConfig]));
+
+        BuildHelper indexedNames;
+        BuildHelper walkedNames;
+        AutoDeletePtr<HierarchicalNames> pIndexed;
+        AutoDeletePtr<HierarchicalNames> pWalked;
+
+        BuildPathHashIndexTestNames(configs[iConfig], items, ARRAYSIZE(items), &indexedNames, &pIndexed);
+        BuildPathHashIndexTestNames(
+            configs[iConfig] | HierarchicalNamesBuilder::BuildWithoutPathHashIndex, items, ARRAYSIZE(items), &walkedNames, &pWalked);
+
+        VERIFY_IS_TRUE(pIndexed->HasPathHashIndex());
+        VERIFY_IS_FALSE(pWalked->HasPathHashIndex());
+
+        // Every item must be found through the index.
+        for (int i = 0; i < ARRAYSIZE(items); i++)
+        {
+            int itemIndex = -1;
+            VERIFY_IS_TRUE(pIndexed->Contains(items[i], nullptr, &itemIndex));
+            VERIFY_IS_TRUE(itemIndex >= 0);
+        }
+
+        // The index must agree with the tree walk, including on misses and malformed paths.
+        for (int i = 0; i < ARRAYSIZE(lookups); i++)
+        {
+            int indexedScope, indexedItem, indexedName;
+            int walkedScope, walkedItem, walkedName;
+
+            Log::Comment(tmp.Format(L"[ Lookup: \"%s\" ]", lookups[i]));
+            bool indexedFound = pIndexed->Contains(lookups[i], &indexedScope, &indexedItem, &indexedName);
+            bool walkedFound = pWalked->Contains(lookups[i], &walkedScope, &walkedItem, &walkedName);
+
+            VERIFY_ARE_EQUAL(walkedFound, indexedFound);
+            if (walkedFound)
+            {
+                VERIFY_ARE_EQUAL(walkedScope, indexedScope);
+                VERIFY_ARE_EQUAL(walkedItem, indexedItem);
+                VERIFY_ARE_EQUAL(walkedName, indexedName);
+            }
+        }
+    }
+}
+
 }; // namespace UnitTests
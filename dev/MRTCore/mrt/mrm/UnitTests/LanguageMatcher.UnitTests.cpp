@@ -0,0 +1,225 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+#include "StdAfx.h"
+#include "Helpers.h"
+#include "mrm/build/Base.h"
+
+using namespace WEX::Common;
+using namespace WEX::TestExecution;
+using namespace WEX::Logging;
+
+using namespace Microsoft::Resources;
+
+namespace UnitTests
+{
+// Scores a tag 1.0 if it's the first language in the list and 0.5 if it's anywhere else in the
+// list.  Tags containing '_' are rejected.  Counts how often it's called.
+class CountingLanguageTagScorer : public ILanguageTagScorer
+{
+public:
+    CountingLanguageTagScorer() : numValidated(0), numScored(0) {}
+
+    HRESULT ValidateLanguageTag(_In_ PCWSTR tag) const override
+    {
+        numValidated++;
+        return ((*tag == L'\0') || (wcschr(tag, L'_') != nullptr)) ? HRESULT_FROM_WIN32(ERROR_MRM_INVALID_QUALIFIER_VALUE) : S_OK;
+    }
+
+    HRESULT ScoreLanguageTag(_In_ PCWSTR tag, _In_ PCWSTR contextLanguages, _Out_ double* score) const override
+    {
+        numScored++;
+
+        size_t cchTag = wcslen(tag);
+        *score = 0.0;
+        for (PCWSTR pCurrent = contextLanguages; *pCurrent != L'\0';)
+        {
+            PCWSTR pEnd = wcschr(pCurrent, L';');
+            size_t cchCurrent = (pEnd != nullptr) ? static_cast<size_t>(pEnd - pCurrent) : wcslen(pCurrent);
+            if ((cchCurrent == cchTag) && (_wcsnicmp(pCurrent, tag, cchTag) == 0))
+            {
+                *score = (pCurrent == contextLanguages) ? 1.0 : 0.5;
+                break;
+            }
+            pCurrent += cchCurrent + ((pEnd != nullptr) ? 1 : 0);
+        }
+        return S_OK;
+    }
+
+    mutable int numValidated;
+    mutable int numScored;
+};
+
+class LanguageMatcherUnitTests : public WEX::TestClass<LanguageMatcherUnitTests>
+{
+    TEST_CLASS(LanguageMatcherUnitTests);
+
+    TEST_METHOD(ParentTagTests);
+    TEST_METHOD(FallbackScoreTests);
+    TEST_METHOD(InternTagTests);
+    TEST_METHOD(ScoreCacheTests);
+    TEST_METHOD(InvalidTagTests);
+};
+
+void LanguageMatcherUnitTests::ParentTagTests()
+{
+    StringResult parent;
+
+    VERIFY_IS_TRUE(LanguageMatcher::TryGetParentTag(L"en-US", &parent));
+    VERIFY_ARE_EQUAL(wcscmp(L"en", parent.GetRef()), 0);
+
+    VERIFY_IS_TRUE(LanguageMatcher::TryGetParentTag(L"en-GB", &parent));
+    VERIFY_ARE_EQUAL(wcscmp(L"en-001", parent.GetRef()), 0);
+
+    VERIFY_IS_TRUE(LanguageMatcher::TryGetParentTag(L"en-001", &parent));
+    VERIFY_ARE_EQUAL(wcscmp(L"en", parent.GetRef()), 0);
+
+    VERIFY_IS_TRUE(LanguageMatcher::TryGetParentTag(L"zh-tw", &parent));
+    VERIFY_ARE_EQUAL(wcscmp(L"zh-Hant", parent.GetRef()), 0);
+
+    VERIFY_IS_TRUE(LanguageMatcher::TryGetParentTag(L"zh-Hant-TW", &parent));
+    VERIFY_ARE_EQUAL(wcscmp(L"zh-Hant", parent.GetRef()), 0);
+
+    VERIFY_IS_TRUE(LanguageMatcher::TryGetParentTag(L"de-DE-x-private", &parent));
+    VERIFY_ARE_EQUAL(wcscmp(L"de-DE", parent.GetRef()), 0);
+
+    // Script tags for Chinese don't fall back to "zh", and bare languages have no parent.
+    VERIFY_IS_FALSE(LanguageMatcher::TryGetParentTag(L"zh-Hant", &parent));
+    VERIFY_IS_FALSE(LanguageMatcher::TryGetParentTag(L"en", &parent));
+    VERIFY_IS_FALSE(LanguageMatcher::TryGetParentTag(L"x-private", &parent));
+    VERIFY_IS_FALSE(LanguageMatcher::TryGetParentTag(L"", &parent));
+}
+
+void LanguageMatcherUnitTests::FallbackScoreTests()
+{
+    // Exact matches, with a bare language scoring lower.
+    VERIFY_ARE_EQUAL(LanguageMatcher::GetFallbackScore(L"en-US", L"en-us"), 1.0);
+    VERIFY_ARE_EQUAL(LanguageMatcher::GetFallbackScore(L"en", L"en"), 0.5);
+
+    // Ancestors of the context language, closer ones scoring higher.
+    double parentScore = LanguageMatcher::GetFallbackScore(L"en-001", L"en-GB");
+    double grandparentScore = LanguageMatcher::GetFallbackScore(L"en", L"en-GB");
+    VERIFY_IS_GREATER_THAN(parentScore, grandparentScore);
+    VERIFY_IS_GREATER_THAN(grandparentScore, 0.0);
+    VERIFY_IS_LESS_THAN(parentScore, 0.5);
+    VERIFY_ARE_EQUAL(LanguageMatcher::GetFallbackScore(L"zh-Hant", L"zh-TW"), parentScore);
+
+    // Siblings score below any ancestor.
+    double siblingScore = LanguageMatcher::GetFallbackScore(L"en-GB", L"en-US");
+    VERIFY_IS_GREATER_THAN(siblingScore, 0.0);
+    VERIFY_IS_LESS_THAN(siblingScore, grandparentScore);
+    VERIFY_ARE_EQUAL(LanguageMatcher::GetFallbackScore(L"es-MX", L"es-AR"), siblingScore);
+
+    // Descendants of the context language don't match.
+    VERIFY_ARE_EQUAL(LanguageMatcher::GetFallbackScore(L"en-US", L"en"), 0.0);
+
+    // Traditional and Simplified Chinese don't match each other.
+    VERIFY_ARE_EQUAL(LanguageMatcher::GetFallbackScore(L"zh-TW", L"zh-CN"), 0.0);
+    VERIFY_ARE_EQUAL(LanguageMatcher::GetFallbackScore(L"zh-Hans", L"zh-TW"), 0.0);
+
+    VERIFY_ARE_EQUAL(LanguageMatcher::GetFallbackScore(L"fr-FR", L"en-US"), 0.0);
+    VERIFY_ARE_EQUAL(LanguageMatcher::GetFallbackScore(L"", L"en-US"), 0.0);
+}
+
+void LanguageMatcherUnitTests::InternTagTests()
+{
+    CountingLanguageTagScorer scorer;
+    AutoDeletePtr<LanguageMatcher> pMatcher;
+    VERIFY_SUCCEEDED(LanguageMatcher::CreateInstance(&scorer, &pMatcher));
+    VERIFY_ARE_EQUAL(pMatcher->GetNumTags(), 0);
+
+    int index1, index2, index3;
+    VERIFY_SUCCEEDED(pMatcher->GetTagIndex(L"en-US", &index1));
+    VERIFY_SUCCEEDED(pMatcher->GetTagIndex(L"EN-us", &index2));
+    VERIFY_SUCCEEDED(pMatcher->GetTagIndex(L"fr-FR", &index3));
+    VERIFY_ARE_EQUAL(index1, index2);
+    VERIFY_ARE_NOT_EQUAL(index1, index3);
+    VERIFY_ARE_EQUAL(pMatcher->GetNumTags(), 2);
+    VERIFY_ARE_EQUAL(scorer.numValidated, 2);
+
+    // Enough tags to force the hash and the score rows to grow.
+    WCHAR tag[16];
+    for (int i = 0; i < 200; i++)
+    {
+        VERIFY_SUCCEEDED(StringCchPrintf(tag, ARRAYSIZE(tag), L"qaa-x-t%d", i));
+        VERIFY_SUCCEEDED(pMatcher->GetTagIndex(tag, &index1));
+        VERIFY_ARE_EQUAL(index1, i + 2);
+
+        double score;
+        VERIFY_SUCCEEDED(pMatcher->GetScore(index1, L"qaa-x-t0", &score));
+        VERIFY_ARE_EQUAL(score, (i == 0) ? 1.0 : 0.0);
+    }
+
+    VERIFY_SUCCEEDED(pMatcher->GetTagIndex(L"QAA-X-T17", &index1));
+    VERIFY_ARE_EQUAL(index1, 19);
+    VERIFY_ARE_EQUAL(pMatcher->GetNumTags(), 202);
+}
+
+void LanguageMatcherUnitTests::ScoreCacheTests()
+{
+    CountingLanguageTagScorer scorer;
+    AutoDeletePtr<LanguageMatcher> pMatcher;
+    VERIFY_SUCCEEDED(LanguageMatcher::CreateInstance(&scorer, &pMatcher));
+
+    double score;
+    VERIFY_SUCCEEDED(pMatcher->Evaluate(L"en-US", L"en-US;fr-FR", &score));
+    VERIFY_ARE_EQUAL(score, 1.0);
+    VERIFY_SUCCEEDED(pMatcher->Evaluate(L"fr-FR", L"en-US;fr-FR", &score));
+    VERIFY_ARE_EQUAL(score, 0.5);
+    VERIFY_SUCCEEDED(pMatcher->Evaluate(L"de-DE", L"en-US;fr-FR", &score));
+    VERIFY_ARE_EQUAL(score, 0.0);
+    VERIFY_ARE_EQUAL(scorer.numScored, 3);
+
+    // Repeats come from the cache.
+    VERIFY_SUCCEEDED(pMatcher->Evaluate(L"en-us", L"en-US;fr-FR", &score));
+    VERIFY_ARE_EQUAL(score, 1.0);
+    VERIFY_ARE_EQUAL(scorer.numScored, 3);
+
+    // A new list gets its own row, and the old one is still there when we come back.
+    VERIFY_SUCCEEDED(pMatcher->Evaluate(L"en-US", L"fr-FR;en-US", &score));
+    VERIFY_ARE_EQUAL(score, 0.5);
+    VERIFY_ARE_EQUAL(scorer.numScored, 4);
+    VERIFY_SUCCEEDED(pMatcher->Evaluate(L"fr-FR", L"en-US;fr-FR", &score));
+    VERIFY_ARE_EQUAL(score, 0.5);
+    VERIFY_ARE_EQUAL(scorer.numScored, 4);
+    VERIFY_ARE_EQUAL(pMatcher->GetNumScoresComputed(), static_cast<UINT32>(scorer.numScored));
+
+    // Using more lists than we cache evicts the least recently used one.
+    PCWSTR lists[] = { L"en-US;fr-FR", L"fr-FR;en-US", L"de-DE", L"ja-JP", L"ko-KR" };
+    C_ASSERT(ARRAYSIZE(lists) > LanguageMatcher::MaxContextLists);
+    for (int i = 0; i < ARRAYSIZE(lists); i++)
+    {
+        VERIFY_SUCCEEDED(pMatcher->Evaluate(L"en-US", lists[i], &score));
+    }
+    VERIFY_ARE_EQUAL(scorer.numScored, 7);
+
+    // "ko-KR" is still cached; "en-US;fr-FR" was evicted.
+    VERIFY_SUCCEEDED(pMatcher->Evaluate(L"en-US", L"ko-KR", &score));
+    VERIFY_ARE_EQUAL(scorer.numScored, 7);
+    VERIFY_SUCCEEDED(pMatcher->Evaluate(L"en-US", L"en-US;fr-FR", &score));
+    VERIFY_ARE_EQUAL(score, 1.0);
+    VERIFY_ARE_EQUAL(scorer.numScored, 8);
+}
+
+void LanguageMatcherUnitTests::InvalidTagTests()
+{
+    CountingLanguageTagScorer scorer;
+    AutoDeletePtr<LanguageMatcher> pMatcher;
+    VERIFY_SUCCEEDED(LanguageMatcher::CreateInstance(&scorer, &pMatcher));
+
+    double score = 1.0;
+    VERIFY_ARE_EQUAL(pMatcher->Evaluate(L"en_US", L"en-US", &score), HRESULT_FROM_WIN32(ERROR_MRM_INVALID_QUALIFIER_VALUE));
+    VERIFY_ARE_EQUAL(score, 0.0);
+    VERIFY_ARE_EQUAL(pMatcher->Evaluate(L"EN_us", L"fr-FR", &score), HRESULT_FROM_WIN32(ERROR_MRM_INVALID_QUALIFIER_VALUE));
+
+    // Rejected tags are only validated once, and never scored.
+    VERIFY_ARE_EQUAL(scorer.numValidated, 1);
+    VERIFY_ARE_EQUAL(scorer.numScored, 0);
+
+    int index;
+    VERIFY_SUCCEEDED(pMatcher->GetTagIndex(L"en-US", &index));
+    VERIFY_ARE_EQUAL(pMatcher->GetScore(index + 1, L"en-US", &score), E_INVALIDARG);
+    VERIFY_ARE_EQUAL(pMatcher->GetScore(-1, L"en-US", &score), E_INVALIDARG);
+}
+
+} // namespace UnitTests
@@ -7,6 +7,7 @@
 
 #include "mrm/readers/MrmReaders.h"
 #include "mrm/build/MrmBuilders.h"
+#include "mrm/build/IncrementalPriBuilder.h"
 
 #include "TestPri.h"
 #include "TestMap.h"
@@ -32,6 +33,15 @@ public:
     BEGIN_TEST_METHOD(DeduplicationTests)
         TEST_METHOD_PROPERTY(L"DataSource", L"Table:PriBuilder.UnitTests.xml#DeduplicationTests")
     END_TEST_METHOD();
+
+    BEGIN_TEST_METHOD(ParallelBuildTests)
+        TEST_METHOD_PROPERTY(L"DataSource", L"Table:PriBuilder.UnitTests.xml#SimpleBuildTests")
+    END_TEST_METHOD();
+
+    TEST_METHOD(IncrementalBuildTests);
+
+private:
+    void _VerifyStringCandidates(_In_ const IResourceMapBase* pMap, _In_ PCWSTR pResourceName, _In_ int numCandidates, _In_opt_ PCWSTR pNeutralValue);
 };
 
 void PriBuilderUnitTests::SimpleBuilderReaderTests()
@@ -320,4 +330,267 @@ void PriBuilderUnitTests::DeduplicationTests()
         (actualDataValueSize2 * 2 == ((wcslen(utf16String2) + 1) * sizeof(wchar_t))));
 }
 
-} // namespace UnitTests
\ No newline at end of file
+void PriBuilderUnitTests::ParallelBuildTests()
+{
+    AutoDeletePtr<CoreProfile> serialProfile;
+    AutoDeletePtr<CoreProfile> parallelProfile;
+    VERIFY_SUCCEEDED(CoreProfile::ChooseDefaultProfile(&serialProfile));
+    VERIFY_SUCCEEDED(CoreProfile::ChooseDefaultProfile(&parallelProfile));
+
+    MrmBuildConfiguration* parallelConfig = parallelProfile->GetBuildConfiguration();
+    VERIFY_IS_NOT_NULL(parallelConfig);
+    parallelConfig->SetFlags(parallelConfig->GetFlags() | MrmBuildConfiguration::UseParallelBuildFlag);
+
+    TestHPri serialPri;
+    TestHPri parallelPri;
+
+    Log::Comment(L"[ Setting up serial and parallel test PRIs ]");
+    VERIFY_SUCCEEDED(serialPri.InitFromTestVars(L"", NULL, serialProfile, NULL));
+    VERIFY_SUCCEEDED(parallelPri.InitFromTestVars(L"", NULL, parallelProfile, NULL));
+    VERIFY_IS_FALSE(serialPri.GetFileBuilder()->GetParallelBuild());
+    VERIFY_IS_TRUE(parallelPri.GetFileBuilder()->GetParallelBuild());
+
+    Log::Comment(L"[ Building serial and parallel test PRIs ]");
+    VERIFY_SUCCEEDED(serialPri.Build());
+    VERIFY_SUCCEEDED(parallelPri.Build());
+
+    void* serialBuffer = nullptr;
+    void* parallelBuffer = nullptr;
+    UINT32 serialSizeInBytes = 0;
+    UINT32 parallelSizeInBytes = 0;
+    VERIFY_SUCCEEDED(serialPri.GetFileBuilder()->GenerateFileContents(&serialBuffer, &serialSizeInBytes));
+    unique_deffree_ptr<void> serialContents(serialBuffer);
+    VERIFY_SUCCEEDED(parallelPri.GetFileBuilder()->GenerateFileContents(&parallelBuffer, &parallelSizeInBytes));
+    unique_deffree_ptr<void> parallelContents(parallelBuffer);
+
+    Log::Comment(L"[ Verifying parallel PRI is byte-identical to serial PRI ]");
+    VERIFY_ARE_EQUAL(serialSizeInBytes, parallelSizeInBytes);
+    VERIFY_ARE_EQUAL(0, memcmp(serialContents.get(), parallelContents.get(), serialSizeInBytes));
+
+    Log::Comment(L"[ Reading back parallel test PRI ]");
+    VERIFY_SUCCEEDED(parallelPri.CreateReader(parallelProfile));
+    TestHPri::VerifyAgainstTestVars(parallelPri.GetPriFile(), L"", parallelPri.GetTestDI(), L"");
+}
+
+void PriBuilderUnitTests::IncrementalBuildTests()
+{
+    FileBasedTest fileBasedTestObj;
+    VERIFY_IS_TRUE(fileBasedTestObj.SetupClassFolders(L"PriBuilderUnitTests"));
+    VERIFY_IS_TRUE(fileBasedTestObj.SetupTestMethodOutputFolder(L"IncrementalBuildTests"));
+
+    String strOutDir;
+    VERIFY_IS_TRUE(FileBasedTest::GetTestOutputDirectory(L"PriBuilderUnitTests", L"IncrementalBuildTests", strOutDir));
+    String strPreviousPath = strOutDir;
+    strPreviousPath += L"\\Previous.pri";
+    String strUnchangedPath = strOutDir;
+    strUnchangedPath += L"\\Unchanged.pri";
+    String strIncrementalPath = strOutDir;
+    strIncrementalPath += L"\\Incremental.pri";
+    String strSameNamesPath = strOutDir;
+    strSameNamesPath += L"\\SameNames.pri";
+
+    AutoDeletePtr<CoreProfile> pProfile;
+    VERIFY_SUCCEEDED(CoreProfile::ChooseDefaultProfile(&pProfile));
+
+    PCWSTR const seedString = L"This is an embedded data blob.";
+    const BYTE* pBlob = reinterpret_cast<const BYTE*>(seedString);
+    UINT cbBlob = static_cast<UINT>((wcslen(seedString) + 1) * sizeof(WCHAR));
+
+    Log::Comment(L"[ Building the previous PRI ]");
+    {
+        AutoDeletePtr<PriFileBuilder> pFileBuilder;
+        VERIFY_SUCCEEDED(PriFileBuilder::CreateInstance(L"IncrementalTest", 1, pProfile, &pFileBuilder));
+        PriSectionBuilder* pDescriptor = pFileBuilder->GetDescriptor();
+
+        AutoDeletePtr<DecisionInfoQualifierSetBuilder> pQualifiers;
+        VERIFY_SUCCEEDED(pDescriptor->GetQualifierSetBuilder(&pQualifiers));
+        pQualifiers->Reset();
+        VERIFY_SUCCEEDED(pQualifiers->AddQualifier(L"Language", L"fr-FR", 0.0));
+
+        VERIFY_SUCCEEDED(
+            pDescriptor->AddCandidateWithString(nullptr, L"Resources/Alpha", MrmEnvironment::ResourceValueType_Utf16String, L"alpha", nullptr));
+        VERIFY_SUCCEEDED(pDescriptor->AddCandidateWithString(
+            nullptr, L"Resources/Alpha", MrmEnvironment::ResourceValueType_Utf16String, L"alpha-fr", pQualifiers));
+        VERIFY_SUCCEEDED(
+            pDescriptor->AddCandidateWithString(nullptr, L"Resources/Beta", MrmEnvironment::ResourceValueType_Utf16String, L"beta", nullptr));
+        VERIFY_SUCCEEDED(pDescriptor->AddCandidateWithString(
+            nullptr, L"Resources/Beta", MrmEnvironment::ResourceValueType_Utf16String, L"beta-fr", pQualifiers));
+        VERIFY_SUCCEEDED(
+            pDescriptor->AddCandidateWithString(nullptr, L"Resources/Gamma", MrmEnvironment::ResourceValueType_Utf16String, L"gamma", nullptr));
+        VERIFY_SUCCEEDED(pDescriptor->AddCandidateWithEmbeddedData(
+            nullptr, L"Files/Blob", MrmEnvironment::ResourceValueType_EmbeddedData, pBlob, cbBlob, nullptr));
+
+        VERIFY_SUCCEEDED(pFileBuilder->WriteToFile(strPreviousPath));
+    }
+
+    Log::Comment(L"[ An empty delta leaves the previous PRI as it is ]");
+    {
+        AutoDeletePtr<IncrementalPriBuilder> pIncremental;
+        VERIFY_SUCCEEDED(IncrementalPriBuilder::CreateInstance(strPreviousPath, pProfile, &pIncremental));
+        VERIFY_IS_FALSE(pIncremental->HasChanges());
+        VERIFY_SUCCEEDED(pIncremental->WriteToFile(strUnchangedPath));
+        VERIFY_ARE_EQUAL(pIncremental->WriteToFile(strUnchangedPath), HRESULT_FROM_WIN32(ERROR_INVALID_OPERATION));
+
+        DEF_CHECKSUM previousChecksum;
+        DEF_CHECKSUM unchangedChecksum;
+        VERIFY_SUCCEEDED(DefChecksum::ComputeFileChecksum(0, strPreviousPath, &previousChecksum));
+        VERIFY_SUCCEEDED(DefChecksum::ComputeFileChecksum(0, strUnchangedPath, &unchangedChecksum));
+        VERIFY_ARE_EQUAL(previousChecksum, unchangedChecksum);
+    }
+
+    Log::Comment(L"[ Adding a new resource on its own is a change ]");
+    {
+        AutoDeletePtr<IncrementalPriBuilder> pIncremental;
+        VERIFY_SUCCEEDED(IncrementalPriBuilder::CreateInstance(strPreviousPath, pProfile, &pIncremental));
+        VERIFY_SUCCEEDED(pIncremental->GetDescriptor()->AddCandidateWithString(
+            nullptr, L"Resources/Delta", MrmEnvironment::ResourceValueType_Utf16String, L"delta", nullptr));
+        VERIFY_IS_TRUE(pIncremental->HasChanges());
+    }
+
+    Log::Comment(L"[ A delta that adds no names reuses the previous schema section ]");
+    {
+        AutoDeletePtr<IncrementalPriBuilder> pIncremental;
+        VERIFY_SUCCEEDED(IncrementalPriBuilder::CreateInstance(strPreviousPath, pProfile, &pIncremental));
+        VERIFY_SUCCEEDED(pIncremental->GetDescriptor()->AddCandidateWithString(
+            nullptr, L"Resources/Beta", MrmEnvironment::ResourceValueType_Utf16String, L"beta-2", nullptr));
+        VERIFY_SUCCEEDED(pIncremental->WriteToFile(strSameNamesPath));
+
+        AutoDeletePtr<StandalonePriFile> pPreviousPri;
+        AutoDeletePtr<StandalonePriFile> pSameNamesPri;
+        VERIFY_SUCCEEDED(StandalonePriFile::CreateInstance(0, strPreviousPath, pProfile, &pPreviousPri));
+        VERIFY_SUCCEEDED(StandalonePriFile::CreateInstance(0, strSameNamesPath, pProfile, &pSameNamesPri));
+
+        const IHierarchicalSchema* pPreviousSchema;
+        const IHierarchicalSchema* pSameNamesSchema;
+        VERIFY_SUCCEEDED(pPreviousPri->GetPrimarySchema(&pPreviousSchema));
+        VERIFY_SUCCEEDED(pSameNamesPri->GetPrimarySchema(&pSameNamesSchema));
+
+        BlobResult previousSection;
+        BlobResult sameNamesSection;
+        size_t cbPreviousSection;
+        size_t cbSameNamesSection;
+        VERIFY_SUCCEEDED(pPreviousSchema->GetSchemaBlobFromFileSection(nullptr, &previousSection));
+        VERIFY_SUCCEEDED(pSameNamesSchema->GetSchemaBlobFromFileSection(nullptr, &sameNamesSection));
+        const void* pPreviousSection = previousSection.GetRef(&cbPreviousSection);
+        const void* pSameNamesSection = sameNamesSection.GetRef(&cbSameNamesSection);
+        VERIFY_ARE_EQUAL(cbPreviousSection, cbSameNamesSection);
+        VERIFY_ARE_EQUAL(0, memcmp(pPreviousSection, pSameNamesSection, cbPreviousSection));
+
+        const IResourceMapBase* pMap;
+        VERIFY_SUCCEEDED(pSameNamesPri->GetPrimaryResourceMap(&pMap));
+        _VerifyStringCandidates(pMap, L"Resources/Alpha", 2, L"alpha");
+        _VerifyStringCandidates(pMap, L"Resources/Beta", 1, L"beta-2");
+        _VerifyStringCandidates(pMap, L"Resources/Gamma", 1, L"gamma");
+    }
+
+    Log::Comment(L"[ Replace Beta, remove Gamma and add Delta ]");
+    {
+        AutoDeletePtr<IncrementalPriBuilder> pIncremental;
+        VERIFY_SUCCEEDED(IncrementalPriBuilder::CreateInstance(strPreviousPath, pProfile, &pIncremental));
+        PriSectionBuilder* pDescriptor = pIncremental->GetDescriptor();
+
+        VERIFY_ARE_EQUAL(pIncremental->RemoveResource(L"Resources/Missing"), HRESULT_FROM_WIN32(ERROR_MRM_NAMED_RESOURCE_NOT_FOUND));
+        VERIFY_IS_FALSE(pIncremental->HasChanges());
+
+        VERIFY_SUCCEEDED(pDescriptor->AddCandidateWithString(
+            nullptr, L"Resources/Beta", MrmEnvironment::ResourceValueType_Utf16String, L"beta-2", nullptr));
+        VERIFY_IS_TRUE(pIncremental->HasChanges());
+
+        VERIFY_SUCCEEDED(pIncremental->RemoveResource(L"Resources/Gamma"));
+        VERIFY_SUCCEEDED(
+            pDescriptor->AddCandidateWithString(nullptr, L"Resources/Delta", MrmEnvironment::ResourceValueType_Utf16String, L"delta", nullptr));
+
+        VERIFY_SUCCEEDED(pIncremental->WriteToFile(strIncrementalPath));
+    }
+
+    Log::Comment(L"[ Verifying the incremental PRI ]");
+    {
+        AutoDeletePtr<StandalonePriFile> pPri;
+        VERIFY_SUCCEEDED(StandalonePriFile::CreateInstance(0, strIncrementalPath, pProfile, &pPri));
+
+        const IResourceMapBase* pMap;
+        VERIFY_SUCCEEDED(pPri->GetPrimaryResourceMap(&pMap));
+
+        _VerifyStringCandidates(pMap, L"Resources/Alpha", 2, L"alpha");
+        _VerifyStringCandidates(pMap, L"Resources/Beta", 1, L"beta-2");
+        _VerifyStringCandidates(pMap, L"Resources/Gamma", 0, nullptr);
+        _VerifyStringCandidates(pMap, L"Resources/Delta", 1, L"delta");
+
+        NamedResourceResult namedResource;
+        ResourceCandidateResult candidate;
+        BlobResult blobValue;
+        size_t cbValue;
+        VERIFY_SUCCEEDED(pMap->GetResource(L"Files/Blob", &namedResource));
+        VERIFY_ARE_EQUAL(namedResource.GetNumCandidates(), 1);
+        VERIFY_SUCCEEDED(namedResource.GetCandidate(0, &candidate));
+        VERIFY_IS_TRUE(candidate.TryGetBlobValue(&blobValue));
+        const void* pValue = blobValue.GetRef(&cbValue);
+        VERIFY_ARE_EQUAL(cbValue, static_cast<size_t>(cbBlob));
+        VERIFY_ARE_EQUAL(0, memcmp(pValue, pBlob, cbBlob));
+    }
+
+    Log::Comment(L"[ Rebuilding over the previous PRI ]");
+    {
+        AutoDeletePtr<IncrementalPriBuilder> pIncremental;
+        VERIFY_SUCCEEDED(IncrementalPriBuilder::CreateInstance(strIncrementalPath, pProfile, &pIncremental));
+        VERIFY_SUCCEEDED(pIncremental->RemoveResource(L"Resources/Delta"));
+        VERIFY_SUCCEEDED(pIncremental->WriteToFile(strIncrementalPath));
+    }
+
+    {
+        AutoDeletePtr<StandalonePriFile> pPri;
+        VERIFY_SUCCEEDED(StandalonePriFile::CreateInstance(0, strIncrementalPath, pProfile, &pPri));
+
+        const IResourceMapBase* pMap;
+        VERIFY_SUCCEEDED(pPri->GetPrimaryResourceMap(&pMap));
+
+        _VerifyStringCandidates(pMap, L"Resources/Alpha", 2, L"alpha");
+        _VerifyStringCandidates(pMap, L"Resources/Beta", 1, L"beta-2");
+        _VerifyStringCandidates(pMap, L"Resources/Delta", 0, nullptr);
+    }
+
+    fileBasedTestObj.CleanupClassFolders();
+}
+
+void PriBuilderUnitTests::_VerifyStringCandidates(
+    _In_ const IResourceMapBase* pMap,
+    _In_ PCWSTR pResourceName,
+    _In_ int numCandidates,
+    _In_opt_ PCWSTR pNeutralValue)
+{
+    NamedResourceResult namedResource;
+    HRESULT hr = pMap->GetResource(pResourceName, &namedResource);
+    if (numCandidates == 0)
+    {
+        // A removed resource keeps its name in the schema but can't be resolved any more.
+        VERIFY_IS_TRUE(FAILED(hr) || (namedResource.GetNumCandidates() == 0));
+        return;
+    }
+
+    VERIFY_SUCCEEDED(hr);
+    VERIFY_ARE_EQUAL(namedResource.GetNumCandidates(), numCandidates);
+
+    bool foundNeutral = false;
+    for (int i = 0; i < namedResource.GetNumCandidates(); i++)
+    {
+        ResourceCandidateResult candidate;
+        QualifierSetResult qualifiers;
+        int qualifierSetIndex;
+        StringResult value;
+
+        VERIFY_SUCCEEDED(namedResource.GetCandidate(i, &candidate));
+        VERIFY_SUCCEEDED(candidate.GetQualifiers(&qualifiers));
+        VERIFY_SUCCEEDED(qualifiers.GetIndex(&qualifierSetIndex));
+        VERIFY_IS_TRUE(candidate.TryGetStringValue(&value));
+
+        if (qualifierSetIndex == IDecisionInfo::UnconditionalQualifierSetIndex)
+        {
+            VERIFY_ARE_EQUAL(DefString_Compare(value.GetRef(), pNeutralValue), Def_Equal);
+            foundNeutral = true;
+        }
+    }
+
+    VERIFY_IS_TRUE(foundNeutral);
+}
+
+} // namespace UnitTests
@@ -35,7 +35,20 @@ public:
         TEST_METHOD_PROPERTY(L"DataSource", L"Table:ResourcePackMerge.UnitTests.xml#LoadPriWitMergeTests")
     END_TEST_METHOD();
 
+    BEGIN_TEST_METHOD(StreamingMergeTest)
+        TEST_METHOD_PROPERTY(L"DataSource", L"Table:ResourcePackMerge.UnitTests.xml#ThreeFilesMergeTests")
+    END_TEST_METHOD();
+
 private:
+    bool _MergePriFiles(
+        _In_ CoreProfile* pProfile,
+        _In_ DynamicArray<PCWSTR>* pPriPaths,
+        _In_ bool bStreaming,
+        _In_ UINT64 cbMaxLoadedInputBytes,
+        _In_ PCWSTR pszOutputFile);
+
+    bool _VerifyFilesAreIdentical(_In_ PCWSTR pszFile1, _In_ PCWSTR pszFile2);
+
     bool _BuildAndVerifyPri(_In_ TestHPri* pTestHPri, _In_ PCWSTR pVarPrefix, _In_ bool bAutoMerge, _In_ bool bResourcePackMerge);
 
     bool _CreatePriFile(
@@ -240,6 +253,112 @@ void ResourcePackMergeTests::LoadUnloadWithResourcePackTest()
     fileBasedTestObj.CleanupClassFolders();
 }
 
+void ResourcePackMergeTests::StreamingMergeTest()
+{
+    FileBasedTest fileBasedTestObj;
+    String strPri3FilePath;
+    String strPri4FilePath;
+    String strPri5FilePath;
+    TestHPri testHPri3;
+    TestHPri testHPri4;
+    TestHPri testHPri5;
+
+    VERIFY_IS_TRUE(fileBasedTestObj.SetupClassFolders(L"ResourcePackMergeTests"));
+
+    VERIFY_IS_TRUE(_CreatePriFile(
+        L"Pri3_", L"ResourcePackMergeTests_StreamingMerge", L"ResourcePackMergeTests_Main.pri", testHPri3, strPri3FilePath, true, true));
+    VERIFY_IS_TRUE(_CreatePriFile(
+        L"Pri4_", L"ResourcePackMergeTests_StreamingMerge", L"ResourcePackMergeTests_it-it.pri", testHPri4, strPri4FilePath, false, true));
+    VERIFY_IS_TRUE(_CreatePriFile(
+        L"Pri5_", L"ResourcePackMergeTests_StreamingMerge", L"ResourcePackMergeTests_ko-KR.pri", testHPri5, strPri5FilePath, false, true));
+
+    AutoDeletePtr<CoreProfile> pProfile;
+    VERIFY_SUCCEEDED(CoreProfile::ChooseDefaultProfile(&pProfile));
+
+    DynamicArray<PCWSTR> priPathsCollection;
+    VERIFY_SUCCEEDED(priPathsCollection.Add(reinterpret_cast<PCWSTR>(strPri3FilePath.GetBuffer())));
+    VERIFY_SUCCEEDED(priPathsCollection.Add(reinterpret_cast<PCWSTR>(strPri4FilePath.GetBuffer())));
+    VERIFY_SUCCEEDED(priPathsCollection.Add(reinterpret_cast<PCWSTR>(strPri5FilePath.GetBuffer())));
+
+    String strOutDir;
+    fileBasedTestObj.GetTestOutputDirectory(L"ResourcePackMergeTests_StreamingMerge", NULL, strOutDir);
+    String strInMemoryPath = strOutDir;
+    strInMemoryPath += L"\\InMemoryMerge.pri";
+    String strStreamedPath = strOutDir;
+    strStreamedPath += L"\\StreamedMerge.pri";
+    String strBoundedPath = strOutDir;
+    strBoundedPath += L"\\BoundedMerge.pri";
+
+    // A ceiling of zero releases every resource pack as soon as it's been added; a large one keeps them all.
+    VERIFY_IS_TRUE(_MergePriFiles(pProfile, &priPathsCollection, false, 0, strInMemoryPath));
+    VERIFY_IS_TRUE(_MergePriFiles(pProfile, &priPathsCollection, true, 0, strStreamedPath));
+    VERIFY_IS_TRUE(_MergePriFiles(pProfile, &priPathsCollection, true, MAXUINT64, strBoundedPath));
+
+    VERIFY_IS_TRUE(_VerifyFilesAreIdentical(strInMemoryPath, strStreamedPath));
+    VERIFY_IS_TRUE(_VerifyFilesAreIdentical(strInMemoryPath, strBoundedPath));
+    _VerifyMergedFile(strStreamedPath, L"PriMerged_3_4_5_", &testHPri3);
+
+    // Streaming has to be chosen before any files are added.
+    AutoDeletePtr<ResourcePackMerge> spResourcePackMerge;
+    VERIFY_SUCCEEDED(ResourcePackMerge::CreateInstance(pProfile, &spResourcePackMerge));
+    VERIFY_SUCCEEDED(spResourcePackMerge->AddPriFile(
+        reinterpret_cast<PCWSTR>(strPri3FilePath.GetBuffer()), PriFileMerger::InPlaceMerge | PriFileMerger::DefaultPriMergeFlags));
+    VERIFY_ARE_EQUAL(spResourcePackMerge->EnableStreamingMerge(0), HRESULT_FROM_WIN32(ERROR_INVALID_OPERATION));
+    VERIFY_IS_FALSE(spResourcePackMerge->IsStreamingMerge());
+
+    fileBasedTestObj.CleanupClassFolders();
+}
+
+bool ResourcePackMergeTests::_MergePriFiles(
+    _In_ CoreProfile* pProfile,
+    _In_ DynamicArray<PCWSTR>* pPriPaths,
+    _In_ bool bStreaming,
+    _In_ UINT64 cbMaxLoadedInputBytes,
+    _In_ PCWSTR pszOutputFile)
+{
+    AutoDeletePtr<ResourcePackMerge> spResourcePackMerge;
+    VERIFY_SUCCEEDED(ResourcePackMerge::CreateInstance(pProfile, &spResourcePackMerge));
+
+    if (bStreaming)
+    {
+        VERIFY_SUCCEEDED(spResourcePackMerge->EnableStreamingMerge(cbMaxLoadedInputBytes));
+        VERIFY_IS_TRUE(spResourcePackMerge->IsStreamingMerge());
+    }
+
+    for (UINT i = 0; i < pPriPaths->Count(); i++)
+    {
+        PCWSTR path;
+        VERIFY_SUCCEEDED(pPriPaths->Get(i, &path));
+
+        PriFileMerger::PriMergeFlags mergeFlags = PriFileMerger::InPlaceMerge | PriFileMerger::DefaultPriMergeFlags;
+        if (i == 0)
+        {
+            mergeFlags |= PriFileMerger::SetPreLoad;
+        }
+        VERIFY_SUCCEEDED(spResourcePackMerge->AddPriFile(path, mergeFlags));
+    }
+
+    // Adding a file twice is still caught after the first copy has been released.
+    PCWSTR lastPath;
+    VERIFY_SUCCEEDED(pPriPaths->Get(pPriPaths->Count() - 1, &lastPath));
+    VERIFY_FAILED(spResourcePackMerge->AddPriFile(lastPath, PriFileMerger::InPlaceMerge | PriFileMerger::DefaultPriMergeFlags));
+
+    VERIFY_SUCCEEDED(spResourcePackMerge->WriteToFile(pszOutputFile));
+    return true;
+}
+
+bool ResourcePackMergeTests::_VerifyFilesAreIdentical(_In_ PCWSTR pszFile1, _In_ PCWSTR pszFile2)
+{
+    AutoDeletePtr<BaseFile> pFile1;
+    AutoDeletePtr<BaseFile> pFile2;
+    VERIFY_SUCCEEDED(BaseFile::CreateInstance(BaseFile::LoadFileFlag, pszFile1, &pFile1));
+    VERIFY_SUCCEEDED(BaseFile::CreateInstance(BaseFile::LoadFileFlag, pszFile2, &pFile2));
+
+    VERIFY_ARE_EQUAL(pFile1->GetFileSizeInBytes(), pFile2->GetFileSizeInBytes());
+    VERIFY_ARE_EQUAL(memcmp(pFile1->GetFileHeader(), pFile2->GetFileHeader(), pFile1->GetFileSizeInBytes()), 0);
+    return true;
+}
+
 bool ResourcePackMergeTests::_VerifyMergedFile(_In_ PCWSTR pszMergedFile, _In_ PCWSTR pszManifestClassName, _In_ TestHPri* pTestHPri)
 {
     // Load the merged PRI file with official API
@@ -32,6 +32,10 @@ public:
     BEGIN_TEST_METHOD(SimpleBuilderReaderTests)
         TEST_METHOD_PROPERTY(L"DataSource", L"Table:ReverseFileMap.UnitTests.xml#SimpleBuildTests")
     END_TEST_METHOD();
+
+    BEGIN_TEST_METHOD(BulkLookupTests)
+        TEST_METHOD_PROPERTY(L"DataSource", L"Table:ReverseFileMap.UnitTests.xml#SimpleBuildTests")
+    END_TEST_METHOD();
 };
 
 void ReverseFileMapUnitTests::SimpleBuilderTests()
@@ -120,4 +124,46 @@ void ReverseFileMapUnitTests::SimpleBuilderReaderTests()
         testReverseMap.GetReverseFileMap(), pEnvironment, map, testReverseMap.GetTestDI(), testReverseMap.GetDecisionInfo(), L"");
 }
 
+void ReverseFileMapUnitTests::BulkLookupTests()
+{
+    TestHPri pri;
+    TestReverseFileMap testReverseMap;
+
+    AutoDeletePtr<CoreProfile> pProfile;
+    VERIFY_SUCCEEDED(CoreProfile::ChooseDefaultProfile(&pProfile));
+    AutoDeletePtr<AtomPoolGroup> pAtoms;
+    VERIFY_SUCCEEDED(AtomPoolGroup::CreateInstance(4, &pAtoms));
+    AutoDeletePtr<UnifiedEnvironment> pEnvironment;
+    VERIFY_SUCCEEDED(UnifiedEnvironment::CreateInstance(pProfile, pAtoms, &pEnvironment));
+
+    if (FAILED(pri.InitFromTestVars(L"", NULL, pProfile, NULL)))
+    {
+        Log::Error(L"[ Couldn't init TestPri ]");
+    }
+
+    if (FAILED(testReverseMap.InitFromTestVars(pri.GetPriSectionBuilder(), pEnvironment, L"")))
+    {
+        Log::Error(L"[ Couldn't load reverse map test data ]");
+        return;
+    }
+
+    VERIFY_SUCCEEDED(testReverseMap.Finalize());
+    VERIFY_SUCCEEDED(pri.Build());
+    VERIFY_SUCCEEDED(testReverseMap.Build());
+    VERIFY_SUCCEEDED(pri.CreateReader(pProfile));
+    VERIFY_SUCCEEDED(testReverseMap.CreateReader());
+
+    ReverseFileMap* pReverseMap = testReverseMap.GetReverseFileMap();
+    if (pReverseMap->GetNumEntries() > 1)
+    {
+        VERIFY_IS_TRUE(pReverseMap->HasPathHashIndex());
+    }
+
+    // Validate contents
+    const IResourceMapBase* map;
+    VERIFY_SUCCEEDED(pri.GetPriFile()->GetPrimaryResourceMap(&map));
+    VERIFY_SUCCEEDED(TestReverseFileMap::VerifyBulkLookupAgainstTestVars(
+        pReverseMap, pEnvironment, map, testReverseMap.GetTestDI(), testReverseMap.GetDecisionInfo(), L""));
+}
+
 } // namespace UnitTests
@@ -716,4 +716,188 @@ void StringResult_Buffer::Copy(void)
     delete pCopy;
 }
 
+class StringResult_Storage : public WEX::TestClass<StringResult_Storage>, public StringResult_Struct
+{
+    TEST_CLASS(StringResult_Storage);
+
+    TEST_METHOD(ShortStringsStayInline);
+    TEST_METHOD(LongStringsUseHeap);
+    TEST_METHOD(ArenaAvoidsHeap);
+    TEST_METHOD(ArenaExhausted);
+    TEST_METHOD(ReleaseInlineContents);
+    TEST_METHOD(SetContentsFromInlineOther);
+
+    static bool IsInline(_In_ StringResult* pResult)
+    {
+        PCWSTR pBuf = pResult->GetStringResult()->pBuf;
+        PCWSTR pStart = reinterpret_cast<PCWSTR>(pResult);
+        return (pBuf >= pStart) && (pBuf < reinterpret_cast<PCWSTR>(pResult + 1));
+    }
+
+    static bool IsInArena(_In_ StringResult* pResult, _In_reads_(cchArena) PCWSTR pArena, _In_ size_t cchArena)
+    {
+        PCWSTR pBuf = pResult->GetStringResult()->pBuf;
+        return (pBuf >= pArena) && (pBuf < pArena + cchArena);
+    }
+};
+
+void StringResult_Storage::ShortStringsStayInline(void)
+{
+    StringResult result;
+    VERIFY_ARE_EQUAL(0u, result.GetHeapAllocationCount());
+
+    VERIFY_SUCCEEDED(result.SetCopy(medStr));
+    CHECK_STRINGRESULT_BUF(&result, medStr);
+    VERIFY_IS_TRUE(IsInline(&result));
+
+    VERIFY_SUCCEEDED(result.Concat(concatStr));
+    CHECK_STRINGRESULT_BUF(&result, endStr);
+    VERIFY_IS_TRUE(IsInline(&result));
+
+    VERIFY_SUCCEEDED(result.SetCopy(L"C:\\Program Files"));
+    VERIFY_SUCCEEDED(result.ConcatPathElement(L"Assets"));
+    VERIFY_ARE_EQUAL(Def_Equal, result.Compare(L"C:\\Program Files\\Assets"));
+    VERIFY_IS_TRUE(IsInline(&result));
+
+    VERIFY_SUCCEEDED(result.SetCopyInteger(123456));
+    VERIFY_ARE_EQUAL(Def_Equal, result.Compare(L"123456"));
+
+    StringResult copy;
+    VERIFY_SUCCEEDED(result.GetCopy(&copy));
+    VERIFY_IS_TRUE(IsInline(&copy));
+    VERIFY_ARE_EQUAL(Def_Equal, copy.Compare(L"123456"));
+
+    VERIFY_ARE_EQUAL(0u, result.GetHeapAllocationCount());
+    VERIFY_ARE_EQUAL(0u, copy.GetHeapAllocationCount());
+}
+
+void StringResult_Storage::LongStringsUseHeap(void)
+{
+    WCHAR longPath[StringResult::InlineBufferSizeInChars * 2];
+    for (size_t i = 0; i < _countof(longPath) - 1; i++)
+    {
+        longPath[i] = L'a' + (i % 26);
+    }
+    longPath[_countof(longPath) - 1] = L'\0';
+
+    StringResult result;
+    VERIFY_SUCCEEDED(result.SetCopy(medStr));
+    VERIFY_ARE_EQUAL(0u, result.GetHeapAllocationCount());
+
+    // Growing past the inline buffer moves the string to the heap once.
+    VERIFY_SUCCEEDED(result.ConcatPathElement(longPath));
+    VERIFY_IS_FALSE(IsInline(&result));
+    VERIFY_ARE_EQUAL(1u, result.GetHeapAllocationCount());
+
+    size_t length;
+    VERIFY_SUCCEEDED(result.GetLength(&length));
+    VERIFY_ARE_EQUAL(medLen + 1 + wcslen(longPath), length);
+
+    // Short strings reuse the heap buffer rather than allocating again.
+    VERIFY_SUCCEEDED(result.SetCopy(shortStr));
+    VERIFY_ARE_EQUAL(Def_Equal, result.Compare(shortStr));
+    VERIFY_ARE_EQUAL(1u, result.GetHeapAllocationCount());
+}
+
+void StringResult_Storage::ArenaAvoidsHeap(void)
+{
+    WCHAR arenaBuffer[512];
+    StringResultArena arena(arenaBuffer, _countof(arenaBuffer));
+
+    WCHAR longSegment[StringResult::InlineBufferSizeInChars + 8];
+    for (size_t i = 0; i < _countof(longSegment) - 1; i++)
+    {
+        longSegment[i] = L'A' + (i % 26);
+    }
+    longSegment[_countof(longSegment) - 1] = L'\0';
+
+    {
+        // The strings a lookup builds: a qualifier value, a name and a path.
+        StringResult value(&arena);
+        StringResult name(&arena);
+        StringResult path(&arena);
+
+        VERIFY_SUCCEEDED(value.SetCopy(L"en-US"));
+        VERIFY_IS_TRUE(IsInline(&value));
+
+        VERIFY_SUCCEEDED(name.SetCopy(L"Resources/"));
+        VERIFY_SUCCEEDED(name.Concat(longSegment));
+        VERIFY_IS_TRUE(IsInArena(&name, arenaBuffer, _countof(arenaBuffer)));
+
+        VERIFY_SUCCEEDED(path.SetCopy(L"C:\\Program Files\\WindowsApps"));
+        VERIFY_SUCCEEDED(path.ConcatPathElement(longSegment));
+        VERIFY_SUCCEEDED(path.ConcatPathElement(L"resources.pri"));
+        VERIFY_IS_TRUE(IsInArena(&path, arenaBuffer, _countof(arenaBuffer)));
+
+        size_t length;
+        VERIFY_SUCCEEDED(path.GetLength(&length));
+        VERIFY_ARE_EQUAL(wcslen(L"C:\\Program Files\\WindowsApps") + 1 + wcslen(longSegment) + 1 + wcslen(L"resources.pri"), length);
+
+        VERIFY_ARE_EQUAL(0u, value.GetHeapAllocationCount());
+        VERIFY_ARE_EQUAL(0u, name.GetHeapAllocationCount());
+        VERIFY_ARE_EQUAL(0u, path.GetHeapAllocationCount());
+        VERIFY_IS_TRUE(arena.GetUsedSizeInChars() > 0);
+    }
+
+    arena.Reset();
+    VERIFY_ARE_EQUAL((size_t)0, arena.GetUsedSizeInChars());
+}
+
+void StringResult_Storage::ArenaExhausted(void)
+{
+    WCHAR arenaBuffer[StringResult::InlineBufferSizeInChars * 2];
+    StringResultArena arena(arenaBuffer, _countof(arenaBuffer));
+
+    WCHAR longStr2[StringResult::InlineBufferSizeInChars * 3];
+    for (size_t i = 0; i < _countof(longStr2) - 1; i++)
+    {
+        longStr2[i] = L'x';
+    }
+    longStr2[_countof(longStr2) - 1] = L'\0';
+
+    StringResult result(&arena);
+    VERIFY_SUCCEEDED(result.SetCopy(longStr2));
+    VERIFY_IS_FALSE(IsInArena(&result, arenaBuffer, _countof(arenaBuffer)));
+    VERIFY_ARE_EQUAL(1u, result.GetHeapAllocationCount());
+    VERIFY_ARE_EQUAL((size_t)0, arena.GetUsedSizeInChars());
+    VERIFY_ARE_EQUAL(Def_Equal, result.Compare(longStr2));
+}
+
+void StringResult_Storage::ReleaseInlineContents(void)
+{
+    StringResult result;
+    VERIFY_SUCCEEDED(result.SetCopy(medStr));
+    VERIFY_IS_TRUE(IsInline(&result));
+
+    // Released buffers belong to the caller, so an inline one is copied to the heap.
+    PWSTR pStrOut = NULL;
+    size_t cchStrOut = 0;
+    VERIFY_SUCCEEDED(result.ReleaseContents(&pStrOut, &cchStrOut));
+    CHECK_STRINGRESULT_EMPTY(&result);
+    CHECK_STRINGRESULT_BUF_EMPTY(&result);
+    CHECK_BUFFER(pStrOut, cchStrOut, medStr);
+    VERIFY_ARE_EQUAL(1u, result.GetHeapAllocationCount());
+    Def_Free(pStrOut);
+
+    // The inline buffer is available again.
+    VERIFY_SUCCEEDED(result.SetCopy(shortStr));
+    VERIFY_IS_TRUE(IsInline(&result));
+    VERIFY_ARE_EQUAL(1u, result.GetHeapAllocationCount());
+}
+
+void StringResult_Storage::SetContentsFromInlineOther(void)
+{
+    StringResult other;
+    VERIFY_SUCCEEDED(other.SetCopy(medStr));
+
+    StringResult result;
+    VERIFY_SUCCEEDED(result.SetContentsFromOther(&other));
+    CHECK_STRINGRESULT_BUF(&result, medStr);
+    VERIFY_IS_TRUE(IsInline(&result));
+    CHECK_STRINGRESULT_EMPTY(&other);
+
+    VERIFY_ARE_EQUAL(0u, result.GetHeapAllocationCount());
+    VERIFY_ARE_EQUAL(0u, other.GetHeapAllocationCount());
+}
+
 } // namespace UnitTests
@@ -6,6 +6,8 @@
 #include "Helpers.h"
 #include "TestReverseMap.h"
 
+#include <vector>
+
 using namespace Microsoft::Resources;
 using namespace Microsoft::Resources::Build;
 using namespace WEX::Common;
@@ -200,4 +202,100 @@ TestReverseFileMap::VerifyAllAgainstTestVars(
     return S_OK;
 }
 
+HRESULT
+TestReverseFileMap::VerifyBulkLookupAgainstTestVars(
+    __in ReverseFileMap* pReverseMap,
+    __in const UnifiedEnvironment* pEnvironment,
+    __in const IResourceMapBase* pResourceMapBase,
+    __in TestDecisionInfo* pTestDI,
+    __in IDecisionInfo* pDecisionInfo,
+    __in PCWSTR pVarPrefix)
+{
+    TestDataArray<String> specs;
+    String tmp;
+
+    Log::Comment(tmp.Format(L"[ Verifying bulk lookup for \"%s\" ]", pVarPrefix));
+
+    if (FAILED(TestData::TryGetValue(tmp.Format(L"%sExpectedCandidateInfo", pVarPrefix), specs)))
+    {
+        Log::Warning(tmp.Format(L"[ %sExpectedCandidateInfo not defined ]", pVarPrefix));
+        return S_OK;
+    }
+
+    // One extra path that isn't in the map, which has to come back as not found.
+    size_t maxPaths = specs.GetSize() + 1;
+    std::vector<TestStringArray> parsedSpecs(maxPaths);
+    std::vector<PCWSTR> paths(maxPaths);
+    std::vector<int> wantQualifierSetIndexes(maxPaths);
+    std::vector<int> wantNamedResourceIndexes(maxPaths);
+    std::vector<int> gotQualifierSetIndexes(maxPaths);
+    std::vector<int> gotNamedResourceIndexes(maxPaths);
+
+    // Same format as VerifyAllAgainstTestVars: item ; candidate index; value type; qualifier set name; value
+    int numWanted = 0;
+    for (unsigned iSpec = 0; iSpec < specs.GetSize(); iSpec++)
+    {
+        TestStringArray& spec = parsedSpecs[numWanted];
+        if (!spec.InitFromList(specs[iSpec]) || (spec.GetNumStrings() != 5))
+        {
+            Log::Warning(tmp.Format(L"[ Error parsing spec %d in %sExpectedCandidateInfo ]", iSpec, pVarPrefix));
+            continue;
+        }
+
+        int itemIndex = -1;
+        PCWSTR pResourceName = NULL;
+        if (!spec.TryGetStringAsInt(0, &itemIndex))
+        {
+            // not an integer, must be a name.
+            pResourceName = spec.GetString(0);
+        }
+
+        QualifierSetResult wantQualifiers;
+        if (!pTestDI->GetQualifierSetData()->TryGetQualifierSet(spec.GetString(3), pDecisionInfo, pEnvironment, &wantQualifiers))
+        {
+            Log::Warning(tmp.Format(L"[ Malformed expected candidate info \"%s\" - unknown qualifier set ]", (PCWSTR)specs[iSpec]));
+            continue;
+        }
+
+        NamedResourceResult namedResourceResult;
+        VERIFY_SUCCEEDED(pResourceMapBase->GetResource(pResourceName, &namedResourceResult));
+
+        paths[numWanted] = spec.GetString(4);
+        wantQualifierSetIndexes[numWanted] = wantQualifiers.GetIndex();
+        wantNamedResourceIndexes[numWanted] = namedResourceResult.GetResourceIndexInSchema();
+        numWanted++;
+    }
+    paths[numWanted] = L"NoSuchFolder\\NoSuchFile.png";
+    int numPaths = numWanted + 1;
+
+    int numFound = -1;
+    VERIFY_ARE_EQUAL(
+        S_FALSE,
+        pReverseMap->GetCandidateInfoForPaths(
+            numPaths, paths.data(), gotQualifierSetIndexes.data(), gotNamedResourceIndexes.data(), &numFound));
+    VERIFY_ARE_EQUAL(numWanted, numFound);
+
+    for (int i = 0; i < numWanted; i++)
+    {
+        Log::Comment(tmp.Format(L"[ Candidate %d: %s ]", i, paths[i]));
+        VERIFY_ARE_EQUAL(wantQualifierSetIndexes[i], gotQualifierSetIndexes[i]);
+        VERIFY_ARE_EQUAL(wantNamedResourceIndexes[i], gotNamedResourceIndexes[i]);
+    }
+
+    VERIFY_ARE_EQUAL(-1, gotQualifierSetIndexes[numWanted]);
+    VERIFY_ARE_EQUAL(-1, gotNamedResourceIndexes[numWanted]);
+
+    // Without the missing path, everything is found.
+    VERIFY_ARE_EQUAL(
+        S_OK,
+        pReverseMap->GetCandidateInfoForPaths(
+            numWanted, paths.data(), gotQualifierSetIndexes.data(), gotNamedResourceIndexes.data(), nullptr));
+    for (int i = 0; i < numWanted; i++)
+    {
+        VERIFY_ARE_EQUAL(wantQualifierSetIndexes[i], gotQualifierSetIndexes[i]);
+        VERIFY_ARE_EQUAL(wantNamedResourceIndexes[i], gotNamedResourceIndexes[i]);
+    }
+    return S_OK;
+}
+
 } // namespace UnitTests
\ No newline at end of file
@@ -2,6 +2,7 @@
 // Licensed under the MIT License. See LICENSE in the project root for license information.
 
 #include "StdAfx.h"
+#include <psapi.h>
 #include "Helpers.h"
 #include "mrm/build/Base.h"
 #include "mrm/readers/MrmManagers.h"
@@ -73,6 +74,22 @@ public:
     END_TEST_METHOD();
 
     TEST_METHOD(EnvironmentValidationTests);
+
+    BEGIN_TEST_METHOD(ResolverContentionTests)
+        TEST_METHOD_PROPERTY(L"DataSource", L"Table:UnifiedView.UnitTests.xml#ResolverContentionTests")
+    END_TEST_METHOD();
+
+    BEGIN_TEST_METHOD(ResolverQualifierChurnTests)
+        TEST_METHOD_PROPERTY(L"DataSource", L"Table:UnifiedView.UnitTests.xml#ResolverContentionTests")
+    END_TEST_METHOD();
+
+    BEGIN_TEST_METHOD(MappedApplicationPriTests)
+        TEST_METHOD_PROPERTY(L"DataSource", L"Table:UnifiedView.UnitTests.xml#SingleMapViewTests")
+    END_TEST_METHOD();
+
+    BEGIN_TEST_METHOD(QualifierChangeTrackingTests)
+        TEST_METHOD_PROPERTY(L"DataSource", L"Table:UnifiedView.UnitTests.xml#ResolverContentionTests")
+    END_TEST_METHOD();
 };
 
 bool UnifiedResourceViewUnitTests::ClassSetup()
@@ -1183,4 +1200,487 @@ void UnifiedResourceViewUnitTests::EnvironmentValidationTests()
     VERIFY_ARE_EQUAL(hr, HRESULT_FROM_WIN32(ERROR_MRM_UNKNOWN_QUALIFIER));
 }
 
+struct ResolverContentionThreadInfo
+{
+    ProviderResolver* pResolver;
+    const DecisionResult* pDecisions;
+    const int* pExpectedSets;
+    int numDecisions;
+    int numIterations;
+    HANDLE hStart;
+    HRESULT hr;
+    int numMismatches;
+};
+
+static DWORD WINAPI ResolverContentionThreadProc(_In_ LPVOID pParam)
+{
+    ResolverContentionThreadInfo* pInfo = static_cast<ResolverContentionThreadInfo*>(pParam);
+    (void)WaitForSingleObject(pInfo->hStart, INFINITE);
+
+    for (int iteration = 0; iteration < pInfo->numIterations; iteration++)
+    {
+        for (int i = 0; i < pInfo->numDecisions; i++)
+        {
+            int resultIndex;
+            int resultSet;
+            HRESULT hr = pInfo->pResolver->EvaluateDecision(&pInfo->pDecisions[i], 1, &resultIndex, &resultSet);
+            if (FAILED(hr))
+            {
+                pInfo->hr = hr;
+                return 0;
+            }
+
+            if (resultSet != pInfo->pExpectedSets[i])
+            {
+                pInfo->numMismatches++;
+            }
+        }
+    }
+    return 0;
+}
+
+void UnifiedResourceViewUnitTests::ResolverContentionTests()
+{
+    static const int c_maxThreads = 16;
+    static const int c_maxDecisions = 32;
+
+    TestHPri testPri;
+    TestResourceMap testMap;
+
+    if (!SetupTestMethodOutputFolder(L"ResolverContentionTests"))
+    {
+        return;
+    }
+
+    String priFilePath;
+    VERIFY(GetOutputLongFilePath(L"contention.pri", priFilePath) != NULL);
+
+    TestDataArray<int> threadCounts;
+    int iterationsPerThread;
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"ThreadCounts", threadCounts));
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"IterationsPerThread", iterationsPerThread));
+
+    AutoDeletePtr<CoreProfile> pProfile;
+    VERIFY_SUCCEEDED(CoreProfile::ChooseDefaultProfile(&pProfile));
+    VERIFY_SUCCEEDED(testPri.Init(pProfile));
+    VERIFY_SUCCEEDED(testPri.GetTestDI()->InitDataFromTestVars(L""));
+    VERIFY_SUCCEEDED(testMap.InitFromTestVars(
+        testPri.GetPriSectionBuilder(), testPri.GetTestDI(), L"", GetTestOutputPath(), TestResourceMap::AddAllAsPrimary));
+    VERIFY_SUCCEEDED(testPri.WriteToFile((PCWSTR)priFilePath));
+
+    AutoDeletePtr<UnifiedResourceView> pView;
+    VERIFY_SUCCEEDED(UnifiedResourceView::CreateInstance(pProfile, &pView));
+
+    const ManagedResourceMap* pMap;
+    VERIFY_SUCCEEDED(pView->SetApplicationFile((PCWSTR)priFilePath, GetTestOutputPath(), &pMap));
+
+    ProviderResolver* pResolver = pView->GetDefaultResolver();
+    DecisionResult decisions[c_maxDecisions];
+    int expectedSets[c_maxDecisions];
+    int numDecisions = min(pMap->GetNumResources(), c_maxDecisions);
+    VERIFY_IS_TRUE(numDecisions > 0);
+
+    // Resolve everything once on a single thread; every thread must agree with this.
+    for (int i = 0; i < numDecisions; i++)
+    {
+        NamedResourceResult resource;
+        int resultIndex;
+        VERIFY_SUCCEEDED(pMap->GetResourceByIndex(i, &resource));
+        VERIFY_SUCCEEDED(resource.GetDecision(&decisions[i]));
+        VERIFY_SUCCEEDED(pResolver->EvaluateDecision(&decisions[i], 1, &resultIndex, &expectedSets[i]));
+    }
+
+    for (size_t iCount = 0; iCount < threadCounts.GetSize(); iCount++)
+    {
+        int numThreads = min(threadCounts[iCount], c_maxThreads);
+
+        for (int pass = 0; pass < 2; pass++)
+        {
+            // The first pass starts from a cold cache so the fill path is contended too.
+            bool coldCache = (pass == 0);
+            if (coldCache)
+            {
+                pResolver->Reset();
+            }
+
+            HANDLE hStart = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+            VERIFY_IS_NOT_NULL(hStart);
+
+            ResolverContentionThreadInfo info[c_maxThreads] = {};
+            HANDLE threads[c_maxThreads] = {};
+            for (int t = 0; t < numThreads; t++)
+            {
+                info[t] = {pResolver, decisions, expectedSets, numDecisions, iterationsPerThread, hStart, S_OK, 0};
+                threads[t] = CreateThread(nullptr, 0, ResolverContentionThreadProc, &info[t], 0, nullptr);
+                VERIFY_IS_NOT_NULL(threads[t]);
+            }
+
+            LARGE_INTEGER frequency;
+            LARGE_INTEGER start;
+            LARGE_INTEGER end;
+            QueryPerformanceFrequency(&frequency);
+            QueryPerformanceCounter(&start);
+            SetEvent(hStart);
+            VERIFY_ARE_EQUAL(WaitForMultipleObjects(numThreads, threads, TRUE, INFINITE), WAIT_OBJECT_0);
+            QueryPerformanceCounter(&end);
+
+            for (int t = 0; t < numThreads; t++)
+            {
+                CloseHandle(threads[t]);
+                VERIFY_SUCCEEDED(info[t].hr);
+                VERIFY_ARE_EQUAL(info[t].numMismatches, 0);
+            }
+            CloseHandle(hStart);
+
+            double seconds = static_cast<double>(end.QuadPart - start.QuadPart) / static_cast<double>(frequency.QuadPart);
+            double lookups = static_cast<double>(numThreads) * iterationsPerThread * numDecisions;
+            String msg;
+            Log::Comment(msg.Format(
+                L"%d thread(s), %s cache: %.0f lookups/sec (%.0f per thread)",
+                numThreads,
+                coldCache ? L"cold" : L"warm",
+                (seconds > 0) ? (lookups / seconds) : 0.0,
+                (seconds > 0) ? (lookups / seconds / numThreads) : 0.0));
+        }
+    }
+}
+
+struct ResolverChurnThreadInfo
+{
+    ProviderResolver* pResolver;
+    const DecisionResult* pDecisions;
+    const int* pExpectedSetsA;
+    const int* pExpectedSetsB;
+    int numDecisions;
+    volatile LONG* pStop;
+    HANDLE hStart;
+    HRESULT hr;
+    int numMismatches;
+    int numLookups;
+};
+
+static DWORD WINAPI ResolverChurnThreadProc(_In_ LPVOID pParam)
+{
+    ResolverChurnThreadInfo* pInfo = static_cast<ResolverChurnThreadInfo*>(pParam);
+    (void)WaitForSingleObject(pInfo->hStart, INFINITE);
+
+    while (ReadAcquire(pInfo->pStop) == 0)
+    {
+        for (int i = 0; i < pInfo->numDecisions; i++)
+        {
+            int resultIndex;
+            int resultSet;
+            HRESULT hr = pInfo->pResolver->EvaluateDecision(&pInfo->pDecisions[i], 1, &resultIndex, &resultSet);
+            if (FAILED(hr))
+            {
+                pInfo->hr = hr;
+                return 0;
+            }
+
+            // Whichever language was current, the winner must be the one for that language.
+            if ((resultSet != pInfo->pExpectedSetsA[i]) && (resultSet != pInfo->pExpectedSetsB[i]))
+            {
+                pInfo->numMismatches++;
+            }
+            pInfo->numLookups++;
+        }
+    }
+    return 0;
+}
+
+void UnifiedResourceViewUnitTests::ResolverQualifierChurnTests()
+{
+    static const int c_maxThreads = 16;
+    static const int c_maxDecisions = 32;
+
+    TestHPri testPri;
+    TestResourceMap testMap;
+
+    if (!SetupTestMethodOutputFolder(L"ResolverQualifierChurnTests"))
+    {
+        return;
+    }
+
+    String priFilePath;
+    VERIFY(GetOutputLongFilePath(L"churn.pri", priFilePath) != NULL);
+
+    TestDataArray<int> threadCounts;
+    int iterationsPerThread;
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"ThreadCounts", threadCounts));
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"IterationsPerThread", iterationsPerThread));
+
+    AutoDeletePtr<CoreProfile> pProfile;
+    VERIFY_SUCCEEDED(CoreProfile::ChooseDefaultProfile(&pProfile));
+    VERIFY_SUCCEEDED(testPri.Init(pProfile));
+    VERIFY_SUCCEEDED(testPri.GetTestDI()->InitDataFromTestVars(L""));
+    VERIFY_SUCCEEDED(testMap.InitFromTestVars(
+        testPri.GetPriSectionBuilder(), testPri.GetTestDI(), L"", GetTestOutputPath(), TestResourceMap::AddAllAsPrimary));
+    VERIFY_SUCCEEDED(testPri.WriteToFile((PCWSTR)priFilePath));
+
+    AutoDeletePtr<UnifiedResourceView> pView;
+    VERIFY_SUCCEEDED(UnifiedResourceView::CreateInstance(pProfile, &pView));
+
+    const ManagedResourceMap* pMap;
+    VERIFY_SUCCEEDED(pView->SetApplicationFile((PCWSTR)priFilePath, GetTestOutputPath(), &pMap));
+
+    ProviderResolver* pResolver = pView->GetDefaultResolver();
+    DecisionResult decisions[c_maxDecisions];
+    int expectedSetsA[c_maxDecisions];
+    int expectedSetsB[c_maxDecisions];
+    int numDecisions = min(pMap->GetNumResources(), c_maxDecisions);
+    VERIFY_IS_TRUE(numDecisions > 0);
+
+    // Every resource has a candidate per language, so switching the language switches the winner.
+    VERIFY_SUCCEEDED(pResolver->SetQualifier(L"Language", L"en-US"));
+    for (int i = 0; i < numDecisions; i++)
+    {
+        NamedResourceResult resource;
+        int resultIndex;
+        VERIFY_SUCCEEDED(pMap->GetResourceByIndex(i, &resource));
+        VERIFY_SUCCEEDED(resource.GetDecision(&decisions[i]));
+        VERIFY_SUCCEEDED(pResolver->EvaluateDecision(&decisions[i], 1, &resultIndex, &expectedSetsA[i]));
+    }
+
+    VERIFY_SUCCEEDED(pResolver->SetQualifier(L"Language", L"de-DE"));
+    for (int i = 0; i < numDecisions; i++)
+    {
+        int resultIndex;
+        VERIFY_SUCCEEDED(pResolver->EvaluateDecision(&decisions[i], 1, &resultIndex, &expectedSetsB[i]));
+        VERIFY_ARE_NOT_EQUAL(expectedSetsA[i], expectedSetsB[i]);
+    }
+
+    for (size_t iCount = 0; iCount < threadCounts.GetSize(); iCount++)
+    {
+        int numThreads = min(threadCounts[iCount], c_maxThreads);
+        volatile LONG stop = 0;
+
+        HANDLE hStart = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        VERIFY_IS_NOT_NULL(hStart);
+
+        ResolverChurnThreadInfo info[c_maxThreads] = {};
+        HANDLE threads[c_maxThreads] = {};
+        for (int t = 0; t < numThreads; t++)
+        {
+            info[t] = {pResolver, decisions, expectedSetsA, expectedSetsB, numDecisions, &stop, hStart, S_OK, 0, 0};
+            threads[t] = CreateThread(nullptr, 0, ResolverChurnThreadProc, &info[t], 0, nullptr);
+            VERIFY_IS_NOT_NULL(threads[t]);
+        }
+
+        // Flip the language back and forth while the readers resolve.
+        SetEvent(hStart);
+        for (int iteration = 0; iteration < iterationsPerThread; iteration++)
+        {
+            VERIFY_SUCCEEDED(pResolver->SetQualifier(L"Language", ((iteration % 2) == 0) ? L"en-US" : L"de-DE"));
+        }
+        InterlockedExchange(&stop, 1);
+        VERIFY_ARE_EQUAL(WaitForMultipleObjects(numThreads, threads, TRUE, INFINITE), WAIT_OBJECT_0);
+
+        int numLookups = 0;
+        for (int t = 0; t < numThreads; t++)
+        {
+            CloseHandle(threads[t]);
+            VERIFY_SUCCEEDED(info[t].hr);
+            VERIFY_ARE_EQUAL(info[t].numMismatches, 0);
+            numLookups += info[t].numLookups;
+        }
+        CloseHandle(hStart);
+
+        // Once the churn stops, lookups have to agree with the last value set.
+        const int* pFinalSets = ((iterationsPerThread % 2) == 0) ? expectedSetsB : expectedSetsA;
+        for (int i = 0; i < numDecisions; i++)
+        {
+            int resultIndex;
+            int resultSet;
+            VERIFY_SUCCEEDED(pResolver->EvaluateDecision(&decisions[i], 1, &resultIndex, &resultSet));
+            VERIFY_ARE_EQUAL(resultSet, pFinalSets[i]);
+        }
+
+        String msg;
+        Log::Comment(msg.Format(L"%d thread(s): %d lookups across %d qualifier changes", numThreads, numLookups, iterationsPerThread));
+    }
+}
+
+void UnifiedResourceViewUnitTests::QualifierChangeTrackingTests()
+{
+    TestHPri testPri;
+    TestResourceMap testMap;
+
+    if (!SetupTestMethodOutputFolder(L"QualifierChangeTrackingTests"))
+    {
+        return;
+    }
+
+    String priFilePath;
+    VERIFY(GetOutputLongFilePath(L"tracking.pri", priFilePath) != NULL);
+
+    AutoDeletePtr<CoreProfile> pProfile;
+    VERIFY_SUCCEEDED(CoreProfile::ChooseDefaultProfile(&pProfile));
+    VERIFY_SUCCEEDED(testPri.Init(pProfile));
+    VERIFY_SUCCEEDED(testPri.GetTestDI()->InitDataFromTestVars(L""));
+    VERIFY_SUCCEEDED(testMap.InitFromTestVars(
+        testPri.GetPriSectionBuilder(), testPri.GetTestDI(), L"", GetTestOutputPath(), TestResourceMap::AddAllAsPrimary));
+    VERIFY_SUCCEEDED(testPri.WriteToFile((PCWSTR)priFilePath));
+
+    AutoDeletePtr<UnifiedResourceView> pView;
+    VERIFY_SUCCEEDED(UnifiedResourceView::CreateInstance(pProfile, &pView));
+
+    const ManagedResourceMap* pMap;
+    VERIFY_SUCCEEDED(pView->SetApplicationFile((PCWSTR)priFilePath, GetTestOutputPath(), &pMap));
+
+    ProviderResolver* pResolver = pView->GetDefaultResolver();
+    VERIFY_SUCCEEDED(pResolver->SetQualifier(L"Language", L"fr-FR"));
+    LONG generation = pResolver->GetQualifierGeneration();
+
+    int numDecisions;
+    ResolverBase::FrozenDecisions* pFrozen;
+    VERIFY_SUCCEEDED(pResolver->BeginFreeze(&pFrozen, &numDecisions));
+    VERIFY_SUCCEEDED(pResolver->FreezeDecisions(pFrozen, 0, numDecisions));
+    VERIFY_SUCCEEDED(pResolver->EndFreeze(pFrozen, true));
+    VERIFY_IS_TRUE(pResolver->IsFrozen());
+
+    Log::Comment(L"[ Freezing again replaces the table ]");
+    VERIFY_SUCCEEDED(pResolver->BeginFreeze(&pFrozen, &numDecisions));
+    VERIFY_SUCCEEDED(pResolver->FreezeDecisions(pFrozen, 0, numDecisions));
+    VERIFY_SUCCEEDED(pResolver->EndFreeze(pFrozen, true));
+    VERIFY_IS_TRUE(pResolver->IsFrozen());
+
+    Log::Comment(L"[ Setting a qualifier to its current value keeps the caches ]");
+    VERIFY_SUCCEEDED(pResolver->SetQualifier(L"Language", L"fr-FR"));
+    VERIFY_ARE_EQUAL(generation, pResolver->GetQualifierGeneration());
+    VERIFY_IS_TRUE(pResolver->IsFrozen());
+
+    Log::Comment(L"[ Setting a qualifier to a new value invalidates the caches ]");
+    VERIFY_SUCCEEDED(pResolver->SetQualifier(L"Language", L"FR-fr"));
+    VERIFY_ARE_NOT_EQUAL(generation, pResolver->GetQualifierGeneration());
+    VERIFY_IS_FALSE(pResolver->IsFrozen());
+
+    generation = pResolver->GetQualifierGeneration();
+    VERIFY_SUCCEEDED(pResolver->SetQualifier(L"Language", L"de-DE"));
+    VERIFY_ARE_NOT_EQUAL(generation, pResolver->GetQualifierGeneration());
+
+    StringResult value;
+    VERIFY_SUCCEEDED(pResolver->GetQualifierValue(L"Language", &value));
+    VERIFY_ARE_EQUAL(0, wcscmp(value.GetRef(), L"de-DE"));
+
+    Log::Comment(L"[ Resetting the resolver drops the values ]");
+    generation = pResolver->GetQualifierGeneration();
+    pResolver->Reset();
+    VERIFY_ARE_NOT_EQUAL(generation, pResolver->GetQualifierGeneration());
+}
+
+void UnifiedResourceViewUnitTests::MappedApplicationPriTests()
+{
+    TestHPri testPri;
+    TestResourceMap testMap;
+    String tmp;
+
+    if (!SetupTestMethodOutputFolder(L"MappedApplicationPriTests"))
+    {
+        return;
+    }
+
+    String priFilePath;
+    VERIFY(GetOutputLongFilePath(L"mapped.pri", priFilePath) != NULL);
+
+    AutoDeletePtr<CoreProfile> pProfile;
+    VERIFY_SUCCEEDED(CoreProfile::ChooseDefaultProfile(&pProfile));
+    VERIFY_SUCCEEDED(testPri.Init(pProfile));
+    VERIFY_SUCCEEDED(testPri.GetTestDI()->InitDataFromTestVars(L""));
+    VERIFY_SUCCEEDED(testMap.InitFromTestVars(
+        testPri.GetPriSectionBuilder(), testPri.GetTestDI(), L"", GetTestOutputPath(), TestResourceMap::AddAllAsPrimary));
+    VERIFY_SUCCEEDED(testPri.WriteToFile((PCWSTR)priFilePath));
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+
+    // Open the same file mapped (the default) and loaded into memory, and report what each costs the process.
+    for (int pass = 0; pass < 2; pass++)
+    {
+        bool isMapped = (pass == 0);
+
+        AutoDeletePtr<UnifiedResourceView> pView;
+        VERIFY_SUCCEEDED(UnifiedResourceView::CreateInstance(pProfile, &pView));
+        if (!isMapped)
+        {
+            VERIFY_SUCCEEDED(pView->SetDefaultFileFlags(BaseFile::LoadFileFlag));
+        }
+
+        PROCESS_MEMORY_COUNTERS_EX before = {};
+        VERIFY_WIN32_BOOL_SUCCEEDED(
+            GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&before), sizeof(before)));
+
+        LARGE_INTEGER start;
+        QueryPerformanceCounter(&start);
+
+        const PriFile* pPriFile;
+        VERIFY_SUCCEEDED(pView->SetApplicationPriFile((PCWSTR)priFilePath, GetTestOutputPath(), &pPriFile));
+
+        LARGE_INTEGER end;
+        QueryPerformanceCounter(&end);
+
+        PROCESS_MEMORY_COUNTERS_EX after = {};
+        VERIFY_WIN32_BOOL_SUCCEEDED(
+            GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&after), sizeof(after)));
+
+        // A mapped file lives in a file-backed view rather than in our private heap.
+        const BaseFile* pBaseFile;
+        VERIFY_SUCCEEDED(pPriFile->GetBaseFile(&pBaseFile));
+        MEMORY_BASIC_INFORMATION memoryInfo;
+        VERIFY_ARE_EQUAL(VirtualQuery(pBaseFile->GetFileHeader(), &memoryInfo, sizeof(memoryInfo)), sizeof(memoryInfo));
+        VERIFY_ARE_EQUAL(memoryInfo.Type, static_cast<DWORD>(isMapped ? MEM_MAPPED : MEM_PRIVATE));
+
+        const IResourceMapBase* pMap;
+        VERIFY_SUCCEEDED(pView->GetResourceMap(0, &pMap));
+        TestResourceMap::VerifyAllAgainstTestVars(pMap, testPri.GetTestDI(), pView->GetUnifiedEnvironment(), L"");
+
+        Log::Comment(tmp.Format(
+            L"%s: %Iu byte file, private bytes %+I64d, working set %+I64d, %.3f ms",
+            isMapped ? L"Mapped" : L"Loaded",
+            pBaseFile->GetFileSizeInBytes(),
+            static_cast<INT64>(after.PrivateUsage) - static_cast<INT64>(before.PrivateUsage),
+            static_cast<INT64>(after.WorkingSetSize) - static_cast<INT64>(before.WorkingSetSize),
+            ((end.QuadPart - start.QuadPart) * 1000.0) / frequency.QuadPart));
+    }
+
+    // Opening a file only validates its structure; a damaged section is caught when that section is first used.
+    AutoDeletePtr<BaseFile> pFile;
+    VERIFY_SUCCEEDED(BaseFile::CreateInstance(BaseFile::LoadFileFlag, (PCWSTR)priFilePath, &pFile));
+
+    BaseFile::SectionIndex damagedIndex = pFile->GetFirstSectionIndex(gDataItemsSectionType);
+    VERIFY_IS_TRUE(damagedIndex >= 0);
+
+    const DEFFILE_SECTION_HEADER* pSectionHeader;
+    VERIFY_SUCCEEDED(pFile->GetSectionHeader(damagedIndex, &pSectionHeader));
+    const BYTE* pFileData = reinterpret_cast<const BYTE*>(pFile->GetFileHeader());
+    size_t trailerOffset = reinterpret_cast<const BYTE*>(BaseFile::GetSectionTrailer(pSectionHeader)) - pFileData;
+
+    String damagedPath;
+    VERIFY(GetOutputLongFilePath(L"damaged.pri", damagedPath) != NULL);
+
+    HANDLE hFile = INVALID_HANDLE_VALUE;
+    VERIFY_IS_TRUE(CreateOutputFile(L"damaged.pri", &hFile));
+    DWORD cbWritten = 0;
+    UINT32 badMarker = ~DEFFILE_SECTION_END_MARKER;
+    VERIFY_WIN32_BOOL_SUCCEEDED(WriteFile(hFile, pFileData, static_cast<DWORD>(pFile->GetFileSizeInBytes()), &cbWritten, NULL));
+    VERIFY_ARE_EQUAL(SetFilePointer(hFile, static_cast<LONG>(trailerOffset), NULL, FILE_BEGIN), static_cast<DWORD>(trailerOffset));
+    VERIFY_WIN32_BOOL_SUCCEEDED(WriteFile(hFile, &badMarker, sizeof(badMarker), &cbWritten, NULL));
+    CloseHandle(hFile);
+
+    AutoDeletePtr<BaseFile> pDamagedFile;
+    VERIFY_SUCCEEDED(BaseFile::CreateInstance(BaseFile::MapFileFlag, (PCWSTR)damagedPath, &pDamagedFile));
+
+    for (int i = 0; i < pDamagedFile->GetNumSections(); i++)
+    {
+        const void* pSectionData;
+        UINT32 cbSectionData;
+        VERIFY_SUCCEEDED(pDamagedFile->GetSectionHeader(i, &pSectionHeader));
+        VERIFY_SUCCEEDED(pDamagedFile->GetSectionData(i, &pSectionData, &cbSectionData));
+
+        HRESULT hr = pDamagedFile->ValidateSection(i, pSectionHeader, cbSectionData);
+        VERIFY_ARE_EQUAL(hr, (i == damagedIndex) ? HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE) : S_OK);
+    }
+
+    // MethodCleanup() cleans up for us
+}
+
 } // namespace UnitTests
@@ -59,6 +59,14 @@ public:
         __in TestDecisionInfo* pTestDI,
         __in IDecisionInfo* pDecisionInfo,
         __in PCWSTR pVarPrefix);
+
+    static HRESULT VerifyBulkLookupAgainstTestVars(
+        __in ReverseFileMap* pReverseMap,
+        __in const UnifiedEnvironment* pEnvironment,
+        __in const IResourceMapBase* pResourceMapBase,
+        __in TestDecisionInfo* pTestDI,
+        __in IDecisionInfo* pDecisionInfo,
+        __in PCWSTR pVarPrefix);
 };
 
 } // namespace UnitTests
@@ -158,6 +158,8 @@ public:
 
     static const HashMethod HashMethodDefault = DEF_HASH_DEFAULT;
     static const HashMethod HashMethodCaseInsensitive = DEF_HASH_CASE_INSENSITIVE;
+    static const HashMethod HashMethodStrong = DEF_HASH_STRONG;
+    static const HashMethod HashMethodStrongCaseInsensitive = static_cast<HashMethod>(DEF_HASH_STRONG | DEF_HASH_CASE_INSENSITIVE);
 
     static bool IsValidPoolIndex(Atom::Index index) { return (index > 0) && (index <= DEF_ATOM_MAX_INDEX); }
 
@@ -276,6 +276,51 @@ protected:
     int m_index{ 0 };
 };
 
+/*!
+ * A flattened, read-only view of a decision pool, for code that walks
+ * decisions and qualifier sets in tight loops.
+ *
+ * Decisions and qualifier sets are [first, first + count) ranges into
+ * pReferences, which holds qualifier set indexes for decisions and qualifier
+ * indexes for qualifier sets.  Qualifiers are packed into a single array with
+ * their attribute already mapped to the runtime atom pool.  Every range and
+ * reference is validated when the view is built, so callers can index the
+ * arrays directly.
+ */
+struct DecisionInfoFlatView
+{
+    typedef struct _FlatQualifier
+    {
+        DEF_ATOM_SMALL attribute;
+        UINT16 priority;
+        UINT16 fallbackScore;
+    } FlatQualifier;
+
+    int numQualifiers;
+    int numQualifierSets;
+    int numDecisions;
+
+    _Field_size_(numQualifiers) const FlatQualifier* pQualifiers;
+    _Field_size_(numQualifierSets) const MRMFILE_QUALIFIER_SET* pQualifierSets;
+    _Field_size_(numDecisions) const MRMFILE_DECISION* pDecisions;
+    const UINT16* pReferences;
+
+    bool IsValidQualifierSetIndex(_In_ int index) const { return (index >= 0) && (index < numQualifierSets); }
+
+    bool IsValidDecisionIndex(_In_ int index) const { return (index >= 0) && (index < numDecisions); }
+
+    int GetNumQualifiersInSet(_In_ int setIndex) const { return pQualifierSets[setIndex].numQualifierRefs; }
+
+    const UINT16* GetQualifierIndexesInSet(_In_ int setIndex) const { return &pReferences[pQualifierSets[setIndex].firstQualifierRef]; }
+
+    int GetNumSetsInDecision(_In_ int decisionIndex) const { return pDecisions[decisionIndex].numQualifierSetRefs; }
+
+    const UINT16* GetSetIndexesInDecision(_In_ int decisionIndex) const
+    {
+        return &pReferences[pDecisions[decisionIndex].firstQualifierSetRef];
+    }
+};
+
 class IEnvironment;
 
 class IDecisionInfo : public DefObject
@@ -295,6 +340,9 @@ public:
 
     virtual HRESULT GetDecisionNumQualifierSets(_In_ int index, _Out_ int* pNumSetsOut) const = 0;
 
+    // Returns nullptr if this pool doesn't keep a flat view.
+    virtual const DecisionInfoFlatView* GetFlatView() const { return nullptr; }
+
     static const int AlwaysTrueQualifierIndex = MRMFILE_ALWAYS_TRUE_QUALIFIER_INDEX;
     static const int UnconditionalQualifierSetIndex = MRMFILE_UNCONDITIONAL_QUALIFIER_SET_INDEX;
     static const int EmptyDecisionIndex = MRMFILE_EMPTY_DECISION_INDEX;
@@ -8,11 +8,44 @@
 namespace Microsoft::Resources
 {
 
+/*!
+ * Caller-supplied memory for StringResult buffers that don't fit inline.
+ * Space is only given back by Reset(), so an arena suits the short-lived
+ * strings of a single operation such as a lookup.  Not thread-safe; every
+ * StringResult using it must be destroyed before it is reset or destroyed.
+ */
+class StringResultArena : public DefObject
+{
+public:
+    StringResultArena(_Out_writes_(bufferSizeInChars) PWSTR buffer, _In_ size_t bufferSizeInChars);
+
+    void Reset() { m_arena.cchUsed = 0; }
+
+    size_t GetUsedSizeInChars() const { return m_arena.cchUsed; }
+    size_t GetSizeInChars() const { return m_arena.cchArena; }
+
+    DEFSTRINGARENA* GetArena() { return &m_arena; }
+
+private:
+    DEFSTRINGARENA m_arena;
+
+    StringResultArena(const StringResultArena&);
+    StringResultArena& operator=(const StringResultArena&);
+};
+
 class StringResult : public DefObject
 {
+public:
+    //! Strings up to this size, including the terminator, are kept in the result itself.
+    static const UINT32 InlineBufferSizeInChars = 32;
+
 protected:
     DEFSTRINGRESULT* m_pString;
     DEFSTRINGRESULT m_string;
+    DEFSTRINGSTORAGE m_storage;
+    WCHAR m_inlineBuffer[InlineBufferSizeInChars];
+
+    void AttachStorage(_In_opt_ StringResultArena* arena);
 
 public:
     HRESULT Init(_In_opt_ PCWSTR initialString, _In_ DEFRESULTTYPE type);
@@ -25,6 +58,9 @@ public:
     //! Creates an empty string
     StringResult();
 
+    //! Creates an empty string that takes buffers too big to keep inline from arena, before the heap
+    explicit StringResult(_In_opt_ StringResultArena* arena);
+
     //! \see DefStringResult_New()
     static HRESULT CreateInstance(_In_opt_ PCWSTR initialString, _In_ DEFRESULTTYPE type, _Outptr_ StringResult** result);
 
@@ -42,6 +78,9 @@ public:
          */
     DEFSTRINGRESULT* GetStringResult() { return m_pString; }
 
+    //! \returns the number of buffers this result has had to allocate from the heap.
+    UINT32 GetHeapAllocationCount() const { return m_storage.numHeapAllocations; }
+
     //! \see DefStringResult_SetRef()
     HRESULT SetRef(_In_opt_ PCWSTR str);
 
@@ -19,6 +19,7 @@ private:
         fDefault = 0x0000,
         fIsCaseInsensitive = 0x0001,
         fIsNotSorted = 0x0004,
+        fHasOpenHashTable = 0x0010,
         fStringPoolIsOwned = 0x0100
     };
 
@@ -47,6 +48,8 @@ protected:
 
     HRESULT Extend(__in size_t newSize);
 
+    HRESULT BuildOpenHashTable(__out_ecount(numSlots) DEFFILE_ATOMPOOL_HASHINDEX* pSlots, __in UINT32 numSlots) const;
+
 public:
     static HRESULT CreateInstance(__in PCWSTR pDescription, bool isCaseInsensitive, _Outptr_ FileAtomPoolBuilder** result);
     static HRESULT CreateInstance(
@@ -110,6 +110,8 @@ private:
     UINT32 m_cbSectionData;
     UINT32 m_nSectionDataUsed;
 
+    bool m_parallelBuild;
+
 protected:
     FileBuilder(DEFFILE_MAGIC magic);
 
@@ -126,6 +128,11 @@ public:
 
     HRESULT AddSection(__in ISectionBuilder* pSection);
 
+    // Has pSection write the section at sectionIndex in place of the builder that added it.  Only
+    // allowed between FinalizeAllSections and generating the file, so the original builder is still
+    // finalized and the sections that refer to it see its final state.  Doesn't take ownership.
+    HRESULT ReplaceSection(__in BaseFile::SectionIndex sectionIndex, __in ISectionBuilder* pSection);
+
     BaseFile::SectionIndex GetDescriptorIndex() { return m_descriptorIndex; }
 
     HRESULT SetDescriptorIndex(__in BaseFile::SectionIndex index);
@@ -175,6 +182,11 @@ public:
 
     DEFFILE_MAGIC GetMagic() { return m_magic; }
 
+    // When set, section contents are generated concurrently on the thread pool and
+    // then laid out in section order, so the output matches a serial build.
+    bool GetParallelBuild() const { return m_parallelBuild; }
+    void SetParallelBuild(bool parallelBuild) { m_parallelBuild = parallelBuild; }
+
     virtual HRESULT GetMaxSize(_Out_ UINT32* size);
 
     virtual HRESULT FinalizeAllSections();
@@ -188,6 +200,8 @@ private:
 
     virtual HRESULT BuildAllSections();
 
+    HRESULT BuildAllSectionsParallel();
+
     virtual HRESULT FinishGenerating();
 
     virtual HRESULT GenerateFileContentsInternal();
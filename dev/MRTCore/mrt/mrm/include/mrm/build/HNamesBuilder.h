@@ -578,6 +578,7 @@ public:
     static const UINT32 BuildAsciiOrUtf16 = 0x1;
     static const UINT32 BuildEncodingFlagsMask = 0x1;
     static const UINT32 BuildLargeHNamesNode = 0x2;
+    static const UINT32 BuildWithoutPathHashIndex = 0x4;
 
     static HRESULT CreateInstance(_In_ UINT32 flags, _Outptr_ HierarchicalNamesBuilder** result);
     static HRESULT CreateInstance(_In_ UINT32 flags, _In_ AtomPoolGroup* pAtoms, _Outptr_ HierarchicalNamesBuilder** result);
@@ -792,6 +793,17 @@ protected:
 
     bool AssignChildNameIndices(__in ScopeInfo* pScopeInfo, __in int* pNextNameIndex);
 
+    /*!
+         * Gets the number of slots in the full-path hash index, or 0
+         * if no index is to be generated.
+         */
+    UINT32 GetPathHashIndexNumSlots() const;
+
+    HRESULT AddPathHashIndexEntry(
+        _In_ const HNamesNode* pNode,
+        _In_ UINT32 numSlots,
+        _Inout_updates_(numSlots) DEFFILE_HNAMES_PATH_HASH_SLOT* pSlots) const;
+
     HRESULT AddScope(__in ScopeInfo* pScope, __out int* pIndexOut);
 
     HRESULT AddItem(__in ItemInfo* pItem, __out int* pIndexOut);
@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "mrm/build/SectionCopiers.h"
+
+namespace Microsoft::Resources::Build
+{
+
+/*!
+ * Rebuilds a PRI file from a previous build of the same PRI plus a delta, so that
+ * resources which didn't change are carried forward from the previous file instead
+ * of being re-indexed from their sources.
+ *
+ * The delta is described with the usual AddCandidate* calls on GetDescriptor().  A
+ * named resource that gets any candidate in this build replaces all of its previous
+ * candidates, and a name that isn't in the previous schema is added to it.
+ * RemoveResource drops a previous resource; as with any build from a previous schema,
+ * its name stays in the schema.
+ *
+ * The new PRI is built on the previous schema, so every previous resource keeps its
+ * index.  If the delta added no names, the schema's version checksum is unchanged and
+ * the previous schema section is copied into the new file as it is.  Every other
+ * section is rebuilt: carried-forward candidates are re-added one by one, and their
+ * data goes through the data item orchestrator, which shares identical values by
+ * checksum.  If the delta turns out to be empty, WriteToFile leaves the previous file
+ * as it is rather than rewriting it.
+ */
+class IncrementalPriBuilder : public DefObject
+{
+public:
+    static HRESULT CreateInstance(_In_ PCWSTR pPreviousPriFilePath, _In_ CoreProfile* pProfile, _Outptr_ IncrementalPriBuilder** result);
+
+    ~IncrementalPriBuilder();
+
+    PriSectionBuilder* GetDescriptor() const { return m_pFileBuilder->GetDescriptor(); }
+
+    HRESULT RemoveResource(_In_ PCWSTR pResourceName);
+
+    // True if the delta added so far changes anything about the previous PRI.
+    bool HasChanges() const;
+
+    bool IsFinalized() const { return m_bFinalized; }
+
+    HRESULT WriteToFile(_In_ PCWSTR pszOutputFile);
+
+private:
+    IncrementalPriBuilder();
+
+    HRESULT Init(_In_ PCWSTR pPreviousPriFilePath, _In_ CoreProfile* pProfile);
+
+    HRESULT CarryForwardResource(_In_ int resourceIndex);
+
+    // Writes the previous schema section in place of the rebuilt one if they're the same version.
+    HRESULT ReuseUnchangedSchema();
+
+    PWSTR m_pPreviousPriFilePath{ nullptr };
+    StandalonePriFile* m_pPreviousPri{ nullptr };
+    const IResourceMapBase* m_pPreviousMap{ nullptr };
+    PriFileBuilder* m_pFileBuilder{ nullptr };
+    RemapInfo* m_pRemap{ nullptr };
+    SectionCopier* m_pSchemaCopier{ nullptr };
+    bool* m_pRemovedResources{ nullptr };
+    int m_numPreviousResources{ 0 };
+    int m_numRemovedResources{ 0 };
+    bool m_bFinalized{ false };
+};
+
+} // namespace Microsoft::Resources::Build
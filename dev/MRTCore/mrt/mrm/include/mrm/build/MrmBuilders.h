@@ -743,6 +743,17 @@ public:
     virtual HRESULT GetDataBlob(_Inout_ BlobResult* pBlobResult) const = 0;
 
     virtual UINT8 GetLocatorType() const = 0;
+
+    // Gets the size of the referenced data with two independent hashes of it, its CRC32 checksum
+    // and a 64-bit FNV-1a hash.  Only references that have been detached from their source file
+    // provide this; everything else returns false.
+    virtual bool TryGetDataChecksum(_Out_ UINT32* pcbData, _Out_ DEF_CHECKSUM* pChecksum, _Out_ UINT64* pHash) const
+    {
+        *pcbData = 0;
+        *pChecksum = 0;
+        *pHash = 0;
+        return false;
+    }
 };
 
 class DataItemsBuildInstanceReference : public IBuildInstanceReference
@@ -816,6 +827,15 @@ public:
         _In_ const FileInfo* pFileInfo,
         _Outptr_ ExternalFileStaticDataInstanceReference** result);
 
+    // A detached reference records the size and hashes of the candidate's value up front and
+    // drops the candidate, so the source file can be unloaded while the reference is alive.
+    // Detached references are compared by size and both hashes and can't return their data.
+    static HRESULT CreateInstance(
+        _In_ ResourceCandidateResult* pResourceCandidateResult,
+        _In_ const FileInfo* pFileInfo,
+        _In_ bool bDetachFromSource,
+        _Outptr_ ExternalFileStaticDataInstanceReference** result);
+
     int GetInstanceLocatorTypeIndex() const { return MrmEnvironment::ResourceValueLocatorType_DataItemsSection; }
 
     HRESULT GenerateInstance(_Out_ MRMFILE_INDEX_INSTANCE* pInstanceIndex) const;
@@ -826,14 +846,22 @@ public:
 
     UINT8 GetLocatorType() const { return MRMFILE_MAP_VALUE_LOCATOR_DATA_ITEM; }
 
+    bool TryGetDataChecksum(_Out_ UINT32* pcbData, _Out_ DEF_CHECKSUM* pChecksum, _Out_ UINT64* pHash) const;
+
+    bool IsDetached() const { return m_bDetached; }
+
 private:
     ExternalFileStaticDataInstanceReference(_In_ ResourceCandidateResult* pResourceCandidateResult, _In_ const FileInfo* pFileInfo);
 
-    HRESULT Init();
+    HRESULT Init(_In_ bool bDetachFromSource);
 
     MRMFILE_INDEX_INSTANCE m_mrmIndexInstance{};
     const FileInfo* m_pFileInfo;
     ResourceCandidateResult m_resourceCandidateResult;
+    bool m_bDetached{ false };
+    UINT32 m_cbData{ 0 };
+    DEF_CHECKSUM m_dataChecksum{ 0 };
+    UINT64 m_dataHash{ 0 };
 };
 
 struct BuilderPrioritizedCondition : public DefObject
@@ -39,6 +39,13 @@ public:
 
     HRESULT AddPriFile(_In_ PCWSTR pszPriFileName, _In_ PriFileMerger::PriMergeFlags priMergeFlags);
 
+    // Switches to a streaming merge.  Each resource pack is released once its candidates have been
+    // added, oldest first, so that at most cbMaxLoadedInputBytes of resource pack data stays loaded.
+    // The main package PRI stays loaded throughout.  Must be called before the first AddPriFile.
+    HRESULT EnableStreamingMerge(_In_ UINT64 cbMaxLoadedInputBytes);
+
+    bool IsStreamingMerge() const { return m_bStreamingMerge; }
+
     bool IsFinalized() const;
 
     HRESULT WriteToFile(_In_ PCWSTR pszOutputFile);
@@ -80,6 +87,8 @@ private:
 
     bool ValidateInPlaceMergeEnabled(_In_ const PriFile* pPriFile) const;
 
+    HRESULT ReleaseLoadedResourcePacks();
+
     AtomPoolGroup* m_pAtoms;
     UnifiedEnvironment* m_pEnvironment;
     PriFileManager* m_pPriFileManager;
@@ -89,6 +98,10 @@ private:
     mutable const IHierarchicalSchema* m_pFirstEntrySchema;
     FileListBuilder* m_pFileListBuilder{ nullptr };
     DynamicArray<PriFile*>* m_pPriFileList;
+    bool m_bStreamingMerge{ false };
+    UINT64 m_cbMaxLoadedInputBytes{ 0 };
+    UINT64 m_cbLoadedInputBytes{ 0 };
+    int m_nextPackToRelease{ 1 };
 };
 
 } // namespace Microsoft::Resources
\ No newline at end of file
@@ -38,7 +38,7 @@ class DataBlobBuilder : public DefObject
 {
 protected:
     MEM_LINKED_DATABLOB* m_pHeadDataList;
-    mutable MEM_LINKED_DATABLOB* m_pCurDataList{ nullptr };
+    MEM_LINKED_DATABLOB* m_pCurDataList{ nullptr };
     UINT32 m_offset;
     static const UINT32 maxListBufferSize = 1024 * 1024; // 1M
 
@@ -117,7 +117,8 @@ extern "C"
     typedef enum
     {
         DEF_HASH_DEFAULT = 0, //!< Use the default hash function
-        DEF_HASH_CASE_INSENSITIVE = 1 //!< Use a case-insensitive hash function
+        DEF_HASH_CASE_INSENSITIVE = 1, //!< Use a case-insensitive hash function
+        DEF_HASH_STRONG = 0x10 //!< Use the strong, block-mixing hash function (combinable with DEF_HASH_CASE_INSENSITIVE)
     } DEF_ATOM_HASH_METHOD;
 
     /*! \enum DEF_ATOM_COMPARISON
@@ -308,12 +309,38 @@ extern "C"
      * _DEFSTRINGRESULT::cchBuf must be >= the length of _DEFSTRINGRESULT::pBuf + 1
      * and < STRSAFE_MAX_CCH at all times
      */
+    /*!
+     * A caller-supplied block that ::DEFSTRINGRESULT buffers can be carved from
+     * instead of the heap.  Space is never returned to the arena individually;
+     * the owner resets it once every string using it is gone.
+     */
+    typedef struct _DEFSTRINGARENA
+    {
+        __ecount(cchArena) PWSTR pArena; //!< The block owned by the caller
+        UINT32 cchArena; //!< The size of the block
+        UINT32 cchUsed; //!< The number of characters handed out so far
+    } DEFSTRINGARENA;
+
+    /*!
+     * Optional storage for a ::DEFSTRINGRESULT.  Buffers are taken from
+     * pInlineBuf if they fit, then from pArena, and only then from the heap.
+     */
+    typedef struct _DEFSTRINGSTORAGE
+    {
+        __ecount(cchInlineBuf) PWSTR pInlineBuf; //!< Small buffer owned by the caller, typically embedded next to the result
+        UINT32 cchInlineBuf; //!< The size of the inline buffer
+        DEFSTRINGARENA* pArena; //!< Arena used when the inline buffer is too small, or NULL
+        UINT32 numHeapAllocations; //!< The number of buffers that had to come from the heap
+    } DEFSTRINGSTORAGE;
+
     typedef struct _DEFSTRINGRESULT
     {
         __ecount(cchBuf) PWSTR pBuf; //!< The buffer managed by ::DEFSTRINGRESULT
         UINT32 cchBuf; //!< The allocated size of the buffer
         PCWSTR pRef; /*!< The current pStr value of the string, which might
                                or might no be resident in buf. */
+        DEFSTRINGSTORAGE* pStorage; /*!< Optional storage used before the heap.  pBuf
+                                         is only freed if it came from the heap. */
     } DEFSTRINGRESULT;
 
     typedef DEFSTRINGRESULT* PDEFSTRINGRESULT;
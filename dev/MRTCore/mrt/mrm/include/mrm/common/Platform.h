@@ -62,8 +62,20 @@ extern "C"
 
     BOOLEAN _DefUnmapViewOfFile(__in PVOID pBaseAddress);
 
+    // Asks the memory manager to read the range in with large sequential I/Os, rather than one page
+    // fault at a time as it is first touched.  The range is only a hint and may already be resident.
+    HRESULT _DefPrefetchVirtualMemory(__in_bcount(cbRange) const void* pRange, __in size_t cbRange);
+
+    // Uses PCLMULQDQ or the ARMv8 CRC32 instructions where the CPU supports them, slicing-by-8 otherwise.
     UINT32 _DefComputeCrc32(__in UINT32 partialCrc, __in_bcount(cbBuf) const BYTE* pBuf, __in UINT32 cbBuf);
 
+    // Portable implementations with output identical to _DefComputeCrc32; exposed for testing.
+    UINT32 _DefComputeCrc32Sliced(__in UINT32 partialCrc, __in_bcount(cbBuf) const BYTE* pBuf, __in UINT32 cbBuf);
+
+    UINT32 _DefComputeCrc32Bytewise(__in UINT32 partialCrc, __in_bcount(cbBuf) const BYTE* pBuf, __in UINT32 cbBuf);
+
+    BOOLEAN _DefCrc32HardwareIsAvailable();
+
     UINT32
     _DefComputeStringCrc32(__in UINT32 partialCrc, __in BOOLEAN isCaseInsensitive, __in_ecount(cchStr) PCWSTR pStr, __in UINT32 cchStr);
 
@@ -61,9 +61,35 @@ extern "C"
         DEFFILE_ATOMPOOL_HASH_CASE_INSENSITIVE = 0x0001, //!< Uses case-insensitive hash method
         DEFFILE_ATOMPOOL_HASH_NONE = 0x0002, //!< No hash table present
         DEFFILE_ATOMPOOL_HASH_UNSORTED = 0x0004, //!< Hash table is unsorted
-        DEFFILE_ATOMPOOL_HASH_SMALL = 0x0008 //!< Hash table uses small atom index for hash table
+        DEFFILE_ATOMPOOL_HASH_SMALL = 0x0008, //!< Hash table uses small atom index for hash table
+        DEFFILE_ATOMPOOL_HASH_OPEN_ADDRESSED = 0x0010 //!< Open-addressed table of strong hashes follows the string pool
     } DefFileAtomPoolHashFlags;
 
+    /*!
+      * Open-addressed lookup table.
+      *
+      * Present only if DEFFILE_ATOMPOOL_HASH_OPEN_ADDRESSED is set. The table follows the
+      * string pool, preceded by one WCHAR of padding if cchPool is odd. It contains
+      * DefFileAtomPool_GetOpenHashSlotCount(nAtoms) DEFFILE_ATOMPOOL_HASHINDEX entries, each
+      * keyed by the DEF_HASH_STRONG hash of its string and probed linearly from
+      * (hash & (nSlots - 1)). Empty slots have index DEF_ATOM_INDEX_NONE.
+      *
+      * The hashes array keeps using the legacy hash method, so readers which predate this
+      * flag ignore the table and continue to work.
+      */
+#define DEFFILE_ATOMPOOL_OPEN_HASH_MIN_SLOTS 8
+
+    inline UINT32 DefFileAtomPool_GetOpenHashSlotCount(_In_ UINT32 nAtoms)
+    {
+        // power of two, load factor at most 1/2
+        UINT32 nSlots = DEFFILE_ATOMPOOL_OPEN_HASH_MIN_SLOTS;
+        while ((nSlots < 0x80000000) && (nSlots < (nAtoms * 2)))
+        {
+            nSlots <<= 1;
+        }
+        return nSlots;
+    }
+
 #define DEFFILE_ATOMPOOL_DESC_LENGTH 32
 
     /*!
@@ -155,6 +155,11 @@ extern "C"
      *      HNAMES_SCOPE_LARGE          scopes[hdr.numScopes]
      *      UINT32                      items[hdr.numItems]
      *      WCHAR                       names[hdr.cchNames];
+     *
+     * If HNAMES_FLAGS_PATH_HASH_INDEX is set in hdr.flags, the names
+     * pools are followed by a full-path hash index, aligned to 32 bits:
+     *      HNAMES_PATH_HASH_HEADER     hashHdr
+     *      HNAMES_PATH_HASH_SLOT       slots[hashHdr.numSlots]
      */
     typedef struct _DEFFILE_HNAMES_HEADER
     {
@@ -180,8 +185,45 @@ extern "C"
     } DEFFILE_HNAMES_HEADER_EX, *PDEFFILE_HNAMES_HEADER_EX;
 
     __declspec(selectany) extern const UINT32 DEFFILE_HNAMES_FLAGS_LARGE = 0x0001;
+    __declspec(selectany) extern const UINT32 DEFFILE_HNAMES_FLAGS_PATH_HASH_INDEX = 0x0002;
     __declspec(selectany) extern const UINT32 DEFFILE_MAX_STANDARD_SIZE = 0xffff;
 
+    /*!
+     * Optional index from the hash of the full path of a name to its node.
+     * - numSlots is the size of the open-addressed slot table, always a
+     *   power of two and larger than numEntries.
+     * - numEntries is the number of occupied slots.
+     *
+     * Each slot holds the path hash and the index of the matching node.
+     * The root node is never indexed, so a nodeIndex of 0 marks an empty
+     * slot.  Collisions are resolved by linear probing.  Readers that don't
+     * know about the index ignore it and walk the tree.
+     */
+    typedef struct _DEFFILE_HNAMES_PATH_HASH_HEADER
+    {
+        UINT32 numSlots;
+        UINT32 numEntries;
+    } DEFFILE_HNAMES_PATH_HASH_HEADER, *PDEFFILE_HNAMES_PATH_HASH_HEADER;
+
+    typedef struct _DEFFILE_HNAMES_PATH_HASH_SLOT
+    {
+        UINT32 hash;
+        UINT32 nodeIndex;
+    } DEFFILE_HNAMES_PATH_HASH_SLOT, *PDEFFILE_HNAMES_PATH_HASH_SLOT;
+
+    __declspec(selectany) extern const UINT32 DEFFILE_HNAMES_PATH_HASH_SEED = 0x811c9dc5;
+
+    // Adds one character of a path to a running path hash (FNV-1a).  Paths are hashed
+    // relative to the root without a leading separator, uppercased, and with every
+    // separator normalized to '/', so that lookups are case-insensitive.
+    inline UINT32 HNamesPathHashAddChar(_In_ UINT32 hash, _In_ WCHAR ch)
+    {
+        WCHAR normalized = ((ch == L'\\') ? L'/' : towupper(ch));
+        hash = (hash ^ (normalized & 0xff)) * 0x01000193;
+        hash = (hash ^ (normalized >> 8)) * 0x01000193;
+        return hash;
+    }
+
     __declspec(selectany) extern const DEFFILE_SECTION_TYPEID gHierarchicalNamesSectionType = {
         '[',
         'd',
@@ -695,6 +695,10 @@ extern "C"
      *      MRMFILE_REVERSEFILEMAP_ENTRY    entries[hdr.numFiles]
      *      DEFFILES_HNAMES                 Hierarchichal names header & data
      *      UINT16                          pad
+     *
+     * The names are built with the full-path hash index (DEFFILE_HNAMES_FLAGS_PATH_HASH_INDEX)
+     * whenever they hold more than one name, so a file path maps to its entry without walking
+     * the folder tree.  Readers fall back to the tree walk for files built without it.
      */
     typedef struct _MRMFILE_REVERSEFILEMAP_HEADER
     {
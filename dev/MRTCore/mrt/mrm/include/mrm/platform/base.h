@@ -647,6 +647,8 @@ public:
     static const UINT32 UseDeduplicationFlag = 0x80;
     static const UINT32 UseGranularResourceSplittingFlag = 0x100;
     static const UINT32 SplitLanguageVariantsFlag = 0x200;
+    // Not part of any platform's defaults; generates sections concurrently without changing the output.
+    static const UINT32 UseParallelBuildFlag = 0x400;
 
     static const UINT32 Windows8ConfigurationFlags = 0;
 
@@ -673,6 +675,7 @@ public:
     bool UseDeduplication() const { return ((m_flags & UseDeduplicationFlag) != 0); }
     bool UseGranularResourceSplitting() const { return ((m_flags & UseGranularResourceSplittingFlag) != 0); }
     bool SplitLanguageVariants() const { return ((m_flags & SplitLanguageVariantsFlag) != 0); }
+    bool UseParallelBuild() const { return ((m_flags & UseParallelBuildFlag) != 0); }
 
 protected:
     MrmBuildConfiguration(_In_ DEFFILE_MAGIC fileMagicNumber, _In_ UINT32 flags) : m_magic(fileMagicNumber), m_flags(flags) {}
@@ -834,6 +837,9 @@ protected:
 
     virtual double EvaluateSingleQualifierValue(_In_ PCWSTR valueOnAsset, _In_ PCWSTR valueFromProvider) const;
 
+    // Scores a value on an asset against a provider value, which may be a list if the type allows it.
+    HRESULT EvaluateValue(_In_ PCWSTR valueOnAsset, _In_ PCWSTR valueFromProvider, _Out_ double* score) const;
+
     // Compare does all standard comparisons (e.g. priority) and
     // only calls InnerCompare to break ties.
     virtual HRESULT InnerCompare(_In_ const IQualifier* pQualifier1, _In_ const IQualifier* pQualifier2, _Out_ DEFCOMPARISON* result) const;
@@ -928,6 +934,112 @@ protected:
     HRESULT InnerCompare(_In_ const IQualifier* pQualifier1, _In_ const IQualifier* pQualifier2, _Out_ DEFCOMPARISON* result) const;
 };
 
+/*!
+ * Validates and scores language tags for a LanguageMatcher.  Implemented by
+ * the language qualifier type, so the matcher itself doesn't depend on how
+ * the platform compares tags.
+ */
+class ILanguageTagScorer
+{
+public:
+    virtual HRESULT ValidateLanguageTag(_In_ PCWSTR tag) const = 0;
+
+    virtual HRESULT ScoreLanguageTag(_In_ PCWSTR tag, _In_ PCWSTR contextLanguages, _Out_ double* score) const = 0;
+};
+
+/*!
+ * Interns the language tags used by assets and keeps a row of scores for each
+ * of the most recently used context language lists.  Once a tag has been seen,
+ * evaluating it is a hash lookup and an index into the row for the current
+ * list; the scorer is asked for each (context list, tag) pair once while that
+ * list stays cached, unless two threads happen to miss on it together.  Cache
+ * hits only take the lock shared, and the scorer is called without the lock.
+ *
+ * Also holds a small, portable tag fallback table for platforms that can't
+ * compare language tags themselves.
+ */
+class LanguageMatcher : public DefObject
+{
+public:
+    static const int MaxContextLists = 4;
+
+    static HRESULT CreateInstance(_In_ const ILanguageTagScorer* pScorer, _Outptr_ LanguageMatcher** result);
+
+    virtual ~LanguageMatcher();
+
+    // Gets the index of a tag, interning it if it's new.  Tags are case-insensitive.
+    // Tags that the scorer rejects are interned too, so they're only validated once.
+    HRESULT GetTagIndex(_In_ PCWSTR tag, _Out_ int* pIndexOut);
+
+    int GetNumTags() const;
+
+    HRESULT GetScore(_In_ int tagIndex, _In_ PCWSTR contextLanguages, _Out_ double* score);
+
+    HRESULT Evaluate(_In_ PCWSTR tag, _In_ PCWSTR contextLanguages, _Out_ double* score);
+
+    // The number of scores we've asked the scorer for.
+    UINT32 GetNumScoresComputed() const { return static_cast<UINT32>(m_numScoresComputed); }
+
+    // Scores a single tag on an asset against a single context language, using only
+    // exact matches and the fixed fallback table.
+    static double GetFallbackScore(_In_ PCWSTR tag, _In_ PCWSTR contextLanguage);
+
+    // Gets the parent of a tag, e.g. "en-US" -> "en" or "zh-TW" -> "zh-Hant".
+    // Returns false if the tag has no parent.
+    static bool TryGetParentTag(_In_ PCWSTR tag, _Inout_ StringResult* pParentOut);
+
+protected:
+    typedef struct _TagEntry
+    {
+        PWSTR pTag;
+        HRESULT hrValid;
+    } TagEntry;
+
+    typedef struct _ContextRow
+    {
+        PWSTR pLanguages;
+        double* pScores;
+        volatile LONG lastUsed;
+    } ContextRow;
+
+    LanguageMatcher(_In_ const ILanguageTagScorer* pScorer);
+
+    HRESULT Init();
+
+    HRESULT FindOrAddTag(_In_ PCWSTR tag, _Out_ int* pIndexOut);
+
+    // The rest expect m_lock to be held: shared for FindTag and FindRow, exclusive for the others.
+    int FindTag(_In_ PCWSTR tag) const;
+
+    HRESULT AddTag(_In_ PCWSTR tag, _In_ HRESULT hrValid, _Out_ int* pIndexOut);
+
+    HRESULT GrowBuckets();
+
+    HRESULT EnsureRowCapacity(_In_ int numTags);
+
+    ContextRow* FindRow(_In_ PCWSTR contextLanguages);
+
+    HRESULT GetRow(_In_ PCWSTR contextLanguages, _Outptr_ ContextRow** result);
+
+    const ILanguageTagScorer* m_pScorer;
+
+    _Field_size_(m_numTags) TagEntry* m_pTags;
+    int m_numTags;
+    int m_tagCapacity;
+
+    // Open-addressed hash of tag index + 1; zero marks an empty bucket.
+    _Field_size_(m_numBuckets) int* m_pBuckets;
+    int m_numBuckets;
+
+    ContextRow m_rows[MaxContextLists];
+    int m_rowCapacity;
+    volatile LONG m_useCounter;
+
+    // Bumped outside the lock, since the scorer is called without it.
+    volatile LONG m_numScoresComputed;
+    _DEF_SRWLOCK m_lock;
+};
+
 class IProviderDataSources;
 
 class IQualifierValueProvider : public DefObject
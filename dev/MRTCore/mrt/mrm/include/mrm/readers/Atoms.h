@@ -30,6 +30,8 @@ protected:
     const UINT32* m_pOffsets{ nullptr };
     const WCHAR* m_pPool{ nullptr };
     const WCHAR* m_pPoolGroup{ nullptr };
+    const HashIndex* m_pOpenHashes{ nullptr };
+    UINT32 m_numOpenHashSlots{ 0 };
 
     static const DEFFILE_SECTION_TYPEID gAtomPoolSectionType;
 
@@ -141,8 +143,22 @@ public:
          */
     static UINT32 GetSizeInBytes(__in UINT32 nAtoms, __in UINT32 cchPool);
 
+    /*!
+         * Reports the size needed to hold an atom pool with the
+         * specified number of atoms and pool characters, including
+         * the open-addressed lookup table if flags includes
+         * DEFFILE_ATOMPOOL_HASH_OPEN_ADDRESSED.
+         */
+    static UINT32 GetSizeInBytes(__in UINT32 nAtoms, __in UINT32 cchPool, __in UINT32 flags);
+
     static UINT32 GetSizeInBytes(__in const DEFFILE_ATOMPOOL_HEADER* header);
 
+    /*!
+         * Gets a value indicating if this atom pool has an
+         * open-addressed lookup table.
+         */
+    bool GetHasOpenHashTable() const { return (m_pOpenHashes != nullptr); }
+
     UINT32 GetMaxSizeInBytesForStrings(__in_ecount(nStrings) PCWSTR* ppStrings, __in UINT32 nStrings) const;
 
     static HRESULT ValidateHeader(__in_bcount(cbData) const void* pData, __in UINT32 cbData, __out_opt UINT32* pcbTotalRtrn);
@@ -153,6 +169,9 @@ protected:
     _Success_(return == true)
     bool TryGetHashIndex(__in PCWSTR pString, __out_opt HashIndex* pIndexOut) const;
 
+    _Success_(return == true)
+    bool TryGetOpenHashIndex(__in PCWSTR pString, __out_opt Atom::Index* pIndexOut) const;
+
     DEFCOMPARISON CompareAtIndex(__in Atom::Index index, __in PCWSTR pString) const;
 
     DEFCOMPARISON CompareAtHashIndex(__in Atom::Index hashIndex, __in PCWSTR pString) const;
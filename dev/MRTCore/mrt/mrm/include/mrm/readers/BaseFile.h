@@ -72,7 +72,10 @@ public:
     static const SectionCount MaxSectionCount = DEFFILE_MAX_SECTION_COUNT;
     static const DEFFILE_SECTION_TYPEID SectionTypeNone;
 
-    // Public values for "flags" parameter to constructors
+    // Public values for "flags" parameter to constructors.  A mapped file is shared with every other process
+    // that maps it and only the pages that are touched get paged in, so PriFileManager maps files by default.
+    // Either way only the file header, trailer and TOC are validated up front; each section is validated when
+    // it is first used.  Files on removable drives are always loaded.
     static const UINT32 DefaultFlags = 0x0000;
     static const UINT32 MapFileFlag = 0x0001;
     static const UINT32 LoadFileFlag = 0x0002;
@@ -100,6 +103,12 @@ public:
 
     size_t GetFileSizeInBytes() const { return m_pHeader->cbTotal; }
 
+    /*!
+     * Pages in the whole file in one sequential pass, so that the first lookups don't fault it in a
+     * page at a time.  Only a hint; lookups work the same whether or not it has been called.
+     */
+    HRESULT Prefetch() const;
+
     bool SectionIsPresent(__inout SectionIndex index) { return (index >= 0) && (index < m_pHeader->sizeToc); }
 
     SectionCount GetNumSections() const { return m_pHeader->sizeToc; }
@@ -150,6 +150,9 @@ public:
         __out_opt int* pItemIndexOut = NULL,
         __out_opt int* pNameIndexOut = NULL) const;
 
+    //! Returns true if this section carries a full-path hash index.
+    bool HasPathHashIndex() const { return (m_pPathHashSlots != nullptr); }
+
     int GetNumScopes() const { return m_pHeader->numScopes; }
     IAtomPool* GetScopeNames() const { return m_pScopeNames; }
 
@@ -204,6 +207,8 @@ private:
     // not PCWSTR - not null terminated
     __field_ecount(m_pHeader->cchUtf16NamesPool) const WCHAR* m_pUtf16Names;
     __field_ecount(m_pHeader->cchAsciiNamesPool) const char* m_pAsciiNames;
+    const DEFFILE_HNAMES_PATH_HASH_HEADER* m_pPathHashHeader;
+    __field_ecount(m_pPathHashHeader->numSlots) const DEFFILE_HNAMES_PATH_HASH_SLOT* m_pPathHashSlots;
 
     IAtomPool* m_pScopeNames;
     IAtomPool* m_pItemNames;
@@ -218,6 +223,24 @@ private:
 
     HRESULT GetNumDescendents(_In_ int scopeIndex, _In_ UINT32 currentDepth, _Out_opt_ int* pNumScopes, _Out_opt_ int* pNumItems) const;
 
+    /*!
+         * Looks up a path, relative to the root, in the full-path hash index.
+         *
+         * \param pPath
+         * The path to look up, without a leading separator.
+         *
+         * \param pNodeIndexOut
+         * Returns the index of the matching node, or -1 if the index
+         * shows that no node matches.
+         *
+         * \return bool
+         * Returns true if the index answered the lookup.  Returns false if
+         * the caller has to walk the tree instead.
+         */
+    _Success_(return ) bool TryLookupPathHash(_In_ PCWSTR pPath, _Out_ int* pNodeIndexOut) const;
+
+    bool PathMatchesNode(_In_ int nodeIndex, _In_reads_(cchPath) PCWSTR pPath, _In_ int cchPath) const;
+
     HRESULT GetAsciiName(_In_ int firstChar, _In_ int cchName, _Out_ PCSTR* result) const
     {
         *result = nullptr;
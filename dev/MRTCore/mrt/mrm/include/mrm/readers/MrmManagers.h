@@ -202,6 +202,8 @@ public:
         return m_pDecisionInfo->GetDecisionNumQualifierSets(index, pNumSetsOut);
     }
 
+    const DecisionInfoFlatView* GetFlatView() const { return m_pDecisionInfo->GetFlatView(); }
+
     HRESULT NoteFileUnloading(_In_ const ManagedFile* pFile, _Out_ bool* pbCancelUnloadOut);
 
 protected:
@@ -1036,6 +1038,24 @@ public:
 
     virtual HRESULT GetQualifierProvider(_In_ PCWSTR qualifierName, _Out_ const IQualifierValueProvider** provider) const override = 0;
 
+    class FrozenDecisions;
+
+    // Freezing evaluates every decision once and keeps the winning qualifier set of each in a flat
+    // table, so a frozen decision resolves with a single load.  Anything that resets the resolver,
+    // such as SetQualifier, discards the table.  FreezeDecisions may be called concurrently for
+    // disjoint ranges between BeginFreeze and EndFreeze; EndFreeze always consumes pFrozen.
+    HRESULT BeginFreeze(_Outptr_ FrozenDecisions** result, _Out_ int* pNumDecisionsOut) const;
+
+    HRESULT FreezeDecisions(_Inout_ FrozenDecisions* pFrozen, _In_ int firstDecision, _In_ int numDecisions) const;
+
+    HRESULT EndFreeze(_In_ FrozenDecisions* pFrozen, _In_ bool publish);
+
+    bool IsFrozen() const;
+
+    // Returns HRESULT_FROM_WIN32(ERROR_NOT_FOUND) if the resolver isn't frozen, and
+    // HRESULT_FROM_WIN32(ERROR_MRM_NO_MATCH_OR_DEFAULT_CANDIDATE) if the decision has no usable candidate.
+    HRESULT EvaluateFrozenDecision(_In_ const IDecision* pDecision, _Out_ int* pResultIndexOut) const;
+
 protected:
     ResolverBase(_In_ const UnifiedEnvironment* pEnvironment, _In_ const IDecisionInfo* pDecisions);
 
@@ -1043,6 +1063,23 @@ protected:
 
     HRESULT EvaluateQualifier(_In_ const IQualifier* pQualifier, _Out_ UINT16* pScoreOut, _Out_ UINT16* pFallbackScoreOut) const;
 
+    // AcquireFrozen loads m_pFrozen and counts the caller as a reader until ReleaseFrozen.
+    const FrozenDecisions* AcquireFrozen() const;
+
+    void ReleaseFrozen() const;
+
+    // Frees the retired tables if no lookup is reading m_pFrozen and nobody holds m_srwFreezeLock.
+    // Called after releasing the lock, by anyone who held it.
+    void FreeRetiredFrozen() const;
+
+    // Frees the retired tables if no lookup is reading m_pFrozen.  Requires m_srwFreezeLock, held exclusively.
+    void FreeRetiredFrozenLocked() const;
+
+    HRESULT EvaluateFrozenDecision(
+        _In_opt_ const FrozenDecisions* pFrozen,
+        _In_ const IDecision* pDecision,
+        _Out_ int* pResultIndexOut) const;
+
     class DecisionInfoCache;
 
     const UnifiedEnvironment* m_pEnvironment{ nullptr };
@@ -1050,9 +1087,21 @@ protected:
     UINT64 m_generation = 0;
 
     mutable DecisionInfoCache* m_pCache{ nullptr };
-    mutable SRWLOCK m_srwLock{ nullptr };
-    mutable SRWLOCK m_srwQualifierSetLock{ nullptr };
+
+    // Serializes qualifier evaluation on cache misses against Reset.  Cached lookups are lock-free.
     mutable SRWLOCK m_srwQualifierLock{ nullptr };
+
+    // Held shared by a decision evaluation that keeps losing races with Reset, to hold resets off.
+    // Always taken before m_srwQualifierLock.
+    mutable SRWLOCK m_srwResetLock{ nullptr };
+
+    FrozenDecisions* volatile m_pFrozen{ nullptr };
+
+    // Tables that EndFreeze replaced while lookups were reading them.  They're freed as soon as
+    // m_frozenReaders drops to zero.
+    mutable FrozenDecisions* volatile m_pRetiredFrozen{ nullptr };
+    mutable volatile LONG m_frozenReaders{ 0 };
+    mutable SRWLOCK m_srwFreezeLock{ nullptr };
 };
 
 class ProviderResolver : public ResolverBase
@@ -1086,6 +1135,9 @@ public:
 
     HRESULT SetQualifier(_In_ PCWSTR pQualifierValue, _In_ PCWSTR pNewValue);
 
+    // Changes whenever a qualifier value changes; setting a qualifier to its current value doesn't count.
+    LONG GetQualifierGeneration() const;
+
     virtual HRESULT GetQualifierProvider(_In_ PCWSTR qualifierName, _Out_ const IQualifierValueProvider** provider) const override;
 
 protected:
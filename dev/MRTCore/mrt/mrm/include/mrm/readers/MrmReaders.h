@@ -507,8 +507,20 @@ public:
     _Success_(return ) _Check_return_ HRESULT
         GetCandidateInfo(_In_ int reverseMapIndex, _Out_ int* pQualifierSetIndexOut, _Out_ int* pNamedResourceIndexOut) const;
 
+    // Looks up many candidate values at once.  Paths that aren't in the map get -1 for both
+    // indexes.  Returns S_FALSE if any path wasn't found.
+    HRESULT GetCandidateInfoForPaths(
+        _In_ int numPaths,
+        _In_reads_(numPaths) const PCWSTR* pCandidateValues,
+        _Out_writes_(numPaths) int* pQualifierSetIndexesOut,
+        _Out_writes_(numPaths) int* pNamedResourceIndexesOut,
+        _Out_opt_ int* pNumFoundOut) const;
+
     int GetNumEntries() const { return m_pHeader->numFiles; }
 
+    // True if lookups can use the full-path hash index of the embedded names.
+    bool HasPathHashIndex() const { return m_pNames->HasPathHashIndex(); }
+
     static const DEFFILE_SECTION_TYPEID GetSectionTypeId();
 
 private:
@@ -796,6 +808,59 @@ protected:
     mutable UINT16 m_currentMinorVersion{ 0 };
 };
 
+/*!
+ * Walks the resources below a ResourceMapSubtree one at a time, in the same schema
+ * order as GetDescendentResource.  The walk follows the names directly and only keeps
+ * the path down to the current resource, so unlike the index-based accessors it never
+ * materialises an array covering the whole subtree.
+ *
+ * The subtree must outlive the enumerator.  If the schema behind the subtree changes
+ * version during the walk, MoveNext fails with E_CHANGED_STATE until Reset is called.
+ */
+class DescendentResourceEnumerator : public DefObject
+{
+public:
+    static HRESULT CreateInstance(_In_ const ResourceMapSubtree* pSubtree, _Outptr_ DescendentResourceEnumerator** result);
+
+    ~DescendentResourceEnumerator();
+
+    // Moves to the next resource.  Returns S_FALSE once every resource has been visited.
+    HRESULT MoveNext();
+
+    void Reset();
+
+    // Index of the current resource in the schema, or -1 if there is no current resource.
+    int GetCurrentIndexInSchema() const { return m_currentItem; }
+
+    HRESULT GetCurrentResource(_Inout_ NamedResourceResult* pItemOut) const;
+
+    // Gets the name of the current resource relative to the subtree
+    HRESULT GetCurrentResourceName(_Inout_ StringResult* pNameOut) const;
+
+private:
+    struct ScopePosition
+    {
+        int scopeIndex;
+        int numChildren;
+        int nextChild;
+    };
+
+    DescendentResourceEnumerator();
+
+    HRESULT PushScope(_In_ int scopeIndex);
+
+    const ResourceMapSubtree* m_pSubtree{ nullptr };
+    const IHierarchicalSchema* m_pSchema{ nullptr };
+
+    _Field_size_(m_sizeStack) ScopePosition* m_pStack{ nullptr };
+    int m_sizeStack{ 0 };
+    int m_depth{ 0 };
+
+    int m_currentItem{ -1 };
+    bool m_started{ false };
+    UINT16 m_minorVersion{ 0 };
+};
+
 class IFileSectionResolver;
 class ResourceMapFileData;
 
@@ -977,6 +1042,8 @@ public:
 
     HRESULT GetDecisionNumQualifierSets(_In_ int index, _Out_ int* pNumSetsOut) const;
 
+    const DecisionInfoFlatView* GetFlatView() const;
+
 protected:
     HRESULT Init(
         _In_opt_ const IFileSection* pFileSection,
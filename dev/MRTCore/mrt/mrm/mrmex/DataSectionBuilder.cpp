@@ -219,16 +219,15 @@ HRESULT DataBlobBuilder::BuildDataBlob(__out_bcount(cbBuffer) VOID* pBuffer, __i
     RETURN_HR_IF(E_INVALIDARG, (pBuffer == nullptr) || (cbBuffer < m_offset));
 
     UINT32 cbWritten = 0;
-    m_pCurDataList = m_pHeadDataList;
     BYTE* pDestBuffer = reinterpret_cast<BYTE*>(pBuffer);
 
-    while (m_pCurDataList)
+    // Walk the list with a local cursor so that building never disturbs m_pCurDataList,
+    // which is the append position, and so that sections can be built concurrently.
+    for (const MEM_LINKED_DATABLOB* pDataList = m_pHeadDataList; pDataList != nullptr; pDataList = pDataList->pNext)
     {
+        memcpy_s(&pDestBuffer[cbWritten], cbBuffer - cbWritten, pDataList->pData, pDataList->nSize);
 
-        memcpy_s(&pDestBuffer[cbWritten], cbBuffer - cbWritten, m_pCurDataList->pData, m_pCurDataList->nSize);
-
-        cbWritten += m_pCurDataList->nSize;
-        m_pCurDataList = m_pCurDataList->pNext;
+        cbWritten += pDataList->nSize;
     }
 
     if (pcbWritten)
@@ -63,7 +63,7 @@ FileAtomPoolBuilder::CreateInstance(
     RETURN_HR_IF(E_INVALIDARG, (pStrings == nullptr) || (pDescription == nullptr));
     RETURN_HR_IF(E_INVALIDARG, wcslen(pDescription) >= FileAtomPool::DescriptionLength);
 
-    UINT32 flags = (isCaseInsensitive ? fIsCaseInsensitive : fDefault) | fIsNotSorted;
+    UINT32 flags = (isCaseInsensitive ? fIsCaseInsensitive : fDefault) | fIsNotSorted | fHasOpenHashTable;
     AutoDeletePtr<FileAtomPoolBuilder> pRtrn = new FileAtomPoolBuilder();
     RETURN_IF_NULL_ALLOC(pRtrn);
     RETURN_IF_FAILED(pRtrn->Init(pDescription, pStrings, flags));
@@ -372,7 +372,38 @@ FileAtomPoolBuilder::GetMaxSizeInBytes() const
     {
         return 0;
     }
-    return FileAtomPool::GetSizeInBytes(m_numAtoms, m_pStrings->GetNumCharsInPool());
+    return FileAtomPool::GetSizeInBytes(m_numAtoms, m_pStrings->GetNumCharsInPool(), m_flags);
+}
+
+HRESULT FileAtomPoolBuilder::BuildOpenHashTable(__out_ecount(numSlots) DEFFILE_ATOMPOOL_HASHINDEX* pSlots, __in UINT32 numSlots) const
+{
+    RETURN_HR_IF(E_INVALIDARG, (numSlots == 0) || ((numSlots & (numSlots - 1)) != 0) || (numSlots <= static_cast<UINT32>(m_numAtoms)));
+
+    for (UINT32 i = 0; i < numSlots; i++)
+    {
+        pSlots[i].hash = 0;
+        pSlots[i].index = DEF_ATOM_INDEX_NONE;
+    }
+
+    Atom::HashMethod method = (GetIsCaseInsensitive() ? Atom::HashMethodStrongCaseInsensitive : Atom::HashMethodStrong);
+    UINT32 mask = numSlots - 1;
+
+    // Atoms are inserted in index order, so the layout only depends on the atoms themselves.
+    for (Atom::Index i = 0; i < m_numAtoms; i++)
+    {
+        PCWSTR pString = m_pStrings->GetString(m_offset[i]);
+        RETURN_HR_IF_NULL(E_UNEXPECTED, pString);
+
+        Atom::Hash hash = Atom::HashString(pString, method);
+        UINT32 slot = (hash & mask);
+        while (pSlots[slot].index != DEF_ATOM_INDEX_NONE)
+        {
+            slot = ((slot + 1) & mask);
+        }
+        pSlots[slot].hash = hash;
+        pSlots[slot].index = i;
+    }
+    return S_OK;
 }
 
 HRESULT FileAtomPoolBuilder::Build(__out_bcount(cbBuffer) VOID* pBuffer, UINT32 cbBuffer, __out_opt UINT32* pcbWritten) const
@@ -434,6 +465,21 @@ HRESULT FileAtomPoolBuilder::Build(__out_bcount(cbBuffer) VOID* pBuffer, UINT32
     err = memcpy_s(pChars, cbData, m_pStrings->GetBuffer(), cbData);
     RETURN_IF_FAILED(ErrnoToHResult(err));
 
+    if (m_flags & fHasOpenHashTable)
+    {
+        if (m_pStrings->GetNumCharsInPool() & 1)
+        {
+            WCHAR* pPad = _SECTION_BUILDER_NEXT(data, WCHAR, &hr);
+            RETURN_IF_FAILED(hr);
+            *pPad = 0;
+        }
+
+        UINT32 numSlots = DefFileAtomPool_GetOpenHashSlotCount(m_numAtoms);
+        DEFFILE_ATOMPOOL_HASHINDEX* pSlots = _SECTION_BUILDER_NEXT_ARRAY(data, numSlots, DEFFILE_ATOMPOOL_HASHINDEX, &hr);
+        RETURN_IF_FAILED(hr);
+        RETURN_IF_FAILED(BuildOpenHashTable(pSlots, numSlots));
+    }
+
     if (pcbWritten)
     {
         *pcbWritten = (UINT32)data.UsedBufferSizeInBytes();
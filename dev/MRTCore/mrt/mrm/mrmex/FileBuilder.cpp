@@ -20,7 +20,8 @@ FileBuilder::FileBuilder(__in DEFFILE_MAGIC magic) :
     m_pToc(NULL),
     m_pSectionData(NULL),
     m_cbSectionData(0),
-    m_nSectionDataUsed(0)
+    m_nSectionDataUsed(0),
+    m_parallelBuild(false)
 {}
 
 FileBuilder::~FileBuilder()
@@ -99,6 +100,18 @@ HRESULT FileBuilder::AddSection(__in ISectionBuilder* pSectionBuilder)
     return S_OK;
 }
 
+HRESULT FileBuilder::ReplaceSection(__in BaseFile::SectionIndex sectionIndex, __in ISectionBuilder* pSectionBuilder)
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, pSectionBuilder);
+    RETURN_HR_IF(E_INVALIDARG, (sectionIndex < 0) || (sectionIndex >= m_nSections));
+    RETURN_IF_FAILED(CheckPhase(Finalizing));
+
+    pSectionBuilder->SetSectionIndex(sectionIndex);
+    m_pSections[sectionIndex].m_pSectionBuilder = pSectionBuilder;
+
+    return S_OK;
+}
+
 HRESULT FileBuilder::GetSectionData(__in INT32 sectionIndex, _Out_ const BYTE** data, _Out_ UINT32* pcbSectionData)
 {
     *data = nullptr;
@@ -335,10 +348,132 @@ HRESULT FileBuilder::FinalizeAllSections()
     return S_OK;
 }
 
+// A section generated off to the side by a parallel build, waiting to be copied into the file.
+struct ParallelSectionWork
+{
+    ISectionBuilder* pSectionBuilder;
+    BYTE* pData;
+    UINT32 cbData;
+    UINT32 cbWritten;
+};
+
+struct ParallelBuildContext
+{
+    ParallelSectionWork* pWork;
+    LONG numSections;
+    volatile LONG nextSection;
+    volatile LONG hr;
+};
+
+static void CALLBACK BuildSectionWorkCallback(_Inout_opt_ PTP_CALLBACK_INSTANCE, _Inout_opt_ void* context, _Inout_opt_ PTP_WORK)
+{
+    ParallelBuildContext* pContext = reinterpret_cast<ParallelBuildContext*>(context);
+    while (SUCCEEDED(ReadAcquire(&pContext->hr)))
+    {
+        LONG index = InterlockedIncrement(&pContext->nextSection) - 1;
+        if (index >= pContext->numSections)
+        {
+            break;
+        }
+
+        ParallelSectionWork* pWork = &pContext->pWork[index];
+        HRESULT hr = pWork->pSectionBuilder->Build(pWork->pData, pWork->cbData, &pWork->cbWritten);
+        if (FAILED(hr))
+        {
+            InterlockedCompareExchange(&pContext->hr, hr, S_OK);
+        }
+    }
+}
+
+/*!
+ * Generates every section into its own zeroed scratch buffer on the thread pool, then
+ * reserves and copies the sections into the file one at a time in section order.  Each
+ * scratch buffer is exactly the size StartSection would have reserved, so the bytes
+ * written are identical to those of BuildAllSections.
+ */
+HRESULT FileBuilder::BuildAllSectionsParallel()
+{
+    unique_deffree_ptr<ParallelSectionWork> work(_DefArray_AllocZeroed(ParallelSectionWork, m_nSections));
+    RETURN_IF_NULL_ALLOC(work.get());
+
+    UINT32 cbScratch = 0;
+    for (int i = 0; i < m_nSections; i++)
+    {
+        UINT32 cbSection = BaseFile::PadData(m_pSections[i].m_pSectionBuilder->GetMaxSizeInBytes());
+        RETURN_HR_IF(E_DEFFILE_BUILD_SECTION_DATA_TOO_LARGE, cbScratch + cbSection < cbScratch);
+
+        work.get()[i].pSectionBuilder = m_pSections[i].m_pSectionBuilder;
+        work.get()[i].cbData = cbSection;
+        cbScratch += cbSection;
+    }
+
+    unique_deffree_ptr<BYTE> scratch(_DefArray_AllocZeroed(BYTE, (cbScratch > 0 ? cbScratch : 1)));
+    RETURN_IF_NULL_ALLOC(scratch.get());
+
+    UINT32 offset = 0;
+    for (int i = 0; i < m_nSections; i++)
+    {
+        work.get()[i].pData = &scratch.get()[offset];
+        offset += work.get()[i].cbData;
+    }
+
+    ParallelBuildContext context{ work.get(), m_nSections, 0, S_OK };
+
+    // The calling thread always takes part, so a single section never touches the thread pool.
+    DWORD numWorkers = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    if (numWorkers > static_cast<DWORD>(m_nSections))
+    {
+        numWorkers = m_nSections;
+    }
+
+    PTP_WORK threadpoolWork = nullptr;
+    if (numWorkers > 1)
+    {
+        threadpoolWork = CreateThreadpoolWork(BuildSectionWorkCallback, &context, nullptr);
+        RETURN_LAST_ERROR_IF_NULL(threadpoolWork);
+
+        for (DWORD i = 1; i < numWorkers; i++)
+        {
+            SubmitThreadpoolWork(threadpoolWork);
+        }
+    }
+
+    BuildSectionWorkCallback(nullptr, &context, nullptr);
+
+    if (threadpoolWork != nullptr)
+    {
+        WaitForThreadpoolWorkCallbacks(threadpoolWork, FALSE);
+        CloseThreadpoolWork(threadpoolWork);
+    }
+
+    RETURN_IF_FAILED(context.hr);
+
+    for (int i = 0; i < m_nSections; i++)
+    {
+        const ParallelSectionWork* pWork = &work.get()[i];
+        BaseFile::SectionIndex sectionIndex = pWork->pSectionBuilder->GetSectionIndex();
+        FileBuilder::SectionInfo* pSectionInfo;
+        RETURN_IF_FAILED(StartSection(sectionIndex, &pSectionInfo));
+        RETURN_HR_IF(E_DEFFILE_BUILD_SECTION_DATA_TOO_LARGE, pWork->cbData > pSectionInfo->m_cbSectionData);
+
+        errno_t err = memcpy_s(pSectionInfo->m_pSectionData, pSectionInfo->m_cbSectionData, pWork->pData, pWork->cbData);
+        RETURN_IF_FAILED(ErrnoToHResult(err));
+
+        RETURN_IF_FAILED(FinishSection(sectionIndex, pWork->cbWritten));
+    }
+
+    return S_OK;
+}
+
 HRESULT FileBuilder::BuildAllSections()
 {
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_OPERATION), m_phase != Generating);
 
+    if (m_parallelBuild && (m_nSections > 1))
+    {
+        return BuildAllSectionsParallel();
+    }
+
     for (int i = 0; i < m_nSections; i++)
     {
         BaseFile::SectionIndex sectionIndex = m_pSections[i].m_pSectionBuilder->GetSectionIndex();
@@ -1200,10 +1200,73 @@ HierarchicalNamesBuilder::GetMaxSizeInBytes() const
     totalSize += GetNumItems() * ((m_flags & BuildLargeHNamesNode) ? sizeof(UINT32) : sizeof(UINT16));
     totalSize += m_cchFinalizedUtf16Names * sizeof(WCHAR);
     totalSize += m_cchFinalizedAsciiNames * sizeof(char);
+
+    UINT32 numHashSlots = GetPathHashIndexNumSlots();
+    if (numHashSlots > 0)
+    {
+        totalSize = BaseFile::PadData(totalSize, BaseFile::Align32Bit);
+        totalSize += sizeof(DEFFILE_HNAMES_PATH_HASH_HEADER);
+        totalSize += numHashSlots * sizeof(DEFFILE_HNAMES_PATH_HASH_SLOT);
+    }
+
     totalSize = _DEFFILE_PAD_SECTION(totalSize);
     return totalSize;
 }
 
+UINT32 HierarchicalNamesBuilder::GetPathHashIndexNumSlots() const
+{
+    if (((m_flags & BuildWithoutPathHashIndex) != 0) || (GetNumNames() < 2))
+    {
+        return 0;
+    }
+
+    // Every name except the root gets an entry.  Keep the table at most half full
+    // so that probe sequences stay short.
+    UINT32 numEntries = static_cast<UINT32>(GetNumNames() - 1);
+    if (numEntries > 0x40000000)
+    {
+        return 0;
+    }
+
+    UINT32 numSlots = 2;
+    while (numSlots < (numEntries * 2))
+    {
+        numSlots <<= 1;
+    }
+    return numSlots;
+}
+
+HRESULT HierarchicalNamesBuilder::AddPathHashIndexEntry(
+    _In_ const HNamesNode* pNode,
+    _In_ UINT32 numSlots,
+    _Inout_updates_(numSlots) DEFFILE_HNAMES_PATH_HASH_SLOT* pSlots) const
+{
+    StringResult path;
+    RETURN_IF_FAILED(pNode->GetFullPath(&path));
+
+    PCWSTR pPath = path.GetRef();
+    if (IsPathSeparator(pPath[0]))
+    {
+        pPath++;
+    }
+
+    UINT32 hash = DEFFILE_HNAMES_PATH_HASH_SEED;
+    for (PCWSTR pCh = pPath; *pCh != L'\0'; pCh++)
+    {
+        hash = HNamesPathHashAddChar(hash, *pCh);
+    }
+
+    UINT32 slot = (hash & (numSlots - 1));
+    while (pSlots[slot].nodeIndex != 0)
+    {
+        slot = ((slot + 1) & (numSlots - 1));
+    }
+
+    pSlots[slot].hash = hash;
+    pSlots[slot].nodeIndex = static_cast<UINT32>(pNode->GetNameIndex());
+    return S_OK;
+}
+
 bool HierarchicalNamesBuilder::AssignChildNameIndices(__in ScopeInfo* pScope, __in int* pNextNameIndex)
 {
     int childIndex = *pNextNameIndex;
@@ -1467,16 +1530,35 @@ HRESULT HierarchicalNamesBuilder::Build(__out_bcount(cbBuffer) VOID* pBuffer, UI
 
     pUtf16Names = _SECTION_BUILDER_NEXT_ARRAY(data, m_cchFinalizedUtf16Names, WCHAR, &hr);
     pAsciiNames = _SECTION_BUILDER_NEXT_ARRAY(data, m_cchFinalizedAsciiNames, char, &hr);
+
+    UINT32 numHashSlots = GetPathHashIndexNumSlots();
+    DEFFILE_HNAMES_PATH_HASH_HEADER* pHashHeader = nullptr;
+    DEFFILE_HNAMES_PATH_HASH_SLOT* pHashSlots = nullptr;
+    if (numHashSlots > 0)
+    {
+        _SECTION_BUILDER_PAD(&data, BaseFile::Align32Bit, &hr);
+        pHashHeader = _SECTION_BUILDER_NEXT(data, DEFFILE_HNAMES_PATH_HASH_HEADER, &hr);
+        pHashSlots = _SECTION_BUILDER_NEXT_ARRAY(data, numHashSlots, DEFFILE_HNAMES_PATH_HASH_SLOT, &hr);
+    }
     _SECTION_BUILDER_PAD(&data, &hr);
 
     RETURN_IF_FAILED(hr);
 
+    UINT16 headerFlags = static_cast<UINT16>((m_flags & BuildLargeHNamesNode) ? DEFFILE_HNAMES_FLAGS_LARGE : 0);
+    if (pHashHeader != nullptr)
+    {
+        headerFlags |= DEFFILE_HNAMES_FLAGS_PATH_HASH_INDEX;
+        pHashHeader->numSlots = numHashSlots;
+        pHashHeader->numEntries = static_cast<UINT32>(GetNumNames() - 1);
+        ZeroMemory(pHashSlots, numHashSlots * sizeof(DEFFILE_HNAMES_PATH_HASH_SLOT));
+    }
+
     if (useExtendedHNames)
     {
         DEFFILE_HNAMES_HEADER_EX* pHeaderEx = static_cast<DEFFILE_HNAMES_HEADER_EX*>(pHeaderUnknownType);
 
         pHeaderEx->cchLongestPath = static_cast<UINT16>(m_cchLongestFinalizedName);
-        pHeaderEx->flags = (m_flags & BuildLargeHNamesNode) ? DEFFILE_HNAMES_FLAGS_LARGE : 0;
+        pHeaderEx->flags = headerFlags;
         pHeaderEx->numNodes = GetNumNames();
         pHeaderEx->numScopes = GetNumScopes();
         pHeaderEx->numItems = GetNumItems();
@@ -1489,7 +1571,7 @@ HRESULT HierarchicalNamesBuilder::Build(__out_bcount(cbBuffer) VOID* pBuffer, UI
         DEFFILE_HNAMES_HEADER* pHeader = static_cast<DEFFILE_HNAMES_HEADER*>(pHeaderUnknownType);
 
         pHeader->cchLongestPath = static_cast<UINT16>(m_cchLongestFinalizedName);
-        pHeader->flags = (m_flags & BuildLargeHNamesNode) ? DEFFILE_HNAMES_FLAGS_LARGE : 0;
+        pHeader->flags = headerFlags;
         pHeader->numNodes = GetNumNames();
         pHeader->numScopes = GetNumScopes();
         pHeader->numItems = GetNumItems();
@@ -1566,6 +1648,11 @@ HRESULT HierarchicalNamesBuilder::Build(__out_bcount(cbBuffer) VOID* pBuffer, UI
             pFileScope->firstChildNameNode = static_cast<UINT16>(((pChild != nullptr) ? pChild->GetNameIndex() : 0));
             pFileScope->flags = 0;
         }
+
+        if ((pHashSlots != nullptr) && (pScope->GetName() != nullptr))
+        {
+            RETURN_IF_FAILED(AddPathHashIndexEntry(pScope, numHashSlots, pHashSlots));
+        }
     }
 
     for (int i = 0; i < m_pAllItems->Count(); i++)
@@ -1591,6 +1678,11 @@ HRESULT HierarchicalNamesBuilder::Build(__out_bcount(cbBuffer) VOID* pBuffer, UI
             // build the item index
             pItems[pItem->GetIndex()] = static_cast<UINT16>(pItem->GetNameIndex());
         }
+
+        if (pHashSlots != nullptr)
+        {
+            RETURN_IF_FAILED(AddPathHashIndexEntry(pItem, numHashSlots, pHashSlots));
+        }
     }
 
     if (pcbWrittenOut != nullptr)
@@ -0,0 +1,311 @@
+// Copyright (c) Microsoft Corporation and Contributors. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root for license information.
+
+#include "stdafx.h"
+
+#include <mrm/build/IncrementalPriBuilder.h>
+
+namespace Microsoft::Resources::Build
+{
+
+HRESULT
+IncrementalPriBuilder::CreateInstance(_In_ PCWSTR pPreviousPriFilePath, _In_ CoreProfile* pProfile, _Outptr_ IncrementalPriBuilder** result)
+{
+    *result = nullptr;
+
+    RETURN_HR_IF(E_INVALIDARG, DefString_IsEmpty(pPreviousPriFilePath) || (pProfile == nullptr));
+
+    AutoDeletePtr<IncrementalPriBuilder> pRtrn = new IncrementalPriBuilder();
+    RETURN_IF_NULL_ALLOC(pRtrn);
+    RETURN_IF_FAILED(pRtrn->Init(pPreviousPriFilePath, pProfile));
+
+    *result = pRtrn.Detach();
+    return S_OK;
+}
+
+IncrementalPriBuilder::IncrementalPriBuilder() {}
+
+IncrementalPriBuilder::~IncrementalPriBuilder()
+{
+    // Candidates in the file builder can still point into the previous file, so it goes first.
+    delete m_pFileBuilder;
+    m_pFileBuilder = nullptr;
+
+    delete m_pSchemaCopier;
+    m_pSchemaCopier = nullptr;
+
+    delete m_pRemap;
+    m_pRemap = nullptr;
+
+    delete m_pPreviousPri;
+    m_pPreviousPri = nullptr;
+    m_pPreviousMap = nullptr;
+
+    if (m_pRemovedResources != nullptr)
+    {
+        Def_Free(m_pRemovedResources);
+        m_pRemovedResources = nullptr;
+    }
+
+    if (m_pPreviousPriFilePath != nullptr)
+    {
+        Def_Free(m_pPreviousPriFilePath);
+        m_pPreviousPriFilePath = nullptr;
+    }
+}
+
+HRESULT IncrementalPriBuilder::Init(_In_ PCWSTR pPreviousPriFilePath, _In_ CoreProfile* pProfile)
+{
+    RETURN_IF_FAILED(DefString_Dup(pPreviousPriFilePath, &m_pPreviousPriFilePath));
+    RETURN_IF_FAILED(StandalonePriFile::CreateInstance(0, pPreviousPriFilePath, pProfile, &m_pPreviousPri));
+
+    // Merged PRIs reference the files they were merged from and have to be rebuilt from those.
+    // Anything else the tools produce has exactly one resource map.
+    const PriDescriptor* pPreviousDescriptor = m_pPreviousPri->GetPriDescriptor();
+    RETURN_HR_IF(
+        HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED),
+        pPreviousDescriptor->GetIsDeploymentMergeResult() || pPreviousDescriptor->GetIsAutomergeMergeResult());
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_MAP_NOT_FOUND), m_pPreviousPri->GetNumResourceMaps() != 1);
+
+    RETURN_IF_FAILED(m_pPreviousPri->GetPrimaryResourceMap(&m_pPreviousMap));
+
+    RETURN_IF_FAILED(PriFileBuilder::CreateInstance(m_pPreviousMap->GetSchema(), pProfile, &m_pFileBuilder));
+
+    UINT32 priFileFlags = 0;
+    if (pPreviousDescriptor->GetAutoMergeEnabled())
+    {
+        priFileFlags |= MRMFILE_PRI_FLAGS_AUTO_MERGE;
+    }
+
+    if (pPreviousDescriptor->GetIsDeploymentMergeable())
+    {
+        priFileFlags |= MRMFILE_PRI_FLAGS_DEPLOYMENT_MERGEABLE;
+    }
+
+    RETURN_IF_FAILED(m_pFileBuilder->GetDescriptor()->SetPriFileFlags(priFileFlags));
+
+    m_numPreviousResources = m_pPreviousMap->GetNumResources();
+    if (m_numPreviousResources > 0)
+    {
+        m_pRemovedResources = _DefArray_AllocZeroed(bool, m_numPreviousResources);
+        RETURN_IF_NULL_ALLOC(m_pRemovedResources);
+    }
+
+    return S_OK;
+}
+
+HRESULT IncrementalPriBuilder::RemoveResource(_In_ PCWSTR pResourceName)
+{
+    RETURN_HR_IF(E_INVALIDARG, DefString_IsEmpty(pResourceName));
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_OPERATION), IsFinalized());
+
+    NamedResourceResult namedResource;
+    RETURN_IF_FAILED(m_pPreviousMap->GetResource(pResourceName, &namedResource));
+
+    int resourceIndex = namedResource.GetResourceIndexInSchema();
+    RETURN_HR_IF(E_UNEXPECTED, (resourceIndex < 0) || (resourceIndex >= m_numPreviousResources));
+
+    if (!m_pRemovedResources[resourceIndex])
+    {
+        m_pRemovedResources[resourceIndex] = true;
+        m_numRemovedResources++;
+    }
+
+    return S_OK;
+}
+
+bool IncrementalPriBuilder::HasChanges() const
+{
+    if ((m_numRemovedResources > 0) || (m_pPreviousMap == nullptr))
+    {
+        return true;
+    }
+
+    PriSectionBuilder* pDescriptor = m_pFileBuilder->GetDescriptor();
+    if ((pDescriptor->GetNumSchemas() != 1) || (pDescriptor->GetNumResourceMaps() != 1))
+    {
+        return true;
+    }
+
+    // Names are only ever added to the schema, so the delta added one if either count grew.
+    const IHierarchicalSchema* pPreviousSchema = m_pPreviousMap->GetSchema();
+    const HierarchicalSchemaSectionBuilder* pSchemaBuilder = pDescriptor->GetSchemaBuilder(0);
+    if ((pSchemaBuilder->GetNumScopes() != pPreviousSchema->GetNumScopes()) ||
+        (pSchemaBuilder->GetNumItems() != pPreviousSchema->GetNumItems()))
+    {
+        return true;
+    }
+
+    // Otherwise the delta can only have replaced the candidates of existing resources.
+    ResourceMapSectionBuilder* pMapBuilder = pDescriptor->GetResourceMapBuilder(0);
+    for (int i = 0; i < m_numPreviousResources; i++)
+    {
+        int numCandidates;
+        if (pMapBuilder->TryGetResourceInfo(i, nullptr, &numCandidates) && (numCandidates > 0))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+HRESULT IncrementalPriBuilder::CarryForwardResource(_In_ int resourceIndex)
+{
+    PriSectionBuilder* pDescriptor = m_pFileBuilder->GetDescriptor();
+    NamedResourceResult namedResource;
+    ResourceCandidateResult resCandidate;
+    QualifierSetResult qualifierSet;
+    StringResult strResourceName;
+    MrmEnvironment::ResourceValueType valueType;
+
+    RETURN_IF_FAILED(m_pPreviousMap->GetResourceByIndex(resourceIndex, &namedResource));
+    RETURN_IF_FAILED(namedResource.GetResourceName(&strResourceName));
+
+    for (int nResCandItr = 0; nResCandItr < namedResource.GetNumCandidates(); nResCandItr++)
+    {
+        RETURN_IF_FAILED(namedResource.GetCandidate(nResCandItr, &resCandidate));
+        RETURN_IF_FAILED(resCandidate.GetQualifiers(&qualifierSet));
+        RETURN_IF_FAILED(resCandidate.GetResourceValueType(&valueType));
+
+        if (MrmEnvironment::IsBinaryResourceValueType(valueType))
+        {
+            BlobResult brCandidateValue;
+            RETURN_HR_IF(E_UNEXPECTED, !resCandidate.TryGetBlobValue(&brCandidateValue));
+
+            size_t cbBlobSize;
+            const BYTE* blob = static_cast<const BYTE*>(brCandidateValue.GetRef(&cbBlobSize));
+
+            UINT32 cbBlob;
+            RETURN_IF_FAILED(SizeTToUInt32(cbBlobSize, &cbBlob));
+
+            RETURN_IF_FAILED(
+                pDescriptor->AddCandidateWithEmbeddedData(nullptr, strResourceName.GetRef(), valueType, blob, cbBlob, &qualifierSet));
+        }
+        else
+        {
+            StringResult strCandidateValue;
+            RETURN_HR_IF(E_UNEXPECTED, !resCandidate.TryGetStringValue(&strCandidateValue));
+
+            // The previous file may hold the value in a more compact encoding, but it always
+            // comes back as UTF-16 and the builder picks the encoding again.
+            valueType = MrmEnvironment::IsPathResourceValueType(valueType) ? MrmEnvironment::ResourceValueType_Utf16Path :
+                                                                             MrmEnvironment::ResourceValueType_Utf16String;
+
+            RETURN_IF_FAILED(
+                pDescriptor->AddCandidateWithString(nullptr, strResourceName.GetRef(), valueType, strCandidateValue.GetRef(), &qualifierSet));
+        }
+    }
+
+    return S_OK;
+}
+
+HRESULT IncrementalPriBuilder::ReuseUnchangedSchema()
+{
+    PriSectionBuilder* pDescriptor = m_pFileBuilder->GetDescriptor();
+    if ((pDescriptor->GetNumSchemas() != 1) || (m_pPreviousPri->GetNumSchemas() != 1))
+    {
+        return S_OK;
+    }
+
+    // The schema builder only settles its names and version once it's finalized.
+    RETURN_IF_FAILED(m_pFileBuilder->FinalizeAllSections());
+
+    // Builds from a previous schema always write a single version, and only bump it if names
+    // were added.  Checksum the new names against the previous version to be sure.
+    const IHierarchicalSchema* pPreviousSchema = m_pPreviousMap->GetSchema();
+    const HierarchicalSchemaSectionBuilder* pSchemaBuilder = pDescriptor->GetSchemaBuilder(0);
+    const IHierarchicalSchemaVersionInfo* pPreviousVersion = pPreviousSchema->GetVersionInfo(0);
+    if ((pPreviousSchema->GetNumVersionInfos() != 1) || (pPreviousVersion == nullptr) ||
+        (pSchemaBuilder->GetMajorVersion() != pPreviousSchema->GetMajorVersion()) ||
+        (pSchemaBuilder->GetMinorVersion() != pPreviousSchema->GetMinorVersion()) ||
+        (DefString_Compare(pSchemaBuilder->GetUniqueId(), pPreviousSchema->GetUniqueId()) != Def_Equal) ||
+        (DefString_Compare(pSchemaBuilder->GetSimpleId(), pPreviousSchema->GetSimpleId()) != Def_Equal))
+    {
+        return S_OK;
+    }
+
+    DEF_CHECKSUM checksum;
+    RETURN_IF_FAILED(ComputeHierarchicalSchemaVersionChecksum(pSchemaBuilder, pPreviousVersion, &checksum));
+    if (checksum != pPreviousVersion->GetVersionChecksum())
+    {
+        return S_OK;
+    }
+
+    const BaseFile* pPreviousFile;
+    DEFFILE_SECTION_TYPEID sectionType;
+    RETURN_IF_FAILED(m_pPreviousPri->GetBaseFile(&pPreviousFile));
+    RETURN_IF_FAILED(pPreviousSchema->GetSchemaBlobFromFileSection(&sectionType, nullptr));
+
+    BaseFile::SectionIndex sectionIndex = pPreviousFile->GetFirstSectionIndex(sectionType);
+    if (sectionIndex == BaseFile::SectionIndexNone)
+    {
+        return S_OK;
+    }
+
+    AutoDeletePtr<BaseFileSectionResult> pSection;
+    RETURN_IF_FAILED(pPreviousFile->GetFileSectionResultObject(&pSection));
+    RETURN_IF_FAILED(pPreviousFile->GetFileSection(sectionIndex, pSection));
+
+    RETURN_IF_FAILED(RemapInfo::CreateInstance(&m_pRemap));
+    RETURN_IF_FAILED(SectionCopier::CreateInstance(pSection, m_pRemap, &m_pSchemaCopier));
+    RETURN_IF_FAILED(m_pFileBuilder->ReplaceSection(pSchemaBuilder->GetSectionIndex(), m_pSchemaCopier));
+
+    return S_OK;
+}
+
+HRESULT IncrementalPriBuilder::WriteToFile(_In_ PCWSTR pszOutputFile)
+{
+    RETURN_HR_IF(E_INVALIDARG, DefString_IsEmpty(pszOutputFile));
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_OPERATION), IsFinalized());
+
+    m_bFinalized = true;
+
+    if (!HasChanges())
+    {
+        // Nothing to rebuild, so the previous file is the result.
+        if (DefString_ICompare(pszOutputFile, m_pPreviousPriFilePath) == Def_Equal)
+        {
+            return S_OK;
+        }
+
+        RETURN_IF_WIN32_BOOL_FALSE(CopyFileW(m_pPreviousPriFilePath, pszOutputFile, FALSE));
+        return S_OK;
+    }
+
+    // Resources the delta didn't touch are copied over from the previous file.  A resource the
+    // delta added candidates to was replaced, so its previous candidates are dropped.
+    ResourceMapSectionBuilder* pMapBuilder = m_pFileBuilder->GetDescriptor()->GetResourceMapBuilder(0);
+    for (int i = 0; i < m_numPreviousResources; i++)
+    {
+        int numCandidates = 0;
+        if (m_pRemovedResources[i] || (pMapBuilder->TryGetResourceInfo(i, nullptr, &numCandidates) && (numCandidates > 0)))
+        {
+            continue;
+        }
+
+        RETURN_IF_FAILED(CarryForwardResource(i));
+    }
+
+    RETURN_IF_FAILED(ReuseUnchangedSchema());
+
+    if (DefString_ICompare(pszOutputFile, m_pPreviousPriFilePath) == Def_Equal)
+    {
+        // The output replaces the previous file, which can't be written while it's open.  Carried
+        // forward candidates are read out of it while the new file is generated, so generate the
+        // contents first and only then let go of the previous file.
+        void* pContents = nullptr;
+        RETURN_IF_FAILED(m_pFileBuilder->GenerateFileContents(&pContents, nullptr));
+        Def_Free(pContents);
+
+        delete m_pPreviousPri;
+        m_pPreviousPri = nullptr;
+        m_pPreviousMap = nullptr;
+    }
+
+    RETURN_IF_FAILED(m_pFileBuilder->WriteToFile(pszOutputFile));
+
+    return S_OK;
+}
+
+} // namespace Microsoft::Resources::Build
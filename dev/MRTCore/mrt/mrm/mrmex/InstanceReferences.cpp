@@ -142,9 +142,32 @@ FileSectionBuildInstanceReference::FileSectionBuildInstanceReference(_In_ FileLi
     m_pFileListBuilder(pBuilder), m_pFileInfo(pFileInfo)
 {}
 
+// 64-bit FNV-1a.  Detached references can't go back to their bytes, so duplicates are found by
+// hash alone; this one is independent of the CRC32, so two different values have to collide in
+// both before they're merged.
+static UINT64 ComputeDataHash(_In_reads_bytes_(cbData) const BYTE* pData, _In_ UINT32 cbData)
+{
+    UINT64 hash = 0xcbf29ce484222325ull;
+    for (UINT32 i = 0; i < cbData; i++)
+    {
+        hash ^= pData[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+HRESULT ExternalFileStaticDataInstanceReference::CreateInstance(
+    _In_ ResourceCandidateResult* pResourceCandidateResult,
+    _In_ const FileInfo* pFileInfo,
+    _Outptr_ ExternalFileStaticDataInstanceReference** result)
+{
+    return CreateInstance(pResourceCandidateResult, pFileInfo, false, result);
+}
+
 HRESULT ExternalFileStaticDataInstanceReference::CreateInstance(
     _In_ ResourceCandidateResult* pResourceCandidateResult,
     _In_ const FileInfo* pFileInfo,
+    _In_ bool bDetachFromSource,
     _Outptr_ ExternalFileStaticDataInstanceReference** result)
 {
     *result = nullptr;
@@ -153,7 +176,7 @@ HRESULT ExternalFileStaticDataInstanceReference::CreateInstance(
     AutoDeletePtr<ExternalFileStaticDataInstanceReference> pStaticBuilder =
         new ExternalFileStaticDataInstanceReference(pResourceCandidateResult, pFileInfo);
     RETURN_IF_NULL_ALLOC(pStaticBuilder);
-    RETURN_IF_FAILED(pStaticBuilder->Init());
+    RETURN_IF_FAILED(pStaticBuilder->Init(bDetachFromSource));
 
     *result = pStaticBuilder.Detach();
     return S_OK;
@@ -167,7 +190,7 @@ ExternalFileStaticDataInstanceReference::ExternalFileStaticDataInstanceReference
     m_resourceCandidateResult = *pResourceCandidateResult;
 }
 
-HRESULT ExternalFileStaticDataInstanceReference::Init()
+HRESULT ExternalFileStaticDataInstanceReference::Init(_In_ bool bDetachFromSource)
 {
     MRMFILE_MAP_VALUE_LOCATOR locatorType;
     UINT32 data; // sectioniIndex + itemIndex
@@ -191,6 +214,21 @@ HRESULT ExternalFileStaticDataInstanceReference::Init()
     m_mrmIndexInstance.data2 = static_cast<UINT16>(data >> 16); // section index
     m_mrmIndexInstance.data3 = extraData; // higher bits of item index
 
+    if (bDetachFromSource)
+    {
+        // Remember enough about the value to detect duplicates, then let go of the source file.
+        BlobResult blob;
+        size_t cbBlob;
+        RETURN_IF_FAILED(GetDataBlob(&blob));
+        const BYTE* pBlob = static_cast<const BYTE*>(blob.GetRef(&cbBlob));
+        RETURN_IF_FAILED(SizeTToUInt32(cbBlob, &m_cbData));
+
+        m_dataChecksum = DefChecksum::ComputeChecksum(0, pBlob, m_cbData);
+        m_dataHash = ComputeDataHash(pBlob, m_cbData);
+        m_resourceCandidateResult = ResourceCandidateResult();
+        m_bDetached = true;
+    }
+
     return S_OK;
 }
 
@@ -216,13 +254,58 @@ bool ExternalFileStaticDataInstanceReference::IsReferenceEqual(_In_ const IBuild
     BlobResult blob1;
     BlobResult blob2;
 
-    if (FAILED(GetDataBlob(&blob1)) || FAILED(pBuildInstanceReference->GetDataBlob(&blob2)))
+    if (!m_bDetached && SUCCEEDED(GetDataBlob(&blob1)) && SUCCEEDED(pBuildInstanceReference->GetDataBlob(&blob2)))
+    {
+        bool bRet = (blob1.Compare(&blob2) == Def_Equal);
+        return bRet;
+    }
+
+    // At least one side no longer has its data, so fall back to comparing size and both hashes.
+    UINT32 cbData1, cbData2;
+    DEF_CHECKSUM checksum1, checksum2;
+    UINT64 hash1, hash2;
+    if (!TryGetDataChecksum(&cbData1, &checksum1, &hash1) ||
+        !pBuildInstanceReference->TryGetDataChecksum(&cbData2, &checksum2, &hash2))
     {
         return false;
     }
 
-    bool bRet = (blob1.Compare(&blob2) == Def_Equal);
-    return bRet;
+    return (cbData1 == cbData2) && (checksum1 == checksum2) && (hash1 == hash2);
+}
+
+bool ExternalFileStaticDataInstanceReference::TryGetDataChecksum(
+    _Out_ UINT32* pcbData,
+    _Out_ DEF_CHECKSUM* pChecksum,
+    _Out_ UINT64* pHash) const
+{
+    *pcbData = 0;
+    *pChecksum = 0;
+    *pHash = 0;
+
+    if (m_bDetached)
+    {
+        *pcbData = m_cbData;
+        *pChecksum = m_dataChecksum;
+        *pHash = m_dataHash;
+        return true;
+    }
+
+    BlobResult blob;
+    size_t cbBlob;
+    if (FAILED(GetDataBlob(&blob)))
+    {
+        return false;
+    }
+
+    const BYTE* pBlob = static_cast<const BYTE*>(blob.GetRef(&cbBlob));
+    if (FAILED(SizeTToUInt32(cbBlob, pcbData)))
+    {
+        return false;
+    }
+
+    *pChecksum = DefChecksum::ComputeChecksum(0, pBlob, *pcbData);
+    *pHash = ComputeDataHash(pBlob, *pcbData);
+    return true;
 }
 
 HRESULT ExternalFileStaticDataInstanceReference::GetDataBlob(_Inout_ BlobResult* pBlobResult) const
@@ -230,6 +313,9 @@ HRESULT ExternalFileStaticDataInstanceReference::GetDataBlob(_Inout_ BlobResult*
     StringResult strResult;
     MrmEnvironment::ResourceValueType valueType;
 
+    // The candidate was dropped when the reference was detached from its file.
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_OPERATION), m_bDetached);
+
     RETURN_IF_FAILED(m_resourceCandidateResult.GetResourceValueType(&valueType));
 
     if (MrmEnvironment::IsBinaryResourceValueType(valueType))
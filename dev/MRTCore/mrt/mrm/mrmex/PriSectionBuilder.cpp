@@ -126,6 +126,8 @@ HRESULT PriSectionBuilder::Init(_In_ CoreProfile* pProfile)
         return E_OUTOFMEMORY;
     }
 
+    m_pFileBuilder->SetParallelBuild(m_pBuilderConfiguration->UseParallelBuild());
+
     RETURN_IF_FAILED(AtomPoolGroup::CreateInstance(10, &m_pAtoms));
 
     RETURN_IF_FAILED(UnifiedEnvironment::CreateInstance(pProfile, m_pAtoms, &m_pUnifiedEnvironment));
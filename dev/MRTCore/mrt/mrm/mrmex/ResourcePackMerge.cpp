@@ -172,6 +172,49 @@ HRESULT ResourcePackMerge::AddPriFile(_In_ PCWSTR pszPriFileName, _In_ PriFileMe
 
     RETURN_IF_FAILED(AddResourceMap(pFielInfo, pPrimaryResourceMap, localMergeFlags));
 
+    if (m_bStreamingMerge && (m_pPriFileList->Count() > 1))
+    {
+        m_cbLoadedInputBytes += pHeader->cbTotal;
+        RETURN_IF_FAILED(ReleaseLoadedResourcePacks());
+    }
+
+    return S_OK;
+}
+
+HRESULT ResourcePackMerge::EnableStreamingMerge(_In_ UINT64 cbMaxLoadedInputBytes)
+{
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_OPERATION), IsFinalized() || (m_pPriFileList->Count() > 0));
+
+    m_bStreamingMerge = true;
+    m_cbMaxLoadedInputBytes = cbMaxLoadedInputBytes;
+    return S_OK;
+}
+
+HRESULT ResourcePackMerge::ReleaseLoadedResourcePacks()
+{
+    // Candidates from a streaming merge hold detached references, so nothing in the builder
+    // points into a resource pack once it has been added.  The main package PRI at index 0
+    // is never released because later resource packs can fall back to its schema.
+    while ((m_cbLoadedInputBytes > m_cbMaxLoadedInputBytes) && (m_nextPackToRelease < m_pPriFileList->Count()))
+    {
+        PriFile* pPriFile;
+        RETURN_IF_FAILED(m_pPriFileList->Get(m_nextPackToRelease, &pPriFile));
+
+        const BaseFile* pBaseFile;
+        RETURN_IF_FAILED(pPriFile->GetBaseFile(&pBaseFile));
+        UINT32 cbPack = pBaseFile->GetFileHeader()->cbTotal;
+
+        // AddPriFile always builds resource pack PriFiles over a ManagedFile.
+        const ManagedFile* pManagedFile = static_cast<const ManagedFile*>(pPriFile->GetBaseMrmFile());
+
+        RETURN_IF_FAILED(m_pPriFileList->Set(m_nextPackToRelease, nullptr));
+        delete pPriFile;
+        RETURN_IF_FAILED(m_pPriFileManager->UnloadFile(pManagedFile));
+
+        m_cbLoadedInputBytes = (m_cbLoadedInputBytes > cbPack) ? (m_cbLoadedInputBytes - cbPack) : 0;
+        m_nextPackToRelease++;
+    }
+
     return S_OK;
 }
 
@@ -414,7 +457,7 @@ HRESULT ResourcePackMerge::AddResourceMap(
 
             IBuildInstanceReference* pBuildInstanceReference;
             RETURN_IF_FAILED(ExternalFileStaticDataInstanceReference::CreateInstance(
-                &resCandidate, pFileInfo, (ExternalFileStaticDataInstanceReference**)&pBuildInstanceReference));
+                &resCandidate, pFileInfo, m_bStreamingMerge, (ExternalFileStaticDataInstanceReference**)&pBuildInstanceReference));
 
             HRESULT hr;
             if ((localMergeFlags & PriFileMerger::AddItemToSchema) != 0)
@@ -41,7 +41,9 @@ HRESULT ReverseFileMapSectionBuilder::Init()
 
     m_pSchema = pResMapBuilder->GetSchema();
 
-    RETURN_IF_FAILED(HierarchicalNamesBuilder::CreateInstance(m_buildFlags, m_pPriSectionBuilder->GetAtoms(), &m_pNames));
+    // Reverse lookups are by full path, so the names always carry the path hash index.
+    RETURN_IF_FAILED(HierarchicalNamesBuilder::CreateInstance(
+        (m_buildFlags & ~HierarchicalNamesBuilder::BuildWithoutPathHashIndex), m_pPriSectionBuilder->GetAtoms(), &m_pNames));
 
     RETURN_IF_FAILED(DynamicArray<MRMFILE_REVERSEFILEMAP_ENTRY>::CreateInstance(256, &m_pEntries));
 
@@ -19,9 +19,80 @@ const Atom Atom::NullAtom(0, 0);
     (((A1).s.poolIndex == (A2).s.poolIndex) ? (((A1).s.index == (A2).s.index) ? DEF_ATOMS_EQUAL : DEF_ATOMS_UNEQUAL) : \
                                               DEF_ATOMS_INDETERMINATE)
 
+// Strong hash. Consumes the string four WCHARs (one UINT64) at a time and mixes each
+// block multiplicatively, so it spreads similar names ("Atom1", "Atom2", ...) across the
+// full 32 bits where the legacy shift-xor hash does not.
+static const UINT64 StrongHashMultiplier = 0x9E3779B97F4A7C15ull;
+static const UINT64 StrongHashLanes = 0x0001000100010001ull;
+
+static inline UINT64 DefAtom_FoldAsciiBlock(UINT64 block)
+{
+    // All four lanes are known to be < 0x80, so none of these additions carries into the
+    // next lane. Bit 7 of each lane of isUpper is set iff that lane is in 'A'..'Z'.
+    UINT64 aboveA = block + (StrongHashLanes * (0x80 - L'A'));
+    UINT64 aboveZ = block + (StrongHashLanes * (0x80 - L'Z' - 1));
+    UINT64 isUpper = (aboveA & ~aboveZ) & (StrongHashLanes * 0x80);
+    return block | (isUpper >> 2);
+}
+
+static inline UINT64 DefAtom_PackBlock(__in_ecount(cch) PCWSTR pString, size_t cch, bool fold)
+{
+    UINT64 block = 0;
+    for (size_t i = 0; i < cch; i++)
+    {
+        WCHAR ch = (fold ? towlower(pString[i]) : pString[i]);
+        block |= (static_cast<UINT64>(ch) << (16 * i));
+    }
+    return block;
+}
+
+static inline UINT64 DefAtom_MixBlock(UINT64 hash, UINT64 block)
+{
+    hash ^= block;
+    hash *= StrongHashMultiplier;
+    return hash ^ (hash >> 29);
+}
+
+static DEF_ATOM_HASH DefAtom_HashStringStrong(__in PCWSTR pString, DEF_ATOM_HASH_METHOD hashMethod)
+{
+    const bool fold = ((hashMethod & DEF_HASH_CASE_INSENSITIVE) != 0);
+    size_t cchLeft = wcslen(pString);
+    UINT64 rtrn = 0x3482 ^ (cchLeft * StrongHashMultiplier);
+
+    for (; cchLeft >= 4; cchLeft -= 4, pString += 4)
+    {
+        UINT64 block;
+        memcpy(&block, pString, sizeof(block));
+        if (fold)
+        {
+            // ASCII blocks fold without a towlower call per character; anything else
+            // folds one character at a time, which yields the same block.
+            block = (((block & (StrongHashLanes * 0xff80)) == 0) ? DefAtom_FoldAsciiBlock(block) : DefAtom_PackBlock(pString, 4, true));
+        }
+        rtrn = DefAtom_MixBlock(rtrn, block);
+    }
+
+    if (cchLeft > 0)
+    {
+        rtrn = DefAtom_MixBlock(rtrn, DefAtom_PackBlock(pString, cchLeft, fold));
+    }
+
+    rtrn ^= rtrn >> 33;
+    rtrn *= 0xff51afd7ed558ccdull;
+    rtrn ^= rtrn >> 33;
+    rtrn *= 0xc4ceb9fe1a85ec53ull;
+    rtrn ^= rtrn >> 33;
+    return static_cast<DEF_ATOM_HASH>(rtrn);
+}
+
 DEF_ATOM_HASH
 DefAtom_HashString(__in PCWSTR pString, DEF_ATOM_HASH_METHOD hashMethod)
 {
+    if (hashMethod & DEF_HASH_STRONG)
+    {
+        return DefAtom_HashStringStrong(pString, hashMethod);
+    }
+
     DEF_ATOM_HASH rtrn = 0x3482;
 
     //! \todo really basic hash function.  Do something better someday.
@@ -111,8 +111,12 @@ BaseFile::LoadFileData(_In_ PCWSTR pFileName, _Out_ size_t* pcbDataOut, _Outptr_
 
     RETURN_IF_FAILED(_DefGetFileSizeEx(hFile.get(), &fileLen));
 
-    cbData = (UINT32)fileLen.LowPart;
-    unique_deffree_ptr<VOID> pBaseFileData(_DefBlob_AllocZeroed(cbData));
+    // PRI files are limited to 4GB, so don't silently truncate anything bigger.
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE), fileLen.HighPart != 0);
+
+    // The read overwrites every byte, so there's no need to zero the buffer first.
+    cbData = fileLen.LowPart;
+    unique_deffree_ptr<VOID> pBaseFileData(_DefBlob_Alloc(cbData));
     RETURN_IF_NULL_ALLOC(pBaseFileData.get());
 
     RETURN_IF_FAILED(_DefReadFile(hFile.get(), pBaseFileData.get(), cbData, &cbRead));
@@ -140,10 +144,11 @@ BaseFile::MapFileData(_In_ PCWSTR pFileName, _Out_ size_t* pcbDataOut, _Outptr_r
 
     RETURN_IF_FAILED(_DefCreateFile(pFileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, 0, &hFile));
     RETURN_IF_FAILED(_DefGetFileSizeEx(hFile.get(), &fileLen));
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE), fileLen.HighPart != 0);
     RETURN_IF_FAILED(_DefCreateFileMapping(hFile.get(), NULL, PAGE_READONLY, 0, 0, NULL, &hMapping));
     RETURN_IF_FAILED(_DefMapViewOfFile(hMapping.get(), FILE_MAP_READ, 0, 0, 0, &pBaseFileData));
 
-    *pcbDataOut = fileLen.QuadPart;
+    *pcbDataOut = fileLen.LowPart;
     *ppDataOut = pBaseFileData;
 
     return S_OK;
@@ -165,6 +170,15 @@ HRESULT BaseFile::UnmapFileData()
     return S_OK;
 }
 
+HRESULT BaseFile::Prefetch() const
+{
+    RETURN_HR_IF_NULL(E_DEF_NOT_READY, m_pHeader);
+
+    // Sections are laid out back to back, so one range covers everything a lookup can touch.
+    RETURN_IF_FAILED(_DefPrefetchVirtualMemory(m_pHeader, m_pHeader->cbTotal));
+    return S_OK;
+}
+
 HRESULT BaseFile::CreateInstance(__in PCWSTR pFileName, _Outptr_ BaseFile** newFile) { return CreateInstance(0, pFileName, newFile); }
 
 HRESULT BaseFile::CreateInstance(__in UINT32 flags, __in PCWSTR pFileName, _Outptr_ BaseFile** newFile)
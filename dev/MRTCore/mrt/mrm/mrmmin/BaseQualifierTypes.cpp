@@ -183,12 +183,20 @@ QualifierTypeBase::Evaluate(_In_ const IQualifier* qualifierOnAsset, _In_ PCWSTR
     StringResult valueOnAsset;
     RETURN_IF_FAILED(qualifierOnAsset->GetOperand2Literal(&valueOnAsset));
 
+    return EvaluateValue(valueOnAsset.GetRef(), valueFromProvider, score);
+}
+
+HRESULT
+QualifierTypeBase::EvaluateValue(_In_ PCWSTR valueOnAsset, _In_ PCWSTR valueFromProvider, _Out_ double* score) const
+{
+    *score = 0.0;
+
     if (AreListValuesAllowed())
     {
         double localScore = 0.0;
         auto evaluateSingle = [&](unsigned position, PCWSTR singleValue, HRESULT* hr) {
             *hr = S_OK;
-            double singleItemScore = EvaluateSingleQualifierValue(valueOnAsset.GetRef(), singleValue);
+            double singleItemScore = EvaluateSingleQualifierValue(valueOnAsset, singleValue);
             if (singleItemScore > 0.0)
             {
                 localScore = ScoreInPosition(position, singleItemScore);
@@ -204,7 +212,7 @@ QualifierTypeBase::Evaluate(_In_ const IQualifier* qualifierOnAsset, _In_ PCWSTR
         return S_OK;
     }
 
-    *score = EvaluateSingleQualifierValue(valueOnAsset.GetRef(), valueFromProvider);
+    *score = EvaluateSingleQualifierValue(valueOnAsset, valueFromProvider);
     return S_OK;
 }
 
@@ -28,7 +28,11 @@ public:
         return S_OK;
     }
 
-    virtual ~DecisionInfoFileData() {}
+    virtual ~DecisionInfoFileData()
+    {
+        _DefFree(m_pFlatQualifiers);
+        m_pFlatQualifiers = nullptr;
+    }
 
     int GetNumBaseQualifiers() const { return m_pHeader->numBaseQualifiers; }
     int GetNumQualifiers() const { return m_pHeader->numQualifiers; }
@@ -133,6 +137,8 @@ public:
 
     const IDecisionInfo* GetPool() const { return m_pDecisionInfo; }
 
+    const DecisionInfoFlatView* GetFlatView() const { return (m_pFlatQualifiers != nullptr ? &m_flatView : nullptr); }
+
 private:
     const RemapAtomPool* m_pQualifierMapping{ nullptr };
     const DecisionInfoFileSection* m_pDecisionInfo{ nullptr };
@@ -145,6 +151,9 @@ private:
     _Field_size_(m_pHeader->numReferences) const UINT16* m_pReferences{ nullptr };
     _Field_size_(m_pHeader->cchLiterals) PCWSTR m_pLiterals{ nullptr };
 
+    _Field_size_(m_pHeader->numQualifiers) DecisionInfoFlatView::FlatQualifier* m_pFlatQualifiers{ nullptr };
+    DecisionInfoFlatView m_flatView{};
+
     DecisionInfoFileData() :
         m_pHeader(nullptr),
         m_pDecisions(nullptr),
@@ -178,8 +187,78 @@ private:
         m_pReferences = _SECTION_PARSER_NEXT_ARRAY(data, m_pHeader->numReferences, UINT16, &hr);
         m_pLiterals = _SECTION_PARSER_NEXT_ARRAY(data, m_pHeader->cchLiterals, WCHAR, &hr);
         data.GetPadBytes(BaseFile::Align32Bit, &hr, nullptr);
+        RETURN_IF_FAILED(hr);
+
+        return InitFlatView();
+    }
+
+    bool IsValidReferenceRange(_In_ int first, _In_ int count, _In_ int limit) const
+    {
+        if ((first + count) > m_pHeader->numReferences)
+        {
+            return false;
+        }
+
+        for (int i = first; i < first + count; i++)
+        {
+            if (m_pReferences[i] >= limit)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Builds the flat view handed to the resolver.  Damaged data doesn't fail the load; we just
+    // don't build the view, and the wrappers report the damage when something actually reads it.
+    HRESULT InitFlatView()
+    {
+        for (int i = 0; i < m_pHeader->numDecisions; i++)
+        {
+            if (!IsValidReferenceRange(m_pDecisions[i].firstQualifierSetRef, m_pDecisions[i].numQualifierSetRefs, m_pHeader->numQualifierSets))
+            {
+                return S_OK;
+            }
+        }
+
+        for (int i = 0; i < m_pHeader->numQualifierSets; i++)
+        {
+            if (!IsValidReferenceRange(m_pQualifierSets[i].firstQualifierRef, m_pQualifierSets[i].numQualifierRefs, m_pHeader->numQualifiers))
+            {
+                return S_OK;
+            }
+        }
 
-        return hr;
+        for (int i = 0; i < m_pHeader->numQualifiers; i++)
+        {
+            if (!IsValidBaseQualifierIndex(m_pQualifiers[i].baseQualifierIndex))
+            {
+                return S_OK;
+            }
+        }
+
+        m_pFlatQualifiers = _DefArray_AllocZeroed(DecisionInfoFlatView::FlatQualifier, max(m_pHeader->numQualifiers, 1));
+        RETURN_IF_NULL_ALLOC(m_pFlatQualifiers);
+
+        for (int i = 0; i < m_pHeader->numQualifiers; i++)
+        {
+            MRMFILE_BASE_QUALIFIER baseQualifier;
+            RETURN_IF_FAILED(GetBaseQualifier(m_pQualifiers[i].baseQualifierIndex, &baseQualifier));
+
+            m_pFlatQualifiers[i].attribute = baseQualifier.attribute;
+            m_pFlatQualifiers[i].priority = m_pQualifiers[i].priority;
+            m_pFlatQualifiers[i].fallbackScore = m_pQualifiers[i].fallbackScore;
+        }
+
+        m_flatView.numQualifiers = m_pHeader->numQualifiers;
+        m_flatView.numQualifierSets = m_pHeader->numQualifierSets;
+        m_flatView.numDecisions = m_pHeader->numDecisions;
+        m_flatView.pQualifiers = m_pFlatQualifiers;
+        m_flatView.pQualifierSets = m_pQualifierSets;
+        m_flatView.pDecisions = m_pDecisions;
+        m_flatView.pReferences = m_pReferences;
+
+        return S_OK;
     }
 };
 
@@ -1159,4 +1238,6 @@ HRESULT DecisionInfoFileSection::GetDecisionNumQualifierSets(_In_ int index, _Ou
     return m_pFileData->GetDecisionNumQualifierSets(index, pNumSetsOut);
 }
 
+const DecisionInfoFlatView* DecisionInfoFileSection::GetFlatView() const { return m_pFileData->GetFlatView(); }
+
 } // namespace Microsoft::Resources
@@ -39,7 +39,9 @@ FileAtomPool::FileAtomPool() :
     m_pHashes(NULL),
     m_pOffsets(NULL),
     m_pPool(NULL),
-    m_pPoolGroup(NULL)
+    m_pPoolGroup(NULL),
+    m_pOpenHashes(NULL),
+    m_numOpenHashSlots(0)
 {}
 
 HRESULT FileAtomPool::Initialize(__in_opt const IFileSection* pSection, __in_bcount(cbData) const void* pData, __in int cbData)
@@ -67,6 +69,18 @@ HRESULT FileAtomPool::Initialize(__in_opt const IFileSection* pSection, __in_bco
         m_pOffsets = _SECTION_PARSER_NEXT_ARRAY(data, m_pHeader->nAtoms, UINT32, &hr);
         m_pPool = _SECTION_PARSER_NEXT_ARRAY(data, m_pHeader->cchPool, WCHAR, &hr);
 
+        m_pOpenHashes = NULL;
+        m_numOpenHashSlots = 0;
+        if (m_pHeader->flags & DEFFILE_ATOMPOOL_HASH_OPEN_ADDRESSED)
+        {
+            if (m_pHeader->cchPool & 1)
+            {
+                (void)_SECTION_PARSER_NEXT(data, WCHAR, &hr);
+            }
+            m_numOpenHashSlots = DefFileAtomPool_GetOpenHashSlotCount(m_pHeader->nAtoms);
+            m_pOpenHashes = _SECTION_PARSER_NEXT_ARRAY(data, m_numOpenHashSlots, HashIndex, &hr);
+        }
+
         m_flags = 0;
         m_poolIndex = m_pHeader->poolIndex;
         m_cbTotalSize = cbPoolTotal;
@@ -267,6 +281,11 @@ bool FileAtomPool::TryGetIndex(__in PCWSTR pString, __out_opt Atom::Index* pInde
         return false;
     }
 
+    if (m_pOpenHashes != nullptr)
+    {
+        return TryGetOpenHashIndex(pString, pIndexOut);
+    }
+
     if (m_pHeader->flags & DEFFILE_ATOMPOOL_HASH_NONE)
     {
         for (i = 0; i < m_pHeader->nAtoms; i++)
@@ -280,7 +299,7 @@ bool FileAtomPool::TryGetIndex(__in PCWSTR pString, __out_opt Atom::Index* pInde
     }
     else if (m_pHeader->flags & DEFFILE_ATOMPOOL_HASH_UNSORTED)
     {
-        hash = Atom::HashString(pString, static_cast<Atom::HashMethod>(m_pHeader->flags));
+        hash = Atom::HashString(pString, static_cast<Atom::HashMethod>(m_pHeader->flags & DEFFILE_ATOMPOOL_HASH_CASE_INSENSITIVE));
         for (i = 0; i < m_pHeader->nAtoms; i++)
         {
             if ((m_pHashes[i].hash == hash) && (CompareAtHashIndex(i, pString) == 0))
@@ -295,7 +314,7 @@ bool FileAtomPool::TryGetIndex(__in PCWSTR pString, __out_opt Atom::Index* pInde
         Atom::Index low = 0, high = m_pHeader->nAtoms - 1;
 
         // Binary search
-        hash = Atom::HashString(pString, (DEF_ATOM_HASH_METHOD)m_pHeader->flags);
+        hash = Atom::HashString(pString, (DEF_ATOM_HASH_METHOD)(m_pHeader->flags & DEFFILE_ATOMPOOL_HASH_CASE_INSENSITIVE));
         while (low <= high)
         {
             i = ((high - low) / 2) + low;
@@ -345,6 +364,39 @@ bool FileAtomPool::TryGetIndex(__in PCWSTR pString, __out_opt Atom::Index* pInde
     return found;
 }
 
+_Success_(return == true)
+bool FileAtomPool::TryGetOpenHashIndex(__in PCWSTR pString, __out_opt Atom::Index* pIndexOut) const
+{
+    Atom::HashMethod method = static_cast<Atom::HashMethod>(Atom::HashMethodStrong | (m_pHeader->flags & DEFFILE_ATOMPOOL_HASH_CASE_INSENSITIVE));
+    Atom::Hash hash = Atom::HashString(pString, method);
+    UINT32 mask = m_numOpenHashSlots - 1;
+
+    // Load factor is at most 1/2, so an empty slot always terminates the probe. Bound it
+    // anyway so a damaged table can't spin.
+    for (UINT32 probe = 0, slot = (hash & mask); probe < m_numOpenHashSlots; probe++, slot = ((slot + 1) & mask))
+    {
+        const HashIndex& entry = m_pOpenHashes[slot];
+        if (entry.index == DEF_ATOM_INDEX_NONE)
+        {
+            break;
+        }
+        if ((entry.hash == hash) && (CompareAtIndex(entry.index, pString) == Def_Equal))
+        {
+            if (pIndexOut)
+            {
+                *pIndexOut = entry.index;
+            }
+            return true;
+        }
+    }
+
+    if (pIndexOut)
+    {
+        *pIndexOut = Atom::NullAtomIndex;
+    }
+    return false;
+}
+
 DEFCOMPARISON FileAtomPool::CompareAtIndex(__in Atom::Index index, __in PCWSTR pString) const
 {
     if ((pString == nullptr) || (m_pOffsets == nullptr) || (m_pPool == nullptr) || (m_pHeader == nullptr) ||
@@ -376,7 +428,20 @@ UINT32 FileAtomPool::GetSizeInBytes(__in const DEFFILE_ATOMPOOL_HEADER* pHeader)
     {
         return 0;
     }
-    return GetSizeInBytes(pHeader->nAtoms, pHeader->cchPool);
+    return GetSizeInBytes(pHeader->nAtoms, pHeader->cchPool, pHeader->flags);
+}
+
+UINT32 FileAtomPool::GetSizeInBytes(__in UINT32 nAtoms, __in UINT32 cchPool, __in UINT32 flags)
+{
+    UINT32 size = GetSizeInBytes(nAtoms, cchPool);
+
+    if (flags & DEFFILE_ATOMPOOL_HASH_OPEN_ADDRESSED)
+    {
+        // one WCHAR of padding keeps the table naturally aligned
+        size += (cchPool & 1) * sizeof(WCHAR);
+        size += DefFileAtomPool_GetOpenHashSlotCount(nAtoms) * sizeof(HashIndex);
+    }
+    return size;
 }
 
 UINT32 FileAtomPool::GetSizeInBytes(__in UINT32 nAtoms, __in UINT32 cchPool)
@@ -429,6 +494,8 @@ HRESULT FileAtomPool::ValidateHeader(__in_bcount(cbData) const void* pData, __in
     RETURN_HR_IF(E_INVALIDARG, (pHdr == nullptr) || (cbData < sizeof(DEFFILE_ATOMPOOL_HEADER)));
     RETURN_HR_IF(E_DEF_ATOM_BAD_POOL, (pHdr->poolIndex == DEF_ATOM_NULL_POOL_INDEX) || (pHdr->poolIndex == DEF_ATOM_POOL_INDEX_NONE));
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE), pHdr->desc[DEFFILE_ATOMPOOL_DESC_LENGTH - 1] != 0);
+    // every atom needs at least one offset, so this bounds nAtoms before any sizes are computed from it
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE), static_cast<UINT32>(pHdr->nAtoms) > (cbData / sizeof(UINT32)));
 
     minSize = GetSizeInBytes(pHdr);
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE), minSize > cbData);
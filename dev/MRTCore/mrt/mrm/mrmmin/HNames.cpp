@@ -353,6 +353,8 @@ HierarchicalNames::HierarchicalNames() :
     m_pItemsLarge(nullptr),
     m_pUtf16Names(nullptr),
     m_pAsciiNames(nullptr),
+    m_pPathHashHeader(nullptr),
+    m_pPathHashSlots(nullptr),
     m_pScopeNames(nullptr),
     m_pItemNames(nullptr),
     m_largeNode(false)
@@ -431,6 +433,22 @@ HRESULT HierarchicalNames::Init(
     m_pAsciiNames = _SECTION_PARSER_NEXT_ARRAY(data, m_pHeader->cchAsciiNamesPool, char, &hr);
     RETURN_IF_FAILED(hr);
 
+    if ((m_pHeader->flags & DEFFILE_HNAMES_FLAGS_PATH_HASH_INDEX) != 0)
+    {
+        data.GetPadBytes(BaseFile::Align32Bit, &hr, nullptr);
+        m_pPathHashHeader = _SECTION_PARSER_NEXT(data, DEFFILE_HNAMES_PATH_HASH_HEADER, &hr);
+        RETURN_IF_FAILED(hr);
+
+        UINT32 numSlots = m_pPathHashHeader->numSlots;
+        if ((numSlots == 0) || ((numSlots & (numSlots - 1)) != 0) || (m_pPathHashHeader->numEntries >= numSlots))
+        {
+            return HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE);
+        }
+
+        m_pPathHashSlots = _SECTION_PARSER_NEXT_ARRAY(data, numSlots, DEFFILE_HNAMES_PATH_HASH_SLOT, &hr);
+        RETURN_IF_FAILED(hr);
+    }
+
     if (m_largeNode)
     {
         RETURN_IF_FAILED(ScopesAtomPool<DEFFILE_HNAMES_SCOPE_LARGE>::CreateInstance(
@@ -748,6 +766,45 @@ bool HierarchicalNames::Contains(
         pStr++;
     }
 
+    // Paths relative to the root can be looked up directly if the section has a hash index.
+    int hashedNodeIndex = -1;
+    if ((pScope->nameNodeIndex == 0) && TryLookupPathHash(pStr, &hashedNodeIndex))
+    {
+        if (hashedNodeIndex < 0)
+        {
+            return false;
+        }
+
+        const DEFFILE_HNAMES_NODE_LARGE* pHashedNode;
+        DEFFILE_HNAMES_NODE_LARGE hashedNode;
+        if (m_largeNode)
+        {
+            pHashedNode = &m_pNodesLarge[hashedNodeIndex];
+        }
+        else
+        {
+            hashedNode = HNAMES_NODE_TO_HNAMES_NODE_LARGE(&m_pNodes[hashedNodeIndex]);
+            pHashedNode = &hashedNode;
+        }
+
+        bool isScope = ((pHashedNode->flagsAndNameOffsetHigh & DEFFILE_HNAMES_FLAGS_NODE_IS_SCOPE) != 0);
+        if (pScopeIndexOut != nullptr)
+        {
+            *pScopeIndexOut = (isScope ? pHashedNode->payload : -1);
+        }
+
+        if (pItemIndexOut != nullptr)
+        {
+            *pItemIndexOut = (isScope ? -1 : pHashedNode->payload);
+        }
+
+        if (pNameIndexOut != nullptr)
+        {
+            *pNameIndexOut = hashedNodeIndex;
+        }
+        return true;
+    }
+
     const DEFFILE_HNAMES_NODE_LARGE* pMatch = nullptr;
     DEFFILE_HNAMES_NODE_LARGE matchNode;
     PCWSTR pSegmentEnd = nullptr;
@@ -897,6 +954,108 @@ bool HierarchicalNames::Contains(
     return false;
 }
 
+_Success_(return ) bool HierarchicalNames::TryLookupPathHash(_In_ PCWSTR pPath, _Out_ int* pNodeIndexOut) const
+{
+    *pNodeIndexOut = -1;
+
+    if (m_pPathHashSlots == nullptr)
+    {
+        return false;
+    }
+
+    UINT32 hash = DEFFILE_HNAMES_PATH_HASH_SEED;
+    bool isAscii = true;
+    int cchPath = 0;
+
+    for (; pPath[cchPath] != L'\0'; cchPath++)
+    {
+        if (IsPathSeparator(pPath[cchPath]) && ((cchPath == 0) || IsPathSeparator(pPath[cchPath - 1])))
+        {
+            // multiple separators not allowed
+            return true;
+        }
+
+        isAscii = isAscii && (pPath[cchPath] < 0x80);
+        hash = HNamesPathHashAddChar(hash, pPath[cchPath]);
+    }
+
+    if ((cchPath == 0) || IsPathSeparator(pPath[cchPath - 1]))
+    {
+        // Trailing separators aren't part of any stored path; let the tree walk decide.
+        return false;
+    }
+
+    UINT32 mask = m_pPathHashHeader->numSlots - 1;
+    UINT32 slot = (hash & mask);
+    for (UINT32 probe = 0; (probe < m_pPathHashHeader->numSlots) && (m_pPathHashSlots[slot].nodeIndex != 0); probe++)
+    {
+        const DEFFILE_HNAMES_PATH_HASH_SLOT* pSlot = &m_pPathHashSlots[slot];
+        if ((pSlot->hash == hash) && (pSlot->nodeIndex < m_pHeader->numNodes) &&
+            PathMatchesNode(static_cast<int>(pSlot->nodeIndex), pPath, cchPath))
+        {
+            *pNodeIndexOut = static_cast<int>(pSlot->nodeIndex);
+            return true;
+        }
+        slot = ((slot + 1) & mask);
+    }
+
+    // The index is built with towupper, which doesn't fold every character that
+    // the tree walk treats as equal.  Only trust a miss for pure ASCII paths.
+    return isAscii;
+}
+
+bool HierarchicalNames::PathMatchesNode(_In_ int nodeIndex, _In_reads_(cchPath) PCWSTR pPath, _In_ int cchPath) const
+{
+    // Match the path segment by segment, from the node back up to the root.
+    int cchRemaining = cchPath;
+    int depth = 0;
+
+    while (nodeIndex > 0)
+    {
+        if ((nodeIndex > m_pHeader->numNodes - 1) || (depth++ > m_pHeader->numNodes))
+        {
+            return false;
+        }
+
+        const DEFFILE_HNAMES_NODE_LARGE* pNode;
+        DEFFILE_HNAMES_NODE_LARGE node;
+        if (m_largeNode)
+        {
+            pNode = &m_pNodesLarge[nodeIndex];
+        }
+        else
+        {
+            node = HNAMES_NODE_TO_HNAMES_NODE_LARGE(&m_pNodes[nodeIndex]);
+            pNode = &node;
+        }
+
+        int segmentStart = cchRemaining - pNode->cchName;
+        int diff;
+        if ((pNode->cchName == 0) || (segmentStart < 0) ||
+            FAILED(CompareNameSegment<DEFFILE_HNAMES_NODE_LARGE>(pNode, &pPath[segmentStart], &diff)) || (diff != 0))
+        {
+            return false;
+        }
+
+        if (segmentStart > 0)
+        {
+            if (!IsPathSeparator(pPath[segmentStart - 1]))
+            {
+                return false;
+            }
+            cchRemaining = segmentStart - 1;
+        }
+        else
+        {
+            cchRemaining = 0;
+        }
+
+        nodeIndex = pNode->parentNodeIndex;
+    }
+
+    return (nodeIndex == 0) && (cchRemaining == 0);
+}
+
 _Success_(return ) bool HierarchicalNames::TryGetScopeInfo(
     __in int scopeIndex,
     __inout StringResult* pNameOut,
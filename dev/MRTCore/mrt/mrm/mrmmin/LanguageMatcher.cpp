@@ -0,0 +1,476 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+#include "stdafx.h"
+
+namespace Microsoft::Resources
+{
+
+// Scores are in [0.0, 1.0], so anything negative means we haven't asked the scorer yet.
+static const double c_scoreNotComputed = -1.0;
+
+static const int c_initialTagCapacity = 16;
+
+// Parents that plain truncation gets wrong.  An empty parent means the tag has no parent,
+// e.g. zh-Hant resources shouldn't be used for zh-Hans, even though both start with "zh".
+typedef struct _LanguageParentEntry
+{
+    PCWSTR tag;
+    PCWSTR parent;
+} LanguageParentEntry;
+
+static const LanguageParentEntry c_languageParents[] = {
+    {L"az-Cyrl", L""},
+    {L"az-Latn", L""},
+    {L"en-AU", L"en-001"},
+    {L"en-GB", L"en-001"},
+    {L"en-IE", L"en-001"},
+    {L"en-IN", L"en-001"},
+    {L"en-NZ", L"en-001"},
+    {L"en-SG", L"en-001"},
+    {L"en-ZA", L"en-001"},
+    {L"es-AR", L"es-419"},
+    {L"es-BO", L"es-419"},
+    {L"es-CL", L"es-419"},
+    {L"es-CO", L"es-419"},
+    {L"es-CR", L"es-419"},
+    {L"es-MX", L"es-419"},
+    {L"es-PE", L"es-419"},
+    {L"es-US", L"es-419"},
+    {L"es-UY", L"es-419"},
+    {L"es-VE", L"es-419"},
+    {L"pt-AO", L"pt-PT"},
+    {L"pt-MZ", L"pt-PT"},
+    {L"sr-Cyrl", L""},
+    {L"sr-Latn", L""},
+    {L"uz-Cyrl", L""},
+    {L"uz-Latn", L""},
+    {L"zh-CN", L"zh-Hans"},
+    {L"zh-Hans", L""},
+    {L"zh-Hant", L""},
+    {L"zh-HK", L"zh-Hant"},
+    {L"zh-MO", L"zh-Hant"},
+    {L"zh-SG", L"zh-Hans"},
+    {L"zh-TW", L"zh-Hant"},
+};
+
+// No tag in practice gets anywhere near this many subtags; this just bounds the walk.
+static const int c_maxTagDepth = 8;
+
+HRESULT LanguageMatcher::CreateInstance(_In_ const ILanguageTagScorer* pScorer, _Outptr_ LanguageMatcher** result)
+{
+    *result = nullptr;
+
+    RETURN_HR_IF_NULL(E_INVALIDARG, pScorer);
+
+    AutoDeletePtr<LanguageMatcher> pRtrn = new LanguageMatcher(pScorer);
+    RETURN_IF_NULL_ALLOC(pRtrn);
+    RETURN_IF_FAILED(pRtrn->Init());
+
+    *result = pRtrn.Detach();
+    return S_OK;
+}
+
+LanguageMatcher::LanguageMatcher(_In_ const ILanguageTagScorer* pScorer) :
+    m_pScorer(pScorer),
+    m_pTags(nullptr),
+    m_numTags(0),
+    m_tagCapacity(0),
+    m_pBuckets(nullptr),
+    m_numBuckets(0),
+    m_rowCapacity(0),
+    m_useCounter(0),
+    m_numScoresComputed(0)
+{
+    ZeroMemory(m_rows, sizeof(m_rows));
+    _DefInitializeSRWLock(&m_lock);
+}
+
+LanguageMatcher::~LanguageMatcher()
+{
+    for (int i = 0; i < m_numTags; i++)
+    {
+        _DefFree(m_pTags[i].pTag);
+    }
+    _DefFree(m_pTags);
+    _DefFree(m_pBuckets);
+
+    for (int i = 0; i < MaxContextLists; i++)
+    {
+        _DefFree(m_rows[i].pLanguages);
+        _DefFree(m_rows[i].pScores);
+    }
+}
+
+HRESULT LanguageMatcher::Init()
+{
+    m_pTags = _DefArray_AllocZeroed(TagEntry, c_initialTagCapacity);
+    RETURN_IF_NULL_ALLOC(m_pTags);
+    m_tagCapacity = c_initialTagCapacity;
+
+    m_pBuckets = _DefArray_AllocZeroed(int, c_initialTagCapacity * 2);
+    RETURN_IF_NULL_ALLOC(m_pBuckets);
+    m_numBuckets = c_initialTagCapacity * 2;
+
+    return S_OK;
+}
+
+int LanguageMatcher::GetNumTags() const { return m_numTags; }
+
+HRESULT LanguageMatcher::GetTagIndex(_In_ PCWSTR tag, _Out_ int* pIndexOut)
+{
+    *pIndexOut = -1;
+
+    int index;
+    RETURN_IF_FAILED(FindOrAddTag(tag, &index));
+
+    AutoReaderWriterLock autoLock(&m_lock, true);
+    *pIndexOut = index;
+    return m_pTags[index].hrValid;
+}
+
+HRESULT LanguageMatcher::GetScore(_In_ int tagIndex, _In_ PCWSTR contextLanguages, _Out_ double* score)
+{
+    *score = 0.0;
+
+    RETURN_HR_IF(E_INVALIDARG, (tagIndex < 0) || (contextLanguages == nullptr));
+
+    // Most calls hit the cache, so look there under a shared lock first.
+    PCWSTR pTag;
+    {
+        AutoReaderWriterLock autoLock(&m_lock, true);
+
+        RETURN_HR_IF(E_INVALIDARG, tagIndex >= m_numTags);
+        RETURN_IF_FAILED(m_pTags[tagIndex].hrValid);
+
+        ContextRow* pRow = FindRow(contextLanguages);
+        if ((pRow != nullptr) && (pRow->pScores[tagIndex] >= 0.0))
+        {
+            InterlockedExchange(&pRow->lastUsed, InterlockedIncrement(&m_useCounter));
+            *score = pRow->pScores[tagIndex];
+            return S_OK;
+        }
+
+        // Tag strings aren't freed or moved until the matcher is destroyed, so this stays valid once we let go of the lock.
+        pTag = m_pTags[tagIndex].pTag;
+    }
+
+    // Scoring can be slow, so don't hold up other lookups while we do it.  If another thread races us
+    // for the same pair we both ask the scorer, but we both store the same score.
+    double computed;
+    InterlockedIncrement(&m_numScoresComputed);
+    RETURN_IF_FAILED(m_pScorer->ScoreLanguageTag(pTag, contextLanguages, &computed));
+    computed = max(computed, 0.0);
+
+    {
+        AutoReaderWriterLock autoLock(&m_lock);
+
+        ContextRow* pRow;
+        RETURN_IF_FAILED(GetRow(contextLanguages, &pRow));
+        pRow->pScores[tagIndex] = computed;
+    }
+
+    *score = computed;
+    return S_OK;
+}
+
+HRESULT LanguageMatcher::Evaluate(_In_ PCWSTR tag, _In_ PCWSTR contextLanguages, _Out_ double* score)
+{
+    *score = 0.0;
+
+    int index;
+    RETURN_IF_FAILED(FindOrAddTag(tag, &index));
+    return GetScore(index, contextLanguages, score);
+}
+
+HRESULT LanguageMatcher::FindOrAddTag(_In_ PCWSTR tag, _Out_ int* pIndexOut)
+{
+    *pIndexOut = -1;
+
+    RETURN_HR_IF_NULL(E_INVALIDARG, tag);
+
+    {
+        AutoReaderWriterLock autoLock(&m_lock, true);
+
+        int index = FindTag(tag);
+        if (index >= 0)
+        {
+            *pIndexOut = index;
+            return S_OK;
+        }
+    }
+
+    // New tag.  Validate it before taking the lock exclusively; AddTag checks again in case someone else added it meanwhile.
+    HRESULT hrValid = m_pScorer->ValidateLanguageTag(tag);
+
+    AutoReaderWriterLock autoLock(&m_lock);
+    return AddTag(tag, hrValid, pIndexOut);
+}
+
+int LanguageMatcher::FindTag(_In_ PCWSTR tag) const
+{
+    UINT32 mask = static_cast<UINT32>(m_numBuckets - 1);
+    UINT32 bucket = Atom::HashString(tag, Atom::HashMethodCaseInsensitive) & mask;
+    while (m_pBuckets[bucket] != 0)
+    {
+        int index = m_pBuckets[bucket] - 1;
+        if (DefString_IEqual(m_pTags[index].pTag, tag))
+        {
+            return index;
+        }
+        bucket = (bucket + 1) & mask;
+    }
+    return -1;
+}
+
+HRESULT LanguageMatcher::AddTag(_In_ PCWSTR tag, _In_ HRESULT hrValid, _Out_ int* pIndexOut)
+{
+    *pIndexOut = FindTag(tag);
+    if (*pIndexOut >= 0)
+    {
+        return S_OK;
+    }
+
+    // Keep the hash at most half full so probes stay short.
+    if ((m_numTags + 1) * 2 > m_numBuckets)
+    {
+        RETURN_IF_FAILED(GrowBuckets());
+    }
+
+    if (m_numTags >= m_tagCapacity)
+    {
+        TagEntry* pNewTags = _DefArray_AllocZeroed(TagEntry, m_tagCapacity * 2);
+        RETURN_IF_NULL_ALLOC(pNewTags);
+        CopyMemory(pNewTags, m_pTags, m_numTags * sizeof(TagEntry));
+        _DefFree(m_pTags);
+        m_pTags = pNewTags;
+        m_tagCapacity *= 2;
+    }
+
+    RETURN_IF_FAILED(EnsureRowCapacity(m_numTags + 1));
+
+    PWSTR pTag;
+    RETURN_IF_FAILED(DefString_Dup(tag, &pTag));
+
+    UINT32 mask = static_cast<UINT32>(m_numBuckets - 1);
+    UINT32 bucket = Atom::HashString(tag, Atom::HashMethodCaseInsensitive) & mask;
+    while (m_pBuckets[bucket] != 0)
+    {
+        bucket = (bucket + 1) & mask;
+    }
+
+    int index = m_numTags++;
+    m_pTags[index].pTag = pTag;
+    m_pTags[index].hrValid = hrValid;
+    m_pBuckets[bucket] = index + 1;
+
+    *pIndexOut = index;
+    return S_OK;
+}
+
+HRESULT LanguageMatcher::GrowBuckets()
+{
+    int numBuckets = m_numBuckets * 2;
+    int* pBuckets = _DefArray_AllocZeroed(int, numBuckets);
+    RETURN_IF_NULL_ALLOC(pBuckets);
+
+    UINT32 mask = static_cast<UINT32>(numBuckets - 1);
+    for (int i = 0; i < m_numTags; i++)
+    {
+        UINT32 bucket = Atom::HashString(m_pTags[i].pTag, Atom::HashMethodCaseInsensitive) & mask;
+        while (pBuckets[bucket] != 0)
+        {
+            bucket = (bucket + 1) & mask;
+        }
+        pBuckets[bucket] = i + 1;
+    }
+
+    _DefFree(m_pBuckets);
+    m_pBuckets = pBuckets;
+    m_numBuckets = numBuckets;
+    return S_OK;
+}
+
+HRESULT LanguageMatcher::EnsureRowCapacity(_In_ int numTags)
+{
+    if (numTags <= m_rowCapacity)
+    {
+        return S_OK;
+    }
+
+    int capacity = max(m_tagCapacity, numTags);
+    for (int i = 0; i < MaxContextLists; i++)
+    {
+        if (m_rows[i].pLanguages == nullptr)
+        {
+            continue;
+        }
+
+        double* pScores = _DefArray_AllocZeroed(double, capacity);
+        RETURN_IF_NULL_ALLOC(pScores);
+
+        for (int j = 0; j < capacity; j++)
+        {
+            pScores[j] = ((j < m_rowCapacity) ? m_rows[i].pScores[j] : c_scoreNotComputed);
+        }
+
+        _DefFree(m_rows[i].pScores);
+        m_rows[i].pScores = pScores;
+    }
+
+    m_rowCapacity = capacity;
+    return S_OK;
+}
+
+LanguageMatcher::ContextRow* LanguageMatcher::FindRow(_In_ PCWSTR contextLanguages)
+{
+    for (int i = 0; i < MaxContextLists; i++)
+    {
+        if ((m_rows[i].pLanguages != nullptr) && DefString_Equal(m_rows[i].pLanguages, contextLanguages))
+        {
+            return &m_rows[i];
+        }
+    }
+    return nullptr;
+}
+
+HRESULT LanguageMatcher::GetRow(_In_ PCWSTR contextLanguages, _Outptr_ ContextRow** result)
+{
+    *result = FindRow(contextLanguages);
+    if (*result != nullptr)
+    {
+        (*result)->lastUsed = InterlockedIncrement(&m_useCounter);
+        return S_OK;
+    }
+
+    // Prefer an empty row, then the least recently used one.
+    ContextRow* pVictim = &m_rows[0];
+    for (int i = 1; i < MaxContextLists; i++)
+    {
+        ContextRow* pRow = &m_rows[i];
+        if ((pVictim->pLanguages != nullptr) && ((pRow->pLanguages == nullptr) || (pRow->lastUsed < pVictim->lastUsed)))
+        {
+            pVictim = pRow;
+        }
+    }
+
+    // The context languages changed, so start a new row of scores.
+    PWSTR pLanguages;
+    RETURN_IF_FAILED(DefString_Dup(contextLanguages, &pLanguages));
+
+    if (pVictim->pScores == nullptr)
+    {
+        pVictim->pScores = _DefArray_AllocZeroed(double, max(m_rowCapacity, 1));
+        if (pVictim->pScores == nullptr)
+        {
+            _DefFree(pLanguages);
+            return E_OUTOFMEMORY;
+        }
+    }
+
+    for (int i = 0; i < m_rowCapacity; i++)
+    {
+        pVictim->pScores[i] = c_scoreNotComputed;
+    }
+
+    _DefFree(pVictim->pLanguages);
+    pVictim->pLanguages = pLanguages;
+    pVictim->lastUsed = InterlockedIncrement(&m_useCounter);
+
+    *result = pVictim;
+    return S_OK;
+}
+
+bool LanguageMatcher::TryGetParentTag(_In_ PCWSTR tag, _Inout_ StringResult* pParentOut)
+{
+    if (DefString_IsEmpty(tag))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < ARRAYSIZE(c_languageParents); i++)
+    {
+        if (DefString_IEqual(c_languageParents[i].tag, tag))
+        {
+            return (c_languageParents[i].parent[0] != L'\0') && SUCCEEDED(pParentOut->SetRef(c_languageParents[i].parent));
+        }
+    }
+
+    // Otherwise just drop the last subtag.
+    PCWSTR pLastDash = wcsrchr(tag, L'-');
+    if (pLastDash == nullptr)
+    {
+        return false;
+    }
+
+    size_t cchParent = static_cast<size_t>(pLastDash - tag);
+    if ((cchParent >= 2) && (tag[cchParent - 2] == L'-'))
+    {
+        // A single-character subtag introduces an extension or private use, so drop it too.
+        cchParent -= 2;
+    }
+
+    if (cchParent < 2)
+    {
+        // Nothing left but a private use or grandfathered prefix.
+        return false;
+    }
+
+    return SUCCEEDED(pParentOut->SetCopy(tag)) && SUCCEEDED(pParentOut->Truncate(cchParent));
+}
+
+// Fills pAncestorsOut with the parent of tag, its parent, and so on.  Returns the number found.
+static int GetAncestorTags(_In_ PCWSTR tag, _Out_writes_(maxAncestors) StringResult* pAncestorsOut, _In_ int maxAncestors)
+{
+    int numAncestors = 0;
+    PCWSTR current = tag;
+    while ((numAncestors < maxAncestors) && LanguageMatcher::TryGetParentTag(current, &pAncestorsOut[numAncestors]))
+    {
+        current = pAncestorsOut[numAncestors++].GetRef();
+    }
+    return numAncestors;
+}
+
+double LanguageMatcher::GetFallbackScore(_In_ PCWSTR tag, _In_ PCWSTR contextLanguage)
+{
+    if (DefString_IsEmpty(tag) || DefString_IsEmpty(contextLanguage))
+    {
+        return 0.0;
+    }
+
+    // Same tag -> 1.0, or 0.5 for a bare language so that a full match scores higher.
+    if (DefString_IEqual(tag, contextLanguage))
+    {
+        return (wcslen(tag) > 3) ? 1.0 : 0.5;
+    }
+
+    StringResult contextAncestors[c_maxTagDepth];
+    int numContextAncestors = GetAncestorTags(contextLanguage, contextAncestors, c_maxTagDepth);
+
+    // The tag is an ancestor of the context language, e.g. "en" for "en-US".  Closer ancestors score higher.
+    for (int i = 0; i < numContextAncestors; i++)
+    {
+        if (DefString_IEqual(contextAncestors[i].GetRef(), tag))
+        {
+            return 0.5 / (i + 2);
+        }
+    }
+
+    // The tag and the context language share an ancestor, e.g. "en-GB" for "en-US".
+    StringResult tagAncestors[c_maxTagDepth];
+    int numTagAncestors = GetAncestorTags(tag, tagAncestors, c_maxTagDepth);
+    for (int i = 0; i < numTagAncestors; i++)
+    {
+        for (int j = 0; j < numContextAncestors; j++)
+        {
+            if (DefString_IEqual(tagAncestors[i].GetRef(), contextAncestors[j].GetRef()))
+            {
+                return 0.1;
+            }
+        }
+    }
+
+    return 0.0;
+}
+
+} // namespace Microsoft::Resources
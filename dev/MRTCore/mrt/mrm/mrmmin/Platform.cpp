@@ -893,6 +893,26 @@ extern "C"
         return TRUE;
     }
 
+    HRESULT
+    _DefPrefetchVirtualMemory(__in_bcount(cbRange) const void* pRange, __in size_t cbRange)
+    {
+        NTSTATUS Status;
+        MEMORY_RANGE_ENTRY Range;
+        ULONG Flags = 0;
+
+        Range.VirtualAddress = (PVOID)pRange;
+        Range.NumberOfBytes = cbRange;
+
+        Status = NtSetInformationVirtualMemory(NtCurrentProcess(), VmPrefetchInformation, 1, &Range, &Flags, sizeof(Flags));
+
+        if (!NT_SUCCESS(Status))
+        {
+            return HRESULT_FROM_NT(Status);
+        }
+
+        return S_OK;
+    }
+
     UINT _DefGetDriveTypeW(_In_opt_ PCWSTR rootPathName)
     {
         UNREFERENCED_PARAMETER(rootPathName);
@@ -948,6 +968,18 @@ extern "C"
 
 #else // !DEF_RTL
 
+#include <intrin.h>
+#if (defined(_M_X64) && !defined(_M_ARM64EC)) || defined(_M_IX86)
+#include <wmmintrin.h>
+#include <smmintrin.h>
+#define DEF_CRC32_CLMUL
+#elif defined(_M_ARM64)
+#define DEF_CRC32_ARM64
+#ifndef PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE
+#define PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE 31
+#endif
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -1094,6 +1126,21 @@ extern "C"
     BOOLEAN
     _DefUnmapViewOfFile(__in PVOID pBaseAddress) { return (BOOLEAN)UnmapViewOfFile(pBaseAddress); }
 
+    HRESULT
+    _DefPrefetchVirtualMemory(__in_bcount(cbRange) const void* pRange, __in size_t cbRange)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = const_cast<void*>(pRange);
+        range.NumberOfBytes = cbRange;
+
+        if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0))
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        return S_OK;
+    }
+
     ULONG
     _DefVirtualQuery(__in_opt PVOID Address, __out_bcount(Length) PMEMORY_BASIC_INFORMATION Buffer, __in ULONG Length)
     {
@@ -1202,7 +1249,7 @@ extern "C"
  */
 
     UINT32
-    _DefComputeCrc32(__in UINT32 partialCrc, __in_bcount(cbBuf) const BYTE* pBuf, __in UINT32 cbBuf)
+    _DefComputeCrc32Bytewise(__in UINT32 partialCrc, __in_bcount(cbBuf) const BYTE* pBuf, __in UINT32 cbBuf)
     {
         UINT32 crc;
         UINT32 i;
@@ -1221,6 +1268,237 @@ extern "C"
         return (crc ^ 0xffffffffL);
     }
 
+    //
+    // Slicing-by-8 tables. Row 0 is gCrc32Table; row n advances row n-1 by
+    // one more zero byte, so eight table lookups consume eight input bytes.
+    //
+    struct DefCrc32SliceTables
+    {
+        UINT32 rows[8][256];
+    };
+
+    static constexpr DefCrc32SliceTables DefCrc32_MakeSliceTables()
+    {
+        DefCrc32SliceTables tables = {};
+        for (UINT32 i = 0; i < 256; i++)
+        {
+            UINT32 val = i;
+            for (int k = 0; k < 8; k++)
+            {
+                val = ((val & 1) ? (0xedb88320L ^ (val >> 1)) : (val >> 1));
+            }
+            tables.rows[0][i] = val;
+        }
+        for (UINT32 i = 0; i < 256; i++)
+        {
+            for (int row = 1; row < 8; row++)
+            {
+                UINT32 prev = tables.rows[row - 1][i];
+                tables.rows[row][i] = (prev >> 8) ^ tables.rows[0][prev & 0xff];
+            }
+        }
+        return tables;
+    }
+
+    static constexpr DefCrc32SliceTables gCrc32SliceTables = DefCrc32_MakeSliceTables();
+
+    //
+    // The helpers below work on the raw CRC register; callers do the
+    // pre- and post-conditioning.
+    //
+    static UINT32 DefCrc32_UpdateSliced(__in UINT32 crc, __in_bcount(cbBuf) const BYTE* pBuf, __in size_t cbBuf)
+    {
+        const UINT32(&rows)[8][256] = gCrc32SliceTables.rows;
+
+        while ((cbBuf > 0) && ((reinterpret_cast<UINT_PTR>(pBuf) & 7) != 0))
+        {
+            crc = rows[0][(crc ^ *pBuf++) & 0xff] ^ (crc >> 8);
+            cbBuf--;
+        }
+
+        for (; cbBuf >= 8; cbBuf -= 8, pBuf += 8)
+        {
+            UINT32 lo = reinterpret_cast<const UINT32*>(pBuf)[0] ^ crc;
+            UINT32 hi = reinterpret_cast<const UINT32*>(pBuf)[1];
+            crc = rows[7][lo & 0xff] ^ rows[6][(lo >> 8) & 0xff] ^ rows[5][(lo >> 16) & 0xff] ^ rows[4][lo >> 24] ^ rows[3][hi & 0xff] ^
+                  rows[2][(hi >> 8) & 0xff] ^ rows[1][(hi >> 16) & 0xff] ^ rows[0][hi >> 24];
+        }
+
+        while (cbBuf-- > 0)
+        {
+            crc = rows[0][(crc ^ *pBuf++) & 0xff] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+#if defined(DEF_CRC32_CLMUL)
+    //
+    // Folds 64-byte blocks with carry-less multiplication, then reduces to 32
+    // bits with a Barrett reduction ("Fast CRC Computation for Generic
+    // Polynomials Using PCLMULQDQ Instruction", Intel, 2009). The constants
+    // are for the bit-reflected ISO 3309 polynomial used above.
+    //
+    // cbBuf must be at least 64 and a multiple of 16.
+    //
+    static UINT32 DefCrc32_UpdateClmul(__in UINT32 crc, __in_bcount(cbBuf) const BYTE* pBuf, __in size_t cbBuf)
+    {
+        __declspec(align(16)) static const UINT64 k1k2[] = {0x0154442bd4, 0x01c6e41596};
+        __declspec(align(16)) static const UINT64 k3k4[] = {0x01751997d0, 0x00ccaa009e};
+        __declspec(align(16)) static const UINT64 k5k0[] = {0x0163cd6124, 0x0000000000};
+        __declspec(align(16)) static const UINT64 poly[] = {0x01db710641, 0x01f7011641};
+
+        __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+        x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBuf + 0x00));
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBuf + 0x10));
+        x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBuf + 0x20));
+        x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBuf + 0x30));
+        x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+        x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+        pBuf += 64;
+        cbBuf -= 64;
+
+        // Fold four 128-bit lanes in parallel
+        for (; cbBuf >= 64; cbBuf -= 64, pBuf += 64)
+        {
+            x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+            x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+            x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+            x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+            x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+            x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+            x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+            x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBuf + 0x00)));
+            x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBuf + 0x10)));
+            x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBuf + 0x20)));
+            x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBuf + 0x30)));
+        }
+
+        // Fold the four lanes into one
+        x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+        // Fold any remaining 16-byte blocks
+        for (; cbBuf >= 16; cbBuf -= 16, pBuf += 16)
+        {
+            x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+            x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBuf))), x5);
+        }
+
+        // 128 bits to 64
+        x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+        x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+        x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+        x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+        x2 = _mm_srli_si128(x1, 4);
+        x1 = _mm_and_si128(x1, x3);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_xor_si128(x1, x2);
+
+        // Barrett reduction to 32 bits
+        x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+        x2 = _mm_and_si128(x1, x3);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+        x2 = _mm_and_si128(x2, x3);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x1 = _mm_xor_si128(x1, x2);
+
+        return static_cast<UINT32>(_mm_extract_epi32(x1, 1));
+    }
+#elif defined(DEF_CRC32_ARM64)
+    //
+    // The ARMv8 CRC32 instructions implement the same (reflected ISO 3309)
+    // polynomial, so they can consume the buffer directly.
+    //
+    static UINT32 DefCrc32_UpdateArm64(__in UINT32 crc, __in_bcount(cbBuf) const BYTE* pBuf, __in size_t cbBuf)
+    {
+        while ((cbBuf > 0) && ((reinterpret_cast<UINT_PTR>(pBuf) & 7) != 0))
+        {
+            crc = __crc32b(crc, *pBuf++);
+            cbBuf--;
+        }
+        for (; cbBuf >= 8; cbBuf -= 8, pBuf += 8)
+        {
+            crc = __crc32d(crc, *reinterpret_cast<const UINT64*>(pBuf));
+        }
+        while (cbBuf-- > 0)
+        {
+            crc = __crc32b(crc, *pBuf++);
+        }
+        return crc;
+    }
+#endif
+
+    // -1 until the first call determines whether the CPU supports the hardware kernel.
+    static volatile LONG gCrc32HardwareState = -1;
+
+    BOOLEAN
+    _DefCrc32HardwareIsAvailable()
+    {
+        LONG state = gCrc32HardwareState;
+        if (state < 0)
+        {
+            state = 0;
+#if defined(DEF_CRC32_CLMUL)
+            int cpuInfo[4];
+            __cpuid(cpuInfo, 1);
+            // ECX bit 1 = PCLMULQDQ, bit 19 = SSE4.1 (for _mm_extract_epi32)
+            state = (((cpuInfo[2] & (1 << 1)) != 0) && ((cpuInfo[2] & (1 << 19)) != 0)) ? 1 : 0;
+#elif defined(DEF_CRC32_ARM64)
+            state = IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE) ? 1 : 0;
+#endif
+            // Every thread computes the same answer, so a race here is harmless.
+            gCrc32HardwareState = state;
+        }
+        return (state != 0);
+    }
+
+    UINT32
+    _DefComputeCrc32Sliced(__in UINT32 partialCrc, __in_bcount(cbBuf) const BYTE* pBuf, __in UINT32 cbBuf)
+    {
+        return DefCrc32_UpdateSliced(partialCrc ^ 0xffffffffL, pBuf, cbBuf) ^ 0xffffffffL;
+    }
+
+    UINT32
+    _DefComputeCrc32(__in UINT32 partialCrc, __in_bcount(cbBuf) const BYTE* pBuf, __in UINT32 cbBuf)
+    {
+        UINT32 crc = partialCrc ^ 0xffffffffL;
+        size_t cbLeft = cbBuf;
+
+#if defined(DEF_CRC32_CLMUL)
+        if ((cbLeft >= 64) && _DefCrc32HardwareIsAvailable())
+        {
+            size_t cbFolded = (cbLeft & ~static_cast<size_t>(15));
+            crc = DefCrc32_UpdateClmul(crc, pBuf, cbFolded);
+            pBuf += cbFolded;
+            cbLeft -= cbFolded;
+        }
+#elif defined(DEF_CRC32_ARM64)
+        if ((cbLeft >= 8) && _DefCrc32HardwareIsAvailable())
+        {
+            return DefCrc32_UpdateArm64(crc, pBuf, cbLeft) ^ 0xffffffffL;
+        }
+#endif
+
+        return DefCrc32_UpdateSliced(crc, pBuf, cbLeft) ^ 0xffffffffL;
+    }
+
     UINT32
     _DefComputeStringCrc32(__in UINT32 partialCrc, __in BOOLEAN isCaseInsensitive, __in_ecount(cchStr) PCWSTR pStr, __in UINT32 cchStr)
     {
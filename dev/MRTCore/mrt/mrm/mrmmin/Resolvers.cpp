@@ -193,6 +193,56 @@ private:
     DynamicArray<StringResult*>* m_qualifierCaches{ nullptr };
 };
 
+class ResolverBase::FrozenDecisions : public DefObject
+{
+public:
+    // Marks a decision that has neither a matching nor a default candidate.
+    static const INT32 NoMatch = -1;
+
+    static HRESULT CreateInstance(_In_ LONG epoch, _In_ int numDecisions, _Outptr_ FrozenDecisions** result)
+    {
+        *result = nullptr;
+
+        RETURN_HR_IF(E_INVALIDARG, numDecisions < 0);
+
+        AutoDeletePtr<FrozenDecisions> pRtrn = new FrozenDecisions(epoch, numDecisions);
+        RETURN_IF_NULL_ALLOC(pRtrn);
+
+        if (numDecisions > 0)
+        {
+            pRtrn->m_pResults = _DefArray_AllocZeroed(INT32, numDecisions);
+            RETURN_IF_NULL_ALLOC(pRtrn->m_pResults);
+        }
+
+        *result = pRtrn.Detach();
+        return S_OK;
+    }
+
+    ~FrozenDecisions() { Def_Free(m_pResults); }
+
+    LONG GetEpoch() const { return m_epoch; }
+
+    int GetNumDecisions() const { return m_numDecisions; }
+
+    INT32 GetResult(_In_ int index) const { return m_pResults[index]; }
+
+    void SetResult(_In_ int index, _In_ INT32 result) { m_pResults[index] = result; }
+
+    FrozenDecisions* GetNextRetired() const { return m_pNextRetired; }
+
+    void SetNextRetired(_In_opt_ FrozenDecisions* pNext) { m_pNextRetired = pNext; }
+
+protected:
+    FrozenDecisions(_In_ LONG epoch, _In_ int numDecisions) :
+        m_epoch(epoch), m_numDecisions(numDecisions), m_pResults(nullptr), m_pNextRetired(nullptr)
+    {}
+
+    LONG m_epoch;
+    int m_numDecisions;
+    INT32* m_pResults;
+    FrozenDecisions* m_pNextRetired;
+};
+
 class ResolverBase::DecisionInfoCache : public DefObject
 {
 public:
@@ -205,14 +255,31 @@ public:
 
         RETURN_HR_IF_NULL(E_INVALIDARG, pDecisions);
 
-        DecisionInfoCache* pRtrn = new DecisionInfoCache(pDecisions, pEnvironment);
+        AutoDeletePtr<DecisionInfoCache> pRtrn = new DecisionInfoCache(pDecisions, pEnvironment);
         RETURN_IF_NULL_ALLOC(pRtrn);
+        RETURN_IF_FAILED(pRtrn->Init());
 
-        *result = pRtrn;
+        *result = pRtrn.Detach();
         return S_OK;
     }
 
-    ~DecisionInfoCache() {}
+    ~DecisionInfoCache()
+    {
+        FreeTable(m_pTable);
+        while (m_pRetiredTables != nullptr)
+        {
+            CacheTable* pNext = m_pRetiredTables->pNextRetired;
+            FreeTable(m_pRetiredTables);
+            m_pRetiredTables = pNext;
+        }
+
+        while (m_pAllocatedDecisions != nullptr)
+        {
+            DecisionCacheEntry* pNext = m_pAllocatedDecisions->pNextAllocated;
+            _DefFree(m_pAllocatedDecisions);
+            m_pAllocatedDecisions = pNext;
+        }
+    }
 
     const IDecisionInfo* GetDecisionInfo() const { return m_pDecisions; }
 
@@ -237,8 +304,6 @@ public:
         UINT32 pad : 7;
     } QualifierSetCacheEntry;
 
-    static const UINT16 kDecisionAttemptedMask = 0x8000;
-
     class QualifierSetComparer
     {
     public:
@@ -445,34 +510,53 @@ public:
         UINT16 _nextFreeEntry = 0;
     };
 
-    void Reset()
+    typedef struct _DecisionPerSetInfo
     {
-        // using UNREFERENCED_PARAMETER because prefast complains about inconsisten
-        // annotation if I comment out pStatus.
-        AutoReaderWriterLock autoLock(&m_srwLock);
+        UINT16 setIndexInDecision;
+        UINT16 setIndexInPool;
+    } DecisionPerSetInfo;
 
-        _QualifierCacheEntry* pCachedQualifiers = m_qualifierCache.GetAll();
-        for (unsigned int i = 0; i < m_qualifierCache.Count(); ++i)
-        {
-            (pCachedQualifiers + i)->bAttempted = 0;
-        }
-        m_qualifierCache.Reset();
+    // A cached decision result.  The high half of the tag holds the epoch in which the results were
+    // computed and the low half is a sequence number that is odd while a writer is filling in the
+    // sets.  Readers copy the sets out and then re-check the tag, so a concurrent writer is always
+    // detected.
+    typedef struct _DecisionCacheEntry
+    {
+        volatile LONG64 tag;
+        struct _DecisionCacheEntry* pNextAllocated;
+        int numSets;
+        DecisionPerSetInfo sets[ANYSIZE_ARRAY];
+    } DecisionCacheEntry;
 
-        QualifierSetCacheEntry* pCachedQualifierSets = m_qualifierSetCache.GetAll();
-        for (unsigned int i = 0; i < m_qualifierSetCache.Count(); ++i)
-        {
-            (pCachedQualifierSets + i)->attempted = 0;
-        }
-        m_qualifierSetCache.Reset();
+    // The published cache.  Slots are only ever written with interlocked operations, so a table
+    // can be read without holding a lock.  If the decision info grows, a larger table is published
+    // and the old one is retired; retired tables stay valid until the cache is destroyed.
+    typedef struct _CacheTable
+    {
+        int numQualifiers;
+        int numQualifierSets;
+        int numDecisions;
+        volatile LONG64* pQualifiers;
+        volatile LONG64* pQualifierSets;
+        DecisionCacheEntry* volatile* ppDecisions;
+        struct _CacheTable* pNextRetired;
+    } CacheTable;
+
+    LONG GetEpoch() const { return ReadAcquire(&m_epoch); }
 
-        UINT16* pCachedDecision = m_decisionCache.GetAll();
-        for (unsigned int i = 0; i < m_decisionCache.Count(); ++i)
+    const CacheTable* GetTable() const
+    {
+        return static_cast<const CacheTable*>(ReadPointerAcquire(reinterpret_cast<PVOID const volatile*>(&m_pTable)));
+    }
+
+    void Reset()
+    {
+        // Advancing the epoch invalidates every cached entry at once.  Zero is never a valid
+        // epoch because freshly allocated slots are zeroed.
+        if (InterlockedIncrement(&m_epoch) == 0)
         {
-            *(pCachedDecision + i) &= ~kDecisionAttemptedMask;
+            InterlockedCompareExchange(&m_epoch, 1, 0);
         }
-        m_decisionCache.Reset();
-
-        m_decisionPerSetInfo.Reset();
     }
 
     void Reset(_In_ Atom)
@@ -481,26 +565,31 @@ public:
         return Reset();
     }
 
-    HRESULT GetQualifierScores(_In_ const IQualifier* pQualifier, _Out_ UINT16* pScoreOut, _Out_ UINT16* pFallbackScoreOut)
+    HRESULT GetQualifierScores(_In_ const IQualifier* pQualifier, _Out_ UINT16* pScoreOut, _Out_ UINT16* pFallbackScoreOut) const
     {
+        *pScoreOut = 0;
+        *pFallbackScoreOut = 0;
+
         int index;
         RETURN_IF_FAILED(pQualifier->GetQualifierIndex(&index));
 
-        AutoReaderWriterLock autoLock(&m_srwLock, true);
-        QualifierCacheEntry* pEntries = m_qualifierCache.GetAll();
-        if ((index < 0) || (index >= m_qualifierCache.Count()) || (!pEntries[index].bAttempted))
+        QualifierCacheEntry entry;
+        if (!TryLoadQualifierEntry(GetTable(), GetEpoch(), index, &entry) || !entry.bAttempted)
         {
-            *pScoreOut = 0;
-            *pFallbackScoreOut = 0;
             return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
         }
 
-        *pScoreOut = pEntries[index].score;
-        *pFallbackScoreOut = pEntries[index].fallbackScore;
+        *pScoreOut = entry.score;
+        *pFallbackScoreOut = entry.fallbackScore;
         return S_OK;
     }
 
-    HRESULT SetQualifierScores(_In_ const IQualifier* pQualifier, _In_ int priority, _In_ UINT16 score, _In_ UINT16 fallbackScore)
+    HRESULT SetQualifierScores(
+        _In_ LONG epoch,
+        _In_ const IQualifier* pQualifier,
+        _In_ int priority,
+        _In_ UINT16 score,
+        _In_ UINT16 fallbackScore)
     {
         int index;
         RETURN_IF_FAILED(pQualifier->GetQualifierIndex(&index));
@@ -510,20 +599,20 @@ public:
         RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_RANGE_NOT_FOUND), (score < 0) || (score > IQualifier::MaxFallbackScore));
         RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_RANGE_NOT_FOUND), (fallbackScore < 0) || (fallbackScore > IQualifier::MaxFallbackScore));
 
-        AutoReaderWriterLock autoLock(&m_srwLock);
-        if (index >= m_qualifierCache.Count())
+        const CacheTable* pTable;
+        RETURN_IF_FAILED(GetTableForWrite(&pTable));
+        if (index >= pTable->numQualifiers)
         {
-            // decision info has grown since we were initialized
-            // but we weren't able to grow our cache.
-            RETURN_IF_FAILED(m_qualifierCache.SetExtent(m_pDecisions->GetNumQualifiers()));
+            // decision info grew again while we were publishing; the next lookup will recompute.
+            return S_OK;
         }
 
-        QualifierCacheEntry entry;
+        QualifierCacheEntry entry = {};
         entry.bAttempted = 1;
         entry.priority = priority;
         entry.score = score;
         entry.fallbackScore = fallbackScore;
-        RETURN_IF_FAILED(m_qualifierCache.Set(index, entry));
+        StoreSlot(&pTable->pQualifiers[index], epoch, &entry);
 
         return S_OK;
     }
@@ -534,15 +623,13 @@ public:
         _Out_ bool* pbIsDefaultOut,
         _Out_ bool* pbIsMatchOrDefaultOut,
         _Out_opt_ UINT16* pBestActualMatchScoreOut = NULL,
-        _Out_opt_ UINT16* pBestActualMatchPriorityOut = NULL)
+        _Out_opt_ UINT16* pBestActualMatchPriorityOut = NULL) const
     {
         int index;
         RETURN_IF_FAILED(pQualifierSet->GetIndex(&index));
 
-        AutoReaderWriterLock autoLock(&m_srwLock, true);
-
-        QualifierSetCacheEntry* pEntries = m_qualifierSetCache.GetAll();
-        if ((index < 0) || (index >= m_qualifierSetCache.Count()) || (!pEntries[index].attempted))
+        QualifierSetCacheEntry entry;
+        if (!TryLoadQualifierSetEntry(GetTable(), GetEpoch(), index, &entry) || !entry.attempted)
         {
             *pbIsMatchOut = *pbIsDefaultOut = *pbIsMatchOrDefaultOut = false;
             if (pBestActualMatchScoreOut)
@@ -556,38 +643,24 @@ public:
             return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
         }
 
-        *pbIsMatchOut = (pEntries[index].isMatch != 0);
-        *pbIsDefaultOut = (pEntries[index].isDefault != 0);
-        *pbIsMatchOrDefaultOut = (pEntries[index].isMatchOrDefault != 0);
+        *pbIsMatchOut = (entry.isMatch != 0);
+        *pbIsDefaultOut = (entry.isDefault != 0);
+        *pbIsMatchOrDefaultOut = (entry.isMatchOrDefault != 0);
 
         if (pBestActualMatchScoreOut)
         {
-            *pBestActualMatchScoreOut = pEntries[index].bestMatchScore;
+            *pBestActualMatchScoreOut = entry.bestMatchScore;
         }
         if (pBestActualMatchPriorityOut)
         {
-            *pBestActualMatchPriorityOut = pEntries[index].bestMatchPriority;
+            *pBestActualMatchPriorityOut = entry.bestMatchPriority;
         }
 
         return S_OK;
     }
 
-    HRESULT GetQualifierSetCacheEntry(_In_ int index, _Out_ const QualifierSetCacheEntry** ppQualifierSetResult)
-    {
-        AutoReaderWriterLock autoLock(&m_srwLock, true);
-
-        QualifierSetCacheEntry* pEntries = m_qualifierSetCache.GetAll();
-        if ((index < 0) || (index >= m_qualifierSetCache.Count()) || (!pEntries[index].attempted))
-        {
-            *ppQualifierSetResult = NULL;
-            return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
-        }
-
-        *ppQualifierSetResult = &pEntries[index];
-        return S_OK;
-    }
-
     HRESULT SetQualifierSetResults(
+        _In_ LONG epoch,
         _In_ const IQualifierSet* pQualifierSet,
         _In_ bool isMatch,
         _In_ bool isDefaultMatch,
@@ -606,15 +679,14 @@ public:
         RETURN_HR_IF(
             HRESULT_FROM_WIN32(ERROR_RANGE_NOT_FOUND), (bestActualMatchScore < 0) || (bestActualMatchScore > IQualifier::MaxFallbackScore));
 
-        AutoReaderWriterLock autoLock(&m_srwLock);
-        if (index >= m_qualifierSetCache.Count())
+        const CacheTable* pTable;
+        RETURN_IF_FAILED(GetTableForWrite(&pTable));
+        if (index >= pTable->numQualifierSets)
         {
-            // decision info has grown since we were initialized
-            // but we weren't able to grow our cache.
-            RETURN_IF_FAILED(m_qualifierSetCache.SetExtent(m_pDecisions->GetNumQualifierSets()));
+            return S_OK;
         }
 
-        QualifierSetCacheEntry entry;
+        QualifierSetCacheEntry entry = {};
         entry.attempted = 1;
         entry.isMatch = (isMatch ? 1 : 0);
         entry.isDefault = (isDefaultMatch ? 1 : 0);
@@ -622,129 +694,124 @@ public:
         entry.requireComplexResolution = (requireComplexResolution ? 1 : 0);
         entry.bestMatchPriority = bestActualMatchPriority;
         entry.bestMatchScore = bestActualMatchScore;
-
-        RETURN_IF_FAILED(m_qualifierSetCache.Set(index, entry));
+        StoreSlot(&pTable->pQualifierSets[index], epoch, &entry);
 
         return S_OK;
     }
 
-    typedef struct _DecisionPerSetInfo
-    {
-        UINT16 setIndexInDecision;
-        UINT16 setIndexInPool;
-    } DecisionPerSetInfo;
-
     HRESULT GetDecisionResults(
         _In_ const IDecision* pDecision,
         _In_ int numResults,
         _Out_writes_(numResults) int* pSetIndexesInDecisionOut,
-        _Out_writes_(numResults) int* pSetIndexesInPoolOut)
+        _Out_writes_(numResults) int* pSetIndexesInPoolOut) const
     {
         int index;
         RETURN_IF_FAILED(pDecision->GetIndex(&index));
 
-        UINT16 offset = 0;
-
-        AutoReaderWriterLock autoLock(&m_srwLock, true);
-        if ((index < 0) || (index >= m_decisionCache.Count()) || (!m_decisionCache.TryGet(index, &offset)) ||
-            ((offset & kDecisionAttemptedMask) == 0))
+        const CacheTable* pTable = GetTable();
+        if ((index < 0) || (index >= pTable->numDecisions))
         {
-            // out of range or not attempted
             return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
         }
 
-        // mask off the bit that indicates that the decision was cached
-        offset &= ~kDecisionAttemptedMask;
-
-        int numDecisionResults = pDecision->GetNumQualifierSets();
-        numResults = min(numResults, numDecisionResults);
+        const DecisionCacheEntry* pEntry = LoadDecisionEntry(pTable, index);
+        if (pEntry == nullptr)
+        {
+            return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
+        }
 
-        DEF_ASSERT((offset + numResults) <= m_decisionPerSetInfo.Count());
+        LONG64 tag = ReadAcquire64(&pEntry->tag);
+        if ((GetSlotEpoch(tag) != GetEpoch()) || ((GetSlotValue(tag) & kDecisionWritingTag) != 0))
+        {
+            // out of date, or a writer is filling it in
+            return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
+        }
 
-        const DecisionPerSetInfo* pSets = &m_decisionPerSetInfo.GetAll()[offset];
-        for (int i = 0; (i < numResults); i++)
+        numResults = min(numResults, pEntry->numSets);
+        for (int i = 0; i < numResults; i++)
         {
-            pSetIndexesInDecisionOut[i] = pSets[i].setIndexInDecision;
-            pSetIndexesInPoolOut[i] = pSets[i].setIndexInPool;
+            pSetIndexesInDecisionOut[i] = pEntry->sets[i].setIndexInDecision;
+            pSetIndexesInPoolOut[i] = pEntry->sets[i].setIndexInPool;
         }
+
+        // If the tag changed while we were copying, the copy may be torn.
+        MemoryBarrier();
+        RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_NOT_FOUND), ReadNoFence64(&pEntry->tag) != tag);
+
         return S_OK;
     }
 
-    HRESULT
-    BeginSetDecisionResults(_In_ const IDecision* pDecision, _Out_writes_(*pNumSetsOut) DecisionPerSetInfo** result, _Out_ int* pNumSetsOut)
+    HRESULT SetDecisionResults(
+        _In_ LONG epoch,
+        _In_ const IDecision* pDecision,
+        _In_reads_(numSets) const DecisionPerSetInfo* pSets,
+        _In_ int numSets)
     {
-        *result = nullptr;
-        *pNumSetsOut = 0;
-
         int index;
         RETURN_IF_FAILED(pDecision->GetIndex(&index));
 
-        AutoReaderWriterLock autoLock(&m_srwLock);
         DEF_ASSERT((index >= 0) && (index < m_pDecisions->GetNumDecisions()));
+        RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_RANGE_NOT_FOUND), (index < 0) || (numSets <= 0));
 
-        if (index >= m_decisionCache.Count())
+        const CacheTable* pTable;
+        RETURN_IF_FAILED(GetTableForWrite(&pTable));
+        if (index >= pTable->numDecisions)
         {
-            // couldn't extend the cache
-            RETURN_IF_FAILED(m_decisionCache.SetExtent(m_pDecisions->GetNumDecisions()));
+            return S_OK;
         }
 
-        UINT16* pCachedDecision = &m_decisionCache.GetAll()[index];
-
-        // We have our entry in the decision cache, now we need to figure
-        // out where the qualifier set data will go.
-        int offset = m_decisionPerSetInfo.Count();
-        int numSets = pDecision->GetNumQualifierSets();
-
-        // If there are no qualifier sets, return with MRM_NO_MATCHING_CANDIDATE
-        // If we can't extend, SetExtent reports the error.
-        RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_NO_MATCH_OR_DEFAULT_CANDIDATE), numSets == 0);
-        RETURN_IF_FAILED(m_decisionPerSetInfo.SetExtent(offset + numSets));
-
-        DecisionPerSetInfo* pSets = &m_decisionPerSetInfo.GetAll()[offset];
-        SecureZeroMemory(pSets, numSets * sizeof(DecisionPerSetInfo));
-
-        // Set the offset in the cached decisions, but don't set the attempted bit
-        // until EndDecisionResults
-        *pCachedDecision = static_cast<UINT16>(offset);
-        *pNumSetsOut = numSets;
-        *result = pSets;
-
-        return S_OK;
-    }
-
-    HRESULT EndSetDecisionResults(_In_ const IDecision* pDecision)
-    {
-        int index;
-        RETURN_IF_FAILED(pDecision->GetIndex(&index));
+        DecisionCacheEntry* volatile* ppSlot = &pTable->ppDecisions[index];
+        DecisionCacheEntry* pEntry = LoadDecisionEntry(pTable, index);
+        if ((pEntry == nullptr) || (pEntry->numSets != numSets))
+        {
+            DecisionCacheEntry* pNewEntry;
+            RETURN_IF_FAILED(AllocDecisionEntry(numSets, &pNewEntry));
 
-        AutoReaderWriterLock autoLock(&m_srwLock);
-        DEF_ASSERT((index >= 0) && (index < m_pDecisions->GetNumDecisions()) && (index < m_decisionCache.Count()));
+            DecisionCacheEntry* pCurrent = static_cast<DecisionCacheEntry*>(InterlockedCompareExchangePointer(
+                reinterpret_cast<PVOID volatile*>(ppSlot), pNewEntry, pEntry));
+            pEntry = (pCurrent == pEntry) ? pNewEntry : pCurrent;
+            if (pEntry->numSets != numSets)
+            {
+                // Someone else installed a different entry.  Leave it to them.
+                return S_OK;
+            }
+        }
 
-        UINT16* pCachedDecision = &m_decisionCache.GetAll()[index];
+        // Claim the entry by making its sequence number odd.  Every write advances the sequence,
+        // so a reader that sees the same tag before and after copying saw a stable entry.
+        LONG64 tag = ReadAcquire64(&pEntry->tag);
+        UINT32 sequence = GetSlotValue(tag);
+        if ((epoch != GetEpoch()) || ((sequence & kDecisionWritingTag) != 0) || (GetSlotEpoch(tag) == epoch) ||
+            (InterlockedCompareExchange64(&pEntry->tag, MakeSlot(epoch, sequence + 1), tag) != tag))
+        {
+            // stale, already cached, or someone else is writing it
+            return S_OK;
+        }
 
-        (*pCachedDecision) |= kDecisionAttemptedMask;
+        CopyMemory(pEntry->sets, pSets, numSets * sizeof(DecisionPerSetInfo));
+        InterlockedExchange64(&pEntry->tag, MakeSlot(epoch, sequence + 2));
 
         return S_OK;
     }
 
-    // Comments out below lock held as OACR can't understand ReadWriterLock.
-    // _Requires_lock_held_(ResolverBase::m_srwLock)
-    // _Requires_lock_held_(ResolverBase::m_srwQualifierSetLock)
-    int CompareQualifierSetResults(_In_ int setIndexInPool1, _In_ int setIndexInPool2, _Inout_ const IResolver* pResolver)
+    int CompareQualifierSetResults(
+        _In_ const CacheTable* pTable,
+        _In_ LONG epoch,
+        _In_ int setIndexInPool1,
+        _In_ int setIndexInPool2,
+        _Inout_ const IResolver* pResolver)
     {
-        if ((setIndexInPool1 < 0) || (setIndexInPool1 > m_qualifierSetCache.Count() - 1))
-        {
-            return 0;
-        }
+        QualifierSetCacheEntry entry1;
+        QualifierSetCacheEntry entry2;
 
-        if ((setIndexInPool2 < 0) || (setIndexInPool2 > m_qualifierSetCache.Count() - 1))
+        if (!TryLoadQualifierSetEntry(pTable, epoch, setIndexInPool1, &entry1) ||
+            !TryLoadQualifierSetEntry(pTable, epoch, setIndexInPool2, &entry2))
         {
             return 0;
         }
 
-        QualifierSetCacheEntry* pEntries = m_qualifierSetCache.GetAll();
-        const DecisionInfoCache::QualifierSetCacheEntry* pEntry1 = &pEntries[setIndexInPool1];
-        const DecisionInfoCache::QualifierSetCacheEntry* pEntry2 = &pEntries[setIndexInPool2];
+        const DecisionInfoCache::QualifierSetCacheEntry* pEntry1 = &entry1;
+        const DecisionInfoCache::QualifierSetCacheEntry* pEntry2 = &entry2;
 
         int diff = 0;
 
@@ -768,8 +835,8 @@ public:
                 if (diff == 0)
                 {
                     diff = (pEntry1->requireComplexResolution == 1 || pEntry2->requireComplexResolution == 1) ?
-                               CompareQualifierSetResultComplex(setIndexInPool1, setIndexInPool2, pResolver) :
-                               CompareQualifierSetResultDetails(setIndexInPool1, setIndexInPool2, pResolver);
+                               CompareQualifierSetResultComplex(pTable, epoch, setIndexInPool1, setIndexInPool2, pResolver) :
+                               CompareQualifierSetResultDetails(pTable, epoch, setIndexInPool1, setIndexInPool2, pResolver);
                 }
             }
         }
@@ -785,8 +852,8 @@ public:
             else
             {
                 diff = (pEntry1->requireComplexResolution == 1 || pEntry2->requireComplexResolution == 1) ?
-                           CompareQualifierSetResultComplex(setIndexInPool1, setIndexInPool2, pResolver) :
-                           CompareQualifierSetResultDetails(setIndexInPool1, setIndexInPool2, pResolver);
+                           CompareQualifierSetResultComplex(pTable, epoch, setIndexInPool1, setIndexInPool2, pResolver) :
+                           CompareQualifierSetResultDetails(pTable, epoch, setIndexInPool1, setIndexInPool2, pResolver);
             }
         }
         else
@@ -801,6 +868,8 @@ public:
     {
         DecisionInfoCache* pCache;
         const IResolver* pResolver;
+        const CacheTable* pTable;
+        LONG epoch;
     } _DecisionSortingInfo;
 
     // helper function for decision results
@@ -810,7 +879,11 @@ public:
         const _DecisionPerSetInfo* pResult2)
     {
         int diff = pSortingContextInfo->pCache->CompareQualifierSetResults(
-            pResult1->setIndexInPool, pResult2->setIndexInPool, pSortingContextInfo->pResolver);
+            pSortingContextInfo->pTable,
+            pSortingContextInfo->epoch,
+            pResult1->setIndexInPool,
+            pResult2->setIndexInPool,
+            pSortingContextInfo->pResolver);
         // If the two decision results compare identically, position in the decision is the final tie breaker.
         if (diff != 0)
         {
@@ -833,50 +906,276 @@ public:
     }
 
 protected:
+    static const UINT32 kDecisionWritingTag = 1;
+
     const IDecisionInfo* m_pDecisions;
     const UnifiedEnvironment* m_pEnvironment;
 
-    DynamicArray<QualifierCacheEntry> m_qualifierCache;
-    DynamicArray<QualifierSetCacheEntry> m_qualifierSetCache;
-    DynamicArray<DecisionPerSetInfo> m_decisionPerSetInfo;
-    DynamicArray<UINT16> m_decisionCache;
+    CacheTable* volatile m_pTable;
+    CacheTable* m_pRetiredTables;
+    DecisionCacheEntry* volatile m_pAllocatedDecisions;
+    volatile LONG m_epoch;
 
     DecisionInfoCache(_In_ const IDecisionInfo* pDecisions, _In_ const UnifiedEnvironment* pEnvironment) :
         m_pDecisions(pDecisions),
         m_pEnvironment(pEnvironment),
-        m_qualifierCache(),
-        m_qualifierSetCache(),
-        m_decisionPerSetInfo(),
-        m_decisionCache()
+        m_pTable(nullptr),
+        m_pRetiredTables(nullptr),
+        m_pAllocatedDecisions(nullptr),
+        m_epoch(1)
     {
-        ::InitializeSRWLock(&m_srwLock);
+        ::InitializeSRWLock(&m_srwGrowLock);
+    }
+
+    static LONG64 MakeSlot(_In_ LONG epoch, _In_ UINT32 value) { return (static_cast<LONG64>(epoch) << 32) | value; }
+
+    static LONG GetSlotEpoch(_In_ LONG64 slot) { return static_cast<LONG>(slot >> 32); }
+
+    static UINT32 GetSlotValue(_In_ LONG64 slot) { return static_cast<UINT32>(slot); }
+
+    template<class TEntry>
+    static void StoreSlot(_Inout_ volatile LONG64* pSlot, _In_ LONG epoch, _In_ const TEntry* pEntry)
+    {
+        static_assert(sizeof(TEntry) == sizeof(UINT32), "cache entries must fit in the low half of a slot");
+
+        UINT32 value;
+        CopyMemory(&value, pEntry, sizeof(value));
+        InterlockedExchange64(pSlot, MakeSlot(epoch, value));
+    }
+
+    // Loads the entry at index as of epoch.  Entries from any other epoch come back zeroed,
+    // i.e. not attempted.  Returns false if index is outside the table.
+    template<class TEntry>
+    static bool TryLoadSlot(_In_ const volatile LONG64* pSlots, _In_ int numSlots, _In_ LONG epoch, _In_ int index, _Out_ TEntry* pEntryOut)
+    {
+        static_assert(sizeof(TEntry) == sizeof(UINT32), "cache entries must fit in the low half of a slot");
+
+        ZeroMemory(pEntryOut, sizeof(*pEntryOut));
+        if ((index < 0) || (index >= numSlots))
+        {
+            return false;
+        }
+
+        LONG64 slot = ReadAcquire64(&pSlots[index]);
+        if (GetSlotEpoch(slot) == epoch)
+        {
+            UINT32 value = GetSlotValue(slot);
+            CopyMemory(pEntryOut, &value, sizeof(value));
+        }
+        return true;
+    }
+
+    static bool TryLoadQualifierEntry(_In_ const CacheTable* pTable, _In_ LONG epoch, _In_ int index, _Out_ QualifierCacheEntry* pEntryOut)
+    {
+        return TryLoadSlot(pTable->pQualifiers, pTable->numQualifiers, epoch, index, pEntryOut);
+    }
+
+    static bool
+    TryLoadQualifierSetEntry(_In_ const CacheTable* pTable, _In_ LONG epoch, _In_ int index, _Out_ QualifierSetCacheEntry* pEntryOut)
+    {
+        return TryLoadSlot(pTable->pQualifierSets, pTable->numQualifierSets, epoch, index, pEntryOut);
+    }
+
+    static DecisionCacheEntry* LoadDecisionEntry(_In_ const CacheTable* pTable, _In_ int index)
+    {
+        return static_cast<DecisionCacheEntry*>(ReadPointerAcquire(reinterpret_cast<PVOID const volatile*>(&pTable->ppDecisions[index])));
+    }
+
+    static void FreeTable(_In_opt_ CacheTable* pTable)
+    {
+        if (pTable != nullptr)
+        {
+            _DefFree(const_cast<LONG64*>(pTable->pQualifiers));
+            _DefFree(const_cast<LONG64*>(pTable->pQualifierSets));
+            _DefFree(const_cast<DecisionCacheEntry**>(pTable->ppDecisions));
+            _DefFree(pTable);
+        }
+    }
+
+    HRESULT AllocTable(_In_opt_ const CacheTable* pOld, _Outptr_ CacheTable** result)
+    {
+        *result = nullptr;
+
+        int numQualifiers = max(m_pDecisions->GetNumQualifiers(), 0);
+        int numQualifierSets = max(m_pDecisions->GetNumQualifierSets(), 0);
+        int numDecisions = max(m_pDecisions->GetNumDecisions(), 0);
+
+        if (pOld != nullptr)
+        {
+            numQualifiers = max(numQualifiers, pOld->numQualifiers);
+            numQualifierSets = max(numQualifierSets, pOld->numQualifierSets);
+            numDecisions = max(numDecisions, pOld->numDecisions);
+        }
+
+        CacheTable* pTable = _DefAllocZeroed(CacheTable);
+        RETURN_IF_NULL_ALLOC(pTable);
+
+        // Always allocate at least one slot so an empty table is still a valid table.
+        pTable->pQualifiers = _DefArray_AllocZeroed(LONG64, max(numQualifiers, 1));
+        pTable->pQualifierSets = _DefArray_AllocZeroed(LONG64, max(numQualifierSets, 1));
+        pTable->ppDecisions = _DefArray_AllocZeroed(DecisionCacheEntry*, max(numDecisions, 1));
+        if ((pTable->pQualifiers == nullptr) || (pTable->pQualifierSets == nullptr) || (pTable->ppDecisions == nullptr))
+        {
+            FreeTable(pTable);
+            return E_OUTOFMEMORY;
+        }
+
+        pTable->numQualifiers = numQualifiers;
+        pTable->numQualifierSets = numQualifierSets;
+        pTable->numDecisions = numDecisions;
+
+        *result = pTable;
+        return S_OK;
+    }
+
+    HRESULT Init()
+    {
+        CacheTable* pTable;
+        RETURN_IF_FAILED(AllocTable(nullptr, &pTable));
+        m_pTable = pTable;
+        return S_OK;
+    }
+
+    bool CoversDecisionInfo(_In_ const CacheTable* pTable) const
+    {
+        return (pTable->numQualifiers >= m_pDecisions->GetNumQualifiers()) &&
+               (pTable->numQualifierSets >= m_pDecisions->GetNumQualifierSets()) &&
+               (pTable->numDecisions >= m_pDecisions->GetNumDecisions());
+    }
+
+    // Returns a table that covers the decision info as it is now, publishing a larger one if it
+    // has grown.  Only writers get here; lookups always use whatever table is published.
+    HRESULT GetTableForWrite(_Outptr_ const CacheTable** result)
+    {
+        const CacheTable* pTable = GetTable();
+        if (CoversDecisionInfo(pTable))
+        {
+            *result = pTable;
+            return S_OK;
+        }
+
+        AutoReaderWriterLock autoLock(&m_srwGrowLock);
+
+        CacheTable* pOld = m_pTable;
+        if (CoversDecisionInfo(pOld))
+        {
+            *result = pOld;
+            return S_OK;
+        }
+
+        CacheTable* pNew;
+        RETURN_IF_FAILED(AllocTable(pOld, &pNew));
+
+        // Lookups may still be walking the old table, so keep it around until we're destroyed.
+        // Results stored in the old table are not carried over; advancing the epoch makes any
+        // evaluation that straddled the switch start over instead of caching partial results.
+        pOld->pNextRetired = m_pRetiredTables;
+        m_pRetiredTables = pOld;
+        InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_pTable), pNew);
+        Reset();
+
+        *result = pNew;
+        return S_OK;
+    }
+
+    HRESULT AllocDecisionEntry(_In_ int numSets, _Outptr_ DecisionCacheEntry** result)
+    {
+        *result = nullptr;
+
+        size_t cbEntry = FIELD_OFFSET(DecisionCacheEntry, sets) + (static_cast<size_t>(numSets) * sizeof(DecisionPerSetInfo));
+        DecisionCacheEntry* pEntry = static_cast<DecisionCacheEntry*>(_DefBlob_AllocZeroed(cbEntry));
+        RETURN_IF_NULL_ALLOC(pEntry);
+
+        pEntry->numSets = numSets;
+
+        // Every entry we ever hand out goes on this list so the destructor can free it, even if
+        // it lost the race to be installed in a table.
+        DecisionCacheEntry* pHead;
+        do
+        {
+            pHead = static_cast<DecisionCacheEntry*>(ReadPointerAcquire(reinterpret_cast<PVOID volatile*>(&m_pAllocatedDecisions)));
+            pEntry->pNextAllocated = pHead;
+        } while (InterlockedCompareExchangePointer(reinterpret_cast<PVOID volatile*>(&m_pAllocatedDecisions), pEntry, pHead) != pHead);
+
+        *result = pEntry;
+        return S_OK;
     }
 
-    int CompareQualifierSetResultDetails(_In_ int setIndexInPool1, _In_ int setIndexInPool2, _In_ const IResolver* pResolver)
+    // The qualifier indexes of one qualifier set.  Read straight from the pool's flat view when it
+    // has one, so comparisons don't build a QualifierSetResult or check an HRESULT per qualifier.
+    class SetQualifierIndexes
+    {
+    public:
+        HRESULT Set(_In_ const IDecisionInfo* pDecisions, _In_opt_ const DecisionInfoFlatView* pFlat, _In_ int setIndexInPool)
+        {
+            if (pFlat != nullptr)
+            {
+                RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_RANGE_NOT_FOUND), !pFlat->IsValidQualifierSetIndex(setIndexInPool));
+
+                m_pFlatIndexes = pFlat->GetQualifierIndexesInSet(setIndexInPool);
+                m_numQualifiers = pFlat->GetNumQualifiersInSet(setIndexInPool);
+                m_bFlat = true;
+                return S_OK;
+            }
+
+            RETURN_IF_FAILED(pDecisions->GetQualifierSet(setIndexInPool, &m_set));
+            m_numQualifiers = m_set.GetNumQualifiers();
+            m_bFlat = false;
+            return S_OK;
+        }
+
+        int GetNumQualifiers() const { return m_numQualifiers; }
+
+        bool TryGetQualifierIndexInPool(_In_ int indexInSet, _Out_ int* pIndexInPoolOut) const
+        {
+            if (m_bFlat)
+            {
+                // The flat view validated every reference when it was built.
+                *pIndexInPoolOut = m_pFlatIndexes[indexInSet];
+                return true;
+            }
+
+            return SUCCEEDED(m_set.GetQualifierIndexInPool(indexInSet, pIndexInPoolOut));
+        }
+
+    protected:
+        QualifierSetResult m_set;
+        const UINT16* m_pFlatIndexes{ nullptr };
+        int m_numQualifiers{ 0 };
+        bool m_bFlat{ false };
+    };
+
+    int CompareQualifierSetResultDetails(
+        _In_ const CacheTable* pTable,
+        _In_ LONG epoch,
+        _In_ int setIndexInPool1,
+        _In_ int setIndexInPool2,
+        _In_ const IResolver* pResolver)
     {
-        QualifierSetResult set1;
-        QualifierSetResult set2;
+        const DecisionInfoFlatView* pFlat = m_pDecisions->GetFlatView();
+        SetQualifierIndexes set1;
+        SetQualifierIndexes set2;
 
-        if (FAILED(m_pDecisions->GetQualifierSet(setIndexInPool1, &set1)) || FAILED(m_pDecisions->GetQualifierSet(setIndexInPool2, &set2)))
+        if (FAILED(set1.Set(m_pDecisions, pFlat, setIndexInPool1)) || FAILED(set2.Set(m_pDecisions, pFlat, setIndexInPool2)))
         {
             return 0;
         }
 
         int q1;
         int q2;
-        _QualifierCacheEntry* pQualifiers = m_qualifierCache.GetAll();
-        _QualifierCacheEntry* pQ1;
-        _QualifierCacheEntry* pQ2;
+        QualifierCacheEntry entry1;
+        QualifierCacheEntry entry2;
+        const QualifierCacheEntry* pQ1 = &entry1;
+        const QualifierCacheEntry* pQ2 = &entry2;
 
         for (int i = 0; i < set1.GetNumQualifiers(); i++)
         {
             // Get the next qualifier from set 1
-            if (FAILED(set1.GetQualifierIndexInPool(i, &q1)) || (q1 < 0) || (q1 > m_qualifierCache.Count() - 1))
+            if (!set1.TryGetQualifierIndexInPool(i, &q1) || !TryLoadQualifierEntry(pTable, epoch, q1, &entry1))
             {
                 // error, can't continue.
                 return 0;
             }
-            pQ1 = &pQualifiers[q1];
 
             // See if set 2 also has a qualifier
             if (i >= set2.GetNumQualifiers())
@@ -886,12 +1185,11 @@ protected:
             }
 
             // Get the qualifier from set 2
-            if (FAILED(set2.GetQualifierIndexInPool(i, &q2)) || (q2 < 0) || (q2 > m_qualifierCache.Count() - 1))
+            if (!set2.TryGetQualifierIndexInPool(i, &q2) || !TryLoadQualifierEntry(pTable, epoch, q2, &entry2))
             {
                 // error, can't continue.
                 return 0;
             }
-            pQ2 = &pQualifiers[q2];
 
             if (pQ2->priority > pQ1->priority)
             {
@@ -971,7 +1269,7 @@ protected:
             }
 
             // Everything matches.  Qualifier type gets to break the tie.
-            int diff = CompareQualiferType(q1, q2, pResolver);
+            int diff = CompareQualiferType(pFlat, q1, q2, pResolver);
             if (diff != 0)
             {
                 return diff;
@@ -981,12 +1279,11 @@ protected:
         if (set2.GetNumQualifiers() > set1.GetNumQualifiers())
         {
             // Set 2 is more specific.  See who wins.
-            if (FAILED(set2.GetQualifierIndexInPool(set1.GetNumQualifiers(), &q2)) || (q2 < 0) || (q2 > m_qualifierCache.Count() - 1))
+            if (!set2.TryGetQualifierIndexInPool(set1.GetNumQualifiers(), &q2) || !TryLoadQualifierEntry(pTable, epoch, q2, &entry2))
             {
                 // error, can't continue.
                 return 0;
             }
-            pQ2 = &pQualifiers[q2];
             return ((pQ2->score > 0) ? -1 : 1);
         }
 
@@ -994,47 +1291,47 @@ protected:
         return 0;
     }
 
-    int CompareQualifierSetResultComplex(_In_ int setIndexInPool1, _In_ int setIndexInPool2, _In_ const IResolver* resolver)
+    int CompareQualifierSetResultComplex(
+        _In_ const CacheTable* pTable,
+        _In_ LONG epoch,
+        _In_ int setIndexInPool1,
+        _In_ int setIndexInPool2,
+        _In_ const IResolver* resolver)
     {
-        QualifierSetResult set1;
-        QualifierSetResult set2;
+        const DecisionInfoFlatView* pFlat = m_pDecisions->GetFlatView();
+        SetQualifierIndexes set1;
+        SetQualifierIndexes set2;
 
-        if (FAILED(m_pDecisions->GetQualifierSet(setIndexInPool1, &set1)) || FAILED(m_pDecisions->GetQualifierSet(setIndexInPool2, &set2)))
+        if (FAILED(set1.Set(m_pDecisions, pFlat, setIndexInPool1)) || FAILED(set2.Set(m_pDecisions, pFlat, setIndexInPool2)))
         {
             return 0;
         }
 
         int q1;
         int q2;
-        _QualifierCacheEntry* pQualifiers = m_qualifierCache.GetAll();
-        _QualifierCacheEntry* pQ1;
-        _QualifierCacheEntry* pQ2;
+        QualifierCacheEntry entry;
 
         QualifierSetComparer comparer1;
         QualifierSetComparer comparer2;
 
         for (int i = 0; i < set1.GetNumQualifiers(); i++)
         {
-            if (FAILED(set1.GetQualifierIndexInPool(i, &q1)) || (q1 < 0) || (q1 > m_qualifierCache.Count() - 1))
+            if (!set1.TryGetQualifierIndexInPool(i, &q1) || !TryLoadQualifierEntry(pTable, epoch, q1, &entry))
             {
                 return 0;
             }
 
-            pQ1 = &pQualifiers[q1];
-
-            comparer1.SetScore(pQ1->priority, pQ1->score, pQ1->fallbackScore);
+            comparer1.SetScore(entry.priority, entry.score, entry.fallbackScore);
         }
 
         for (int i = 0; i < set2.GetNumQualifiers(); i++)
         {
-            if (FAILED(set2.GetQualifierIndexInPool(i, &q2)) || (q2 < 0) || (q2 > m_qualifierCache.Count() - 1))
+            if (!set2.TryGetQualifierIndexInPool(i, &q2) || !TryLoadQualifierEntry(pTable, epoch, q2, &entry))
             {
                 return 0;
             }
 
-            pQ2 = &pQualifiers[q2];
-
-            comparer2.SetScore(pQ2->priority, pQ2->score, pQ2->fallbackScore);
+            comparer2.SetScore(entry.priority, entry.score, entry.fallbackScore);
         }
 
         int diff = comparer1.Compare(&comparer2);
@@ -1047,18 +1344,18 @@ protected:
         for (int i = 0; i < set1.GetNumQualifiers() && i < set2.GetNumQualifiers(); i++)
         {
             // We already checked for range correctness above so no need to do it again.
-            if (FAILED(set1.GetQualifierIndexInPool(i, &q1)))
+            if (!set1.TryGetQualifierIndexInPool(i, &q1))
             {
                 return 0;
             }
 
-            if (FAILED(set2.GetQualifierIndexInPool(i, &q2)))
+            if (!set2.TryGetQualifierIndexInPool(i, &q2))
             {
                 return 0;
             }
 
             // Everything matches. Qualifier type gets to break the tie.
-            diff = CompareQualiferType(q1, q2, resolver);
+            diff = CompareQualiferType(pFlat, q1, q2, resolver);
             if (diff != 0)
             {
                 return diff;
@@ -1069,8 +1366,18 @@ protected:
         return 0;
     }
 
-    int CompareQualiferType(_In_ int qualifier1, _In_ int qualifier2, _In_ const IResolver* resolver)
+    int CompareQualiferType(
+        _In_opt_ const DecisionInfoFlatView* pFlat,
+        _In_ int qualifier1,
+        _In_ int qualifier2,
+        _In_ const IResolver* resolver)
     {
+        if ((pFlat != nullptr) && (pFlat->pQualifiers[qualifier1].attribute.uVal != pFlat->pQualifiers[qualifier2].attribute.uVal))
+        {
+            // Different attributes, so the type can't break the tie.  No need to build the qualifiers.
+            return 0;
+        }
+
         QualifierResult qr1;
         QualifierResult qr2;
         Atom qa1;
@@ -1092,18 +1399,29 @@ protected:
     }
 
 private:
-    SRWLOCK m_srwLock;
+    SRWLOCK m_srwGrowLock;
 };
 
 ResolverBase::ResolverBase(_In_ const UnifiedEnvironment* pEnvironment, _In_ const IDecisionInfo* pDecisions) :
     m_pEnvironment(pEnvironment), m_pDecisions(pDecisions), m_pCache(NULL)
 {
-    ::InitializeSRWLock(&m_srwLock);
-    ::InitializeSRWLock(&m_srwQualifierSetLock);
     ::InitializeSRWLock(&m_srwQualifierLock);
+    ::InitializeSRWLock(&m_srwResetLock);
+    ::InitializeSRWLock(&m_srwFreezeLock);
 }
 
-ResolverBase::~ResolverBase() { delete m_pCache; }
+ResolverBase::~ResolverBase()
+{
+    delete m_pFrozen;
+    while (m_pRetiredFrozen != nullptr)
+    {
+        FrozenDecisions* pNext = m_pRetiredFrozen->GetNextRetired();
+        delete m_pRetiredFrozen;
+        m_pRetiredFrozen = pNext;
+    }
+
+    delete m_pCache;
+}
 
 HRESULT ResolverBase::Init()
 {
@@ -1114,20 +1432,14 @@ HRESULT ResolverBase::Init()
 
 void ResolverBase::Reset()
 {
-    // Frequent reset during evalueDecision can corrupt the cache.
-    // Order is important here, m_srwLock -> m_srwQualifierSetLock -> m_srwQualifierLock.
-    // We consider to have separate scope for respective m_srwLock and m_srwQualifierSetLock in future.
-    AutoReaderWriterLock autoLock(&m_srwLock);
-    {
-        AutoReaderWriterLock autoQualifierSetLock(&m_srwQualifierSetLock); // protect pResults object for potential race condition
-        {
-            AutoReaderWriterLock autoQualifierLock(&m_srwQualifierLock); // protect pResults object for potential race condit
-            {
-                // the cache doesn't do anythnig interesting with per-qualifier reset yet so just reset the whole thing.
-                m_pCache->Reset();
-            }
-        }
-    }
+    // Resetting the cache just advances its epoch, so lookups in flight never see freed memory.
+    // Wait for any qualifier evaluation in progress so it doesn't observe a qualifier value
+    // that is being replaced, and for any decision evaluation that is holding resets off.
+    AutoReaderWriterLock autoResetLock(&m_srwResetLock);
+    AutoReaderWriterLock autoQualifierLock(&m_srwQualifierLock);
+
+    // the cache doesn't do anythnig interesting with per-qualifier reset yet so just reset the whole thing.
+    m_pCache->Reset();
 }
 
 HRESULT ResolverBase::Reset(__in_ecount(numQualifierNames) Atom* pQualifierNames, _In_ int numQualifierNames)
@@ -1135,20 +1447,14 @@ HRESULT ResolverBase::Reset(__in_ecount(numQualifierNames) Atom* pQualifierNames
     RETURN_HR_IF(
         E_INVALIDARG, (pQualifierNames == nullptr) || (numQualifierNames < 1) || (numQualifierNames > m_pDecisions->GetNumQualifiers()));
 
-    // Frequent reset during evalueDecision can corrupt the cache.
-    // Order is important here, m_srwLock -> m_srwQualifierSetLock -> m_srwQualifierLock.
-    // We consider to have separate scope for respective m_srwLock and m_srwQualifierSetLock in future.
-    AutoReaderWriterLock autoLock(&m_srwLock);
-    {
-        AutoReaderWriterLock autoQualifierSetLock(&m_srwQualifierSetLock); // protect pResults object for potential race condition
-        {
-            AutoReaderWriterLock autoQualifierLock(&m_srwQualifierLock); // protect pResults object for potential race condit
-            {
-                // the cache doesn't do anythnig interesting with per-qualifier reset yet so just reset the whole thing.
-                m_pCache->Reset();
-            }
-        }
-    }
+    // Resetting the cache just advances its epoch, so lookups in flight never see freed memory.
+    // Wait for any qualifier evaluation in progress so it doesn't observe a qualifier value
+    // that is being replaced, and for any decision evaluation that is holding resets off.
+    AutoReaderWriterLock autoResetLock(&m_srwResetLock);
+    AutoReaderWriterLock autoQualifierLock(&m_srwQualifierLock);
+
+    // the cache doesn't do anythnig interesting with per-qualifier reset yet so just reset the whole thing.
+    m_pCache->Reset();
 
     return S_OK;
 }
@@ -1173,6 +1479,9 @@ HRESULT ResolverBase::EvaluateQualifier(_In_ const IQualifier* pQualifier, _Out_
         return S_OK;
     }
 
+    // Results computed against an epoch that has since been reset are never published.
+    LONG epoch = m_pCache->GetEpoch();
+
     double score = 0.0;
     double fallbackScore;
     RETURN_IF_FAILED(pQualifier->GetFallbackScore(&fallbackScore));
@@ -1182,7 +1491,7 @@ HRESULT ResolverBase::EvaluateQualifier(_In_ const IQualifier* pQualifier, _Out_
     const IBuildQualifierType* pType = NULL;
     StringResult value;
 
-    // The method can be called by (1) under m_srwLock and m_srwQualifierSetLock exclusive lock, or (2) no lock
+    // Only cache misses get here; cached lookups never take this lock.
     AutoReaderWriterLock autoLock(&m_srwQualifierLock);
 
     HRESULT hr = pQualifier->GetOperand1Attribute(&qualifierName);
@@ -1213,7 +1522,7 @@ HRESULT ResolverBase::EvaluateQualifier(_In_ const IQualifier* pQualifier, _Out_
     // from this function, and still use fallbackScore for evaluation.
     RETURN_IF_FAILED(IQualifier::ToUint16Score(score, pScoreOut));
     RETURN_IF_FAILED(IQualifier::ToUint16Score(fallbackScore, pFallbackScoreOut));
-    RETURN_IF_FAILED(m_pCache->SetQualifierScores(pQualifier, pQualifier->GetPriority(), *pScoreOut, *pFallbackScoreOut));
+    RETURN_IF_FAILED(m_pCache->SetQualifierScores(epoch, pQualifier, pQualifier->GetPriority(), *pScoreOut, *pFallbackScoreOut));
     return hr;
 }
 
@@ -1231,6 +1540,7 @@ HRESULT ResolverBase::EvaluateQualifierSet(
     }
 
     // Nope.  Try to evaluate it.
+    LONG epoch = m_pCache->GetEpoch();
     bool bIsMatch = true;
     bool bIsDefault = true;
     bool bIsMatchOrDefault = true;
@@ -1241,9 +1551,6 @@ HRESULT ResolverBase::EvaluateQualifierSet(
     UINT16 fallbackScore;
     int lastQualifierPriority = 0;
 
-    // The method can be called by (1) under m_srwLock exclusive lock, or (2) no lock
-    AutoReaderWriterLock autoLock(&m_srwQualifierSetLock);
-
     int numQualifiers = pQualifierSet->GetNumQualifiers();
     if (numQualifiers > 0)
     {
@@ -1295,6 +1602,7 @@ HRESULT ResolverBase::EvaluateQualifierSet(
     }
 
     RETURN_IF_FAILED(m_pCache->SetQualifierSetResults(
+        epoch,
         pQualifierSet, bIsMatch, bIsDefault, bIsMatchOrDefault, bMultipleOfSameQualifier, bestActualMatchPriority, bestActualMatchScore));
 
     return S_OK;
@@ -1317,67 +1625,286 @@ HRESULT ResolverBase::EvaluateDecision(
     _Out_writes_(numResults) int* pResultIndexesOut,
     _Out_writes_(numResults) int* pResultSetIndexesOut) const
 {
-    AutoReaderWriterLock autoLock(&m_srwLock); // protect pResults object for potential race condition
-
+    // Cached decisions are read without taking any lock.
     if (SUCCEEDED(m_pCache->GetDecisionResults(pDecision, numResults, pResultIndexesOut, pResultSetIndexesOut)))
     {
         return S_OK;
     }
-    int numSets = 0;
-    DecisionInfoCache::DecisionPerSetInfo* pResults;
-    RETURN_IF_FAILED(m_pCache->BeginSetDecisionResults(pDecision, &pResults, &numSets));
-    DEF_ASSERT(numSets == pDecision->GetNumQualifierSets());
+
+    // If there are no qualifier sets, return with MRM_NO_MATCHING_CANDIDATE
+    int numSets = pDecision->GetNumQualifierSets();
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_NO_MATCH_OR_DEFAULT_CANDIDATE), numSets <= 0);
+
+    DynamicArray<DecisionInfoCache::DecisionPerSetInfo> results;
+    RETURN_IF_FAILED(results.SetExtent(numSets));
+    DecisionInfoCache::DecisionPerSetInfo* pResults = results.GetAll();
 
     QualifierSetResult qualifierSet;
     int indexInPool;
     bool bIsMatch;
     bool bIsFallbackMatch;
     bool bIsMatchOrDefault;
-    const DecisionInfoCache::QualifierSetCacheEntry* pEntry;
 
-    // We'll put matches at the head and non-matches at the tail
-    int nextMatch = 0;
-    int nextFailed = numSets - 1;
-    for (int i = 0; i < numSets; i++)
+    // If the cache is reset while we're evaluating, the results can mix old and new qualifier
+    // values and were sorted against both, so they're thrown away and the decision evaluated
+    // again.  A context that keeps changing could starve us, so after a few attempts we hold
+    // off resets for one last evaluation, which is then guaranteed a stable epoch.
+    static const int c_maxOptimisticAttempts = 4;
+    for (int attempt = 0;; attempt++)
     {
-        if (FAILED(pDecision->GetQualifierSet(i, &qualifierSet, &indexInPool)) ||
-            FAILED(EvaluateQualifierSet(&qualifierSet, &bIsMatch, &bIsFallbackMatch, &bIsMatchOrDefault)) ||
-            FAILED(m_pCache->GetQualifierSetCacheEntry(indexInPool, &pEntry)))
+        bool bHoldingResets = (attempt >= c_maxOptimisticAttempts);
+        if (bHoldingResets)
         {
-            // something went badly wrong.  Count this set as a failure.
-            bIsMatch = bIsFallbackMatch = bIsMatchOrDefault = false;
+            ::AcquireSRWLockShared(&m_srwResetLock);
         }
 
-        // Okay, we now have our qualifier set, our index in the global pool and our cache entry.
-        if (bIsMatch)
+        LONG epoch = m_pCache->GetEpoch();
+
+        // We'll put matches at the head and non-matches at the tail
+        int nextMatch = 0;
+        int nextFailed = numSets - 1;
+        for (int i = 0; i < numSets; i++)
         {
-            pResults[nextMatch].setIndexInDecision = static_cast<UINT16>(i);
-            pResults[nextMatch].setIndexInPool = static_cast<UINT16>(indexInPool);
-            nextMatch++;
+            if (FAILED(pDecision->GetQualifierSet(i, &qualifierSet, &indexInPool)) ||
+                FAILED(EvaluateQualifierSet(&qualifierSet, &bIsMatch, &bIsFallbackMatch, &bIsMatchOrDefault)))
+            {
+                // something went badly wrong.  Count this set as a failure.
+                bIsMatch = bIsFallbackMatch = bIsMatchOrDefault = false;
+            }
+
+            // Okay, we now have our qualifier set and our index in the global pool.
+            if (bIsMatch)
+            {
+                pResults[nextMatch].setIndexInDecision = static_cast<UINT16>(i);
+                pResults[nextMatch].setIndexInPool = static_cast<UINT16>(indexInPool);
+                nextMatch++;
+            }
+            else
+            {
+                pResults[nextFailed].setIndexInDecision = static_cast<UINT16>(i);
+                pResults[nextFailed].setIndexInPool = static_cast<UINT16>(indexInPool);
+                nextFailed--;
+            }
         }
-        else
+
+        // Sort the results so that the matches are prioritized ahead of the fallbacks, ahead of the non-matches
+        DEF_ASSERT(nextFailed + 1 == nextMatch);
+        DecisionInfoCache::_DecisionSortingInfo sortingContextInfo = {m_pCache, this, m_pCache->GetTable(), epoch};
+
+        qsort_s(
+            pResults,
+            numSets,
+            sizeof(*pResults),
+            (int(__cdecl*)(void*, const void*, const void*))DecisionInfoCache::_DecisionSortingHelper,
+            &sortingContextInfo);
+
+        bool bStable = (m_pCache->GetEpoch() == epoch);
+        HRESULT hr = bStable ? m_pCache->SetDecisionResults(epoch, pDecision, pResults, numSets) : S_OK;
+
+        if (bHoldingResets)
+        {
+            ::ReleaseSRWLockShared(&m_srwResetLock);
+        }
+
+        if (bStable)
+        {
+            RETURN_IF_FAILED(hr);
+            break;
+        }
+    }
+
+    numResults = min(numResults, numSets);
+    for (int i = 0; i < numResults; i++)
+    {
+        pResultIndexesOut[i] = pResults[i].setIndexInDecision;
+        pResultSetIndexesOut[i] = pResults[i].setIndexInPool;
+    }
+
+    return S_OK;
+}
+
+HRESULT ResolverBase::BeginFreeze(_Outptr_ FrozenDecisions** result, _Out_ int* pNumDecisionsOut) const
+{
+    *result = nullptr;
+    *pNumDecisionsOut = 0;
+
+    // Capture the epoch first so a reset while we're evaluating keeps the table from being published.
+    LONG epoch = m_pCache->GetEpoch();
+    int numDecisions = m_pDecisions->GetNumDecisions();
+    RETURN_IF_FAILED(FrozenDecisions::CreateInstance(epoch, numDecisions, result));
+
+    *pNumDecisionsOut = numDecisions;
+    return S_OK;
+}
+
+HRESULT ResolverBase::FreezeDecisions(_Inout_ FrozenDecisions* pFrozen, _In_ int firstDecision, _In_ int numDecisions) const
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, pFrozen);
+    RETURN_HR_IF(
+        E_INVALIDARG, (firstDecision < 0) || (numDecisions < 0) || (numDecisions > pFrozen->GetNumDecisions() - firstDecision));
+
+    DecisionResult decision;
+    QualifierSetResult qualifierSet;
+    for (int i = firstDecision; i < firstDecision + numDecisions; i++)
+    {
+        RETURN_IF_FAILED(m_pDecisions->GetDecision(i, &decision));
+
+        int resultIndex;
+        HRESULT hr = EvaluateDecision(&decision, &resultIndex, &qualifierSet);
+        if (hr == HRESULT_FROM_WIN32(ERROR_MRM_NO_MATCH_OR_DEFAULT_CANDIDATE))
         {
-            pResults[nextFailed].setIndexInDecision = static_cast<UINT16>(i);
-            pResults[nextFailed].setIndexInPool = static_cast<UINT16>(indexInPool);
-            nextFailed--;
+            pFrozen->SetResult(i, FrozenDecisions::NoMatch);
+            continue;
         }
+        RETURN_IF_FAILED(hr);
+
+        // Only a match or a default is usable, same as an unfrozen lookup.
+        bool isMatch;
+        bool isDefault;
+        bool isMatchOrDefault;
+        RETURN_IF_FAILED(EvaluateQualifierSet(&qualifierSet, &isMatch, &isDefault, &isMatchOrDefault, nullptr));
+
+        pFrozen->SetResult(i, (isMatch || isDefault) ? resultIndex : FrozenDecisions::NoMatch);
+    }
+
+    return S_OK;
+}
+
+HRESULT ResolverBase::EndFreeze(_In_ FrozenDecisions* pFrozen, _In_ bool publish)
+{
+    AutoDeletePtr<FrozenDecisions> pNewFrozen = pFrozen;
+    if (!publish)
+    {
+        return S_OK;
     }
 
-    // Sort the results so that the matches are prioritized ahead of the fallbacks, ahead of the non-matches
-    DEF_ASSERT(nextFailed + 1 == nextMatch);
-    DecisionInfoCache::_DecisionSortingInfo sortingContextInfo = {m_pCache, this};
+    // The context changed while we were evaluating, so the table is already stale.
+    bool stale = false;
+    {
+        AutoReaderWriterLock autoLock(&m_srwFreezeLock);
 
-    AutoReaderWriterLock autoQualifierSetLock(&m_srwQualifierSetLock);
-    qsort_s(
-        pResults,
-        numSets,
-        sizeof(*pResults),
-        (int(__cdecl*)(void*, const void*, const void*))DecisionInfoCache::_DecisionSortingHelper,
-        &sortingContextInfo);
-    RETURN_IF_FAILED(m_pCache->EndSetDecisionResults(pDecision));
+        stale = (pFrozen->GetEpoch() != m_pCache->GetEpoch());
+        if (!stale)
+        {
+            // Lookups may still be reading the previous table, so retire it rather than freeing it here.
+            FrozenDecisions* pOldFrozen = static_cast<FrozenDecisions*>(
+                InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_pFrozen), pNewFrozen.Detach()));
+            if (pOldFrozen != nullptr)
+            {
+                pOldFrozen->SetNextRetired(m_pRetiredFrozen);
+                m_pRetiredFrozen = pOldFrozen;
+            }
+        }
+    }
 
-    RETURN_IF_FAILED(m_pCache->GetDecisionResults(pDecision, numResults, pResultIndexesOut, pResultSetIndexesOut));
+    // A lookup that finished while we held the lock couldn't free anything, so check again now that
+    // the lock is released.
+    FreeRetiredFrozen();
 
+    RETURN_HR_IF(E_CHANGED_STATE, stale);
+    return S_OK;
+}
+
+bool ResolverBase::IsFrozen() const
+{
+    const FrozenDecisions* pFrozen = AcquireFrozen();
+    bool isFrozen = (pFrozen != nullptr) && (pFrozen->GetEpoch() == m_pCache->GetEpoch());
+    ReleaseFrozen();
+    return isFrozen;
+}
+
+HRESULT ResolverBase::EvaluateFrozenDecision(_In_ const IDecision* pDecision, _Out_ int* pResultIndexOut) const
+{
+    *pResultIndexOut = -1;
+
+    const FrozenDecisions* pFrozen = AcquireFrozen();
+    HRESULT hr = EvaluateFrozenDecision(pFrozen, pDecision, pResultIndexOut);
+    ReleaseFrozen();
+    return hr;
+}
+
+const ResolverBase::FrozenDecisions* ResolverBase::AcquireFrozen() const
+{
+    // Count ourselves before loading the table.  Both are full barriers, as is the exchange in EndFreeze,
+    // so if EndFreeze sees no readers then any reader that comes along later loads the new table.
+    InterlockedIncrement(&m_frozenReaders);
+    return static_cast<const FrozenDecisions*>(ReadPointerAcquire(reinterpret_cast<PVOID const volatile*>(&m_pFrozen)));
+}
+
+void ResolverBase::ReleaseFrozen() const
+{
+    // The last reader out frees any tables that EndFreeze couldn't.
+    if (InterlockedDecrement(&m_frozenReaders) == 0)
+    {
+        FreeRetiredFrozen();
+    }
+}
+
+void ResolverBase::FreeRetiredFrozen() const
+{
+    // Don't wait if someone else holds the lock.  Every holder comes back here after releasing it, so
+    // the last one to leave sees the reader count that was dropped while it held the lock, and no
+    // retired table is left behind once lookups stop.
+    while ((InterlockedCompareExchange(&m_frozenReaders, 0, 0) == 0) &&
+           (ReadPointerAcquire(reinterpret_cast<PVOID const volatile*>(&m_pRetiredFrozen)) != nullptr) &&
+           ::TryAcquireSRWLockExclusive(&m_srwFreezeLock))
+    {
+        FreeRetiredFrozenLocked();
+        ::ReleaseSRWLockExclusive(&m_srwFreezeLock);
+    }
+}
+
+void ResolverBase::FreeRetiredFrozenLocked() const
+{
+    // Every retired table was replaced in m_pFrozen before it was retired, so only a lookup that was
+    // already under way could still be reading one.  If there are none, they can all go.
+    if (InterlockedCompareExchange(&m_frozenReaders, 0, 0) != 0)
+    {
+        return;
+    }
+
+    FrozenDecisions* pRetired = m_pRetiredFrozen;
+    m_pRetiredFrozen = nullptr;
+    while (pRetired != nullptr)
+    {
+        FrozenDecisions* pNext = pRetired->GetNextRetired();
+        delete pRetired;
+        pRetired = pNext;
+    }
+}
+
+HRESULT ResolverBase::EvaluateFrozenDecision(
+    _In_opt_ const FrozenDecisions* pFrozen,
+    _In_ const IDecision* pDecision,
+    _Out_ int* pResultIndexOut) const
+{
+    *pResultIndexOut = -1;
+
+    // Any reset advances the cache epoch, which thaws the table.
+    if ((pFrozen == nullptr) || (pFrozen->GetEpoch() != m_pCache->GetEpoch()))
+    {
+        return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
+    }
+
+    // The table is indexed by our own decision pool.
+    if (pDecision->GetPool() != m_pDecisions)
+    {
+        return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
+    }
+
+    int index = pDecision->GetIndex();
+    if ((index < 0) || (index >= pFrozen->GetNumDecisions()))
+    {
+        return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
+    }
+
+    INT32 result = pFrozen->GetResult(index);
+    if (result == FrozenDecisions::NoMatch)
+    {
+        return HRESULT_FROM_WIN32(ERROR_MRM_NO_MATCH_OR_DEFAULT_CANDIDATE);
+    }
+
+    *pResultIndexOut = result;
     return S_OK;
 }
 
@@ -1465,6 +1992,7 @@ public:
     {
         AutoReaderWriterLock autoLock(&m_srwLock, false);
         m_attemptedValues = m_presentValues = 0;
+        InterlockedIncrement(&m_generation);
     }
 
     void ResetCache(_In_ Atom atom)
@@ -1476,6 +2004,25 @@ public:
 
         m_attemptedValues &= ~maskbit;
         m_presentValues &= ~maskbit;
+        InterlockedIncrement(&m_generation);
+    }
+
+    // Advances every time a qualifier value is set to something new or dropped from the cache.
+    LONG GetGeneration() const { return ReadAcquire(&m_generation); }
+
+    bool HasQualifierValue(_In_ Atom atom, _In_ PCWSTR pValue)
+    {
+        AutoReaderWriterLock autoLock(&m_srwLock, true);
+        DEF_ASSERT((atom.GetPoolIndex() == m_pPool->GetPoolIndex()) && (atom.GetIndex() < m_cacheSize));
+        DEF_ASSERT(atom.GetIndex() < 32); // don't overflow m_ownedProviders
+
+        if ((m_presentValues & (1 << atom.GetIndex())) == 0)
+        {
+            return false;
+        }
+
+        PCWSTR pCurrent = m_pCachedValues[atom.GetIndex()].GetRef();
+        return (pCurrent != nullptr) && (wcscmp(pCurrent, pValue) == 0);
     }
 
     HRESULT GetQualifierValue(_In_ Atom atom, _In_ const IProviderDataSources* pData, _Inout_ StringResult* pRtrn)
@@ -1518,8 +2065,14 @@ public:
         return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
     }
 
+    // Returns S_FALSE, leaving the cache and generation alone, if the qualifier already has this value.
     HRESULT SetQualifierValue(_In_ Atom atom, _In_ PCWSTR pValue, _In_ bool bCopy)
     {
+        if (HasQualifierValue(atom, pValue))
+        {
+            return S_FALSE;
+        }
+
         AutoReaderWriterLock autoLock(&m_srwLock, false);
 
         DEF_ASSERT((atom.GetPoolIndex() == m_pPool->GetPoolIndex()) && (atom.GetIndex() < m_cacheSize));
@@ -1534,6 +2087,7 @@ public:
             RETURN_IF_FAILED(m_pCachedValues[atom.GetIndex()].SetRef(pValue));
         }
         m_presentValues |= (1 << atom.GetIndex());
+        InterlockedIncrement(&m_generation);
         return S_OK;
     }
 
@@ -1547,6 +2101,7 @@ protected:
     __ecount(m_cacheSize) mutable StringResult* m_pCachedValues;
     UINT32 m_attemptedValues;
     UINT32 m_presentValues;
+    volatile LONG m_generation;
     SRWLOCK m_srwLock;
 
     PerQualifierPoolInfo(_In_ const IAtomPool* pPool) :
@@ -1556,7 +2111,8 @@ protected:
         m_cacheSize(pPool->GetNumAtoms()),
         m_pCachedValues(NULL),
         m_attemptedValues(0),
-        m_presentValues(0)
+        m_presentValues(0),
+        m_generation(0)
     {
         ::InitializeSRWLock(&m_srwLock);
     }
@@ -1726,13 +2282,24 @@ HRESULT ProviderResolver::SetQualifier(_In_ PCWSTR pQualifierName, _In_ PCWSTR p
 
 HRESULT ProviderResolver::SetQualifier(_In_ Atom qualifier, _In_ PCWSTR pNewValue)
 {
-    (void)Reset(&qualifier, 1);
+    RETURN_HR_IF_NULL(E_INVALIDARG, pNewValue);
 
-    RETURN_IF_FAILED(m_pQualifiers->SetQualifierValue(qualifier, pNewValue, true));
+    HRESULT hr = m_pQualifiers->SetQualifierValue(qualifier, pNewValue, true);
+    RETURN_IF_FAILED(hr);
+
+    // Setting the value the qualifier already has leaves every cached result valid.  Otherwise
+    // invalidate only after the new value is visible, so that a lookup racing with us can't
+    // cache a result computed from the old value under the new epoch.
+    if (hr == S_OK)
+    {
+        (void)ResolverBase::Reset(&qualifier, 1);
+    }
 
     return S_OK;
 }
 
+LONG ProviderResolver::GetQualifierGeneration() const { return m_pQualifiers->GetGeneration(); }
+
 HRESULT ProviderResolver::GetQualifierProvider(_In_ PCWSTR qualifierName, _Out_ const IQualifierValueProvider** provider) const
 {
     Atom qualifierAtom;
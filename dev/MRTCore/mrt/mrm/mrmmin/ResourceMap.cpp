@@ -1170,12 +1170,20 @@ HRESULT ResourceMapSubtree::MoveToSubtree(_In_ PCWSTR pPath)
 
 int ResourceMapSubtree::GetNumDescendentResources() const
 {
-    if (FAILED(GetOrUpdateDescendents()))
+    if ((m_numDescendentResources >= 0) && (m_currentMinorVersion == m_pSchema->GetMinorVersion()))
+    {
+        return m_numDescendentResources;
+    }
+
+    // Counting doesn't need the index arrays, so leave building them to whoever first asks
+    // for a resource by index.
+    int numResources = 0;
+    if (FAILED(m_pSchema->GetNumDescendents(m_scopeIndex, nullptr, &numResources)))
     {
         return -1;
     }
 
-    return m_numDescendentResources;
+    return numResources;
 }
 
 HRESULT ResourceMapSubtree::GetDescendentResource(_In_ int index, _Inout_ NamedResourceResult* pItemOut) const
@@ -1328,6 +1336,132 @@ bool ResourceMapSubtree::IsValid() const
     return true;
 }
 
+HRESULT
+DescendentResourceEnumerator::CreateInstance(_In_ const ResourceMapSubtree* pSubtree, _Outptr_ DescendentResourceEnumerator** result)
+{
+    *result = nullptr;
+    RETURN_HR_IF_NULL_EXPECTED(E_INVALIDARG, pSubtree);
+
+    AutoDeletePtr<DescendentResourceEnumerator> pRtrn = new DescendentResourceEnumerator();
+    RETURN_IF_NULL_ALLOC(pRtrn);
+
+    pRtrn->m_pSubtree = pSubtree;
+    pRtrn->m_pSchema = pSubtree->GetFullResourceMap()->GetSchema();
+    pRtrn->Reset();
+
+    *result = pRtrn.Detach();
+    return S_OK;
+}
+
+DescendentResourceEnumerator::DescendentResourceEnumerator() {}
+
+DescendentResourceEnumerator::~DescendentResourceEnumerator()
+{
+    if (m_pStack != nullptr)
+    {
+        Def_Free(m_pStack);
+        m_pStack = nullptr;
+    }
+    m_sizeStack = 0;
+    m_depth = 0;
+}
+
+void DescendentResourceEnumerator::Reset()
+{
+    m_depth = 0;
+    m_currentItem = -1;
+    m_started = false;
+    m_minorVersion = m_pSchema->GetMinorVersion();
+}
+
+HRESULT DescendentResourceEnumerator::PushScope(_In_ int scopeIndex)
+{
+    // A scope can appear on the stack at most once.
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE), m_depth >= m_pSchema->GetNumScopes());
+
+    if (m_depth >= m_sizeStack)
+    {
+        int newSize = (m_sizeStack > 0) ? (m_sizeStack * 2) : 8;
+        RETURN_HR_IF(E_OUTOFMEMORY, !_DefArray_TryEnsureSize(&m_pStack, ScopePosition, m_sizeStack, newSize));
+        m_sizeStack = newSize;
+    }
+
+    StringResult strScopeName;
+    int numChildren = 0;
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE), !m_pSchema->TryGetScopeInfo(scopeIndex, &strScopeName, &numChildren));
+
+    m_pStack[m_depth].scopeIndex = scopeIndex;
+    m_pStack[m_depth].numChildren = numChildren;
+    m_pStack[m_depth].nextChild = 0;
+    m_depth++;
+
+    return S_OK;
+}
+
+HRESULT DescendentResourceEnumerator::MoveNext()
+{
+    RETURN_HR_IF(E_CHANGED_STATE, m_minorVersion != m_pSchema->GetMinorVersion());
+
+    if (!m_started)
+    {
+        m_started = true;
+        RETURN_IF_FAILED(PushScope(m_pSubtree->GetSubtreeRootIndex()));
+    }
+
+    m_currentItem = -1;
+
+    // Children are visited in order, descending into each child scope as it comes up, which
+    // is the order in which GetDescendents reports them.
+    while (m_depth > 0)
+    {
+        ScopePosition* pTop = &m_pStack[m_depth - 1];
+        if (pTop->nextChild >= pTop->numChildren)
+        {
+            m_depth--;
+            continue;
+        }
+
+        int childScope = -1;
+        int childItem = -1;
+        RETURN_HR_IF(
+            HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE),
+            !m_pSchema->TryGetScopeChild(pTop->scopeIndex, pTop->nextChild, &childScope, &childItem));
+        pTop->nextChild++;
+
+        if (childItem >= 0)
+        {
+            m_currentItem = childItem;
+            return S_OK;
+        }
+
+        // Child scopes have a higher index than their parent, which is what keeps the walk from
+        // cycling.  A file that breaks that is corrupt.
+        RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_INVALID_PRI_FILE), childScope <= pTop->scopeIndex);
+        RETURN_IF_FAILED(PushScope(childScope));
+    }
+
+    return S_FALSE;
+}
+
+HRESULT DescendentResourceEnumerator::GetCurrentResource(_Inout_ NamedResourceResult* pItemOut) const
+{
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_RANGE_NOT_FOUND), m_currentItem < 0);
+
+    return m_pSubtree->GetFullResourceMap()->GetResourceByIndex(m_currentItem, pItemOut);
+}
+
+HRESULT DescendentResourceEnumerator::GetCurrentResourceName(_Inout_ StringResult* pNameOut) const
+{
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_RANGE_NOT_FOUND), m_currentItem < 0);
+
+    if (m_pSchema->TryGetRelativeItemName(m_pSubtree->GetSubtreeRootIndex(), m_currentItem, pNameOut))
+    {
+        return S_OK;
+    }
+
+    return HRESULT_FROM_WIN32(ERROR_MRM_NAMED_RESOURCE_NOT_FOUND);
+}
+
 HRESULT ResourceMapBase::CreateInstance(
     _In_ const IFileSectionResolver* pSections,
     _In_ const ISchemaCollection* pSchemaCollection,
@@ -89,4 +89,47 @@ ReverseFileMap::GetCandidateInfo(_In_ int reverseMapIndex, _Out_ int* pQualifier
     return S_OK;
 }
 
+HRESULT ReverseFileMap::GetCandidateInfoForPaths(
+    _In_ int numPaths,
+    _In_reads_(numPaths) const PCWSTR* pCandidateValues,
+    _Out_writes_(numPaths) int* pQualifierSetIndexesOut,
+    _Out_writes_(numPaths) int* pNamedResourceIndexesOut,
+    _Out_opt_ int* pNumFoundOut) const
+{
+    if (pNumFoundOut != nullptr)
+    {
+        *pNumFoundOut = 0;
+    }
+
+    RETURN_HR_IF(E_INVALIDARG, numPaths < 0);
+    RETURN_HR_IF(
+        E_INVALIDARG,
+        (numPaths > 0) && ((pCandidateValues == nullptr) || (pQualifierSetIndexesOut == nullptr) || (pNamedResourceIndexesOut == nullptr)));
+
+    // Each lookup goes through the path hash index when the builder emitted one, so the
+    // cost is per path rather than per folder level.
+    int numFound = 0;
+    for (int i = 0; i < numPaths; i++)
+    {
+        pQualifierSetIndexesOut[i] = -1;
+        pNamedResourceIndexesOut[i] = -1;
+
+        int reverseMapIndex;
+        if ((pCandidateValues[i] != nullptr) && TryGetReverseMapCandidateIndex(pCandidateValues[i], &reverseMapIndex) &&
+            (reverseMapIndex >= 0) && (reverseMapIndex < static_cast<int>(m_pHeader->numFiles)))
+        {
+            pQualifierSetIndexesOut[i] = m_pEntries[reverseMapIndex].qualifierSetIndex;
+            pNamedResourceIndexesOut[i] = m_pEntries[reverseMapIndex].namedResourceIndex;
+            numFound++;
+        }
+    }
+
+    if (pNumFoundOut != nullptr)
+    {
+        *pNumFoundOut = numFound;
+    }
+
+    return (numFound == numPaths) ? S_OK : S_FALSE;
+}
+
 } // namespace Microsoft::Resources
@@ -95,25 +95,31 @@ protected:
     RtlProfile() : CoreProfile() {}
 };
 
-// NOTE:  The current implementation of the language list qualifier type is bogus.  It doesn't actually do
-// anything language-tag specific yet.
+// Language tags are compared by the platform's BCP-47 helpers when they're available, and by
+// LanguageMatcher's fixed fallback table otherwise.  Either way, scores are cached per context
+// language list by the matcher, so each asset tag is only compared once per list.
 
-class RtlLanguageListQualifierType : public QualifierTypeBase
+class RtlLanguageListQualifierType : public QualifierTypeBase, public ILanguageTagScorer
 {
 public:
     static HRESULT CreateInstance(_Outptr_ RtlLanguageListQualifierType** type)
     {
         *type = nullptr;
 
-        RtlLanguageListQualifierType* pRtrn = new RtlLanguageListQualifierType();
+        AutoDeletePtr<RtlLanguageListQualifierType> pRtrn = new RtlLanguageListQualifierType();
         RETURN_IF_NULL_ALLOC(pRtrn);
+        RETURN_IF_FAILED(LanguageMatcher::CreateInstance(pRtrn, &pRtrn->m_pMatcher));
 
-        *type = pRtrn;
+        *type = pRtrn.Detach();
 
         return S_OK;
     }
 
-    virtual ~RtlLanguageListQualifierType() {}
+    virtual ~RtlLanguageListQualifierType()
+    {
+        delete m_pMatcher;
+        m_pMatcher = nullptr;
+    }
 
     HRESULT ValidateSingleQualifierValue(_In_ PCWSTR pValue) const override
     {
@@ -127,18 +133,7 @@ public:
 
     double EvaluateSingleQualifierValue(_In_ PCWSTR valueOnAsset, _In_ PCWSTR valueFromProvider) const override
     {
-        double result = 0.0;
-
-        // Same value -> 1
-        // Same value, but the provider value is a neutral -> 0.5, as we want to score a full match higher than a neutral.
-        // Different value -> 0
-        // This is not a full BCP47 distance match implementation, and will not match say en-GB and en-US.
-        if (DefString_ICompare(valueOnAsset, valueFromProvider) == Def_Equal)
-        {
-            result = wcslen(valueOnAsset) > 3 ? 1.0 : 0.5;
-        }
-
-        return result;
+        return LanguageMatcher::GetFallbackScore(valueOnAsset, valueFromProvider);
     }
 
     HRESULT Evaluate(_In_ const IQualifier* pQualifier, _In_ PCWSTR pszProviderValue, _Out_ double* score) const override
@@ -147,16 +142,14 @@ public:
 
         if (wcslen(pszProviderValue) > 0)
         {
+            ICondition::ConditionOperator op;
             StringResult qualifierValue;
-            RETURN_IF_FAILED(ValidateQualifier(pQualifier));
+            RETURN_IF_FAILED(pQualifier->GetOperator(&op));
+            RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_MRM_INVALID_QUALIFIER_OPERATOR), op != ICondition::MatchOp);
             RETURN_IF_FAILED(pQualifier->GetOperand2Literal(&qualifierValue));
 
-            (void)_DefGetDistanceOfClosestLanguageInList(qualifierValue.GetRef(), pszProviderValue, L';', score);
-            if (*score < 0.0)
-            {
-                // Not evaluated by previous function. Use base method.
-                RETURN_IF_FAILED(QualifierTypeBase::Evaluate(pQualifier, pszProviderValue, score));
-            }
+            // The matcher validates each tag once and caches its score for this list of languages.
+            RETURN_IF_FAILED(m_pMatcher->Evaluate(qualifierValue.GetRef(), pszProviderValue, score));
         }
 
         return S_OK;
@@ -164,8 +157,25 @@ public:
 
     int GetMaxQualifierEntries() const override { return 256; }
 
+    // ILanguageTagScorer
+    HRESULT ValidateLanguageTag(_In_ PCWSTR tag) const override { return ValidateQualifierValue(tag); }
+
+    HRESULT ScoreLanguageTag(_In_ PCWSTR tag, _In_ PCWSTR contextLanguages, _Out_ double* score) const override
+    {
+        (void)_DefGetDistanceOfClosestLanguageInList(tag, contextLanguages, L';', score);
+        if (*score < 0.0)
+        {
+            // Not evaluated by previous function. Use base method.
+            RETURN_IF_FAILED(EvaluateValue(tag, contextLanguages, score));
+        }
+
+        return S_OK;
+    }
+
 protected:
-    RtlLanguageListQualifierType() : QualifierTypeBase(ListValuesAllowed | EmptyValuesNotAllowed) {}
+    RtlLanguageListQualifierType() : QualifierTypeBase(ListValuesAllowed | EmptyValuesNotAllowed), m_pMatcher(nullptr) {}
+
+    LanguageMatcher* m_pMatcher;
 };
 
 HRESULT
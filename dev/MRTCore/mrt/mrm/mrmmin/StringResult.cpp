@@ -8,11 +8,35 @@
 namespace Microsoft::Resources
 {
 
+_Use_decl_annotations_ StringResultArena::StringResultArena(PWSTR buffer, size_t bufferSizeInChars)
+{
+    m_arena.pArena = buffer;
+    m_arena.cchArena = (buffer != nullptr) ? static_cast<UINT32>(min(bufferSizeInChars, static_cast<size_t>(DEFRESULT_MAX))) : 0;
+    m_arena.cchUsed = 0;
+}
+
 // Constructors
 StringResult::StringResult()
 {
     DefStringResult_InitBuf(&m_string, NULL);
     m_pString = &m_string;
+    AttachStorage(nullptr);
+}
+
+_Use_decl_annotations_ StringResult::StringResult(StringResultArena* arena)
+{
+    DefStringResult_InitBuf(&m_string, NULL);
+    m_pString = &m_string;
+    AttachStorage(arena);
+}
+
+_Use_decl_annotations_ void StringResult::AttachStorage(StringResultArena* arena)
+{
+    m_storage.pInlineBuf = m_inlineBuffer;
+    m_storage.cchInlineBuf = InlineBufferSizeInChars;
+    m_storage.pArena = (arena != nullptr) ? arena->GetArena() : nullptr;
+    m_storage.numHeapAllocations = 0;
+    m_string.pStorage = &m_storage;
 }
 
 _Use_decl_annotations_ HRESULT StringResult::CreateInstance(PCWSTR pStr, DEFRESULTTYPE type, StringResult** result)
@@ -73,13 +97,13 @@ _Use_decl_annotations_ HRESULT StringResult::CreateInstance(DEFSTRINGRESULT* pSt
 _Use_decl_annotations_ HRESULT StringResult::Init(PCWSTR pStr, DEFRESULTTYPE type)
 {
     m_pString = &m_string;
-    return DefStringResult_Init(&m_string, pStr, type);
+    return _DefStringResult_Init(&m_string, pStr, type);
 }
 
 _Use_decl_annotations_ HRESULT StringResult::Init(PCWSTR pStr)
 {
     m_pString = &m_string;
-    return DefStringResult_InitRef(&m_string, pStr);
+    return _DefStringResult_InitRef(&m_string, pStr);
 }
 
 // Deep Copy
@@ -116,6 +140,12 @@ _Use_decl_annotations_ HRESULT StringResult::SetContentsFromOther(StringResult*
         RETURN_IF_FAILED(SetRef(pOther->GetRef()));
         RETURN_IF_FAILED(pOther->SetRef(NULL));
     }
+    else if ((pOther->GetType() == DEFRESULTTYPE::DefResultType_Buffer) && (pOther->m_string.pBuf == pOther->m_inlineBuffer))
+    {
+        // An inline buffer can't be handed over, and copying it is cheaper than releasing it to the heap.
+        RETURN_IF_FAILED(SetCopy(pOther->GetRef()));
+        RETURN_IF_FAILED(pOther->SetRef(NULL));
+    }
     else if (pOther->GetType() == DEFRESULTTYPE::DefResultType_Buffer)
     {
         // pOther has an internal buffer.
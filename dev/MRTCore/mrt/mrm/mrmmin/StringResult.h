@@ -15,6 +15,14 @@ HRESULT DefStringResult_InitRef(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR
 
 HRESULT DefStringResult_InitBuf(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pInitStr);
 
+// The DefStringResult_Init* functions start over with no storage.  These keep pSelf->pStorage,
+// for owners that attach storage once and then re-initialize the result.
+HRESULT _DefStringResult_Init(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pStr, _In_ DEFRESULTTYPE type);
+
+HRESULT _DefStringResult_InitRef(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pStr);
+
+HRESULT _DefStringResult_InitBuf(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pInitStr);
+
 // Returns a read-only ref to the result's contents.
 HRESULT DefStringResult_GetRef(_In_ const DEFSTRINGRESULT* pSelf, _Out_ PCWSTR* ref);
 
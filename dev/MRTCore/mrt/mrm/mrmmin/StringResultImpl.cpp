@@ -106,6 +106,102 @@ DefStringResult_Init(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pStr, _In_
     return E_INVALIDARG;
 }
 
+HRESULT
+_DefStringResult_Init(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pStr, _In_ DEFRESULTTYPE type)
+{
+    if (type == DefResultType_Reference)
+    {
+        return _DefStringResult_InitRef(pSelf, pStr);
+    }
+
+    if (type == DefResultType_Buffer)
+    {
+        return _DefStringResult_InitBuf(pSelf, pStr);
+    }
+
+    return E_INVALIDARG;
+}
+
+// Buffers from the inline buffer or the arena belong to the storage, not to the result, and must never be freed.
+static bool _DefStringResult_IsBorrowedBuffer(_In_ const DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pBuf)
+{
+    const DEFSTRINGSTORAGE* pStorage = pSelf->pStorage;
+    if ((pBuf == nullptr) || (pStorage == nullptr))
+    {
+        return false;
+    }
+
+    if (pBuf == pStorage->pInlineBuf)
+    {
+        return true;
+    }
+
+    const DEFSTRINGARENA* pArena = pStorage->pArena;
+    return (pArena != nullptr) && (pBuf >= pArena->pArena) && (pBuf < pArena->pArena + pArena->cchArena);
+}
+
+// The inline buffer is handed out at the size asked for, just like a heap buffer, so cchBuf
+// stays meaningful.  It can grow up to its full size without moving.
+static size_t _DefStringResult_GetCapacity(_In_ const DEFSTRINGRESULT* pSelf)
+{
+    if ((pSelf->pStorage != nullptr) && (pSelf->pBuf != nullptr) && (pSelf->pBuf == pSelf->pStorage->pInlineBuf))
+    {
+        return pSelf->pStorage->cchInlineBuf;
+    }
+
+    return pSelf->cchBuf;
+}
+
+static void _DefStringResult_GrowInPlace(_Inout_ DEFSTRINGRESULT* pSelf, _In_ size_t cchMinBufferSize)
+{
+    if (pSelf->cchBuf < cchMinBufferSize)
+    {
+        ZeroMemory(pSelf->pBuf + pSelf->cchBuf, (cchMinBufferSize - pSelf->cchBuf) * sizeof(WCHAR));
+        pSelf->cchBuf = (UINT32)cchMinBufferSize;
+    }
+}
+
+// Returns a zeroed buffer of cchBuf characters from the inline buffer if it fits and isn't
+// already in use, then from the arena, and otherwise from the heap.
+static PWSTR _DefStringResult_AllocBuffer(_Inout_ DEFSTRINGRESULT* pSelf, _In_ size_t cchBuf)
+{
+    DEFSTRINGSTORAGE* pStorage = pSelf->pStorage;
+    if (pStorage == nullptr)
+    {
+        return _DefArray_AllocZeroed(WCHAR, cchBuf);
+    }
+
+    if ((pStorage->pInlineBuf != nullptr) && (cchBuf <= pStorage->cchInlineBuf) && (pSelf->pBuf != pStorage->pInlineBuf))
+    {
+        ZeroMemory(pStorage->pInlineBuf, cchBuf * sizeof(WCHAR));
+        return pStorage->pInlineBuf;
+    }
+
+    DEFSTRINGARENA* pArena = pStorage->pArena;
+    if ((pArena != nullptr) && (cchBuf <= pArena->cchArena - pArena->cchUsed))
+    {
+        PWSTR pNewBuf = pArena->pArena + pArena->cchUsed;
+        pArena->cchUsed += (UINT32)cchBuf;
+        ZeroMemory(pNewBuf, cchBuf * sizeof(WCHAR));
+        return pNewBuf;
+    }
+
+    PWSTR pNewBuf = _DefArray_AllocZeroed(WCHAR, cchBuf);
+    if (pNewBuf != nullptr)
+    {
+        pStorage->numHeapAllocations++;
+    }
+    return pNewBuf;
+}
+
+static void _DefStringResult_FreeBuffer(_In_ const DEFSTRINGRESULT* pSelf, _In_opt_ PWSTR pBuf)
+{
+    if ((pBuf != nullptr) && !_DefStringResult_IsBorrowedBuffer(pSelf, pBuf))
+    {
+        _DefFree(pBuf);
+    }
+}
+
 static HRESULT _DefStringResult_EnsureEmptyBuffer(_Inout_ DEFSTRINGRESULT* pSelf, _In_ size_t cchMinBufferSize)
 {
     PWCHAR pNewBuf = nullptr;
@@ -123,10 +219,11 @@ static HRESULT _DefStringResult_EnsureEmptyBuffer(_Inout_ DEFSTRINGRESULT* pSelf
 
     if (pSelf->pBuf != nullptr)
     {
-        if (pSelf->cchBuf >= cchMinBufferSize)
+        if (_DefStringResult_GetCapacity(pSelf) >= cchMinBufferSize)
         {
             // Current buffer is big enough.  Truncate
             // it and use it.
+            _DefStringResult_GrowInPlace(pSelf, cchMinBufferSize);
             pSelf->pBuf[0] = L'\0';
             pSelf->pRef = pSelf->pBuf;
             return S_OK;
@@ -134,7 +231,7 @@ static HRESULT _DefStringResult_EnsureEmptyBuffer(_Inout_ DEFSTRINGRESULT* pSelf
         pOldBuf = pSelf->pBuf;
     }
 
-    pNewBuf = _DefArray_AllocZeroed(WCHAR, cchMinBufferSize);
+    pNewBuf = _DefStringResult_AllocBuffer(pSelf, cchMinBufferSize);
     if (pNewBuf == nullptr)
     {
         return E_OUTOFMEMORY;
@@ -147,7 +244,7 @@ static HRESULT _DefStringResult_EnsureEmptyBuffer(_Inout_ DEFSTRINGRESULT* pSelf
     pSelf->pRef = pSelf->pBuf;
     if (pOldBuf)
     {
-        Def_Free(pOldBuf);
+        _DefStringResult_FreeBuffer(pSelf, pOldBuf);
     }
 #pragma prefast(suppress : 26045, "_DefArray_AllocZeroed ensures len(pNewBuf) == cchMinBufferSize")
     return S_OK;
@@ -187,9 +284,10 @@ static HRESULT _DefStringResult_EnsureBuffer(_Inout_ DEFSTRINGRESULT* pSelf, _In
 
     // If we have no buffer or if our existing buffer is too small,
     // allocate a new one.
-    if (pSelf->pBuf && (pSelf->cchBuf >= cchMinBufferSize))
+    if (pSelf->pBuf && (_DefStringResult_GetCapacity(pSelf) >= cchMinBufferSize))
     {
         // current buffer is big enough.  We're good to go.
+        _DefStringResult_GrowInPlace(pSelf, cchMinBufferSize);
         // Check whether reference is different than the buffer
         if (pSelf->pRef != pSelf->pBuf)
         {
@@ -210,7 +308,7 @@ static HRESULT _DefStringResult_EnsureBuffer(_Inout_ DEFSTRINGRESULT* pSelf, _In
         return S_OK;
     }
 
-    pNewBuf = _DefArray_AllocZeroed(WCHAR, cchMinBufferSize);
+    pNewBuf = _DefStringResult_AllocBuffer(pSelf, cchMinBufferSize);
     if (pNewBuf == nullptr)
     {
         return E_OUTOFMEMORY;
@@ -224,7 +322,7 @@ static HRESULT _DefStringResult_EnsureBuffer(_Inout_ DEFSTRINGRESULT* pSelf, _In
         hr = _DefStringCchCopy(pNewBuf, cchMinBufferSize, pSelf->pRef);
         if (FAILED(hr))
         {
-            Def_Free(pNewBuf);
+            _DefStringResult_FreeBuffer(pSelf, pNewBuf);
             return hr;
         }
     }
@@ -235,7 +333,7 @@ static HRESULT _DefStringResult_EnsureBuffer(_Inout_ DEFSTRINGRESULT* pSelf, _In
 
     if (pOldBuf)
     {
-        Def_Free(pOldBuf);
+        _DefStringResult_FreeBuffer(pSelf, pOldBuf);
     }
 #pragma prefast(suppress : 26045, "_DefArray_AllocZeroed ensures len(pNewBuf) == cchMinBufferSize")
     return S_OK;
@@ -251,17 +349,17 @@ static HRESULT _DefStringResult_InitEmpty(_Inout_ DEFSTRINGRESULT* pSelf, _In_ s
     }
 
     pSelf->pRef = nullptr;
+    pSelf->pBuf = nullptr;
+    pSelf->cchBuf = 0;
 
     // Empty
     if (cchBuf == 0)
     {
-        pSelf->pBuf = nullptr;
-        pSelf->cchBuf = 0;
         return S_OK;
     }
 
     // Not Empty
-    pTempStr = _DefArray_AllocZeroed(wchar_t, cchBuf);
+    pTempStr = _DefStringResult_AllocBuffer(pSelf, cchBuf);
     if (pTempStr == nullptr)
     {
         return E_OUTOFMEMORY;
@@ -283,6 +381,18 @@ DefStringResult_InitRef(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pStr)
         return E_INVALIDARG;
     }
 
+    pSelf->pStorage = nullptr;
+    return _DefStringResult_InitRef(pSelf, pStr);
+}
+
+HRESULT
+_DefStringResult_InitRef(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pStr)
+{
+    if (pSelf == nullptr)
+    {
+        return E_INVALIDARG;
+    }
+
     HRESULT hr = _DefStringResult_InitEmpty(pSelf, 0);
     if (FAILED(hr))
     {
@@ -301,6 +411,18 @@ DefStringResult_InitBuf(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pInitStr
         return E_INVALIDARG;
     }
 
+    pSelf->pStorage = nullptr;
+    return _DefStringResult_InitBuf(pSelf, pInitStr);
+}
+
+HRESULT
+_DefStringResult_InitBuf(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pInitStr)
+{
+    if (pSelf == nullptr)
+    {
+        return E_INVALIDARG;
+    }
+
     if (pInitStr == nullptr)
     {
         _DefStringResult_InitEmpty(pSelf, 0);
@@ -323,7 +445,8 @@ DefStringResult_InitBuf(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pInitStr
         else
         {
             // Alloc new buffer
-            PWSTR pNewBuf = _DefArray_AllocZeroed(wchar_t, cchInitStr);
+            _DefStringResult_InitEmpty(pSelf, 0); // will not fail
+            PWSTR pNewBuf = _DefStringResult_AllocBuffer(pSelf, cchInitStr);
             if (pNewBuf == nullptr)
             {
                 return E_OUTOFMEMORY;
@@ -332,7 +455,7 @@ DefStringResult_InitBuf(_Inout_ DEFSTRINGRESULT* pSelf, _In_opt_ PCWSTR pInitStr
             hr = _DefStringCchCopy(pNewBuf, cchInitStr, pInitStr);
             if (FAILED(hr))
             {
-                _DefFree(pNewBuf);
+                _DefStringResult_FreeBuffer(pSelf, pNewBuf);
                 return hr;
             }
 
@@ -692,7 +815,23 @@ DefStringResult_ReleaseContents(
         return E_INVALIDARG;
     }
 
-    *ppBufferOut = pSelf->pBuf;
+    if (_DefStringResult_IsBorrowedBuffer(pSelf, pSelf->pBuf))
+    {
+        // The caller frees what we hand back, so it has to come from the heap.
+        PWSTR pHeapBuf = _DefArray_AllocZeroed(WCHAR, pSelf->cchBuf);
+        if (pHeapBuf == nullptr)
+        {
+            return E_OUTOFMEMORY;
+        }
+        memcpy(pHeapBuf, pSelf->pBuf, pSelf->cchBuf * sizeof(WCHAR));
+        pSelf->pStorage->numHeapAllocations++;
+
+        *ppBufferOut = pHeapBuf;
+    }
+    else
+    {
+        *ppBufferOut = pSelf->pBuf;
+    }
     *pcchBufferOut = pSelf->cchBuf;
 
     return _DefStringResult_InitEmpty(pSelf, 0);
@@ -740,6 +879,12 @@ _DefStringResult_Swap(_Inout_ DEFSTRINGRESULT* pSelf, _Inout_ DEFSTRINGRESULT* p
         return S_OK;
     }
 
+    // An inline buffer can't change hands.
+    if ((pSelf->pStorage != nullptr) || (pOther->pStorage != nullptr))
+    {
+        return E_INVALIDARG;
+    }
+
     DEFSTRINGRESULT temp;
 
     temp.cchBuf = pSelf->cchBuf;
@@ -976,7 +1121,7 @@ DefStringResult_Clear(_Inout_ DEFSTRINGRESULT* pSelf, _In_ __BOOL releaseBuffer)
     pSelf->pRef = nullptr;
     if (pSelf->pBuf && releaseBuffer)
     {
-        _DefFree(pSelf->pBuf);
+        _DefStringResult_FreeBuffer(pSelf, pSelf->pBuf);
         pSelf->pBuf = nullptr;
         pSelf->cchBuf = 0;
     }
@@ -4,6 +4,7 @@
 #include <pch.h>
 
 #include "catalog.h"
+#include "catalogindex.h"
 #include "Microsoft.Utf8.h"
 #include "TypeResolution.h"
 
@@ -13,6 +14,9 @@
 
 #include <wrl.h>
 
+#include <atomic>
+#include <vector>
+
 #include <../DynamicDependency/API/MddWinRT.h>
 
 using namespace std;
@@ -25,60 +29,121 @@ extern "C"
     typedef HRESULT(__stdcall* activation_factory_type)(HSTRING, IActivationFactory**);
 }
 
+static HRESULT CallActivationFactory(activation_factory_type get_activation_factory, HSTRING className, REFIID iid, void** factory)
+{
+    IActivationFactory* ifactory = nullptr;
+    HRESULT hr = get_activation_factory(className, &ifactory);
+    // optimize for IActivationFactory?
+    if (SUCCEEDED(hr))
+    {
+        hr = ifactory->QueryInterface(iid, factory);
+        ifactory->Release();
+    }
+    return hr;
+}
+
 // Intentionally no class factory cache here. That would be excessive since
 // other layers already cache.
 struct component
 {
     wstring module_name;
     wstring xmlns;
-    HMODULE handle = nullptr;
-    activation_factory_type get_activation_factory{};
+    atomic<HMODULE> handle{};
+    atomic<activation_factory_type> get_activation_factory{};
     ABI::Windows::Foundation::ThreadingType threading_model{ ABI::Windows::Foundation::ThreadingType::ThreadingType_BOTH };
 
     ~component()
     {
-        if (handle)
+        if (const auto module{ handle.load() })
         {
-            FreeLibrary(handle);
+            FreeLibrary(module);
         }
     }
 
+    // No lock is held across LoadLibrary, so first activations of different classes don't wait
+    // on each other or on the loader lock. Threads racing to load the same module each load it;
+    // the first to publish keeps its reference and the others drop theirs.
     HRESULT LoadModule()
     {
-        if (handle == nullptr)
+        if (get_activation_factory.load(memory_order_acquire) != nullptr)
         {
-            handle = LoadLibraryExW(module_name.c_str(), nullptr, LOAD_WITH_ALTERED_SEARCH_PATH);
-            if (handle == nullptr)
-            {
-                return HRESULT_FROM_WIN32(GetLastError());
-            }
-            this->get_activation_factory = (activation_factory_type)GetProcAddress(handle, "DllGetActivationFactory");
-            if (this->get_activation_factory == nullptr)
-            {
-                return HRESULT_FROM_WIN32(GetLastError());
-            }
+            return S_OK;
+        }
+
+        wil::unique_hmodule module{ LoadLibraryExW(module_name.c_str(), nullptr, LOAD_WITH_ALTERED_SEARCH_PATH) };
+        if (!module)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+        const auto loaded{ reinterpret_cast<activation_factory_type>(GetProcAddress(module.get(), "DllGetActivationFactory")) };
+        if (loaded == nullptr)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
         }
-        return (handle != nullptr && this->get_activation_factory != nullptr) ? S_OK : E_FAIL;
+
+        HMODULE expected{};
+        if (handle.compare_exchange_strong(expected, module.get(), memory_order_acq_rel))
+        {
+            module.release();
+        }
+        get_activation_factory.store(loaded, memory_order_release);
+        return S_OK;
     }
 
     HRESULT GetActivationFactory(HSTRING className, REFIID  iid, void** factory)
     {
         RETURN_IF_FAILED(LoadModule());
-
-        IActivationFactory* ifactory = nullptr;
-        HRESULT hr = this->get_activation_factory(className, &ifactory);
-        // optimize for IActivationFactory?
-        if (SUCCEEDED(hr))
-        {
-            hr = ifactory->QueryInterface(iid, factory);
-            ifactory->Release();
-        }
-        return hr;
+        return CallActivationFactory(get_activation_factory.load(memory_order_acquire), className, iid, factory);
     }
 };
 
 static unordered_map<wstring, shared_ptr<component>> g_types;
 
+// Perfect-hash index over g_types, built once after the manifests are parsed (g_types doesn't
+// change after that) so activation can find its class without turning the HSTRING into a wstring.
+struct catalog_value
+{
+    ABI::Windows::Foundation::ThreadingType threading_model{ ABI::Windows::Foundation::ThreadingType::ThreadingType_BOTH };
+    component* owner{};
+};
+
+using catalog_index = UndockedRegFreeWinRT::CatalogIndex<catalog_value>;
+
+static unique_ptr<catalog_index> g_catalogIndexStorage;
+static atomic<const catalog_index*> g_catalogIndex{};
+
+static const catalog_index::Entry* FindCatalogEntry(const catalog_index* index, HSTRING activatableClassId)
+{
+    UINT32 length{};
+    PCWSTR name{ WindowsGetStringRawBuffer(activatableClassId, &length) };
+    return index->Find(name, length);
+}
+
+HRESULT WinRTBuildCatalogIndex() try
+{
+    if ((g_catalogIndex.load(memory_order_acquire) != nullptr) || g_types.empty())
+    {
+        return S_OK;
+    }
+
+    vector<catalog_index::Key> keys;
+    keys.reserve(g_types.size());
+    for (const auto& [name, owner] : g_types)
+    {
+        const auto nameLength{ static_cast<UINT32>(name.size()) };
+        keys.push_back({ name.c_str(), nameLength, UndockedRegFreeWinRT::CatalogHash(name.c_str(), nameLength), { owner->threading_model, owner.get() } });
+    }
+
+    // Leave the index unbuilt and the lookups on g_types if the names can't be separated.
+    auto index{ catalog_index::Build(keys) };
+    RETURN_HR_IF_NULL(E_UNEXPECTED, index);
+
+    g_catalogIndexStorage = std::move(index);
+    g_catalogIndex.store(g_catalogIndexStorage.get(), memory_order_release);
+    return S_OK;
+}
+CATCH_RETURN();
+
 HRESULT LoadManifestFromPath(std::wstring path)
 {
     if (path.size() < 4)
@@ -363,6 +428,14 @@ HRESULT WinRTGetThreadingModel_PackageGraph(HSTRING activatableClassId, ABI::Win
 
 HRESULT WinRTGetThreadingModel_SxS(HSTRING activatableClassId, ABI::Windows::Foundation::ThreadingType* threading_model)
 {
+    if (const auto index{ g_catalogIndex.load(memory_order_acquire) })
+    {
+        const auto entry{ FindCatalogEntry(index, activatableClassId) };
+        RETURN_HR_IF_EXPECTED(REGDB_E_CLASSNOTREG, entry == nullptr);
+        *threading_model = entry->value.threading_model;
+        return S_OK;
+    }
+
     auto raw_class_name = WindowsGetStringRawBuffer(activatableClassId, nullptr);
     auto component_iter = g_types.find(raw_class_name);
     if (component_iter != g_types.end())
@@ -401,6 +474,13 @@ HRESULT WinRTGetActivationFactory_SxS(
     REFIID iid,
     void** factory)
 {
+    if (const auto index{ g_catalogIndex.load(memory_order_acquire) })
+    {
+        const auto entry{ FindCatalogEntry(index, activatableClassId) };
+        RETURN_HR_IF_EXPECTED(REGDB_E_CLASSNOTREG, entry == nullptr);
+        return entry->value.owner->GetActivationFactory(activatableClassId, iid, factory);
+    }
+
     auto raw_class_name = WindowsGetStringRawBuffer(activatableClassId, nullptr);
     auto component_iter = g_types.find(raw_class_name);
     if (component_iter != g_types.end())
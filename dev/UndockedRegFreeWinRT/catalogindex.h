@@ -0,0 +1,180 @@
+﻿// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+#include <wchar.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace UndockedRegFreeWinRT
+{
+    // FNV-1a over the UTF-16 code units, so a lookup can hash an HSTRING's raw buffer in place.
+    inline uint64_t CatalogHash(const wchar_t* name, uint32_t length)
+    {
+        uint64_t hash{ 14695981039346656037ull };
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            hash ^= static_cast<uint16_t>(name[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Read-only index over the activatable class names, built once after the manifests are parsed.
+    // Names are placed with a hash-and-displace perfect hash: the hash picks a bucket and the
+    // bucket's displacement sends each of its names to its own slot, so a lookup is one pass over
+    // the name, two array reads and one compare. Names are compared by length and code units, so
+    // embedded NULs are part of the name. The index points into the caller's name strings.
+    template <typename Value>
+    struct CatalogIndex
+    {
+        struct Key
+        {
+            const wchar_t* name;
+            uint32_t name_length;
+            uint64_t hash;
+            Value value;
+        };
+
+        struct Entry
+        {
+            const wchar_t* name{};
+            uint32_t name_length{};
+            Value value{};
+        };
+
+        // Returns null if the names can't be separated, which only happens when their full hashes
+        // collide; callers then keep looking names up the slow way.
+        static std::unique_ptr<CatalogIndex> Build(std::vector<Key> const& keys);
+
+        const Entry* Find(const wchar_t* name, uint32_t length) const
+        {
+            const uint64_t hash{ CatalogHash(name, length) };
+            const uint32_t displacement{ displacements[Bucket(hash, bucket_count)] };
+            const Entry& entry{ slots[Slot(hash, displacement, slot_count)] };
+            if ((entry.name == nullptr) || (entry.name_length != length) || (wmemcmp(entry.name, name, length) != 0))
+            {
+                return nullptr;
+            }
+            return &entry;
+        }
+
+        uint32_t bucket_count{};
+        uint32_t slot_count{};
+        std::unique_ptr<uint32_t[]> displacements;
+        std::unique_ptr<Entry[]> slots;
+
+    private:
+        static uint32_t Bucket(uint64_t hash, uint32_t bucketCount)
+        {
+            return static_cast<uint32_t>((hash >> 32) % bucketCount);
+        }
+
+        static uint32_t Slot(uint64_t hash, uint32_t displacement, uint32_t slotCount)
+        {
+            uint64_t mixed{ hash ^ (displacement * 0x9E3779B97F4A7C15ull) };
+            mixed ^= mixed >> 33;
+            mixed *= 0xFF51AFD7ED558CCDull;
+            mixed ^= mixed >> 33;
+            return static_cast<uint32_t>(mixed % slotCount);
+        }
+    };
+
+    template <typename Value>
+    std::unique_ptr<CatalogIndex<Value>> CatalogIndex<Value>::Build(std::vector<Key> const& keys)
+    {
+        const auto count{ static_cast<uint32_t>(keys.size()) };
+        if (count == 0)
+        {
+            return nullptr;
+        }
+
+        // About four names per bucket. Placing the largest buckets first, while the table is still
+        // mostly empty, keeps the displacement search short.
+        const uint32_t bucketCount{ (count + 3) / 4 };
+        std::vector<std::vector<uint32_t>> buckets(bucketCount);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            buckets[Bucket(keys[i].hash, bucketCount)].push_back(i);
+        }
+        std::vector<uint32_t> bucketOrder(bucketCount);
+        std::iota(bucketOrder.begin(), bucketOrder.end(), 0);
+        std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&](uint32_t left, uint32_t right)
+            {
+                return buckets[left].size() > buckets[right].size();
+            });
+
+        const uint32_t c_maxDisplacement{ 0x10000 };
+        for (uint32_t slotCount = count + (count / 4) + 1; slotCount <= (count * 16) + 64; slotCount *= 2)
+        {
+            auto displacements{ std::make_unique<uint32_t[]>(bucketCount) };
+            std::vector<bool> slotUsed(slotCount);
+            std::vector<uint32_t> bucketSlots;
+            bool placedAll{ true };
+            for (const auto bucketIndex : bucketOrder)
+            {
+                const auto& bucket{ buckets[bucketIndex] };
+                if (bucket.empty())
+                {
+                    break;
+                }
+
+                bool placed{};
+                for (uint32_t displacement = 0; (displacement < c_maxDisplacement) && !placed; ++displacement)
+                {
+                    bucketSlots.clear();
+                    placed = true;
+                    for (const auto keyIndex : bucket)
+                    {
+                        const uint32_t slot{ Slot(keys[keyIndex].hash, displacement, slotCount) };
+                        if (slotUsed[slot] || (std::find(bucketSlots.begin(), bucketSlots.end(), slot) != bucketSlots.end()))
+                        {
+                            placed = false;
+                            break;
+                        }
+                        bucketSlots.push_back(slot);
+                    }
+                    if (placed)
+                    {
+                        for (const auto slot : bucketSlots)
+                        {
+                            slotUsed[slot] = true;
+                        }
+                        displacements[bucketIndex] = displacement;
+                    }
+                }
+                if (!placed)
+                {
+                    placedAll = false;
+                    break;
+                }
+            }
+            if (!placedAll)
+            {
+                continue;
+            }
+
+            auto index{ std::make_unique<CatalogIndex>() };
+            index->bucket_count = bucketCount;
+            index->slot_count = slotCount;
+            index->slots = std::make_unique<Entry[]>(slotCount);
+            for (const auto& key : keys)
+            {
+                Entry& entry{ index->slots[Slot(key.hash, displacements[Bucket(key.hash, bucketCount)], slotCount)] };
+                entry.name = key.name;
+                entry.name_length = key.name_length;
+                entry.value = key.value;
+            }
+            index->displacements = std::move(displacements);
+            return index;
+        }
+
+        // Names whose full hashes collide can never be separated, however big the table gets.
+        return nullptr;
+    }
+}
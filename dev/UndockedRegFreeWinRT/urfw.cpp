@@ -126,12 +126,12 @@ HRESULT GetActivationLocation(HSTRING activatableClassId, ActivationLocation &ac
     UINT32 activatableClassIdAsStringLength{};
     auto activatableClassIdAsString{ WindowsGetStringRawBuffer(activatableClassId, &activatableClassIdAsStringLength) };
     {
-        // Does the activatableClassId start with "Windows."?
+        // Does the activatableClassId start with "Windows."? (ordinal, case sensitive)
         auto windowsNamespacePrefix{ L"Windows." };
         const int windowsNamespacePrefixLength{ 8 };
         if (activatableClassIdAsStringLength >= windowsNamespacePrefixLength)
         {
-            if (CompareStringOrdinal(activatableClassIdAsString, windowsNamespacePrefixLength, windowsNamespacePrefix, windowsNamespacePrefixLength, FALSE) == CSTR_EQUAL)
+            if (wmemcmp(activatableClassIdAsString, windowsNamespacePrefix, windowsNamespacePrefixLength) == 0)
             {
                 return REGDB_E_CLASSNOTREG;
             }
@@ -430,14 +430,29 @@ HRESULT UrfwInitialize() noexcept
 #endif
 
     // OS Reg-Free WinRT isn't available so let's do it ourselves...
-    DetourAttach(&(PVOID&)TrueRoActivateInstance, RoActivateInstanceDetour);
-    DetourAttach(&(PVOID&)TrueRoGetActivationFactory, RoGetActivationFactoryDetour);
-    DetourAttach(&(PVOID&)TrueRoGetMetaDataFile, RoGetMetaDataFileDetour);
-    DetourAttach(&(PVOID&)TrueRoResolveNamespace, RoResolveNamespaceDetour);
+    PVOID* pointers[]
+    {
+        &(PVOID&)TrueRoActivateInstance,
+        &(PVOID&)TrueRoGetActivationFactory,
+        &(PVOID&)TrueRoGetMetaDataFile,
+        &(PVOID&)TrueRoResolveNamespace,
+    };
+    PVOID detours[]
+    {
+        RoActivateInstanceDetour,
+        RoGetActivationFactoryDetour,
+        RoGetMetaDataFileDetour,
+        RoResolveNamespaceDetour,
+    };
+    static_assert(ARRAYSIZE(pointers) == ARRAYSIZE(detours));
+    RETURN_IF_WIN32_ERROR(DetourAttachBatch(pointers, detours, ARRAYSIZE(pointers)));
     g_apisAreDetoured = true;
     try
     {
         RETURN_IF_FAILED(ExtRoLoadCatalog());
+
+        // Lookups fall back to the parsed catalog if the index can't be built
+        LOG_IF_FAILED(WinRTBuildCatalogIndex());
     }
     catch (...)
     {
@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+// Throughput of the x86/x64 decoder with and without the pre-decoder.
+//
+//   DisasmBenchmark [--rounds n] [file ...]
+//
+// Each corpus is walked linearly, the way DetourAttach walks a prologue, and
+// bytes that don't decode are stepped over one at a time.
+
+#include "DisasmHarness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+struct SweepTiming
+{
+    size_t  nInstructions;
+    double  nSeconds;
+};
+
+static SweepTiming TimeSweep(PF_DETOUR_COPY_INSTRUCTION pfCopy, std::vector<uint8_t>& rb, size_t cbCode, size_t nRounds)
+{
+    uint8_t rbDst[64];
+    SweepTiming timing = {};
+
+    auto const start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < nRounds; n++) {
+        uint8_t *pbSrc = rb.data();
+        uint8_t *pbEnd = rb.data() + cbCode;
+        while (pbSrc < pbEnd) {
+            void *pTarget = nullptr;
+            int32_t lExtra = 0;
+            uint8_t *pbNext = (uint8_t *)pfCopy(rbDst, nullptr, pbSrc, &pTarget, &lExtra);
+            pbSrc = (pbNext != nullptr && pbNext > pbSrc) ? pbNext : pbSrc + 1;
+            timing.nInstructions++;
+        }
+    }
+    timing.nSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return timing;
+}
+
+static void Run(const DisasmArch& arch, const char *pszCorpus, std::vector<uint8_t> rb, size_t nRounds)
+{
+    size_t const cbCode = rb.size();
+    rb.resize(cbCode + c_cbDisasmSlack, 0xcc);
+
+    // One untimed pass builds the pre-decoder tables and warms the caches.
+    TimeSweep(arch.pfFast, rb, cbCode, 1);
+    TimeSweep(arch.pfReference, rb, cbCode, 1);
+
+    SweepTiming const reference = TimeSweep(arch.pfReference, rb, cbCode, nRounds);
+    SweepTiming const fast = TimeSweep(arch.pfFast, rb, cbCode, nRounds);
+
+    double const nsReference = reference.nSeconds * 1e9 / reference.nInstructions;
+    double const nsFast = fast.nSeconds * 1e9 / fast.nInstructions;
+    printf("%-4s %-10s %9zu bytes  reference %6.2f ns/insn %8.1f MB/s  fast %6.2f ns/insn %8.1f MB/s  %.2fx\n",
+           arch.pszName, pszCorpus, cbCode,
+           nsReference, cbCode * nRounds / reference.nSeconds / 1e6,
+           nsFast, cbCode * nRounds / fast.nSeconds / 1e6,
+           nsReference / nsFast);
+}
+
+int main(int argc, char **argv)
+{
+    size_t nRounds = 20;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            nRounds = strtoull(argv[++i], nullptr, 0);
+        }
+        else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    LimitDisasmReferences();
+
+    const size_t cbCorpus = 1 << 20;
+    for (const DisasmArch& arch : GetDisasmArchs()) {
+        std::vector<uint8_t> rbPrologues;
+        while (rbPrologues.size() < cbCorpus) {
+            for (const std::vector<uint8_t>& prologue : *arch.pPrologues) {
+                rbPrologues.insert(rbPrologues.end(), prologue.begin(), prologue.end());
+            }
+        }
+        Run(arch, "prologues", rbPrologues, nRounds);
+
+        DisasmRandom rng(0x5eed);
+        std::vector<uint8_t> rbShaped(cbCorpus);
+        FillInstructionLike(rng, arch.fX64, rbShaped.data(), rbShaped.size());
+        Run(arch, "shaped", rbShaped, nRounds);
+
+        for (const std::string& file : files) {
+            std::ifstream stream(file, std::ios::binary);
+            if (!stream) {
+                printf("cannot open %s\n", file.c_str());
+                return EXIT_FAILURE;
+            }
+            Run(arch, file.c_str(),
+                std::vector<uint8_t>((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>()),
+                nRounds);
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+#include "DisasmHarness.h"
+
+// Prologues and thunks lifted from shipping binaries.  Displacements are kept
+// as found; LimitDisasmReferences keeps the decoders from following them.
+static const std::vector<std::vector<uint8_t>> s_x64Prologues =
+{
+    // MSVC: save nonvolatiles in the home area, then allocate.
+    { 0x48, 0x89, 0x5c, 0x24, 0x08, 0x48, 0x89, 0x74, 0x24, 0x10, 0x57, 0x48, 0x83, 0xec, 0x20,
+      0x48, 0x8b, 0xf9, 0x48, 0x8b, 0xda, 0xe8, 0x10, 0x20, 0x30, 0x00 },
+    { 0x40, 0x53, 0x48, 0x83, 0xec, 0x20, 0x48, 0x8b, 0xd9 },
+    { 0x48, 0x8b, 0xc4, 0x48, 0x89, 0x58, 0x08, 0x48, 0x89, 0x68, 0x10, 0x48, 0x89, 0x70, 0x18,
+      0x48, 0x89, 0x78, 0x20, 0x41, 0x56, 0x48, 0x83, 0xec, 0x20 },
+    // MSVC /GS: frame through r11, cookie loaded RIP-relative.
+    { 0x4c, 0x8b, 0xdc, 0x49, 0x89, 0x5b, 0x08, 0x49, 0x89, 0x73, 0x10, 0x57,
+      0x48, 0x81, 0xec, 0x80, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x05, 0x11, 0x22, 0x33, 0x00,
+      0x48, 0x33, 0xc4, 0x48, 0x89, 0x84, 0x24, 0x70, 0x00, 0x00, 0x00 },
+    { 0x48, 0x83, 0xec, 0x28, 0x48, 0x8d, 0x0d, 0x10, 0x20, 0x30, 0x00, 0xff, 0x15, 0x22, 0x33, 0x44, 0x00 },
+    // Import thunk and branches.
+    { 0xff, 0x25, 0x00, 0x10, 0x00, 0x00 },
+    { 0xe9, 0x10, 0x20, 0x30, 0x40 },
+    { 0xeb, 0x05, 0x74, 0x10, 0x0f, 0x84, 0x10, 0x20, 0x00, 0x00, 0xc3 },
+    // Padding and hotpatch nops.
+    { 0xcc, 0xcc, 0xcc, 0x0f, 0x1f, 0x44, 0x00, 0x00, 0x66, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x66, 0x90 },
+    // GCC and clang: CET marker, frame pointer, pushes.
+    { 0xf3, 0x0f, 0x1e, 0xfa, 0x55, 0x48, 0x89, 0xe5, 0x41, 0x57, 0x41, 0x56, 0x41, 0x55, 0x41, 0x54,
+      0x53, 0x48, 0x83, 0xec, 0x18 },
+    { 0x48, 0x89, 0x7d, 0xf8, 0x89, 0x75, 0xf4, 0xc7, 0x45, 0xf0, 0x00, 0x00, 0x00, 0x00 },
+    // SSE and AVX spills.
+    { 0x0f, 0x29, 0x74, 0x24, 0x20, 0xc5, 0xf8, 0x77, 0xc5, 0xfa, 0x7f, 0x44, 0x24, 0x10,
+      0x66, 0x0f, 0x6f, 0x05, 0x10, 0x20, 0x30, 0x00, 0xf2, 0x0f, 0x10, 0x05, 0x10, 0x20, 0x30, 0x00 },
+    // Immediates whose size depends on the prefixes.
+    { 0x48, 0xb8, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x66, 0xb8, 0x34, 0x12,
+      0x66, 0x05, 0x34, 0x12, 0x66, 0x81, 0xc1, 0x34, 0x12 },
+    // TEB access through gs.
+    { 0x65, 0x48, 0x8b, 0x04, 0x25, 0x30, 0x00, 0x00, 0x00 },
+};
+
+static const std::vector<std::vector<uint8_t>> s_x86Prologues =
+{
+    // Hotpatchable stdcall.
+    { 0x8b, 0xff, 0x55, 0x8b, 0xec, 0x83, 0xec, 0x10, 0x53, 0x56, 0x57 },
+    // SEH frame.
+    { 0x55, 0x8b, 0xec, 0x6a, 0xff, 0x68, 0x10, 0x20, 0x30, 0x40, 0x64, 0xa1, 0x00, 0x00, 0x00, 0x00, 0x50 },
+    // thiscall.
+    { 0x83, 0xec, 0x08, 0x56, 0x8b, 0xf1, 0xe8, 0x10, 0x20, 0x30, 0x40 },
+    // Import thunk and branches.
+    { 0xff, 0x25, 0x00, 0x10, 0x40, 0x00 },
+    { 0xe9, 0x10, 0x20, 0x30, 0x40, 0xeb, 0x05, 0x75, 0xf0, 0xc2, 0x08, 0x00 },
+    // Operand and address size overrides.
+    { 0x66, 0xb8, 0x34, 0x12, 0x66, 0x05, 0x34, 0x12, 0x67, 0x8b, 0x07, 0xa1, 0x10, 0x20, 0x30, 0x40,
+      0x67, 0xa1, 0x10, 0x20 },
+    // GCC main with stack realignment.
+    { 0x8d, 0x4c, 0x24, 0x04, 0x83, 0xe4, 0xf0, 0xff, 0x71, 0xfc, 0x55, 0x89, 0xe5, 0x51 },
+    // SSE spill and padding.
+    { 0x0f, 0x29, 0x45, 0xd8, 0xf3, 0x0f, 0x10, 0x45, 0x08, 0xcc, 0xcc, 0x90 },
+};
+
+const std::vector<DisasmArch>& GetDisasmArchs()
+{
+    static const std::vector<DisasmArch> s_archs =
+    {
+        { "x64", DetourCopyInstructionX64, DetourCopyInstructionX64Reference, true, &s_x64Prologues },
+        { "x86", DetourCopyInstructionX86, DetourCopyInstructionX86Reference, false, &s_x86Prologues },
+    };
+    return s_archs;
+}
+
+void LimitDisasmReferences()
+{
+    // DetourGetModuleSize is stubbed to 0, so this module covers no bytes.
+    void *hModule = (void *)(uintptr_t)0x10000;
+
+    DetourSetCodeModuleX64(hModule, 1);
+    DetourSetCodeModuleX64Reference(hModule, 1);
+    DetourSetCodeModuleX86(hModule, 1);
+    DetourSetCodeModuleX86Reference(hModule, 1);
+}
+
+void FillInstructionLike(DisasmRandom& rng, bool fX64, uint8_t *pb, size_t cb)
+{
+    static const uint8_t s_rbPrefixes[] = { 0x66, 0x67, 0xf2, 0xf3, 0x2e, 0x36, 0x3e, 0x26, 0x64, 0x65, 0xf0 };
+
+    size_t ib = 0;
+    while (ib < cb) {
+        uint32_t const nPrefixes = rng.Below(4) == 0 ? rng.Below(4) : 0;
+        for (uint32_t n = 0; n < nPrefixes && ib < cb; n++) {
+            pb[ib++] = s_rbPrefixes[rng.Below(sizeof(s_rbPrefixes))];
+        }
+        if (fX64 && rng.Below(2) == 0 && ib < cb) {
+            pb[ib++] = (uint8_t)(0x40 | rng.Below(16));
+        }
+        if (rng.Below(4) == 0 && ib < cb) {
+            pb[ib++] = 0x0f;
+            if (rng.Below(4) == 0 && ib < cb) {
+                pb[ib++] = rng.Below(2) ? 0x38 : 0x3a;
+            }
+        }
+        // Opcode, ModR/M, SIB and up to eight bytes of displacement and immediate.
+        uint32_t const cbOperands = 3 + rng.Below(9);
+        for (uint32_t n = 0; n < cbOperands && ib < cb; n++) {
+            pb[ib++] = rng.NextByte();
+        }
+    }
+}
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+#ifndef DETOURS_TEST_DISASMHARNESS_H
+#define DETOURS_TEST_DISASMHARNESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+#ifdef _WIN32
+#define DETOURS_TEST_API __stdcall
+#else
+#define DETOURS_TEST_API
+#endif
+
+// The decoders under test, declared here so the tests don't need windows.h.
+// The Reference builds are the same source with the pre-decoder compiled out.
+typedef void * (DETOURS_TEST_API *PF_DETOUR_COPY_INSTRUCTION)(void *pDst,
+                                                              void **ppDstPool,
+                                                              void *pSrc,
+                                                              void **ppTarget,
+                                                              int32_t *plExtra);
+
+extern "C" {
+void * DETOURS_TEST_API DetourCopyInstructionX64(void *, void **, void *, void **, int32_t *);
+void * DETOURS_TEST_API DetourCopyInstructionX64Reference(void *, void **, void *, void **, int32_t *);
+void * DETOURS_TEST_API DetourCopyInstructionX86(void *, void **, void *, void **, int32_t *);
+void * DETOURS_TEST_API DetourCopyInstructionX86Reference(void *, void **, void *, void **, int32_t *);
+int DETOURS_TEST_API DetourSetCodeModuleX64(void *, int);
+int DETOURS_TEST_API DetourSetCodeModuleX64Reference(void *, int);
+int DETOURS_TEST_API DetourSetCodeModuleX86(void *, int);
+int DETOURS_TEST_API DetourSetCodeModuleX86Reference(void *, int);
+}
+
+struct DisasmArch
+{
+    const char *                pszName;
+    PF_DETOUR_COPY_INSTRUCTION  pfFast;
+    PF_DETOUR_COPY_INSTRUCTION  pfReference;
+    bool                        fX64;
+    // Real function prologues and thunks, as emitted by MSVC, clang and GCC.
+    const std::vector<std::vector<uint8_t>> *   pPrologues;
+};
+
+const std::vector<DisasmArch>& GetDisasmArchs();
+
+// CALL [] and JMP [] read their target through the pointer in the
+// instruction, which on random bytes points anywhere.  Confine the decoders to
+// an empty module so those report a dynamic target instead.
+void LimitDisasmReferences();
+
+// Deterministic byte streams, so a failure reproduces from its seed.
+class DisasmRandom
+{
+  public:
+    explicit DisasmRandom(uint64_t nSeed) : m_nState(nSeed ? nSeed : 0x9e3779b97f4a7c15ull) {}
+
+    uint64_t Next()
+    {
+        m_nState ^= m_nState << 13;
+        m_nState ^= m_nState >> 7;
+        m_nState ^= m_nState << 17;
+        return m_nState;
+    }
+
+    uint8_t NextByte() { return (uint8_t)Next(); }
+
+    uint32_t Below(uint32_t n) { return (uint32_t)(Next() % n); }
+
+  private:
+    uint64_t m_nState;
+};
+
+// Instruction-shaped random bytes: a few prefixes, an opcode, a ModR/M and
+// SIB, and random operand bytes.  Plain random bytes rarely reach the
+// prefixed and two-byte forms where the two decoders are most likely to part.
+void FillInstructionLike(DisasmRandom& rng, bool fX64, uint8_t *pb, size_t cb);
+
+// Slack after the last instruction start, so no decoder reads off the end.
+const size_t c_cbDisasmSlack = 32;
+
+#endif // DETOURS_TEST_DISASMHARNESS_H
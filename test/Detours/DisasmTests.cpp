@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+// Differential tests for the x86/x64 pre-decoder in disasm.cpp.
+//
+// Every input is decoded twice, by the shipping decoder and by the same source
+// built with DETOURS_DISASM_FAST_PATH 0, and the two must agree on the length,
+// the target, the extra bytes and the copied instruction.
+//
+//   DisasmTests [--seed n] [--iterations n] [file ...]
+//
+// Files are swept at every byte offset, so passing real binaries adds their
+// code sections to the corpus.
+
+#include "DisasmHarness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+static const size_t c_nMaxReported = 20;
+static size_t s_nFailures = 0;
+static size_t s_nCompared = 0;
+
+struct DecodeResult
+{
+    void *      pNext;
+    void *      pTarget;
+    int32_t     lExtra;
+    uint8_t     rbDst[64];
+};
+
+static void Decode(PF_DETOUR_COPY_INSTRUCTION pfCopy, uint8_t *pbDst, uint8_t *pbSrc, DecodeResult& result)
+{
+    memset(pbDst, 0xcd, sizeof(result.rbDst));
+    result.pTarget = (void *)(uintptr_t)0x1;
+    result.lExtra = 0x7eadbeef;
+    result.pNext = pfCopy(pbDst, nullptr, pbSrc, &result.pTarget, &result.lExtra);
+    memcpy(result.rbDst, pbDst, sizeof(result.rbDst));
+}
+
+static void Report(const DisasmArch& arch, const char *pszWhat, size_t ib, const uint8_t *pbSrc,
+                   const DecodeResult& fast, const DecodeResult& reference)
+{
+    if (s_nFailures++ >= c_nMaxReported) {
+        return;
+    }
+    printf("MISMATCH %s %s +0x%zx:", arch.pszName, pszWhat, ib);
+    for (size_t n = 0; n < 16; n++) {
+        printf(" %02x", pbSrc[n]);
+    }
+    printf("\n    fast: len=%td target=%p extra=%d\n    ref:  len=%td target=%p extra=%d\n",
+           fast.pNext ? (const uint8_t *)fast.pNext - pbSrc : -1, fast.pTarget, fast.lExtra,
+           reference.pNext ? (const uint8_t *)reference.pNext - pbSrc : -1, reference.pTarget, reference.lExtra);
+}
+
+// Both decoders copy into the same destination, so relocated targets and
+// adjusted displacements are comparable byte for byte.
+static void Compare(const DisasmArch& arch, const char *pszWhat, uint8_t *pbBase, size_t ib)
+{
+    static uint8_t s_rbDst[64];
+
+    uint8_t *pbSrc = pbBase + ib;
+    DecodeResult reference;
+    DecodeResult fast;
+    Decode(arch.pfReference, s_rbDst, pbSrc, reference);
+    Decode(arch.pfFast, s_rbDst, pbSrc, fast);
+    s_nCompared++;
+
+    bool fSame = (fast.pNext == reference.pNext &&
+                  fast.pTarget == reference.pTarget &&
+                  fast.lExtra == reference.lExtra);
+    if (fSame && reference.pNext != nullptr) {
+        size_t const cb = (const uint8_t *)reference.pNext - pbSrc;
+        fSame = cb <= sizeof(s_rbDst) && memcmp(fast.rbDst, reference.rbDst, cb) == 0;
+    }
+    if (!fSame) {
+        Report(arch, pszWhat, ib, pbSrc, fast, reference);
+    }
+}
+
+static void Sweep(const DisasmArch& arch, const char *pszWhat, std::vector<uint8_t>& rb)
+{
+    size_t const cbCode = rb.size();
+    rb.resize(cbCode + c_cbDisasmSlack, 0xcc);
+    for (size_t ib = 0; ib < cbCode; ib++) {
+        Compare(arch, pszWhat, rb.data(), ib);
+    }
+    rb.resize(cbCode);
+}
+
+// A few absolute answers, so a bug shared by both builds still shows up.
+static void CheckKnownLengths()
+{
+    struct Known
+    {
+        bool                    fX64;
+        std::vector<uint8_t>    rb;
+        size_t                  cb;
+        ptrdiff_t               nTarget;    // From the source start, or 0 for none.
+    };
+    static const std::vector<Known> s_known =
+    {
+        { true,  { 0x48, 0x89, 0x5c, 0x24, 0x08 }, 5, 0 },
+        { true,  { 0x40, 0x53 }, 2, 0 },
+        { true,  { 0x48, 0x83, 0xec, 0x20 }, 4, 0 },
+        { true,  { 0x48, 0xb8, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 }, 10, 0 },
+        { true,  { 0x66, 0x05, 0x34, 0x12 }, 4, 0 },
+        { true,  { 0x0f, 0x1f, 0x44, 0x00, 0x00 }, 5, 0 },
+        { true,  { 0xe9, 0x10, 0x00, 0x00, 0x00 }, 5, 0x15 },
+        { true,  { 0xeb, 0x05 }, 2, 0x07 },
+        { false, { 0x8b, 0xff }, 2, 0 },
+        { false, { 0x83, 0xec, 0x10 }, 3, 0 },
+        { false, { 0x66, 0xb8, 0x34, 0x12 }, 4, 0 },
+        { false, { 0x67, 0xa1, 0x10, 0x20 }, 4, 0 },
+        { false, { 0xe8, 0x10, 0x00, 0x00, 0x00 }, 5, 0x15 },
+    };
+
+    for (const DisasmArch& arch : GetDisasmArchs()) {
+        for (const Known& known : s_known) {
+            if (known.fX64 != arch.fX64) {
+                continue;
+            }
+            std::vector<uint8_t> rb(known.rb);
+            rb.resize(rb.size() + c_cbDisasmSlack, 0xcc);
+
+            for (PF_DETOUR_COPY_INSTRUCTION pfCopy : { arch.pfFast, arch.pfReference }) {
+                void *pTarget = nullptr;
+                int32_t lExtra = 0;
+                // Decode in place, so relative targets come out relative to the source.
+                uint8_t *pbNext = (uint8_t *)pfCopy(nullptr, nullptr, rb.data(), &pTarget, &lExtra);
+                uint8_t *pbTarget = known.nTarget ? rb.data() + known.nTarget : nullptr;
+
+                if (pbNext != rb.data() + known.cb || (known.nTarget && pTarget != pbTarget)) {
+                    printf("WRONG %s %s %02x %02x: len=%td target=%p, expected len=%zu target=%p\n",
+                           arch.pszName, pfCopy == arch.pfFast ? "fast" : "ref", rb[0], rb[1],
+                           pbNext ? pbNext - rb.data() : -1, pTarget, known.cb, (void *)pbTarget);
+                    s_nFailures++;
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t nSeed = 0x5eed;
+    size_t nIterations = 200;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            nSeed = strtoull(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            nIterations = strtoull(argv[++i], nullptr, 0);
+        }
+        else {
+            files.push_back(argv[i]);
+        }
+    }
+    printf("seed 0x%llx, %zu iterations\n", (unsigned long long)nSeed, nIterations);
+
+    LimitDisasmReferences();
+    CheckKnownLengths();
+
+    DisasmRandom rng(nSeed);
+    for (const DisasmArch& arch : GetDisasmArchs()) {
+        for (const std::vector<uint8_t>& prologue : *arch.pPrologues) {
+            std::vector<uint8_t> rb(prologue);
+            Sweep(arch, "prologue", rb);
+        }
+
+        std::vector<uint8_t> rb(4096);
+        for (size_t n = 0; n < nIterations; n++) {
+            for (uint8_t& b : rb) {
+                b = rng.NextByte();
+            }
+            Sweep(arch, "random", rb);
+
+            FillInstructionLike(rng, arch.fX64, rb.data(), rb.size());
+            Sweep(arch, "shaped", rb);
+        }
+
+        for (const std::string& file : files) {
+            std::ifstream stream(file, std::ios::binary);
+            if (!stream) {
+                printf("cannot open %s\n", file.c_str());
+                s_nFailures++;
+                continue;
+            }
+            std::vector<uint8_t> rbFile((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+            Sweep(arch, file.c_str(), rbFile);
+        }
+    }
+
+    printf("%zu comparisons, %zu failures\n", s_nCompared, s_nFailures);
+    return s_nFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
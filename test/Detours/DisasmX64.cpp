@@ -0,0 +1,6 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+// The x64 disassembler from dev/Detours, built as an offline library.
+#define DETOURS_X64_OFFLINE_LIBRARY
+#include "disasm.cpp"
@@ -0,0 +1,10 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+// The x64 disassembler without the pre-decoder, which the tests treat as the reference.
+#define DETOURS_X64_OFFLINE_LIBRARY
+#define DETOURS_DISASM_FAST_PATH 0
+#define DetourCopyInstructionX64 DetourCopyInstructionX64Reference
+#define DetourSetCodeModuleX64 DetourSetCodeModuleX64Reference
+#define CDetourDisX64 CDetourDisX64Reference
+#include "disasm.cpp"
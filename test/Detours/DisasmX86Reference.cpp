@@ -0,0 +1,10 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+// The x86 disassembler without the pre-decoder, which the tests treat as the reference.
+#define DETOURS_X86_OFFLINE_LIBRARY
+#define DETOURS_DISASM_FAST_PATH 0
+#define DetourCopyInstructionX86 DetourCopyInstructionX86Reference
+#define DetourSetCodeModuleX86 DetourSetCodeModuleX86Reference
+#define CDetourDisX86 CDetourDisX86Reference
+#include "disasm.cpp"
@@ -0,0 +1,575 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+// Tests for the export index in expindex.cpp, against PE32 and PE32+ images
+// read from disk.
+//
+//   ExportIndexTests [--seed n] [--scratch dir] [image ...]
+//
+// The built-in images are written to the scratch directory and read back, so
+// the index sees them exactly as it would see a file image.  Images named on
+// the command line are checked against a plain walk of their name table.
+
+#define DETOURS_INTERNAL
+#include "detours.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static size_t s_nChecks = 0;
+static size_t s_nFailures = 0;
+
+#define CHECK(e, ...)                                                   \
+    do {                                                                \
+        s_nChecks++;                                                    \
+        if (!(e)) {                                                     \
+            s_nFailures++;                                              \
+            printf("FAILED %s:%d: %s: ", __FILE__, __LINE__, #e);       \
+            printf(__VA_ARGS__);                                        \
+            printf("\n");                                               \
+        }                                                               \
+    } while (0)
+
+static const DWORD c_rvaText = 0x1000;
+static const DWORD c_rvaEdata = 0x3000;
+static const DWORD c_offText = 0x400;       // Raw offsets differ from the RVAs.
+static const DWORD c_offEdata = 0x600;
+static const DWORD c_cbFileAlign = 0x200;
+
+struct TestFunction
+{
+    DWORD           rva;            // 0 for an unused slot.
+    std::string     forwarder;      // "Dll.Name" for a forwarder; rva is ignored.
+};
+
+struct TestName
+{
+    std::string     name;
+    WORD            nFunction;
+};
+
+struct TestImage
+{
+    bool                        fPe32Plus;
+    DWORD                       nBase;
+    std::vector<TestFunction>   functions;
+    std::vector<TestName>       names;
+};
+
+static DWORD AlignUp(DWORD n, DWORD nAlign)
+{
+    return (n + nAlign - 1) & ~(nAlign - 1);
+}
+
+template<typename T> static T * At(std::vector<BYTE>& rb, size_t offset)
+{
+    return (T *)(rb.data() + offset);
+}
+
+// Lays out a file image: headers, a .text section and an .edata section that
+// holds the export directory and its tables, then the DLL name, the forwarder
+// strings and the export names, with the last name last.
+//
+static std::vector<BYTE> BuildFileImage(const TestImage& image, _Out_opt_ DWORD *prvaLastName = NULL)
+{
+    DWORD const cbTables = (DWORD)(image.functions.size() * sizeof(DWORD) +
+                                   image.names.size() * (sizeof(DWORD) + sizeof(WORD)));
+    std::vector<BYTE> rbEdata(sizeof(IMAGE_EXPORT_DIRECTORY) + cbTables);
+    auto append = [&rbEdata](const void *pv, size_t cb) {
+        DWORD rva = c_rvaEdata + (DWORD)rbEdata.size();
+        rbEdata.insert(rbEdata.end(), (const BYTE *)pv, (const BYTE *)pv + cb);
+        return rva;
+    };
+
+    DWORD const offFunctions = sizeof(IMAGE_EXPORT_DIRECTORY);
+    DWORD const offNames = offFunctions + (DWORD)(image.functions.size() * sizeof(DWORD));
+    DWORD const offOrdinals = offNames + (DWORD)(image.names.size() * sizeof(DWORD));
+
+    DWORD rvaDllName = append("test.dll", 9);
+    for (size_t n = 0; n < image.functions.size(); n++) {
+        const TestFunction& function = image.functions[n];
+        DWORD rva = function.forwarder.empty()
+            ? function.rva : append(function.forwarder.c_str(), function.forwarder.size() + 1);
+        memcpy(rbEdata.data() + offFunctions + n * sizeof(DWORD), &rva, sizeof(rva));
+    }
+    for (size_t n = 0; n < image.names.size(); n++) {
+        DWORD rva = append(image.names[n].name.c_str(), image.names[n].name.size() + 1);
+        memcpy(rbEdata.data() + offNames + n * sizeof(DWORD), &rva, sizeof(rva));
+        memcpy(rbEdata.data() + offOrdinals + n * sizeof(WORD), &image.names[n].nFunction, sizeof(WORD));
+        if (prvaLastName != NULL) {
+            *prvaLastName = rva;
+        }
+    }
+
+    PIMAGE_EXPORT_DIRECTORY pExportDir = (PIMAGE_EXPORT_DIRECTORY)rbEdata.data();
+    pExportDir->Name = rvaDllName;
+    pExportDir->Base = image.nBase;
+    pExportDir->NumberOfFunctions = (DWORD)image.functions.size();
+    pExportDir->NumberOfNames = (DWORD)image.names.size();
+    pExportDir->AddressOfFunctions = c_rvaEdata + offFunctions;
+    pExportDir->AddressOfNames = c_rvaEdata + offNames;
+    pExportDir->AddressOfNameOrdinals = c_rvaEdata + offOrdinals;
+
+    DWORD cbEdata = (DWORD)rbEdata.size();
+    DWORD cbEdataRaw = AlignUp(cbEdata, c_cbFileAlign);
+    std::vector<BYTE> rb(c_offEdata + cbEdataRaw);
+
+    PIMAGE_DOS_HEADER pDosHeader = At<IMAGE_DOS_HEADER>(rb, 0);
+    pDosHeader->e_magic = IMAGE_DOS_SIGNATURE;
+    pDosHeader->e_lfanew = 0x80;
+
+    PIMAGE_NT_HEADERS32 pNtHeader = At<IMAGE_NT_HEADERS32>(rb, pDosHeader->e_lfanew);
+    pNtHeader->Signature = IMAGE_NT_SIGNATURE;
+    pNtHeader->FileHeader.Machine = image.fPe32Plus ? IMAGE_FILE_MACHINE_AMD64 : IMAGE_FILE_MACHINE_I386;
+    pNtHeader->FileHeader.NumberOfSections = 2;
+    pNtHeader->FileHeader.SizeOfOptionalHeader = image.fPe32Plus
+        ? sizeof(IMAGE_OPTIONAL_HEADER64) : sizeof(IMAGE_OPTIONAL_HEADER32);
+
+    DWORD const cbImage = AlignUp(c_rvaEdata + cbEdata, 0x1000);
+    PIMAGE_DATA_DIRECTORY pExportEntry;
+    if (image.fPe32Plus) {
+        PIMAGE_OPTIONAL_HEADER64 pOptional = &((PIMAGE_NT_HEADERS64)pNtHeader)->OptionalHeader;
+        pOptional->Magic = IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+        pOptional->SizeOfImage = cbImage;
+        pOptional->SizeOfHeaders = c_offText;
+        pOptional->NumberOfRvaAndSizes = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+        pExportEntry = &pOptional->DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT];
+    }
+    else {
+        PIMAGE_OPTIONAL_HEADER32 pOptional = &pNtHeader->OptionalHeader;
+        pOptional->Magic = IMAGE_NT_OPTIONAL_HDR32_MAGIC;
+        pOptional->SizeOfImage = cbImage;
+        pOptional->SizeOfHeaders = c_offText;
+        pOptional->NumberOfRvaAndSizes = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+        pExportEntry = &pOptional->DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT];
+    }
+    pExportEntry->VirtualAddress = c_rvaEdata;
+    pExportEntry->Size = cbEdata;
+
+    PIMAGE_SECTION_HEADER pSections = (PIMAGE_SECTION_HEADER)
+        ((PBYTE)&pNtHeader->OptionalHeader + pNtHeader->FileHeader.SizeOfOptionalHeader);
+    memcpy(pSections[0].Name, ".text", 5);
+    pSections[0].VirtualAddress = c_rvaText;
+    pSections[0].Misc.VirtualSize = c_rvaEdata - c_rvaText;
+    pSections[0].PointerToRawData = c_offText;
+    pSections[0].SizeOfRawData = c_offEdata - c_offText;
+    memcpy(pSections[1].Name, ".edata", 6);
+    pSections[1].VirtualAddress = c_rvaEdata;
+    pSections[1].Misc.VirtualSize = cbEdata;
+    pSections[1].PointerToRawData = c_offEdata;
+    pSections[1].SizeOfRawData = cbEdataRaw;
+
+    memset(rb.data() + c_offText, 0xcc, c_offEdata - c_offText);
+    memcpy(rb.data() + c_offEdata, rbEdata.data(), cbEdata);
+    return rb;
+}
+
+// Lays a file image out the way the loader maps it.
+//
+static std::vector<BYTE> MapFileImage(const std::vector<BYTE>& rbFile)
+{
+    PIMAGE_NT_HEADERS32 pNtHeader = (PIMAGE_NT_HEADERS32)
+        (rbFile.data() + ((PIMAGE_DOS_HEADER)rbFile.data())->e_lfanew);
+    DWORD cbImage = pNtHeader->OptionalHeader.Magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC
+        ? ((PIMAGE_NT_HEADERS64)pNtHeader)->OptionalHeader.SizeOfImage
+        : pNtHeader->OptionalHeader.SizeOfImage;
+
+    std::vector<BYTE> rb(cbImage);
+    memcpy(rb.data(), rbFile.data(), c_offText);
+
+    PIMAGE_SECTION_HEADER pSections = (PIMAGE_SECTION_HEADER)
+        ((PBYTE)&pNtHeader->OptionalHeader + pNtHeader->FileHeader.SizeOfOptionalHeader);
+    for (WORD n = 0; n < pNtHeader->FileHeader.NumberOfSections; n++) {
+        DWORD cb = pSections[n].SizeOfRawData;
+        if (cb > cbImage - pSections[n].VirtualAddress) {
+            cb = cbImage - pSections[n].VirtualAddress;
+        }
+        memcpy(rb.data() + pSections[n].VirtualAddress, rbFile.data() + pSections[n].PointerToRawData, cb);
+    }
+    return rb;
+}
+
+static std::string s_scratch = ".";
+
+static bool WriteFile(const std::string& path, const std::vector<BYTE>& rb)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write((const char *)rb.data(), (std::streamsize)rb.size());
+    return (bool)stream;
+}
+
+static bool ReadFile(const std::string& path, std::vector<BYTE>& rb)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        return false;
+    }
+    rb.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Round-trips the image through a file, so the index reads exactly what is on disk.
+//
+static std::vector<BYTE> LoadFromDisk(const char *pszName, const std::vector<BYTE>& rbImage)
+{
+    std::string path = s_scratch + "/" + pszName;
+    std::vector<BYTE> rb;
+    CHECK(WriteFile(path, rbImage) && ReadFile(path, rb) && rb == rbImage, "%s", path.c_str());
+    return rb;
+}
+
+struct IndexHolder
+{
+    DETOUR_EXPORT_INDEX *p = NULL;
+    DWORD dwError = NO_ERROR;
+
+    IndexHolder(std::vector<BYTE>& rb, BOOL fMapped, size_t cb = ~(size_t)0)
+    {
+        dwError = detour_export_index_create(rb.data(), (ULONG)(cb < rb.size() ? cb : rb.size()), fMapped, &p);
+    }
+    ~IndexHolder()
+    {
+        if (p != NULL) {
+            detour_export_index_free(p);
+        }
+    }
+};
+
+// The ordinal for pszName, or 0.
+//
+static DWORD FindOrdinal(const DETOUR_EXPORT_INDEX *pIndex, const char *pszName)
+{
+    DWORD nFunction;
+    return detour_export_index_find(pIndex, pszName, &nFunction) ? pIndex->nBase + nFunction : 0;
+}
+
+// Every name resolves to the function of its first entry in the name table,
+// which is what a walk of the table (DetourEnumerateExports, GetProcAddress's
+// linear fallback) finds.
+//
+static void CheckAgainstSpec(const char *pszWhat, const TestImage& image, const DETOUR_EXPORT_INDEX *pIndex)
+{
+    CHECK(pIndex->nBase == image.nBase, "%s", pszWhat);
+    CHECK(pIndex->nFunctions == image.functions.size(), "%s", pszWhat);
+
+    for (size_t n = 0; n < image.names.size(); n++) {
+        const TestName& name = image.names[n];
+        size_t nFirst = n;
+        for (size_t m = 0; m < n; m++) {
+            if (image.names[m].name == name.name) {
+                nFirst = m;
+                break;
+            }
+        }
+        DWORD nExpected = image.names[nFirst].nFunction < image.functions.size()
+            ? image.nBase + image.names[nFirst].nFunction : 0;
+        CHECK(FindOrdinal(pIndex, name.name.c_str()) == nExpected,
+              "%s: %s -> %u, expected %u", pszWhat, name.name.c_str(), FindOrdinal(pIndex, name.name.c_str()), nExpected);
+    }
+}
+
+static TestImage SampleImage(bool fPe32Plus)
+{
+    TestImage image;
+    image.fPe32Plus = fPe32Plus;
+    image.nBase = 5;
+    image.functions = {
+        { c_rvaText + 0x10, "" },
+        { c_rvaText + 0x20, "" },
+        { 0, "" },                                  // Unused ordinal slot.
+        { c_rvaText + 0x40, "" },                   // Exported by ordinal only.
+        { 0, "NTDLL.RtlAllocateHeap" },             // Forwarder.
+        { c_rvaText + 0x60, "" },
+    };
+    image.names = {
+        { "Alpha", 0 },
+        { "Beta", 1 },
+        { "Alloc", 4 },
+        { "Dup", 5 },
+        { "Dup", 1 },                               // Duplicate; the first one wins.
+        { "AlphaBeta", 5 },
+        { "", 0 },                                  // Empty names are names too.
+        { "OutOfRange", 200 },                      // Ordinal past NumberOfFunctions.
+    };
+    return image;
+}
+
+static void TestWellFormed()
+{
+    for (bool fPe32Plus : { false, true }) {
+        const char *pszKind = fPe32Plus ? "PE32+" : "PE32";
+        TestImage image = SampleImage(fPe32Plus);
+        std::vector<BYTE> rbFile = LoadFromDisk(fPe32Plus ? "exports64.dll" : "exports32.dll", BuildFileImage(image));
+        std::vector<BYTE> rbMapped = MapFileImage(rbFile);
+
+        for (BOOL fMapped : { FALSE, TRUE }) {
+            IndexHolder index(fMapped ? rbMapped : rbFile, fMapped);
+            CHECK(index.dwError == NO_ERROR && index.p != NULL, "%s mapped=%d: error %u", pszKind, fMapped, index.dwError);
+            if (index.p == NULL) {
+                continue;
+            }
+            CheckAgainstSpec(pszKind, image, index.p);
+
+            // Misses, prefixes and extensions of real names.
+            for (const char *pszMiss : { "alpha", "Alph", "Alphaa", "Gamma", "RtlAllocateHeap", "Dup\x01" }) {
+                CHECK(FindOrdinal(index.p, pszMiss) == 0, "%s: %s", pszKind, pszMiss);
+            }
+
+            DWORD nFunction, rva;
+            CHECK(detour_export_index_find(index.p, "Alpha", &nFunction) &&
+                  detour_export_index_code_rva(index.p, nFunction, &rva) && rva == c_rvaText + 0x10, "%s", pszKind);
+            CHECK(detour_export_index_find(index.p, "Alloc", &nFunction) &&
+                  !detour_export_index_code_rva(index.p, nFunction, &rva), "%s: forwarder", pszKind);
+            CHECK(detour_export_index_code_rva(index.p, 3, &rva) && rva == c_rvaText + 0x40, "%s: by ordinal", pszKind);
+            CHECK(!detour_export_index_code_rva(index.p, 2, &rva), "%s: empty slot", pszKind);
+        }
+    }
+}
+
+static void TestNoExports()
+{
+    TestImage image = SampleImage(true);
+    std::vector<BYTE> rb = BuildFileImage(image);
+    PIMAGE_NT_HEADERS64 pNtHeader = At<IMAGE_NT_HEADERS64>(rb, At<IMAGE_DOS_HEADER>(rb, 0)->e_lfanew);
+    pNtHeader->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT].VirtualAddress = 0;
+    rb = LoadFromDisk("noexports.dll", rb);
+
+    IndexHolder index(rb, FALSE);
+    CHECK(index.dwError == NO_ERROR && index.p != NULL && index.p->nSlots == 0, "error %u", index.dwError);
+    CHECK(index.p == NULL || FindOrdinal(index.p, "Alpha") == 0, "lookup in an empty index");
+}
+
+static void TestHostileHeaders()
+{
+    TestImage image = SampleImage(false);
+    const std::vector<BYTE> rbGood = BuildFileImage(image);
+    LONG const lfanew = ((PIMAGE_DOS_HEADER)rbGood.data())->e_lfanew;
+
+    struct Corruption
+    {
+        const char *        pszWhat;
+        void                (*pfCorrupt)(std::vector<BYTE>& rb, LONG lfanew);
+        DWORD               dwError;
+    };
+    static const Corruption s_corruptions[] = {
+        { "MZ", [](std::vector<BYTE>& rb, LONG) { rb[0] = 'X'; }, ERROR_BAD_EXE_FORMAT },
+        { "e_lfanew negative", [](std::vector<BYTE>& rb, LONG) {
+            At<IMAGE_DOS_HEADER>(rb, 0)->e_lfanew = -8; }, ERROR_BAD_EXE_FORMAT },
+        { "e_lfanew past the end", [](std::vector<BYTE>& rb, LONG) {
+            At<IMAGE_DOS_HEADER>(rb, 0)->e_lfanew = 0x7ffffff0; }, ERROR_BAD_EXE_FORMAT },
+        { "PE signature", [](std::vector<BYTE>& rb, LONG lfanew) {
+            At<IMAGE_NT_HEADERS32>(rb, lfanew)->Signature = 0; }, ERROR_INVALID_EXE_SIGNATURE },
+        { "NumberOfSections", [](std::vector<BYTE>& rb, LONG lfanew) {
+            At<IMAGE_NT_HEADERS32>(rb, lfanew)->FileHeader.NumberOfSections = 0xffff; }, ERROR_EXE_MARKED_INVALID },
+        { "SizeOfOptionalHeader", [](std::vector<BYTE>& rb, LONG lfanew) {
+            At<IMAGE_NT_HEADERS32>(rb, lfanew)->FileHeader.SizeOfOptionalHeader = 0xfff0; }, ERROR_EXE_MARKED_INVALID },
+        { "optional header magic", [](std::vector<BYTE>& rb, LONG lfanew) {
+            At<IMAGE_NT_HEADERS32>(rb, lfanew)->OptionalHeader.Magic = IMAGE_NT_OPTIONAL_HDR64_MAGIC; }, ERROR_EXE_MARKED_INVALID },
+        { "export directory RVA", [](std::vector<BYTE>& rb, LONG lfanew) {
+            At<IMAGE_NT_HEADERS32>(rb, lfanew)->OptionalHeader.DataDirectory[0].VirtualAddress = 0x7ffff000; }, ERROR_EXE_MARKED_INVALID },
+        { "NumberOfNames", [](std::vector<BYTE>& rb, LONG) {
+            At<IMAGE_EXPORT_DIRECTORY>(rb, c_offEdata)->NumberOfNames = 0x7fffffff; }, ERROR_EXE_MARKED_INVALID },
+        { "NumberOfFunctions", [](std::vector<BYTE>& rb, LONG) {
+            At<IMAGE_EXPORT_DIRECTORY>(rb, c_offEdata)->NumberOfFunctions = 0x10000; }, ERROR_EXE_MARKED_INVALID },
+        { "AddressOfNames", [](std::vector<BYTE>& rb, LONG) {
+            At<IMAGE_EXPORT_DIRECTORY>(rb, c_offEdata)->AddressOfNames = c_rvaEdata + 0xfff0; }, ERROR_EXE_MARKED_INVALID },
+        { "AddressOfNameOrdinals", [](std::vector<BYTE>& rb, LONG) {
+            At<IMAGE_EXPORT_DIRECTORY>(rb, c_offEdata)->AddressOfNameOrdinals = 0xfffffffe; }, ERROR_EXE_MARKED_INVALID },
+    };
+
+    for (const Corruption& corruption : s_corruptions) {
+        std::vector<BYTE> rb(rbGood);
+        corruption.pfCorrupt(rb, lfanew);
+        rb = LoadFromDisk("hostile.dll", rb);
+
+        IndexHolder index(rb, FALSE);
+        CHECK(index.p == NULL && index.dwError == corruption.dwError,
+              "%s: error %u, expected %u", corruption.pszWhat, index.dwError, corruption.dwError);
+    }
+
+    // A name that runs to the end of the file is dropped; the rest still resolve.
+    {
+        TestImage tail = SampleImage(false);
+        DWORD rvaLastName;
+        std::vector<BYTE> rb = BuildFileImage(tail, &rvaLastName);
+        rb.resize(c_offEdata + (rvaLastName - c_rvaEdata) + 3);
+        rb = LoadFromDisk("unterminated.dll", rb);
+
+        IndexHolder index(rb, FALSE);
+        CHECK(index.p != NULL, "unterminated name: error %u", index.dwError);
+        if (index.p != NULL) {
+            const std::string& last = tail.names.back().name;
+            CHECK(FindOrdinal(index.p, last.c_str()) == 0 && FindOrdinal(index.p, last.substr(0, 3).c_str()) == 0,
+                  "unterminated name %s", last.c_str());
+            CHECK(FindOrdinal(index.p, "Beta") == tail.nBase + 1, "unterminated name: Beta");
+        }
+    }
+}
+
+// Every truncation and a run of random corruptions must fail cleanly or give
+// an index whose lookups stay inside the buffer.  Each case gets a buffer of
+// exactly its own size, so a sanitizer build catches any overread.
+//
+static void TestTruncatedAndFuzzed(uint64_t nSeed)
+{
+    for (bool fPe32Plus : { false, true }) {
+        TestImage image = SampleImage(fPe32Plus);
+        std::vector<BYTE> rbGood = BuildFileImage(image);
+
+        for (size_t cb = 0; cb < rbGood.size(); cb++) {
+            std::vector<BYTE> rb(rbGood.begin(), rbGood.begin() + cb);
+            IndexHolder index(rb, FALSE);
+            CHECK((index.p == NULL) == (index.dwError != NO_ERROR), "truncated to %zu", cb);
+            if (index.p != NULL) {
+                for (const TestName& name : image.names) {
+                    FindOrdinal(index.p, name.name.c_str());
+                }
+            }
+        }
+
+        uint64_t nState = nSeed | 1;
+        auto next = [&nState]() {
+            nState ^= nState << 13;
+            nState ^= nState >> 7;
+            nState ^= nState << 17;
+            return nState;
+        };
+        for (size_t n = 0; n < 20000; n++) {
+            std::vector<BYTE> rb(rbGood);
+            for (size_t nFlips = 1 + next() % 4; nFlips > 0; nFlips--) {
+                // Mostly the headers and the export tables, where the parser looks.
+                size_t ib = (next() & 1) ? next() % c_offText : c_offEdata + next() % (rb.size() - c_offEdata);
+                rb[ib] = (BYTE)next();
+            }
+            IndexHolder index(rb, (BOOL)(next() & 1));
+            if (index.p != NULL) {
+                for (const TestName& name : image.names) {
+                    DWORD nFunction, rva;
+                    if (detour_export_index_find(index.p, name.name.c_str(), &nFunction)) {
+                        CHECK(nFunction < index.p->nFunctions, "fuzz %zu", n);
+                        detour_export_index_code_rva(index.p, nFunction, &rva);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// For images from the command line: walk the name table directly, resolving
+// RVAs through the section table, and compare every name with the index.
+//
+static void TestImageFile(const std::string& path)
+{
+    std::vector<BYTE> rb;
+    if (!ReadFile(path, rb)) {
+        CHECK(false, "cannot read %s", path.c_str());
+        return;
+    }
+
+    IndexHolder index(rb, FALSE);
+    if (index.p == NULL) {
+        printf("%s: not indexed (error %u)\n", path.c_str(), index.dwError);
+        return;
+    }
+
+    auto rvaToOffset = [&](DWORD rva) -> size_t {
+        for (DWORD n = 0; n < index.p->nSections; n++) {
+            const IMAGE_SECTION_HEADER& section = index.p->pSections[n];
+            if (rva >= section.VirtualAddress && rva - section.VirtualAddress < section.SizeOfRawData) {
+                return section.PointerToRawData + (rva - section.VirtualAddress);
+            }
+        }
+        return rva;
+    };
+
+    size_t nNames = 0;
+    std::vector<std::string> seen;
+    for (DWORD n = 0; n < index.p->nNames; n++) {
+        size_t offName = rvaToOffset(index.p->pdwNames[n]);
+        if (offName >= rb.size() || memchr(rb.data() + offName, 0, rb.size() - offName) == NULL) {
+            continue;
+        }
+        const char *pszName = (const char *)rb.data() + offName;
+        WORD nFunction = index.p->pwOrdinals[n];
+        bool fFirst = true;
+        for (DWORD m = 0; m < n && fFirst; m++) {
+            size_t off = rvaToOffset(index.p->pdwNames[m]);
+            fFirst = !(off < rb.size() && strcmp((const char *)rb.data() + off, pszName) == 0);
+        }
+        if (!fFirst || nFunction >= index.p->nFunctions) {
+            continue;
+        }
+        CHECK(FindOrdinal(index.p, pszName) == index.p->nBase + nFunction, "%s: %s", path.c_str(), pszName);
+        nNames++;
+    }
+    printf("%s: %zu names\n", path.c_str(), nNames);
+}
+
+#ifdef _WIN32
+// On Windows, check the loaded system modules against DetourEnumerateExports.
+//
+static BOOL CALLBACK CompareExport(_In_opt_ PVOID pContext, _In_ ULONG nOrdinal, _In_opt_ LPCSTR pszName, _In_opt_ PVOID pCode)
+{
+    UNREFERENCED_PARAMETER(pCode);
+    const DETOUR_EXPORT_INDEX *pIndex = (const DETOUR_EXPORT_INDEX *)pContext;
+    if (pszName != NULL) {
+        CHECK(FindOrdinal(pIndex, pszName) == nOrdinal, "%s", pszName);
+    }
+    return TRUE;
+}
+
+static void TestLoadedModules()
+{
+    for (LPCWSTR pszModule : { L"ntdll.dll", L"kernel32.dll", L"kernelbase.dll" }) {
+        HMODULE hModule = GetModuleHandleW(pszModule);
+        if (hModule == NULL) {
+            continue;
+        }
+        DETOUR_EXPORT_INDEX *pIndex;
+        DWORD dwError = detour_export_index_create((PBYTE)hModule, DetourGetModuleSize(hModule), TRUE, &pIndex);
+        CHECK(dwError == NO_ERROR, "%ls: error %u", pszModule, dwError);
+        if (dwError == NO_ERROR) {
+            DetourEnumerateExports(hModule, pIndex, CompareExport);
+            detour_export_index_free(pIndex);
+        }
+    }
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    uint64_t nSeed = 0x5eed;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            nSeed = strtoull(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--scratch") == 0 && i + 1 < argc) {
+            s_scratch = argv[++i];
+        }
+        else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    TestWellFormed();
+    TestNoExports();
+    TestHostileHeaders();
+    TestTruncatedAndFuzzed(nSeed);
+    for (const std::string& file : files) {
+        TestImageFile(file);
+    }
+#ifdef _WIN32
+    TestLoadedModules();
+#endif
+
+    printf("%zu checks, %zu failures\n", s_nChecks, s_nFailures);
+    return s_nFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,230 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+// Tests for the module snapshots in modules.cpp, against this process.
+//
+//   ModuleSnapshotTests
+//
+// Windows only: the snapshots read the loader list and the address space.
+
+#include "detours.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+static size_t s_nChecks = 0;
+static size_t s_nFailures = 0;
+
+#define CHECK(e, ...)                                                   \
+    do {                                                                \
+        s_nChecks++;                                                    \
+        if (!(e)) {                                                     \
+            s_nFailures++;                                              \
+            printf("FAILED %s:%d: %s: ", __FILE__, __LINE__, #e);       \
+            printf(__VA_ARGS__);                                        \
+            printf("\n");                                               \
+        }                                                               \
+    } while (0)
+
+// {6a9d3c1e-58f2-4b7e-9c41-2d0e7f35a8b6}
+static const GUID c_guidFirst =
+{ 0x6a9d3c1e, 0x58f2, 0x4b7e, { 0x9c, 0x41, 0x2d, 0x0e, 0x7f, 0x35, 0xa8, 0xb6 } };
+
+// {0f4b8e27-c3a1-4d59-a6e2-91b7c05d3f48}
+static const GUID c_guidSecond =
+{ 0x0f4b8e27, 0xc3a1, 0x4d59, { 0xa6, 0xe2, 0x91, 0xb7, 0xc0, 0x5d, 0x3f, 0x48 } };
+
+// {d2e81b5c-7a46-4f03-b8d9-5c16e2a4f07b}
+static const GUID c_guidAbsent =
+{ 0xd2e81b5c, 0x7a46, 0x4f03, { 0xb8, 0xd9, 0x5c, 0x16, 0xe2, 0xa4, 0xf0, 0x7b } };
+
+static std::vector<DETOUR_MODULE_INFO> ReadSnapshot(PDETOUR_MODULE_SNAPSHOT pSnapshot)
+{
+    std::vector<DETOUR_MODULE_INFO> modules(DetourModuleSnapshotGetCount(pSnapshot));
+    for (ULONG n = 0; n < modules.size(); n++) {
+        CHECK(DetourModuleSnapshotGetModule(pSnapshot, n, &modules[n]), "module %lu", n);
+    }
+
+    DETOUR_MODULE_INFO info;
+    CHECK(!DetourModuleSnapshotGetModule(pSnapshot, (ULONG)modules.size(), &info) &&
+          GetLastError() == ERROR_NO_MORE_ITEMS, "read past the end");
+    return modules;
+}
+
+static bool Contains(const std::vector<DETOUR_MODULE_INFO>& modules, HMODULE hModule)
+{
+    for (const DETOUR_MODULE_INFO& info : modules) {
+        if (info.hModule == hModule) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void TestSnapshot(DWORD dwFlags)
+{
+    PDETOUR_MODULE_SNAPSHOT pSnapshot = DetourModuleSnapshotCreate(dwFlags);
+    CHECK(pSnapshot != NULL, "flags %lx: error %lu", dwFlags, GetLastError());
+    if (pSnapshot == NULL) {
+        return;
+    }
+
+    std::vector<DETOUR_MODULE_INFO> modules = ReadSnapshot(pSnapshot);
+    for (size_t n = 1; n < modules.size(); n++) {
+        CHECK((ULONG_PTR)modules[n - 1].hModule < (ULONG_PTR)modules[n].hModule,
+              "flags %lx: %p and %p out of order", dwFlags,
+              (void *)modules[n - 1].hModule, (void *)modules[n].hModule);
+    }
+
+    HMODULE hExe = GetModuleHandleW(NULL);
+    HMODULE hNtdll = GetModuleHandleW(L"ntdll.dll");
+    HMODULE hKernel32 = GetModuleHandleW(L"kernel32.dll");
+    CHECK(Contains(modules, hExe), "flags %lx: no exe", dwFlags);
+    CHECK(Contains(modules, hNtdll), "flags %lx: no ntdll", dwFlags);
+    CHECK(Contains(modules, hKernel32), "flags %lx: no kernel32", dwFlags);
+
+    // Look up addresses inside, between and outside the modules.
+    DETOUR_MODULE_INFO info;
+    PVOID pvCreateFile = (PVOID)GetProcAddress(hKernel32, "CreateFileW");
+    CHECK(DetourModuleSnapshotFindAddress(pSnapshot, pvCreateFile, &info) && info.hModule == hKernel32,
+          "flags %lx: CreateFileW in %p", dwFlags, (void *)info.hModule);
+    CHECK(info.cbImage == DetourGetModuleSize(hKernel32), "flags %lx: kernel32 size %lu", dwFlags, info.cbImage);
+
+    std::vector<BYTE> heap(64);
+    CHECK(!DetourModuleSnapshotFindAddress(pSnapshot, heap.data(), &info) &&
+          GetLastError() == ERROR_MOD_NOT_FOUND && info.hModule == NULL,
+          "flags %lx: heap address found in %p", dwFlags, (void *)info.hModule);
+    CHECK(!DetourModuleSnapshotFindAddress(pSnapshot, NULL, &info), "flags %lx: NULL found", dwFlags);
+
+    // The first and last bytes of each module resolve to it, and the loader's
+    // modules agree with DetourGetContainingModule.
+    for (const DETOUR_MODULE_INFO& module : modules) {
+        PBYTE pbLast = (PBYTE)module.hModule + module.cbImage - 1;
+        for (PBYTE pb : { (PBYTE)module.hModule, pbLast }) {
+            CHECK(DetourModuleSnapshotFindAddress(pSnapshot, pb, &info) && info.hModule == module.hModule,
+                  "flags %lx: %p not in %p", dwFlags, (void *)pb, (void *)module.hModule);
+        }
+        if (dwFlags == 0) {
+            CHECK(DetourGetContainingModule((PBYTE)module.hModule + 0x10) == module.hModule,
+                  "%p disagrees with DetourGetContainingModule", (void *)module.hModule);
+        }
+    }
+
+    CHECK(DetourModuleSnapshotClose(pSnapshot), "flags %lx: close", dwFlags);
+}
+
+// The address space walk finds everything on the loader's list.
+static void TestAllImagesIsSuperset()
+{
+    PDETOUR_MODULE_SNAPSHOT pLoader = DetourModuleSnapshotCreate(0);
+    PDETOUR_MODULE_SNAPSHOT pImages = DetourModuleSnapshotCreate(DETOUR_MODULE_SNAPSHOT_ALL_IMAGES);
+    CHECK(pLoader != NULL && pImages != NULL, "create");
+    if (pLoader != NULL && pImages != NULL) {
+        std::vector<DETOUR_MODULE_INFO> loader = ReadSnapshot(pLoader);
+        std::vector<DETOUR_MODULE_INFO> images = ReadSnapshot(pImages);
+        CHECK(images.size() >= loader.size(), "%zu images, %zu modules", images.size(), loader.size());
+        for (const DETOUR_MODULE_INFO& info : loader) {
+            CHECK(Contains(images, info.hModule), "%p missing from the address space walk", (void *)info.hModule);
+        }
+    }
+    if (pLoader != NULL) {
+        DetourModuleSnapshotClose(pLoader);
+    }
+    if (pImages != NULL) {
+        DetourModuleSnapshotClose(pImages);
+    }
+}
+
+static void TestBadArguments()
+{
+    CHECK(DetourModuleSnapshotCreate(0x80000000) == NULL && GetLastError() == ERROR_INVALID_PARAMETER, "flags");
+    CHECK(DetourModuleSnapshotGetCount(NULL) == 0 && GetLastError() == ERROR_INVALID_PARAMETER, "count");
+    CHECK(!DetourModuleSnapshotClose(NULL) && GetLastError() == ERROR_INVALID_PARAMETER, "close");
+}
+
+static void CheckPayload(REFGUID rguid, const char *pszExpected)
+{
+    DWORD cbData = 0;
+    PVOID pvData = DetourFindPayloadEx(rguid, &cbData);
+    CHECK(pvData != NULL && cbData == strlen(pszExpected) + 1 &&
+          memcmp(pvData, pszExpected, cbData) == 0,
+          "%s: %p, %lu bytes, error %lu", pszExpected, pvData, cbData, GetLastError());
+}
+
+// DetourCopyPayloadToProcess writes images without the loader, and without a
+// SizeOfImage.  A payload written after the cached snapshot was taken must
+// still be found, and an absent one must miss cleanly every time.
+//
+static void TestPayloads()
+{
+    DWORD cbData = 0;
+    CHECK(DetourFindPayloadEx(c_guidAbsent, &cbData) == NULL && GetLastError() == ERROR_MOD_NOT_FOUND,
+          "absent payload before any were copied");
+
+    static const char c_szFirst[] = "first payload";
+    CHECK(DetourCopyPayloadToProcess(GetCurrentProcess(), c_guidFirst, (PVOID)c_szFirst, sizeof(c_szFirst)),
+          "copy first: error %lu", GetLastError());
+    CheckPayload(c_guidFirst, c_szFirst);
+
+    static const char c_szSecond[] = "second payload";
+    CHECK(DetourCopyPayloadToProcess(GetCurrentProcess(), c_guidSecond, (PVOID)c_szSecond, sizeof(c_szSecond)),
+          "copy second: error %lu", GetLastError());
+    CheckPayload(c_guidSecond, c_szSecond);
+    CheckPayload(c_guidFirst, c_szFirst);
+
+    for (int n = 0; n < 3; n++) {
+        CHECK(DetourFindPayloadEx(c_guidAbsent, &cbData) == NULL && GetLastError() == ERROR_MOD_NOT_FOUND,
+              "absent payload, search %d", n);
+    }
+
+    // The payload images show up in an address space snapshot.
+    PDETOUR_MODULE_SNAPSHOT pSnapshot = DetourModuleSnapshotCreate(DETOUR_MODULE_SNAPSHOT_ALL_IMAGES);
+    CHECK(pSnapshot != NULL, "create");
+    if (pSnapshot != NULL) {
+        ULONG nPayloads = 0;
+        for (const DETOUR_MODULE_INFO& info : ReadSnapshot(pSnapshot)) {
+            if (info.pPayloads != NULL &&
+                (DetourFindPayload(info.hModule, c_guidFirst, &cbData) != NULL ||
+                 DetourFindPayload(info.hModule, c_guidSecond, &cbData) != NULL)) {
+                CHECK(info.cbImage != 0, "payload image %p has no size", (void *)info.hModule);
+                nPayloads++;
+            }
+        }
+        CHECK(nPayloads == 2, "%lu payload images", nPayloads);
+        DetourModuleSnapshotClose(pSnapshot);
+    }
+}
+
+// A module loaded after the cached snapshot was taken must not hide payloads,
+// and a lookup in it must not trip over the modules that came and went.
+//
+static void TestLoadAndUnload()
+{
+    HMODULE hModule = LoadLibraryW(L"version.dll");
+    CHECK(hModule != NULL, "LoadLibrary: error %lu", GetLastError());
+    CheckPayload(c_guidFirst, "first payload");
+    if (hModule != NULL) {
+        FreeLibrary(hModule);
+    }
+    CheckPayload(c_guidSecond, "second payload");
+
+    DWORD cbData = 0;
+    CHECK(DetourFindPayloadEx(c_guidAbsent, &cbData) == NULL && GetLastError() == ERROR_MOD_NOT_FOUND,
+          "absent payload after an unload");
+}
+
+int main()
+{
+    TestSnapshot(0);
+    TestSnapshot(DETOUR_MODULE_SNAPSHOT_ALL_IMAGES);
+    TestAllImagesIsSuperset();
+    TestBadArguments();
+    TestPayloads();
+    TestLoadAndUnload();
+
+    printf("%zu checks, %zu failures\n", s_nChecks, s_nFailures);
+    return s_nFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+// Definitions that the Detours sources under test expect from the rest of
+// detours.lib or from kernel32.
+
+#define DETOURS_INTERNAL
+#include "detours.h"
+
+#ifndef _WIN32
+static thread_local DWORD s_dwLastError = NO_ERROR;
+
+void WINAPI SetLastError(DWORD dwErrCode)
+{
+    s_dwLastError = dwErrCode;
+}
+
+DWORD WINAPI GetLastError()
+{
+    return s_dwLastError;
+}
+
+// DetourSetCodeModule sizes the module with this.  The tests hand it a fake
+// module, which this makes empty.
+ULONG WINAPI DetourGetModuleSize(_In_opt_ HMODULE hModule)
+{
+    UNREFERENCED_PARAMETER(hModule);
+    return 0;
+}
+#endif
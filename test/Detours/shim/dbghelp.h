@@ -0,0 +1,4 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+// Empty stand-in for the SDK header; see windows.h in this directory.
@@ -0,0 +1,246 @@
+// Copyright (c) Microsoft Corporation and Contributors.
+// Licensed under the MIT License.
+
+// Tests for the perfect-hash catalog index in catalogindex.h.
+//
+//   CatalogIndexTests [--seed n]
+//
+// Names are looked up by buffer and length, the way an HSTRING's raw buffer
+// is, so embedded NULs and prefixes of catalog names are part of the cases.
+
+#include "catalogindex.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+using UndockedRegFreeWinRT::CatalogHash;
+using TestIndex = UndockedRegFreeWinRT::CatalogIndex<uint32_t>;
+
+static size_t s_nChecks = 0;
+static size_t s_nFailures = 0;
+
+#define CHECK(e, ...)                                                   \
+    do {                                                                \
+        s_nChecks++;                                                    \
+        if (!(e)) {                                                     \
+            s_nFailures++;                                              \
+            printf("FAILED %s:%d: %s: ", __FILE__, __LINE__, #e);       \
+            printf(__VA_ARGS__);                                        \
+            printf("\n");                                               \
+        }                                                               \
+    } while (0)
+
+// xorshift64*, so a failing seed can be replayed.
+struct TestRandom
+{
+    uint64_t state;
+
+    explicit TestRandom(uint64_t seed) : state(seed ? seed : 1) {}
+
+    uint32_t Next(uint32_t limit)
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return (uint32_t)((state * 0x2545F4914F6CDD1Dull) >> 32) % limit;
+    }
+};
+
+static std::string Narrow(const std::wstring& name)
+{
+    std::string narrow;
+    for (wchar_t ch : name) {
+        if (ch >= 0x20 && ch < 0x7f) {
+            narrow += (char)ch;
+        }
+        else {
+            char escaped[16];
+            snprintf(escaped, sizeof(escaped), "\\x%x", (unsigned)ch);
+            narrow += escaped;
+        }
+    }
+    return narrow;
+}
+
+// The value of each key is its position in names.
+static std::vector<TestIndex::Key> MakeKeys(const std::vector<std::wstring>& names)
+{
+    std::vector<TestIndex::Key> keys;
+    for (uint32_t i = 0; i < names.size(); i++) {
+        const auto length = (uint32_t)names[i].size();
+        keys.push_back({ names[i].data(), length, CatalogHash(names[i].data(), length), i });
+    }
+    return keys;
+}
+
+static const TestIndex::Entry *Find(const TestIndex& index, const std::wstring& name)
+{
+    return index.Find(name.data(), (uint32_t)name.size());
+}
+
+static void CheckAllFound(const TestIndex& index, const std::vector<std::wstring>& names)
+{
+    for (uint32_t i = 0; i < names.size(); i++) {
+        const TestIndex::Entry *entry = Find(index, names[i]);
+        CHECK(entry != nullptr && entry->value == i && entry->name == names[i].data(),
+              "%s: %s", Narrow(names[i]).c_str(), entry ? "wrong entry" : "not found");
+    }
+}
+
+static void TestHash()
+{
+    // FNV-1a test vectors; ASCII code units hash like bytes.
+    CHECK(CatalogHash(L"", 0) == 0xcbf29ce484222325ull, "empty");
+    CHECK(CatalogHash(L"a", 1) == 0xaf63dc4c8601ec8cull, "a");
+    CHECK(CatalogHash(L"foobar", 6) == 0x85944171f73967e8ull, "foobar");
+
+    // Code units above 0xff are hashed whole, not truncated to a byte.
+    CHECK(CatalogHash(L"\x0141", 1) != CatalogHash(L"\x0041", 1), "high code unit");
+}
+
+static void TestEmpty()
+{
+    CHECK(TestIndex::Build({}) == nullptr, "empty catalog");
+}
+
+// Catalogs of every small size and a few large ones: each name is found, and
+// names that aren't in the catalog, including prefixes and extensions of ones
+// that are, are not.
+static void TestSizes(TestRandom& rng)
+{
+    std::vector<uint32_t> sizes;
+    for (uint32_t n = 1; n <= 64; n++) {
+        sizes.push_back(n);
+    }
+    sizes.insert(sizes.end(), { 100, 1000, 5000 });
+
+    for (uint32_t count : sizes) {
+        std::vector<std::wstring> names;
+        std::set<std::wstring> unique;
+        while (names.size() < count) {
+            std::wstring name = L"Microsoft.Test.";
+            const uint32_t length = 1 + rng.Next(24);
+            for (uint32_t i = 0; i < length; i++) {
+                name += (wchar_t)(L'A' + rng.Next(26));
+            }
+            if (unique.insert(name).second) {
+                names.push_back(name);
+            }
+        }
+
+        std::unique_ptr<TestIndex> index = TestIndex::Build(MakeKeys(names));
+        CHECK(index != nullptr, "%u names", count);
+        if (index == nullptr) {
+            continue;
+        }
+        CHECK(index->slot_count >= count, "%u names in %u slots", count, index->slot_count);
+        CheckAllFound(*index, names);
+
+        for (const std::wstring& name : names) {
+            // Wrong lengths over the same buffer: a prefix, and the name plus the next code unit.
+            std::wstring longer = name + L"X";
+            if (unique.count(name.substr(0, name.size() - 1)) == 0) {
+                CHECK(index->Find(name.data(), (uint32_t)name.size() - 1) == nullptr, "prefix of %s", Narrow(name).c_str());
+            }
+            if (unique.count(longer) == 0) {
+                CHECK(index->Find(longer.data(), (uint32_t)longer.size()) == nullptr, "%s", Narrow(longer).c_str());
+            }
+
+            // Same length, one code unit different.
+            std::wstring changed = name;
+            changed[rng.Next((uint32_t)changed.size())] ^= 0x20;
+            if (unique.count(changed) == 0) {
+                CHECK(Find(*index, changed) == nullptr, "%s", Narrow(changed).c_str());
+            }
+        }
+
+        CHECK(Find(*index, L"") == nullptr, "empty name, %u names", count);
+        CHECK(Find(*index, L"Windows.Foundation.Uri") == nullptr, "inbox name, %u names", count);
+    }
+}
+
+// HSTRINGs can hold NULs.  They are part of the name, not its end.
+static void TestEmbeddedNul()
+{
+    const std::vector<std::wstring> names =
+    {
+        std::wstring(L"Microsoft.Test.A", 16),
+        std::wstring(L"Microsoft.Test.A\0B", 18),
+        std::wstring(L"Microsoft.Test.A\0", 17),
+        std::wstring(L"\0", 1),
+    };
+    std::unique_ptr<TestIndex> index = TestIndex::Build(MakeKeys(names));
+    CHECK(index != nullptr, "build");
+    if (index == nullptr) {
+        return;
+    }
+    CheckAllFound(*index, names);
+
+    CHECK(Find(*index, std::wstring(L"Microsoft.Test.A\0C", 18)) == nullptr, "A\\0C");
+    CHECK(Find(*index, std::wstring(L"Microsoft.Test.A\0B\0", 19)) == nullptr, "A\\0B\\0");
+    CHECK(Find(*index, std::wstring(L"\0\0", 2)) == nullptr, "\\0\\0");
+    CHECK(Find(*index, L"") == nullptr, "empty name");
+
+    // The NUL-terminated prefix of "A\0B" is a different name.
+    const TestIndex::Entry *entry = index->Find(names[1].data(), 16);
+    CHECK(entry != nullptr && entry->value == 0, "A\\0B read to its first NUL");
+}
+
+// Names whose full hashes collide can't be placed, so the build fails and the
+// caller keeps using its own map.  Names that only share a bucket are fine.
+static void TestCollisions()
+{
+    const std::vector<std::wstring> names = { L"Microsoft.Test.First", L"Microsoft.Test.Second", L"Microsoft.Test.Third" };
+
+    std::vector<TestIndex::Key> keys = MakeKeys(names);
+    keys[2].hash = keys[0].hash;
+    CHECK(TestIndex::Build(keys) == nullptr, "full-hash collision");
+
+    // Same high half, so the same bucket, whatever the bucket count.
+    keys = MakeKeys(names);
+    for (TestIndex::Key& key : keys) {
+        key.hash = 0x1234567800000000ull | (key.hash & 0xffffffffull);
+    }
+    std::unique_ptr<TestIndex> index = TestIndex::Build(keys);
+    CHECK(index != nullptr, "shared bucket");
+    if (index != nullptr) {
+        // Find hashes the name itself, so look each slot up directly.
+        for (const TestIndex::Key& key : keys) {
+            bool found = false;
+            for (uint32_t slot = 0; slot < index->slot_count; slot++) {
+                const TestIndex::Entry& entry = index->slots[slot];
+                if (entry.name == key.name) {
+                    CHECK(!found && entry.value == key.value, "%s placed twice", Narrow(key.name).c_str());
+                    found = true;
+                }
+            }
+            CHECK(found, "%s not placed", Narrow(key.name).c_str());
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t nSeed = 0x5eed;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            nSeed = strtoull(argv[++i], nullptr, 0);
+        }
+    }
+    printf("seed 0x%llx\n", (unsigned long long)nSeed);
+
+    TestRandom rng(nSeed);
+    TestHash();
+    TestEmpty();
+    TestSizes(rng);
+    TestEmbeddedNul();
+    TestCollisions();
+
+    printf("%zu checks, %zu failures\n", s_nChecks, s_nFailures);
+    return s_nFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}